@@ -16,13 +16,13 @@
 
 precision mediump float;
 uniform sampler2D u_Texture;
-uniform vec4 u_LightingParameters;
 uniform vec4 u_MaterialParameters;
 uniform vec4 u_ColorCorrectionParameters;
-uniform vec4 u_ColorTintParameters;
 varying vec3 v_ViewPosition;
 varying vec3 v_ViewNormal;
 varying vec2 v_TexCoord;
+varying vec3 v_ViewLightDirection;
+varying vec4 v_ColorTint;
 
 void main() {
   // We support approximate sRGB gamma.
@@ -31,7 +31,7 @@ void main() {
   const float kMiddleGrayGamma = 0.466;
 
   // Unpack lighting and material parameters for better naming.
-  vec3 viewLightDirection = u_LightingParameters.xyz;
+  vec3 viewLightDirection = normalize(v_ViewLightDirection);
   vec3 colorShift = u_ColorCorrectionParameters.rgb;
   float averagePixelIntensity = u_ColorCorrectionParameters.a;
 
@@ -50,7 +50,7 @@ void main() {
   // Flip the y-texture coordinate to address the texture from top-left.
   vec4 objectColor = texture2D(u_Texture,
     vec2(v_TexCoord.x, 1.0 - v_TexCoord.y));
-  objectColor.rgb += u_ColorTintParameters.rgb;
+  objectColor.rgb += v_ColorTint.rgb;
   objectColor.rgb = pow(objectColor.rgb, vec3(kInverseGamma));
 
   // Ambient light is unaffected by the light intensity.
@@ -74,5 +74,5 @@ void main() {
   // Apply average pixel intensity and color shift
   color *= colorShift * (averagePixelIntensity/kMiddleGrayGamma);
   gl_FragColor.rgb = color;
-  gl_FragColor.a = objectColor.a * u_ColorTintParameters.a;
+  gl_FragColor.a = objectColor.a * v_ColorTint.a;
 }
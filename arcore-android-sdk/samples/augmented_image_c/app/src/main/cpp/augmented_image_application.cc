@@ -349,10 +349,11 @@ bool AugmentedImageApplication::DrawAugmentedImage(
           ((tint_color_hex & 0x0000FF00) >> 8) / 255.0f * kTintIntensity,
           kTintAlpha};
 
-      image_renderer_.Draw(projection_mat, view_mat, color_correction,
-                           tint_color_rgba, ar_session_, ar_image, ar_anchor);
+      image_renderer_.AddImage(tint_color_rgba, ar_session_, ar_image,
+                               ar_anchor);
     }
   }
+  image_renderer_.Draw(projection_mat, view_mat, color_correction);
 
   return found_ar_image;
 }
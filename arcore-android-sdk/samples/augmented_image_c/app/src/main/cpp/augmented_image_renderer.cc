@@ -18,54 +18,55 @@
 #include "util.h"
 
 namespace augmented_image {
+namespace {
+constexpr char kFrameTextureFilename[] = "models/frame_base.png";
+}  // namespace
 
 void AugmentedImageRenderer::InitializeGlContent(AAssetManager* asset_manager) {
-  image_frame_upper_left.InitializeGlContent(
-      asset_manager, "models/frame_upper_left.obj", "models/frame_base.png");
-  image_frame_upper_right.InitializeGlContent(
-      asset_manager, "models/frame_upper_right.obj", "models/frame_base.png");
-  image_frame_lower_left.InitializeGlContent(
-      asset_manager, "models/frame_lower_left.obj", "models/frame_base.png");
-  image_frame_lower_right.InitializeGlContent(
-      asset_manager, "models/frame_lower_right.obj", "models/frame_base.png");
+  corner_renderers_[kUpperLeft].InitializeGlContent(
+      asset_manager, "models/frame_upper_left.mesh", kFrameTextureFilename);
+  corner_renderers_[kUpperRight].InitializeGlContent(
+      asset_manager, "models/frame_upper_right.mesh", kFrameTextureFilename);
+  corner_renderers_[kLowerLeft].InitializeGlContent(
+      asset_manager, "models/frame_lower_left.mesh", kFrameTextureFilename);
+  corner_renderers_[kLowerRight].InitializeGlContent(
+      asset_manager, "models/frame_lower_right.mesh", kFrameTextureFilename);
 }
 
-void AugmentedImageRenderer::Draw(const glm::mat4& projection_mat,
-                                  const glm::mat4& view_mat,
-                                  const float* color_correction4,
-                                  const float* color_tint_rgba,
-                                  const ArSession* ar_session,
-                                  const ArAugmentedImage* ar_image,
-                                  const ArAnchor* ar_anchor) const {
+void AugmentedImageRenderer::AddImage(const float* color_tint_rgba,
+                                      const ArSession* ar_session,
+                                      const ArAugmentedImage* ar_image,
+                                      const ArAnchor* ar_anchor) {
   // Get image extents.
   float extent_x, extent_z;
   ArAugmentedImage_getExtentX(ar_session, ar_image, &extent_x);
   ArAugmentedImage_getExtentZ(ar_session, ar_image, &extent_z);
 
-  glm::mat4 local_upper_left_matrix = glm::translate(
-      glm::mat4(1.0), glm::vec3(-0.5f * extent_x, 0.0f, -0.5f * extent_z));
-  glm::mat4 local_upper_right_matrix = glm::translate(
-      glm::mat4(1.0), glm::vec3(0.5f * extent_x, 0.0f, -0.5f * extent_z));
-  glm::mat4 local_lower_right_matrix = glm::translate(
-      glm::mat4(1.0), glm::vec3(0.5f * extent_x, 0.0f, 0.5f * extent_z));
-  glm::mat4 local_lower_left_matrix = glm::translate(
-      glm::mat4(1.0), glm::vec3(-0.5f * extent_x, 0.0f, 0.5f * extent_z));
+  const glm::vec3 corner_offsets[kNumCorners] = {
+      glm::vec3(-0.5f * extent_x, 0.0f, -0.5f * extent_z),
+      glm::vec3(0.5f * extent_x, 0.0f, -0.5f * extent_z),
+      glm::vec3(-0.5f * extent_x, 0.0f, 0.5f * extent_z),
+      glm::vec3(0.5f * extent_x, 0.0f, 0.5f * extent_z)};
 
   glm::mat4 center_matrix;
   util::GetTransformMatrixFromAnchor(ar_session, ar_anchor, &center_matrix);
 
-  image_frame_upper_left.Draw(projection_mat, view_mat,
-                              center_matrix * local_upper_left_matrix,
-                              color_correction4, color_tint_rgba);
-  image_frame_upper_right.Draw(projection_mat, view_mat,
-                               center_matrix * local_upper_right_matrix,
-                               color_correction4, color_tint_rgba);
-  image_frame_lower_left.Draw(projection_mat, view_mat,
-                              center_matrix * local_lower_left_matrix,
-                              color_correction4, color_tint_rgba);
-  image_frame_lower_right.Draw(projection_mat, view_mat,
-                               center_matrix * local_lower_right_matrix,
-                               color_correction4, color_tint_rgba);
+  const glm::vec4 color_tint = glm::make_vec4(color_tint_rgba);
+  for (int corner = 0; corner < kNumCorners; ++corner) {
+    corner_instances_[corner].push_back(ObjRenderer::Instance{
+        glm::translate(center_matrix, corner_offsets[corner]), color_tint});
+  }
+}
+
+void AugmentedImageRenderer::Draw(const glm::mat4& projection_mat,
+                                  const glm::mat4& view_mat,
+                                  const float* color_correction4) {
+  for (int corner = 0; corner < kNumCorners; ++corner) {
+    std::vector<ObjRenderer::Instance>& instances = corner_instances_[corner];
+    corner_renderers_[corner].Draw(projection_mat, view_mat, instances.data(),
+                                   instances.size(), color_correction4);
+    instances.clear();
+  }
 }
 
 }  // namespace augmented_image
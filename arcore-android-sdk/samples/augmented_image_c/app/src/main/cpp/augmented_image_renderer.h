@@ -18,6 +18,7 @@
 #define C_ARCORE_AUGMENTED_IMAGE_AUGMENTED_IMAGE_RENDERER_H_
 
 #include <android/asset_manager.h>
+#include <vector>
 
 #include "arcore_c_api.h"
 #include "glm.h"
@@ -35,17 +36,28 @@ class AugmentedImageRenderer {
   // other methods below.
   void InitializeGlContent(AAssetManager* asset_manager);
 
-  // Draws frames on ArAugmentedImage, with center location at ArAnchor.
+  // Adds a frame on ArAugmentedImage, with center location at ArAnchor, to
+  // the frames drawn by the next Draw().
+  void AddImage(const float* color_tint_rgba, const ArSession* ar_session,
+                const ArAugmentedImage* ar_image, const ArAnchor* ar_anchor);
+
+  // Draws the added frames, with one instanced draw per frame corner, and
+  // clears them.
   void Draw(const glm::mat4& projection_mat, const glm::mat4& view_mat,
-            const float* color_correction4, const float* color_tint_rgba,
-            const ArSession* ar_session, const ArAugmentedImage* ar_image,
-            const ArAnchor* ar_anchor) const;
+            const float* color_correction4);
 
  private:
-  ObjRenderer image_frame_upper_left;
-  ObjRenderer image_frame_upper_right;
-  ObjRenderer image_frame_lower_left;
-  ObjRenderer image_frame_lower_right;
+  enum Corner {
+    kUpperLeft,
+    kUpperRight,
+    kLowerLeft,
+    kLowerRight,
+    kNumCorners
+  };
+
+  ObjRenderer corner_renderers_[kNumCorners];
+  // Corners of the added frames.
+  std::vector<ObjRenderer::Instance> corner_instances_[kNumCorners];
 };
 
 }  // namespace augmented_image
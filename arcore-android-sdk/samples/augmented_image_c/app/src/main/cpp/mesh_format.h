@@ -0,0 +1,121 @@
+/*
+ * Copyright 2017 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef C_ARCORE_AUGMENTED_IMAGE_MESH_FORMAT_H_
+#define C_ARCORE_AUGMENTED_IMAGE_MESH_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Layout of the binary mesh files written from OBJ by the mesh_convert tool
+// of the hello_cloudxr_c sample, and mapped by ObjRenderer.  This header must
+// stay free of Android and GL dependencies.
+//
+// A file is a MeshFileHeader followed by the interleaved vertices and the
+// triangle indices, each at a 16-byte aligned offset, so both can go to
+// glBufferData() straight from the mapped file.  A vertex is the position as
+// 3 floats, then if present the normal and the uv:
+//   normal  3 floats, or with kMeshQuantizedNormals 4 normalized int16
+//           (x, y, z and padding),
+//   uv      2 floats, or with kMeshQuantizedUvs 2 normalized uint16, used only
+//           when every uv is within [0, 1].
+// Indices are uint16, or uint32 with kMeshIndex32.  Values are little endian.
+namespace augmented_image {
+namespace mesh {
+
+constexpr char kFileMagic[4] = {'M', 'E', 'S', 'H'};
+constexpr uint32_t kFileVersion = 1;
+constexpr uint32_t kDataAlignment = 16;
+
+enum MeshFlags : uint32_t {
+  kMeshNormals = 1 << 0,
+  kMeshUvs = 1 << 1,
+  kMeshQuantizedNormals = 1 << 2,
+  kMeshQuantizedUvs = 1 << 3,
+  kMeshIndex32 = 1 << 4,
+};
+
+struct MeshFileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t flags;
+  uint32_t vertex_count;
+  uint32_t vertex_stride;
+  uint32_t index_count;
+  uint32_t reserved;
+  // Offsets from the start of the file.
+  uint64_t vertex_offset;
+  uint64_t vertex_size;
+  uint64_t index_offset;
+  uint64_t index_size;
+};
+static_assert(sizeof(MeshFileHeader) == 64, "MeshFileHeader layout changed");
+
+// Byte offsets of the attributes within a vertex, 0 for absent normals and
+// uvs (the position is always at 0).
+struct MeshVertexLayout {
+  uint32_t normal_offset;
+  uint32_t uv_offset;
+  uint32_t stride;
+};
+
+inline MeshVertexLayout GetVertexLayout(uint32_t flags) {
+  MeshVertexLayout layout = {0, 0, 3 * sizeof(float)};
+  if (flags & kMeshNormals) {
+    layout.normal_offset = layout.stride;
+    layout.stride += (flags & kMeshQuantizedNormals) ? 4 * sizeof(int16_t)
+                                                     : 3 * sizeof(float);
+  }
+  if (flags & kMeshUvs) {
+    layout.uv_offset = layout.stride;
+    layout.stride += (flags & kMeshQuantizedUvs) ? 2 * sizeof(uint16_t)
+                                                 : 2 * sizeof(float);
+  }
+  return layout;
+}
+
+inline uint64_t AlignOffset(uint64_t offset) {
+  return (offset + kDataAlignment - 1) & ~uint64_t(kDataAlignment - 1);
+}
+
+// Checks the header of the |size| byte file at |data| and that the vertex
+// and index data it points to lie within the file.
+inline bool IsValidMeshFile(const void* data, size_t size) {
+  if (size < sizeof(MeshFileHeader)) return false;
+  MeshFileHeader header;
+  memcpy(&header, data, sizeof(header));
+  const uint64_t index_bytes = (header.flags & kMeshIndex32) ? 4 : 2;
+  return memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) == 0 &&
+         header.version == kFileVersion &&
+         header.header_size >= sizeof(MeshFileHeader) &&
+         header.vertex_stride == GetVertexLayout(header.flags).stride &&
+         header.vertex_size ==
+             uint64_t(header.vertex_count) * header.vertex_stride &&
+         header.index_size == header.index_count * index_bytes &&
+         header.vertex_offset % kDataAlignment == 0 &&
+         header.index_offset % kDataAlignment == 0 &&
+         header.vertex_offset >= header.header_size &&
+         header.vertex_offset + header.vertex_size <= size &&
+         header.index_offset >= header.vertex_offset + header.vertex_size &&
+         header.index_offset + header.index_size <= size;
+}
+
+}  // namespace mesh
+}  // namespace augmented_image
+
+#endif  // C_ARCORE_AUGMENTED_IMAGE_MESH_FORMAT_H_
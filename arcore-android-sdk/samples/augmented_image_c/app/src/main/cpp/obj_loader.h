@@ -0,0 +1,70 @@
+/*
+ * Copyright 2017 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef C_ARCORE_AUGMENTED_IMAGE_OBJ_LOADER_H_
+#define C_ARCORE_AUGMENTED_IMAGE_OBJ_LOADER_H_
+
+#include <GLES2/gl2.h>
+#include <android/asset_manager.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace augmented_image {
+
+// Indexed triangle mesh read from an OBJ file.  Each distinct combination of
+// position, texture and normal index in the faces becomes one vertex.
+struct ObjMesh {
+  // Vertex streams: 3 floats per vertex for positions and normals, 2 for uvs.
+  // normals and uvs are empty if no face references them, and zero for the
+  // vertices of faces that do not.
+  std::vector<GLfloat> positions;
+  std::vector<GLfloat> normals;
+  std::vector<GLfloat> uvs;
+
+  // Triangle indices, GL_UNSIGNED_SHORT in indices16 when every vertex fits,
+  // otherwise GL_UNSIGNED_INT in indices32, which on OpenGL ES 2.0 needs
+  // GL_OES_element_index_uint.
+  GLenum index_type = GL_UNSIGNED_SHORT;
+  std::vector<GLushort> indices16;
+  std::vector<GLuint> indices32;
+
+  size_t vertex_count() const { return positions.size() / 3; }
+  size_t index_count() const {
+    return index_type == GL_UNSIGNED_SHORT ? indices16.size()
+                                           : indices32.size();
+  }
+  const void* index_data() const {
+    return index_type == GL_UNSIGNED_SHORT
+               ? static_cast<const void*>(indices16.data())
+               : static_cast<const void*>(indices32.data());
+  }
+};
+
+// Parses OBJ text in one pass, without copying lines, so lines can be of any
+// length.  Reads v, vt, vn and f statements and ignores everything else.
+// Faces can have any number of vertices and are triangulated as fans;
+// negative indices count back from the latest element.  Logs and returns
+// false on malformed numbers or indices out of range.
+bool ParseObj(const char* text, size_t size, ObjMesh* out_mesh);
+
+// Parses the OBJ file |file_name|, relative to the assets folder.
+bool LoadObjMesh(AAssetManager* asset_manager, const char* file_name,
+                 ObjMesh* out_mesh);
+
+}  // namespace augmented_image
+
+#endif  // C_ARCORE_AUGMENTED_IMAGE_OBJ_LOADER_H_
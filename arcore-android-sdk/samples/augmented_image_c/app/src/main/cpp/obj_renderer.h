@@ -16,8 +16,7 @@
 
 #ifndef C_ARCORE_AUGMENTED_IMAGE_OBJ_RENDERER_
 #define C_ARCORE_AUGMENTED_IMAGE_OBJ_RENDERER_
-#include <GLES2/gl2.h>
-#include <GLES2/gl2ext.h>
+#include <GLES3/gl3.h>
 #include <android/asset_manager.h>
 #include <cstdint>
 #include <cstdlib>
@@ -26,19 +25,29 @@
 
 #include "arcore_c_api.h"
 #include "glm.h"
+#include "mesh_format.h"
 
 namespace augmented_image {
 
 // PlaneRenderer renders ARCore plane type.
 class ObjRenderer {
  public:
+  // Per-instance attributes.
+  struct Instance {
+    glm::mat4 model_mat;
+    // Color tint, as in Draw().
+    glm::vec4 color;
+  };
+
   ObjRenderer() = default;
   ~ObjRenderer() = default;
 
-  // Loads the OBJ file and texture and sets up OpenGL resources used to draw
+  // Loads the model and texture and sets up OpenGL resources used to draw
   // the model.  Must be called on the OpenGL thread prior to any other calls.
+  // The model is either a binary .mesh file written by mesh_convert, which is
+  // uploaded straight from the mapped asset, or an OBJ file.
   void InitializeGlContent(AAssetManager* asset_manager,
-                           const std::string& obj_file_name,
+                           const std::string& model_file_name,
                            const std::string& png_file_name);
 
   // Sets the surface's lighting reflectace properties.  Diffuse is modulated by
@@ -55,20 +64,47 @@ class ObjRenderer {
   void Draw(const glm::mat4& projection_mat, const glm::mat4& view_mat,
             const glm::mat4& model_mat, const float* color_correction4) const;
 
+  // Draws |count| instances of the model with one draw call.  Requires an
+  // OpenGL ES 3.0 context.
+  void Draw(const glm::mat4& projection_mat, const glm::mat4& view_mat,
+            const Instance* instances, size_t count,
+            const float* color_correction4) const;
+
  private:
+  bool LoadBinaryMesh(AAssetManager* asset_manager,
+                      const std::string& file_name);
+  bool LoadObj(AAssetManager* asset_manager, const std::string& file_name);
+  // Creates the vertex and index buffers from vertices laid out according to
+  // the mesh::MeshFlags in |flags|, and the vertex array object.
+  void UploadMesh(uint32_t flags, const void* vertices, size_t vertices_size,
+                  const void* indices, uint32_t index_count);
+  // Points the per-vertex and per-instance attributes at the vertex and
+  // instance buffers.
+  void SetVertexAttributes() const;
+
   // Shader material lighting pateremrs
   float ambient_ = 0.0f;
   float diffuse_ = 2.0f;
   float specular_ = 0.5f;
   float specular_power_ = 6.0f;
 
-  // Model attribute arrays
-  std::vector<GLfloat> vertices_;
-  std::vector<GLfloat> uvs_;
-  std::vector<GLfloat> normals_;
+  // Model vertex and index buffers, with mesh::MeshFlags describing them
+  GLuint vertex_buffer_ = 0;
+  GLuint index_buffer_ = 0;
+  uint32_t mesh_flags_ = 0;
+  GLsizei index_count_ = 0;
+
+  // Instances of the current draw, rewritten by every draw.
+  GLuint instance_buffer_ = 0;
+  mutable size_t instance_capacity_ = 0;
+
+  // Vertex array object holding the attribute setup and index buffer.
+  GLuint vertex_array_ = 0;
 
-  // Model triangle indices
-  std::vector<GLushort> indices_;
+  // Uniform values last set on the program, so draws skip unchanged ones.
+  mutable bool uniforms_set_ = false;
+  mutable glm::vec4 material_uniform_;
+  mutable glm::vec4 color_correction_uniform_;
 
   // Loaded TEXTURE_2D object name
   GLuint texture_id_;
@@ -78,13 +114,13 @@ class ObjRenderer {
   GLuint attri_vertices_;
   GLuint attri_uvs_;
   GLuint attri_normals_;
-  GLuint uniform_mvp_mat_;
-  GLuint uniform_mv_mat_;
+  GLuint attri_model_mat_;
+  GLuint attri_color_;
+  GLuint uniform_projection_mat_;
+  GLuint uniform_view_mat_;
   GLuint uniform_texture_;
-  GLuint uniform_lighting_param_;
   GLuint uniform_material_param_;
   GLuint uniform_color_correction_param_;
-  GLuint uniform_color_tint_param_;
 };
 }  // namespace augmented_image
 
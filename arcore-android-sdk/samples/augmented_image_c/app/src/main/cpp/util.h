@@ -131,21 +131,6 @@ bool LoadImageFromAssetManager(const std::string& path, int* out_width,
 // @return true if function is successful, otherwise false
 bool HideFitToScanImage(void* activity);
 
-// Loads obj file from assets folder from the app.
-//
-// @param mgr, AAssetManager pointer.
-// @param file_name, name of the obj file.
-// @param out_vertices, output vertices.
-// @param out_normals, output normals.
-// @param out_uv, output texture UV coordinates.
-// @param out_indices, output triangle indices.
-// @return true if obj is loaded correctly, otherwise false.
-bool LoadObjFile(AAssetManager* mgr, const std::string& file_name,
-                 std::vector<GLfloat>* out_vertices,
-                 std::vector<GLfloat>* out_normals,
-                 std::vector<GLfloat>* out_uv,
-                 std::vector<GLushort>* out_indices);
-
 // Formats and outputs the matrix to logcat file.
 // Note that this function output matrix in row major.
 void Log4x4Matrix(float raw_matrix[16]);
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2017 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host check of PointCloudMap, built by the host configure of CMakeLists.txt
+// with AddressSanitizer and UndefinedBehaviorSanitizer.  Feeds the map
+// synthetic point clouds through stand-ins for the ArPointCloud calls and
+// checks that voxels stay unique and the map never exceeds its capacity.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "point_cloud_map.h"
+
+struct ArPointCloud_ {
+  std::vector<float> data;
+  std::vector<int32_t> ids;
+};
+
+void ArPointCloud_getNumberOfPoints(const ArSession*,
+                                    const ArPointCloud* point_cloud,
+                                    int32_t* out_number_of_points) {
+  *out_number_of_points = static_cast<int32_t>(point_cloud->ids.size());
+}
+
+void ArPointCloud_getData(const ArSession*, const ArPointCloud* point_cloud,
+                          const float** out_point_cloud_data) {
+  *out_point_cloud_data = point_cloud->data.data();
+}
+
+void ArPointCloud_getPointIds(const ArSession*,
+                              const ArPointCloud* point_cloud,
+                              const int32_t** out_point_ids) {
+  *out_point_ids = point_cloud->ids.data();
+}
+
+namespace {
+constexpr float kVoxelSize = 0.02f;
+
+int g_failures = 0;
+
+void Fail(const char* check, size_t frame, const char* message) {
+  fprintf(stderr, "%s: frame %zu: %s\n", check, frame, message);
+  ++g_failures;
+}
+
+// Checks the invariants that hold after every Update().
+void Validate(const char* check, size_t frame,
+              hello_ar::PointCloudMap* map) {
+  if (map->size() > map->capacity()) {
+    Fail(check, frame, "map exceeds its capacity");
+  }
+  size_t begin = 0;
+  size_t end = 0;
+  map->TakeDirtyRange(&begin, &end);
+  if (begin > end || end > map->size()) {
+    Fail(check, frame, "dirty range outside the map");
+  }
+  std::set<std::tuple<int, int, int>> voxels;
+  for (size_t i = 0; i < map->size(); ++i) {
+    const glm::vec4& point = map->points()[i];
+    const glm::vec3 voxel = glm::floor(glm::vec3(point) / kVoxelSize);
+    if (!voxels.emplace(static_cast<int>(voxel.x), static_cast<int>(voxel.y),
+                        static_cast<int>(voxel.z))
+             .second) {
+      Fail(check, frame, "two points share a voxel");
+      return;
+    }
+  }
+}
+
+// Points that ARCore keeps refining: a fixed set of ids whose positions
+// jitter by about a voxel from frame to frame, plus a few new ids per frame.
+void CheckRefinedPoints() {
+  hello_ar::PointCloudMap map(kVoxelSize, 4096);
+  std::mt19937 random(1);
+  std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+  std::normal_distribution<float> jitter(0.0f, kVoxelSize);
+
+  std::vector<glm::vec3> tracked(512);
+  for (glm::vec3& point : tracked) {
+    point = glm::vec3(position(random), position(random), position(random));
+  }
+  int32_t next_id = static_cast<int32_t>(tracked.size());
+  ArPointCloud cloud;
+  for (size_t frame = 0; frame < 300; ++frame) {
+    cloud.data.clear();
+    cloud.ids.clear();
+    for (size_t i = 0; i < tracked.size(); ++i) {
+      const glm::vec3& point = tracked[i];
+      cloud.data.insert(cloud.data.end(),
+                        {point.x + jitter(random), point.y + jitter(random),
+                         point.z + jitter(random), 0.5f});
+      cloud.ids.push_back(static_cast<int32_t>(i));
+    }
+    for (int i = 0; i < 32; ++i) {
+      cloud.data.insert(cloud.data.end(), {position(random), position(random),
+                                           position(random), 0.5f});
+      cloud.ids.push_back(next_id++);
+    }
+    map.Update(nullptr, &cloud);
+    Validate("refined_points", frame, &map);
+  }
+  if (map.size() != map.capacity()) {
+    Fail("refined_points", 300, "map did not fill up");
+  }
+
+  map.Clear();
+  if (map.size() != 0) Fail("refined_points", 300, "Clear() left points");
+  map.Update(nullptr, &cloud);
+  Validate("refined_points", 301, &map);
+  if (map.size() == 0) Fail("refined_points", 301, "no points after Clear()");
+}
+
+// Every frame brings only new points, so once full the map replaces points
+// in round-robin order and must stay at its capacity.
+void CheckReplacement() {
+  hello_ar::PointCloudMap map(kVoxelSize, 1000);
+  ArPointCloud cloud;
+  int32_t next_id = 0;
+  for (size_t frame = 0; frame < 50; ++frame) {
+    cloud.data.clear();
+    cloud.ids.clear();
+    for (int i = 0; i < 100; ++i, ++next_id) {
+      // A distinct voxel for every id.
+      cloud.data.insert(cloud.data.end(),
+                        {(next_id % 100 + 0.5f) * kVoxelSize,
+                         (next_id / 100 + 0.5f) * kVoxelSize, 0.0f, 1.0f});
+      cloud.ids.push_back(next_id);
+    }
+    map.Update(nullptr, &cloud);
+    Validate("replacement", frame, &map);
+    if (map.size() != std::min<size_t>(100 * (frame + 1), 1000)) {
+      Fail("replacement", frame, "unexpected point count");
+    }
+  }
+}
+}  // namespace
+
+int main() {
+  CheckRefinedPoints();
+  CheckReplacement();
+  if (g_failures) return EXIT_FAILURE;
+  printf("point_cloud_map_check passed\n");
+  return EXIT_SUCCESS;
+}
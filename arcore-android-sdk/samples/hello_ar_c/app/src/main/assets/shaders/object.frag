@@ -17,14 +17,14 @@ precision mediump float;
 
 uniform sampler2D u_Texture;
 
-uniform vec4 u_LightingParameters;
 uniform vec4 u_MaterialParameters;
 uniform vec4 u_ColorCorrectionParameters;
 
 varying vec3 v_ViewPosition;
 varying vec3 v_ViewNormal;
 varying vec2 v_TexCoord;
-uniform vec4 u_ObjColor;
+varying vec3 v_ViewLightDirection;
+varying vec4 v_ObjColor;
 
 void main() {
     // We support approximate sRGB gamma.
@@ -33,7 +33,7 @@ void main() {
     const float kMiddleGrayGamma = 0.466;
 
     // Unpack lighting and material parameters for better naming.
-    vec3 viewLightDirection = u_LightingParameters.xyz;
+    vec3 viewLightDirection = normalize(v_ViewLightDirection);
     vec3 colorShift = u_ColorCorrectionParameters.rgb;
     float averagePixelIntensity = u_ColorCorrectionParameters.a;
 
@@ -49,11 +49,11 @@ void main() {
     // Flip the y-texture coordinate to address the texture from top-left.
     vec4 objectColor = texture2D(u_Texture, vec2(v_TexCoord.x, 1.0 - v_TexCoord.y));
 
-    // Apply color to grayscale image only if the alpha of u_ObjColor is
+    // Apply color to grayscale image only if the alpha of v_ObjColor is
     // greater and equal to 255.0.
-    if (u_ObjColor.a >= 255.0) {
+    if (v_ObjColor.a >= 255.0) {
       float intensity = objectColor.r;
-      objectColor.rgb = u_ObjColor.rgb * intensity / 255.0;
+      objectColor.rgb = v_ObjColor.rgb * intensity / 255.0;
     }
 
     // Apply inverse SRGB gamma to the texture before making lighting calculations.
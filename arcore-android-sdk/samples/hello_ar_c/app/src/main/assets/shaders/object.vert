@@ -13,20 +13,30 @@
  * limitations under the License.
  */
 
-uniform mat4 u_ModelView;
-uniform mat4 u_ModelViewProjection;
+uniform mat4 u_View;
+uniform mat4 u_Projection;
 
 attribute vec4 a_Position;
 attribute vec3 a_Normal;
 attribute vec2 a_TexCoord;
 
+// Per instance.
+attribute mat4 a_Model;
+attribute vec4 a_ObjColor;
+
 varying vec3 v_ViewPosition;
 varying vec3 v_ViewNormal;
 varying vec2 v_TexCoord;
+varying vec3 v_ViewLightDirection;
+varying vec4 v_ObjColor;
 
 void main() {
-    v_ViewPosition = (u_ModelView * a_Position).xyz;
-    v_ViewNormal = normalize((u_ModelView * vec4(a_Normal, 0.0)).xyz);
+    mat4 modelView = u_View * a_Model;
+    v_ViewPosition = (modelView * a_Position).xyz;
+    v_ViewNormal = normalize((modelView * vec4(a_Normal, 0.0)).xyz);
+    // The light shines along the model's up axis.
+    v_ViewLightDirection = normalize((modelView * vec4(0.0, 1.0, 0.0, 0.0)).xyz);
     v_TexCoord = a_TexCoord;
-    gl_Position = u_ModelViewProjection * a_Position;
+    v_ObjColor = a_ObjColor;
+    gl_Position = u_Projection * vec4(v_ViewPosition, 1.0);
 }
@@ -24,13 +24,21 @@
 
 namespace hello_ar {
 namespace {
-constexpr size_t kMaxNumberOfAndroidsToRender = 20;
+// All androids are drawn with one instanced draw call.
+constexpr size_t kMaxNumberOfAndroidsToRender = 2048;
+
+// Show a map of the feature points of all frames rather than only the current
+// frame's.  The map keeps one point per voxel and at most kMaxMapPoints.
+constexpr bool kAccumulatePointCloud = false;
+constexpr float kMapVoxelSize = 0.02f;
+constexpr size_t kMaxMapPoints = 65536;
 
 const glm::vec3 kWhite = {255, 255, 255};
 }  // namespace
 
 HelloArApplication::HelloArApplication(AAssetManager* asset_manager)
-    : asset_manager_(asset_manager) {
+    : asset_manager_(asset_manager),
+      point_cloud_map_(kMapVoxelSize, kMaxMapPoints) {
 }
 
 HelloArApplication::~HelloArApplication() {
@@ -45,6 +53,9 @@ void HelloArApplication::OnPause() {
   if (ar_session_ != nullptr) {
     ArSession_pause(ar_session_);
   }
+  // The GL thread is already paused by GLSurfaceView.onPause().  The session
+  // may lose tracking while paused, so start a new map on resume.
+  point_cloud_map_.Clear();
 }
 
 void HelloArApplication::OnResume(void* env, void* context, void* activity) {
@@ -82,6 +93,9 @@ void HelloArApplication::OnResume(void* env, void* context, void* activity) {
     ArFrame_create(ar_session_, &ar_frame_);
     CHECK(ar_frame_);
 
+    // Points of an earlier session are in a different world frame.
+    point_cloud_map_.Clear();
+
     ArSession_setDisplayGeometry(ar_session_, display_rotation_, width_,
                                  height_);
   }
@@ -95,7 +109,7 @@ void HelloArApplication::OnSurfaceCreated() {
 
   background_renderer_.InitializeGlContent(asset_manager_);
   point_cloud_renderer_.InitializeGlContent(asset_manager_);
-  andy_renderer_.InitializeGlContent(asset_manager_, "models/andy.obj",
+  andy_renderer_.InitializeGlContent(asset_manager_, "models/andy.mesh",
                                      "models/andy.png");
   plane_renderer_.InitializeGlContent(asset_manager_);
 }
@@ -175,19 +189,22 @@ void HelloArApplication::OnDrawFrame() {
   ar_light_estimate = nullptr;
 
   // Render Andy objects.
-  glm::mat4 model_mat(1.0f);
+  andy_instances_.clear();
   for (const auto& colored_anchor : anchors_) {
     ArTrackingState tracking_state = AR_TRACKING_STATE_STOPPED;
     ArAnchor_getTrackingState(ar_session_, colored_anchor.anchor,
                               &tracking_state);
     if (tracking_state == AR_TRACKING_STATE_TRACKING) {
       // Render object only if the tracking state is AR_TRACKING_STATE_TRACKING.
+      ObjRenderer::Instance instance;
       util::GetTransformMatrixFromAnchor(*colored_anchor.anchor, ar_session_,
-                                         &model_mat);
-      andy_renderer_.Draw(projection_mat, view_mat, model_mat, color_correction,
-                          colored_anchor.color);
+                                         &instance.model_mat);
+      instance.color = glm::make_vec4(colored_anchor.color);
+      andy_instances_.push_back(instance);
     }
   }
+  andy_renderer_.Draw(projection_mat, view_mat, andy_instances_.data(),
+                      andy_instances_.size(), color_correction);
 
   // Update and render planes.
   ArTrackableList* plane_list = nullptr;
@@ -238,10 +255,17 @@ void HelloArApplication::OnDrawFrame() {
   ArStatus point_cloud_status =
       ArFrame_acquirePointCloud(ar_session_, ar_frame_, &ar_point_cloud);
   if (point_cloud_status == AR_SUCCESS) {
-    point_cloud_renderer_.Draw(projection_mat * view_mat, ar_session_,
-                               ar_point_cloud);
+    if (kAccumulatePointCloud) {
+      point_cloud_map_.Update(ar_session_, ar_point_cloud);
+    } else {
+      point_cloud_renderer_.Draw(projection_mat * view_mat, ar_session_,
+                                 ar_point_cloud);
+    }
     ArPointCloud_release(ar_point_cloud);
   }
+  if (kAccumulatePointCloud) {
+    point_cloud_renderer_.Draw(projection_mat * view_mat, &point_cloud_map_);
+  }
 }
 
 void HelloArApplication::OnTouched(float x, float y) {
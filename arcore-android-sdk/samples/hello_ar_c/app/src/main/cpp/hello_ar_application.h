@@ -31,6 +31,7 @@
 #include "glm.h"
 #include "obj_renderer.h"
 #include "plane_renderer.h"
+#include "point_cloud_map.h"
 #include "point_cloud_renderer.h"
 #include "util.h"
 
@@ -91,6 +92,12 @@ class HelloArApplication {
   };
 
   std::vector<ColoredAnchor> anchors_;
+  // Instances of the anchored androids, refilled every frame.
+  std::vector<ObjRenderer::Instance> andy_instances_;
+
+  // Feature points of all frames so far, shown instead of only the current
+  // frame's when kAccumulatePointCloud is set.
+  PointCloudMap point_cloud_map_;
 
   PointCloudRenderer point_cloud_renderer_;
   BackgroundRenderer background_renderer_;
@@ -0,0 +1,310 @@
+/*
+ * Copyright 2017 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "obj_loader.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+#include "util.h"
+
+namespace hello_ar {
+namespace {
+
+// Powers of ten that are exact in a double.  Scaling a mantissa below 2^53 by
+// one of these rounds correctly, which covers every number a mesh exporter
+// writes.
+constexpr double kExactPowersOf10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+constexpr int kMaxExactPowerOf10 = 22;
+
+// Indices into the position, uv and normal lists of one face vertex.
+struct VertexKey {
+  GLuint position;
+  GLuint uv;
+  GLuint normal;
+
+  bool operator==(const VertexKey& other) const {
+    return position == other.position && uv == other.uv &&
+           normal == other.normal;
+  }
+};
+
+struct VertexKeyHash {
+  size_t operator()(const VertexKey& key) const {
+    uint64_t hash = key.position * 0x9e3779b97f4a7c15ull;
+    hash = (hash ^ key.uv) * 0xff51afd7ed558ccdull;
+    hash = (hash ^ key.normal) * 0xc4ceb9fe1a85ec53ull;
+    return static_cast<size_t>(hash ^ (hash >> 32));
+  }
+};
+
+constexpr GLuint kNoIndex = ~0u;
+
+inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+// '\r' counts as a blank so CRLF files parse like LF ones.
+inline bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+// Read position in the OBJ text.
+struct Cursor {
+  const char* p;
+  const char* end;
+  int line;
+
+  void SkipBlanks() {
+    while (p < end && IsBlank(*p)) ++p;
+  }
+  void SkipLine() {
+    const void* newline = memchr(p, '\n', end - p);
+    p = newline ? static_cast<const char*>(newline) + 1 : end;
+    ++line;
+  }
+  bool AtLineEnd() const { return p == end || *p == '\n' || *p == '#'; }
+  bool AtTokenEnd() const { return AtLineEnd() || IsBlank(*p); }
+};
+
+bool ParseFloat(Cursor* cursor, float* out_value) {
+  const char* p = cursor->p;
+  const char* const end = cursor->end;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+
+  // Digits past the 18th no longer fit the mantissa and only scale it.
+  constexpr uint64_t kMantissaLimit = 100000000000000000ull;
+  uint64_t mantissa = 0;
+  int exponent = 0;
+  const char* digits = p;
+  for (; p < end && IsDigit(*p); ++p) {
+    if (mantissa < kMantissaLimit) {
+      mantissa = mantissa * 10 + (*p - '0');
+    } else {
+      ++exponent;
+    }
+  }
+  bool has_digits = p != digits;
+  if (p < end && *p == '.') {
+    digits = ++p;
+    for (; p < end && IsDigit(*p); ++p) {
+      if (mantissa < kMantissaLimit) {
+        mantissa = mantissa * 10 + (*p - '0');
+        --exponent;
+      }
+    }
+    has_digits = has_digits || p != digits;
+  }
+  if (!has_digits) return false;
+
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool negative_exponent = false;
+    if (p < end && (*p == '-' || *p == '+')) negative_exponent = *p++ == '-';
+    if (p == end || !IsDigit(*p)) return false;
+    int value = 0;
+    for (; p < end && IsDigit(*p); ++p) {
+      if (value < 10000) value = value * 10 + (*p - '0');
+    }
+    exponent += negative_exponent ? -value : value;
+  }
+
+  double value = static_cast<double>(mantissa);
+  if (exponent >= 0) {
+    value *= exponent <= kMaxExactPowerOf10 ? kExactPowersOf10[exponent]
+                                            : std::pow(10.0, exponent);
+  } else {
+    value /= -exponent <= kMaxExactPowerOf10 ? kExactPowersOf10[-exponent]
+                                             : std::pow(10.0, -exponent);
+  }
+  *out_value = static_cast<float>(negative ? -value : value);
+  cursor->p = p;
+  return true;
+}
+
+bool ParseInt(Cursor* cursor, int64_t* out_value) {
+  const char* p = cursor->p;
+  const char* const end = cursor->end;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+  if (p == end || !IsDigit(*p)) return false;
+  int64_t value = 0;
+  for (; p < end && IsDigit(*p); ++p) {
+    // Anything this large is out of range anyway.
+    if (value < (1ll << 40)) value = value * 10 + (*p - '0');
+  }
+  *out_value = negative ? -value : value;
+  cursor->p = p;
+  return true;
+}
+
+// Reads |count| floats separated by blanks and appends them to |out|.
+bool ParseFloats(Cursor* cursor, int count, std::vector<GLfloat>* out) {
+  for (int i = 0; i < count; ++i) {
+    cursor->SkipBlanks();
+    float value;
+    if (!ParseFloat(cursor, &value) || !cursor->AtTokenEnd()) return false;
+    out->push_back(value);
+  }
+  return true;
+}
+
+// Converts a 1-based or negative (relative) OBJ index into a 0-based one.
+bool ResolveIndex(int64_t index, size_t count, GLuint* out_index) {
+  const int64_t resolved = index > 0 ? index - 1 : count + index;
+  if (index == 0 || resolved < 0 || resolved >= static_cast<int64_t>(count)) {
+    return false;
+  }
+  *out_index = static_cast<GLuint>(resolved);
+  return true;
+}
+
+}  // namespace
+
+bool ParseObj(const char* text, size_t size, ObjMesh* out_mesh) {
+  // Elements as declared in the file.
+  std::vector<GLfloat> positions;
+  std::vector<GLfloat> uvs;
+  std::vector<GLfloat> normals;
+
+  ObjMesh mesh;
+  std::vector<GLuint> indices;
+  std::unordered_map<VertexKey, GLuint, VertexKeyHash> vertex_indices;
+  // Typical exporters write around 40 bytes per distinct vertex.
+  vertex_indices.reserve(size / 40);
+  std::vector<GLuint> face;
+  bool has_uvs = false;
+  bool has_normals = false;
+
+  Cursor cursor = {text, text + size, 1};
+  while (cursor.p < cursor.end) {
+    cursor.SkipBlanks();
+    if (cursor.end - cursor.p < 2) break;
+    const char* statement = cursor.p;
+    bool ok = true;
+    if (statement[0] == 'v' && IsBlank(statement[1])) {
+      cursor.p += 1;
+      ok = ParseFloats(&cursor, 3, &positions);
+    } else if (statement[0] == 'v' && statement[1] == 't') {
+      cursor.p += 2;
+      ok = ParseFloats(&cursor, 2, &uvs);
+    } else if (statement[0] == 'v' && statement[1] == 'n') {
+      cursor.p += 2;
+      ok = ParseFloats(&cursor, 3, &normals);
+    } else if (statement[0] == 'f' && IsBlank(statement[1])) {
+      cursor.p += 1;
+      face.clear();
+      while (ok) {
+        cursor.SkipBlanks();
+        if (cursor.AtLineEnd()) break;
+
+        // v, v/vt, v//vn or v/vt/vn.
+        int64_t position = 0;
+        int64_t uv = 0;
+        int64_t normal = 0;
+        ok = ParseInt(&cursor, &position);
+        if (ok && cursor.p < cursor.end && *cursor.p == '/') {
+          ++cursor.p;
+          if (cursor.p < cursor.end && *cursor.p != '/') {
+            ok = ParseInt(&cursor, &uv);
+          }
+          if (ok && cursor.p < cursor.end && *cursor.p == '/') {
+            ++cursor.p;
+            ok = ParseInt(&cursor, &normal);
+          }
+        }
+        VertexKey key = {0, kNoIndex, kNoIndex};
+        ok = ok && cursor.AtTokenEnd() &&
+             ResolveIndex(position, positions.size() / 3, &key.position) &&
+             (uv == 0 || ResolveIndex(uv, uvs.size() / 2, &key.uv)) &&
+             (normal == 0 ||
+              ResolveIndex(normal, normals.size() / 3, &key.normal));
+        if (!ok) break;
+
+        const GLuint next_index = static_cast<GLuint>(mesh.vertex_count());
+        const auto inserted = vertex_indices.emplace(key, next_index);
+        if (inserted.second) {
+          const GLfloat* p = &positions[key.position * 3];
+          mesh.positions.insert(mesh.positions.end(), p, p + 3);
+          if (key.uv != kNoIndex) {
+            const GLfloat* t = &uvs[key.uv * 2];
+            mesh.uvs.insert(mesh.uvs.end(), t, t + 2);
+            has_uvs = true;
+          } else {
+            mesh.uvs.insert(mesh.uvs.end(), 2, 0.f);
+          }
+          if (key.normal != kNoIndex) {
+            const GLfloat* n = &normals[key.normal * 3];
+            mesh.normals.insert(mesh.normals.end(), n, n + 3);
+            has_normals = true;
+          } else {
+            mesh.normals.insert(mesh.normals.end(), 3, 0.f);
+          }
+        }
+        face.push_back(inserted.first->second);
+      }
+      ok = ok && face.size() >= 3;
+      for (size_t i = 2; ok && i < face.size(); ++i) {
+        indices.push_back(face[0]);
+        indices.push_back(face[i - 1]);
+        indices.push_back(face[i]);
+      }
+    }
+    if (!ok) {
+      LOGE("OBJ line %d: malformed '%c' statement", cursor.line,
+           statement[0]);
+      return false;
+    }
+    // Ignores the rest of the line: comments, optional w components and
+    // statements this loader does not use.
+    cursor.SkipLine();
+  }
+
+  if (!has_uvs) mesh.uvs.clear();
+  if (!has_normals) mesh.normals.clear();
+  if (mesh.vertex_count() <= 0x10000) {
+    mesh.index_type = GL_UNSIGNED_SHORT;
+    mesh.indices16.assign(indices.begin(), indices.end());
+  } else {
+    mesh.index_type = GL_UNSIGNED_INT;
+    mesh.indices32.swap(indices);
+  }
+  *out_mesh = std::move(mesh);
+  return true;
+}
+
+bool LoadObjMesh(AAssetManager* asset_manager, const char* file_name,
+                 ObjMesh* out_mesh) {
+  // AASSET_MODE_BUFFER maps uncompressed assets instead of copying them.
+  AAsset* asset =
+      AAssetManager_open(asset_manager, file_name, AASSET_MODE_BUFFER);
+  if (asset == nullptr) {
+    LOGE("Error opening asset %s", file_name);
+    return false;
+  }
+  const char* text = static_cast<const char*>(AAsset_getBuffer(asset));
+  const bool ok =
+      text != nullptr && ParseObj(text, AAsset_getLength(asset), out_mesh);
+  AAsset_close(asset);
+  if (!ok) {
+    LOGE("Could not parse %s", file_name);
+  }
+  return ok;
+}
+
+}  // namespace hello_ar
@@ -15,17 +15,21 @@
  */
 
 #include "obj_renderer.h"
+
+#include <cstddef>
+#include <cstring>
+
+#include "obj_loader.h"
 #include "util.h"
 
 namespace hello_ar {
 namespace {
-const glm::vec4 kLightDirection(0.0f, 1.0f, 0.0f, 0.0f);
 constexpr char kVertexShaderFilename[] = "shaders/object.vert";
 constexpr char kFragmentShaderFilename[] = "shaders/object.frag";
 }  // namespace
 
 void ObjRenderer::InitializeGlContent(AAssetManager* asset_manager,
-                                      const std::string& obj_file_name,
+                                      const std::string& model_file_name,
                                       const std::string& png_file_name) {
   shader_program_ = util::CreateProgram(kVertexShaderFilename,
                                         kFragmentShaderFilename, asset_manager);
@@ -33,22 +37,27 @@ void ObjRenderer::InitializeGlContent(AAssetManager* asset_manager,
     LOGE("Could not create program.");
   }
 
-  uniform_mvp_mat_ =
-      glGetUniformLocation(shader_program_, "u_ModelViewProjection");
-  uniform_mv_mat_ = glGetUniformLocation(shader_program_, "u_ModelView");
+  uniform_projection_mat_ =
+      glGetUniformLocation(shader_program_, "u_Projection");
+  uniform_view_mat_ = glGetUniformLocation(shader_program_, "u_View");
   uniform_texture_ = glGetUniformLocation(shader_program_, "u_Texture");
 
-  uniform_lighting_param_ =
-      glGetUniformLocation(shader_program_, "u_LightingParameters");
   uniform_material_param_ =
       glGetUniformLocation(shader_program_, "u_MaterialParameters");
   uniform_color_correction_param_ =
       glGetUniformLocation(shader_program_, "u_ColorCorrectionParameters");
-  uniform_color_ = glGetUniformLocation(shader_program_, "u_ObjColor");
 
   attri_vertices_ = glGetAttribLocation(shader_program_, "a_Position");
   attri_uvs_ = glGetAttribLocation(shader_program_, "a_TexCoord");
   attri_normals_ = glGetAttribLocation(shader_program_, "a_Normal");
+  attri_model_mat_ = glGetAttribLocation(shader_program_, "a_Model");
+  attri_color_ = glGetAttribLocation(shader_program_, "a_ObjColor");
+
+  // The texture unit never changes.
+  glUseProgram(shader_program_);
+  glUniform1i(uniform_texture_, 0);
+  glUseProgram(0);
+  uniforms_set_ = false;
 
   glGenTextures(1, &texture_id_);
   glBindTexture(GL_TEXTURE_2D, texture_id_);
@@ -65,12 +74,152 @@ void ObjRenderer::InitializeGlContent(AAssetManager* asset_manager,
 
   glBindTexture(GL_TEXTURE_2D, 0);
 
-  util::LoadObjFile(obj_file_name, asset_manager, &vertices_, &normals_, &uvs_,
-                    &indices_);
+  constexpr char kMeshExtension[] = ".mesh";
+  const size_t extension_length = sizeof(kMeshExtension) - 1;
+  const bool is_binary_mesh =
+      model_file_name.size() > extension_length &&
+      model_file_name.compare(model_file_name.size() - extension_length,
+                              extension_length, kMeshExtension) == 0;
+  const bool loaded = is_binary_mesh
+                          ? LoadBinaryMesh(asset_manager, model_file_name)
+                          : LoadObj(asset_manager, model_file_name);
+  if (!loaded) {
+    LOGE("Could not load model %s.", model_file_name.c_str());
+  }
 
   util::CheckGlError("obj_renderer::InitializeGlContent()");
 }
 
+bool ObjRenderer::LoadBinaryMesh(AAssetManager* asset_manager,
+                                 const std::string& file_name) {
+  // AASSET_MODE_BUFFER maps the asset if it is stored uncompressed, see
+  // noCompress in build.gradle.
+  AAsset* asset = AAssetManager_open(asset_manager, file_name.c_str(),
+                                     AASSET_MODE_BUFFER);
+  if (asset == nullptr) {
+    return false;
+  }
+  const uint8_t* data = static_cast<const uint8_t*>(AAsset_getBuffer(asset));
+  const size_t size = AAsset_getLength(asset);
+  bool ok = data != nullptr && mesh::IsValidMeshFile(data, size);
+  if (ok) {
+    mesh::MeshFileHeader header;
+    memcpy(&header, data, sizeof(header));
+    UploadMesh(header.flags, data + header.vertex_offset, header.vertex_size,
+               data + header.index_offset, header.index_count);
+  }
+  AAsset_close(asset);
+  return ok;
+}
+
+bool ObjRenderer::LoadObj(AAssetManager* asset_manager,
+                          const std::string& file_name) {
+  ObjMesh obj;
+  if (!LoadObjMesh(asset_manager, file_name.c_str(), &obj)) {
+    return false;
+  }
+
+  // Interleaves the streams like an unquantized binary mesh.
+  uint32_t flags = obj.index_type == GL_UNSIGNED_INT ? mesh::kMeshIndex32 : 0;
+  if (!obj.normals.empty()) flags |= mesh::kMeshNormals;
+  if (!obj.uvs.empty()) flags |= mesh::kMeshUvs;
+  const mesh::MeshVertexLayout layout = mesh::GetVertexLayout(flags);
+  std::vector<uint8_t> vertices(obj.vertex_count() * layout.stride);
+  for (size_t i = 0; i < obj.vertex_count(); ++i) {
+    uint8_t* vertex = &vertices[i * layout.stride];
+    memcpy(vertex, &obj.positions[i * 3], 3 * sizeof(float));
+    if (flags & mesh::kMeshNormals) {
+      memcpy(vertex + layout.normal_offset, &obj.normals[i * 3],
+             3 * sizeof(float));
+    }
+    if (flags & mesh::kMeshUvs) {
+      memcpy(vertex + layout.uv_offset, &obj.uvs[i * 2], 2 * sizeof(float));
+    }
+  }
+  UploadMesh(flags, vertices.data(), vertices.size(), obj.index_data(),
+             obj.index_count());
+  return true;
+}
+
+void ObjRenderer::UploadMesh(uint32_t flags, const void* vertices,
+                             size_t vertices_size, const void* indices,
+                             uint32_t index_count) {
+  glGenBuffers(1, &vertex_buffer_);
+  glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+  glBufferData(GL_ARRAY_BUFFER, vertices_size, vertices, GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  const size_t index_size = (flags & mesh::kMeshIndex32) ? 4 : 2;
+  glGenBuffers(1, &index_buffer_);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_count * index_size, indices,
+               GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  mesh_flags_ = flags;
+  index_count_ = index_count;
+
+  glGenBuffers(1, &instance_buffer_);
+  instance_capacity_ = 0;
+
+  glGenVertexArrays(1, &vertex_array_);
+  glBindVertexArray(vertex_array_);
+  SetVertexAttributes();
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ObjRenderer::SetVertexAttributes() const {
+  const mesh::MeshVertexLayout layout = mesh::GetVertexLayout(mesh_flags_);
+  auto offset = [](size_t bytes) {
+    return reinterpret_cast<const void*>(static_cast<uintptr_t>(bytes));
+  };
+
+  glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+  glEnableVertexAttribArray(attri_vertices_);
+  glVertexAttribPointer(attri_vertices_, 3, GL_FLOAT, GL_FALSE, layout.stride,
+                        offset(0));
+
+  // Models without normals or uvs read the attributes' current values.
+  if (mesh_flags_ & mesh::kMeshNormals) {
+    glEnableVertexAttribArray(attri_normals_);
+    if (mesh_flags_ & mesh::kMeshQuantizedNormals) {
+      glVertexAttribPointer(attri_normals_, 3, GL_SHORT, GL_TRUE,
+                            layout.stride, offset(layout.normal_offset));
+    } else {
+      glVertexAttribPointer(attri_normals_, 3, GL_FLOAT, GL_FALSE,
+                            layout.stride, offset(layout.normal_offset));
+    }
+  }
+
+  if (mesh_flags_ & mesh::kMeshUvs) {
+    glEnableVertexAttribArray(attri_uvs_);
+    if (mesh_flags_ & mesh::kMeshQuantizedUvs) {
+      glVertexAttribPointer(attri_uvs_, 2, GL_UNSIGNED_SHORT, GL_TRUE,
+                            layout.stride, offset(layout.uv_offset));
+    } else {
+      glVertexAttribPointer(attri_uvs_, 2, GL_FLOAT, GL_FALSE, layout.stride,
+                            offset(layout.uv_offset));
+    }
+  }
+
+  // The model matrix takes four consecutive attribute locations, one per
+  // column.
+  glBindBuffer(GL_ARRAY_BUFFER, instance_buffer_);
+  for (GLint column = 0; column < 4; ++column) {
+    glEnableVertexAttribArray(attri_model_mat_ + column);
+    glVertexAttribPointer(
+        attri_model_mat_ + column, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+        offset(offsetof(Instance, model_mat) + column * sizeof(glm::vec4)));
+    glVertexAttribDivisor(attri_model_mat_ + column, 1);
+  }
+  glEnableVertexAttribArray(attri_color_);
+  glVertexAttribPointer(attri_color_, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                        offset(offsetof(Instance, color)));
+  glVertexAttribDivisor(attri_color_, 1);
+}
+
 void ObjRenderer::SetMaterialProperty(float ambient, float diffuse,
                                       float specular, float specular_power) {
   ambient_ = ambient;
@@ -83,51 +232,59 @@ void ObjRenderer::Draw(const glm::mat4& projection_mat,
                        const glm::mat4& view_mat, const glm::mat4& model_mat,
                        const float* color_correction4,
                        const float* object_color4) const {
+  const Instance instance = {model_mat, glm::make_vec4(object_color4)};
+  Draw(projection_mat, view_mat, &instance, 1, color_correction4);
+}
+
+void ObjRenderer::Draw(const glm::mat4& projection_mat,
+                       const glm::mat4& view_mat, const Instance* instances,
+                       size_t count, const float* color_correction4) const {
   if (!shader_program_) {
     LOGE("shader_program is null.");
     return;
   }
+  if (count == 0) {
+    return;
+  }
+
+  // Orphan the previous frame's instances rather than wait for them.
+  glBindBuffer(GL_ARRAY_BUFFER, instance_buffer_);
+  if (count > instance_capacity_) {
+    instance_capacity_ = count;
+  }
+  glBufferData(GL_ARRAY_BUFFER, instance_capacity_ * sizeof(Instance), nullptr,
+               GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(Instance), instances);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   glUseProgram(shader_program_);
 
   glActiveTexture(GL_TEXTURE0);
-  glUniform1i(uniform_texture_, 0);
   glBindTexture(GL_TEXTURE_2D, texture_id_);
 
-  glm::mat4 mvp_mat = projection_mat * view_mat * model_mat;
-  glm::mat4 mv_mat = view_mat * model_mat;
-  glm::vec4 view_light_direction = glm::normalize(mv_mat * kLightDirection);
-
-  glUniform4f(uniform_lighting_param_, view_light_direction[0],
-              view_light_direction[1], view_light_direction[2], 1.f);
-  glUniform4f(uniform_material_param_, ambient_, diffuse_, specular_,
-              specular_power_);
-  glUniform4fv(uniform_color_correction_param_, 1, color_correction4);
-  glUniform4fv(uniform_color_, 1, object_color4);
-
-  glUniformMatrix4fv(uniform_mvp_mat_, 1, GL_FALSE, glm::value_ptr(mvp_mat));
-  glUniformMatrix4fv(uniform_mv_mat_, 1, GL_FALSE, glm::value_ptr(mv_mat));
-
-  // Note: for simplicity, we are uploading the model each time we draw it.  A
-  // real application should use vertex buffers to upload the geometry once.
-
-  glEnableVertexAttribArray(attri_vertices_);
-  glVertexAttribPointer(attri_vertices_, 3, GL_FLOAT, GL_FALSE, 0,
-                        vertices_.data());
-
-  glEnableVertexAttribArray(attri_normals_);
-  glVertexAttribPointer(attri_normals_, 3, GL_FLOAT, GL_FALSE, 0,
-                        normals_.data());
-
-  glEnableVertexAttribArray(attri_uvs_);
-  glVertexAttribPointer(attri_uvs_, 2, GL_FLOAT, GL_FALSE, 0, uvs_.data());
+  const glm::vec4 material(ambient_, diffuse_, specular_, specular_power_);
+  const glm::vec4 color_correction = glm::make_vec4(color_correction4);
+  if (!uniforms_set_ || material != material_uniform_) {
+    glUniform4fv(uniform_material_param_, 1, glm::value_ptr(material));
+    material_uniform_ = material;
+  }
+  if (!uniforms_set_ || color_correction != color_correction_uniform_) {
+    glUniform4fv(uniform_color_correction_param_, 1, color_correction4);
+    color_correction_uniform_ = color_correction;
+  }
+  uniforms_set_ = true;
 
-  glDrawElements(GL_TRIANGLES, indices_.size(), GL_UNSIGNED_SHORT,
-                 indices_.data());
+  glUniformMatrix4fv(uniform_projection_mat_, 1, GL_FALSE,
+                     glm::value_ptr(projection_mat));
+  glUniformMatrix4fv(uniform_view_mat_, 1, GL_FALSE, glm::value_ptr(view_mat));
 
-  glDisableVertexAttribArray(attri_vertices_);
-  glDisableVertexAttribArray(attri_uvs_);
-  glDisableVertexAttribArray(attri_normals_);
+  const GLenum index_type = (mesh_flags_ & mesh::kMeshIndex32)
+                                ? GL_UNSIGNED_INT
+                                : GL_UNSIGNED_SHORT;
+  glBindVertexArray(vertex_array_);
+  glDrawElementsInstanced(GL_TRIANGLES, index_count_, index_type, nullptr,
+                          count);
+  glBindVertexArray(0);
 
   glUseProgram(0);
   util::CheckGlError("obj_renderer::Draw()");
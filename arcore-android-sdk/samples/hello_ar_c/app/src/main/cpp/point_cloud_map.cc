@@ -0,0 +1,217 @@
+/*
+ * Copyright 2017 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "point_cloud_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace hello_ar {
+namespace {
+constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+// Voxel coordinates are packed into 21 bits per axis.
+constexpr int kVoxelBits = 21;
+constexpr int64_t kVoxelOffset = int64_t{1} << (kVoxelBits - 1);
+constexpr uint64_t kVoxelMask = (uint64_t{1} << kVoxelBits) - 1;
+
+uint64_t PackVoxelCoordinate(float value) {
+  int64_t coordinate = static_cast<int64_t>(std::floor(value)) + kVoxelOffset;
+  return static_cast<uint64_t>(coordinate) & kVoxelMask;
+}
+}  // namespace
+
+PointCloudMap::IndexTable::IndexTable(size_t max_entries) {
+  // At most half full, so probe sequences stay short.
+  size_t capacity = 16;
+  while (capacity < max_entries * 2) capacity *= 2;
+  keys_.resize(capacity);
+  indices_.assign(capacity, kEmpty);
+  mask_ = capacity - 1;
+}
+
+size_t PointCloudMap::IndexTable::Home(uint64_t key) const {
+  uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+  return static_cast<size_t>(hash ^ (hash >> 32)) & mask_;
+}
+
+uint32_t* PointCloudMap::IndexTable::Find(uint64_t key) {
+  for (size_t i = Home(key); indices_[i] != kEmpty; i = (i + 1) & mask_) {
+    if (keys_[i] == key) return &indices_[i];
+  }
+  return nullptr;
+}
+
+void PointCloudMap::IndexTable::Insert(uint64_t key, uint32_t index) {
+  size_t i = Home(key);
+  while (indices_[i] != kEmpty) i = (i + 1) & mask_;
+  keys_[i] = key;
+  indices_[i] = index;
+}
+
+void PointCloudMap::IndexTable::Erase(uint64_t key) {
+  size_t hole = Home(key);
+  while (indices_[hole] != kEmpty && keys_[hole] != key) {
+    hole = (hole + 1) & mask_;
+  }
+  if (indices_[hole] == kEmpty) return;
+
+  // Shift later entries of the probe sequence back into the hole, so lookups
+  // never stop early at it.
+  for (size_t i = (hole + 1) & mask_; indices_[i] != kEmpty;
+       i = (i + 1) & mask_) {
+    const size_t home = Home(keys_[i]);
+    const bool movable = hole <= i ? (home <= hole || home > i)
+                                   : (home <= hole && home > i);
+    if (movable) {
+      keys_[hole] = keys_[i];
+      indices_[hole] = indices_[i];
+      hole = i;
+    }
+  }
+  indices_[hole] = kEmpty;
+}
+
+void PointCloudMap::IndexTable::Clear() {
+  std::fill(indices_.begin(), indices_.end(), kEmpty);
+}
+
+PointCloudMap::PointCloudMap(float voxel_size, size_t max_points)
+    : inverse_voxel_size_(1.0f / voxel_size),
+      max_points_(max_points),
+      id_index_(max_points),
+      voxel_index_(max_points) {
+  points_.reserve(max_points);
+  ids_.reserve(max_points);
+  voxels_.reserve(max_points);
+}
+
+void PointCloudMap::Update(const ArSession* session,
+                           const ArPointCloud* point_cloud) {
+  int32_t number_of_points = 0;
+  ArPointCloud_getNumberOfPoints(session, point_cloud, &number_of_points);
+  if (number_of_points <= 0 || max_points_ == 0) return;
+
+  const float* point_cloud_data = nullptr;
+  const int32_t* point_ids = nullptr;
+  ArPointCloud_getData(session, point_cloud, &point_cloud_data);
+  ArPointCloud_getPointIds(session, point_cloud, &point_ids);
+
+  for (int32_t i = 0; i < number_of_points; ++i) {
+    const glm::vec4 point = glm::make_vec4(point_cloud_data + 4 * i);
+    const uint64_t voxel = VoxelKey(glm::vec3(point));
+
+    const uint32_t* known = id_index_.Find(static_cast<uint32_t>(point_ids[i]));
+    if (known == nullptr) {
+      // One point per voxel: a new point in an occupied voxel is a duplicate.
+      if (voxel_index_.Find(voxel) == nullptr) {
+        AddPoint(point_ids[i], voxel, point);
+      }
+      continue;
+    }
+
+    const uint32_t index = *known;
+    if (voxels_[index] != voxel) {
+      if (voxel_index_.Find(voxel) != nullptr) {
+        // The point moved into a voxel another point already covers.
+        RemovePoint(index);
+        continue;
+      }
+      voxel_index_.Erase(voxels_[index]);
+      voxel_index_.Insert(voxel, index);
+      voxels_[index] = voxel;
+    }
+    points_[index] = point;
+    MarkDirty(index);
+  }
+}
+
+void PointCloudMap::Clear() {
+  points_.clear();
+  ids_.clear();
+  voxels_.clear();
+  id_index_.Clear();
+  voxel_index_.Clear();
+  replace_cursor_ = 0;
+  dirty_begin_ = dirty_end_ = 0;
+}
+
+void PointCloudMap::TakeDirtyRange(size_t* begin, size_t* end) {
+  *begin = std::min(dirty_begin_, points_.size());
+  *end = std::min(dirty_end_, points_.size());
+  dirty_begin_ = dirty_end_ = 0;
+}
+
+uint64_t PointCloudMap::VoxelKey(const glm::vec3& position) const {
+  const glm::vec3 voxel = position * inverse_voxel_size_;
+  return PackVoxelCoordinate(voxel.x) |
+         PackVoxelCoordinate(voxel.y) << kVoxelBits |
+         PackVoxelCoordinate(voxel.z) << (2 * kVoxelBits);
+}
+
+void PointCloudMap::AddPoint(int32_t id, uint64_t voxel,
+                             const glm::vec4& point) {
+  uint32_t index;
+  if (points_.size() < max_points_) {
+    index = static_cast<uint32_t>(points_.size());
+    points_.push_back(point);
+    ids_.push_back(id);
+    voxels_.push_back(voxel);
+  } else {
+    index = static_cast<uint32_t>(replace_cursor_);
+    replace_cursor_ = (replace_cursor_ + 1) % max_points_;
+    id_index_.Erase(static_cast<uint32_t>(ids_[index]));
+    voxel_index_.Erase(voxels_[index]);
+    points_[index] = point;
+    ids_[index] = id;
+    voxels_[index] = voxel;
+  }
+  id_index_.Insert(static_cast<uint32_t>(id), index);
+  voxel_index_.Insert(voxel, index);
+  MarkDirty(index);
+}
+
+void PointCloudMap::RemovePoint(uint32_t index) {
+  id_index_.Erase(static_cast<uint32_t>(ids_[index]));
+  voxel_index_.Erase(voxels_[index]);
+
+  // Keep the points contiguous by moving the last one into the gap.
+  const uint32_t last = static_cast<uint32_t>(points_.size() - 1);
+  if (index != last) {
+    points_[index] = points_[last];
+    ids_[index] = ids_[last];
+    voxels_[index] = voxels_[last];
+    *id_index_.Find(static_cast<uint32_t>(ids_[index])) = index;
+    *voxel_index_.Find(voxels_[index]) = index;
+    MarkDirty(index);
+  }
+  points_.pop_back();
+  ids_.pop_back();
+  voxels_.pop_back();
+}
+
+void PointCloudMap::MarkDirty(size_t index) {
+  if (dirty_begin_ == dirty_end_) {
+    dirty_begin_ = index;
+    dirty_end_ = index + 1;
+  } else {
+    dirty_begin_ = std::min(dirty_begin_, index);
+    dirty_end_ = std::max(dirty_end_, index + 1);
+  }
+}
+
+}  // namespace hello_ar
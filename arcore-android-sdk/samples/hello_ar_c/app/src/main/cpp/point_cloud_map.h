@@ -0,0 +1,92 @@
+/*
+ * Copyright 2017 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef C_ARCORE_HELLOE_AR_POINT_CLOUD_MAP_H_
+#define C_ARCORE_HELLOE_AR_POINT_CLOUD_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "arcore_c_api.h"
+#include "glm.h"
+
+namespace hello_ar {
+
+// PointCloudMap accumulates the feature points of successive frames into a
+// map with at most one point per voxel.  A point ARCore keeps reporting under
+// the same id moves with its refined position instead of leaving a trail.
+// All storage is allocated up front for |max_points|; once the map is full,
+// new points replace old ones in round-robin order.
+class PointCloudMap {
+ public:
+  PointCloudMap(float voxel_size, size_t max_points);
+
+  // Merges the points of |point_cloud| into the map.
+  void Update(const ArSession* session, const ArPointCloud* point_cloud);
+
+  void Clear();
+
+  // Points as x, y, z, confidence, the layout of ArPointCloud_getData().
+  const glm::vec4* points() const { return points_.data(); }
+  size_t size() const { return points_.size(); }
+  size_t capacity() const { return max_points_; }
+
+  // Returns the range of points changed since the last call, empty if none.
+  void TakeDirtyRange(size_t* begin, size_t* end);
+
+ private:
+  // Open addressing hash table from 64-bit keys to point indices.
+  class IndexTable {
+   public:
+    explicit IndexTable(size_t max_entries);
+    // Returns the index stored for |key|, or nullptr.
+    uint32_t* Find(uint64_t key);
+    void Insert(uint64_t key, uint32_t index);
+    void Erase(uint64_t key);
+    void Clear();
+
+   private:
+    size_t Home(uint64_t key) const;
+
+    std::vector<uint64_t> keys_;
+    std::vector<uint32_t> indices_;
+    size_t mask_;
+  };
+
+  uint64_t VoxelKey(const glm::vec3& position) const;
+  void AddPoint(int32_t id, uint64_t voxel, const glm::vec4& point);
+  void RemovePoint(uint32_t index);
+  void MarkDirty(size_t index);
+
+  const float inverse_voxel_size_;
+  const size_t max_points_;
+
+  std::vector<glm::vec4> points_;
+  // Id and voxel of each point, to unlink it on removal.
+  std::vector<int32_t> ids_;
+  std::vector<uint64_t> voxels_;
+  IndexTable id_index_;
+  IndexTable voxel_index_;
+  // Next point to replace once the map is full.
+  size_t replace_cursor_ = 0;
+
+  size_t dirty_begin_ = 0;
+  size_t dirty_end_ = 0;
+};
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLOE_AR_POINT_CLOUD_MAP_H_
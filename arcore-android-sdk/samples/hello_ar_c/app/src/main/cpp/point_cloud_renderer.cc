@@ -15,6 +15,9 @@
  */
 
 #include "point_cloud_renderer.h"
+
+#include <algorithm>
+
 #include "util.h"
 
 namespace hello_ar {
@@ -36,6 +39,9 @@ void PointCloudRenderer::InitializeGlContent(AAssetManager* asset_manager) {
   uniform_color_ = glGetUniformLocation(shader_program_, "u_Color");
   uniform_point_size_ = glGetUniformLocation(shader_program_, "u_PointSize");
 
+  glGenBuffers(1, &stream_buffer_);
+  glGenBuffers(1, &map_buffer_);
+
   util::CheckGlError("point_cloud_renderer::InitializeGlContent()");
 }
 
@@ -44,8 +50,6 @@ void PointCloudRenderer::Draw(const glm::mat4& mvp_matrix,
                               ArPointCloud* ar_point_cloud) const {
   CHECK(shader_program_);
 
-  glUseProgram(shader_program_);
-
   int32_t number_of_points = 0;
   ArPointCloud_getNumberOfPoints(ar_session, ar_point_cloud, &number_of_points);
   if (number_of_points <= 0) {
@@ -55,21 +59,65 @@ void PointCloudRenderer::Draw(const glm::mat4& mvp_matrix,
   const float* point_cloud_data;
   ArPointCloud_getData(ar_session, ar_point_cloud, &point_cloud_data);
 
+  // Orphan the buffer so the driver hands out fresh storage instead of
+  // waiting for the previous frame's draw; it only grows when the point count
+  // exceeds every earlier frame's.
+  const size_t size = number_of_points * 4 * sizeof(float);
+  stream_capacity_ = std::max(stream_capacity_, size);
+  glBindBuffer(GL_ARRAY_BUFFER, stream_buffer_);
+  glBufferData(GL_ARRAY_BUFFER, stream_capacity_, nullptr, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, size, point_cloud_data);
+
+  DrawPoints(mvp_matrix, stream_buffer_, number_of_points);
+  util::CheckGlError("PointCloudRenderer::Draw");
+}
+
+void PointCloudRenderer::Draw(const glm::mat4& mvp_matrix,
+                              PointCloudMap* map) {
+  CHECK(shader_program_);
+
+  size_t begin, end;
+  map->TakeDirtyRange(&begin, &end);
+  glBindBuffer(GL_ARRAY_BUFFER, map_buffer_);
+  if (map_capacity_ != map->capacity()) {
+    // Fresh storage holds none of the points yet.
+    map_capacity_ = map->capacity();
+    glBufferData(GL_ARRAY_BUFFER, map_capacity_ * sizeof(glm::vec4), nullptr,
+                 GL_DYNAMIC_DRAW);
+    begin = 0;
+    end = map->size();
+  }
+  if (begin < end) {
+    glBufferSubData(GL_ARRAY_BUFFER, begin * sizeof(glm::vec4),
+                    (end - begin) * sizeof(glm::vec4), map->points() + begin);
+  }
+
+  if (map->size() > 0) {
+    DrawPoints(mvp_matrix, map_buffer_, static_cast<GLsizei>(map->size()));
+  }
+  util::CheckGlError("PointCloudRenderer::Draw map");
+}
+
+void PointCloudRenderer::DrawPoints(const glm::mat4& mvp_matrix, GLuint buffer,
+                                    GLsizei count) const {
+  glUseProgram(shader_program_);
+
   glUniformMatrix4fv(uniform_mvp_mat_, 1, GL_FALSE, glm::value_ptr(mvp_matrix));
 
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
   glEnableVertexAttribArray(attribute_vertices_);
-  glVertexAttribPointer(attribute_vertices_, 4, GL_FLOAT, GL_FALSE, 0,
-                        point_cloud_data);
+  glVertexAttribPointer(attribute_vertices_, 4, GL_FLOAT, GL_FALSE, 0, 0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   // Set cyan color to the point cloud.
   glUniform4f(uniform_color_, 31.0f / 255.0f, 188.0f / 255.0f, 210.0f / 255.0f,
               1.0f);
   glUniform1f(uniform_point_size_, 5.0f);
 
-  glDrawArrays(GL_POINTS, 0, number_of_points);
+  glDrawArrays(GL_POINTS, 0, count);
 
+  glDisableVertexAttribArray(attribute_vertices_);
   glUseProgram(0);
-  util::CheckGlError("PointCloudRenderer::Draw");
 }
 
 }  // namespace hello_ar
@@ -17,13 +17,13 @@
 #ifndef C_ARCORE_HELLOE_AR_POINT_CLOUD_RENDERER_H_
 #define C_ARCORE_HELLOE_AR_POINT_CLOUD_RENDERER_H_
 
-#include <GLES2/gl2.h>
-#include <GLES2/gl2ext.h>
+#include <GLES3/gl3.h>
 #include <android/asset_manager.h>
 #include <cstdlib>
 #include <vector>
 #include "arcore_c_api.h"
 #include "glm.h"
+#include "point_cloud_map.h"
 
 namespace hello_ar {
 
@@ -47,7 +47,22 @@ class PointCloudRenderer {
   void Draw(const glm::mat4& mvp_matrix, ArSession* ar_session,
             ArPointCloud* ar_point_cloud) const;
 
+  // Render the accumulated point cloud |map|, uploading only the points
+  // changed since the last call.
+  void Draw(const glm::mat4& mvp_matrix, PointCloudMap* map);
+
  private:
+  void DrawPoints(const glm::mat4& mvp_matrix, GLuint buffer,
+                  GLsizei count) const;
+
+  // Current frame's points, orphaned and refilled by every draw.
+  GLuint stream_buffer_ = 0;
+  mutable size_t stream_capacity_ = 0;
+
+  // Points of the accumulated map, allocated once for its capacity.
+  GLuint map_buffer_ = 0;
+  size_t map_capacity_ = 0;
+
   GLuint shader_program_;
   GLint attribute_vertices_;
   GLint uniform_mvp_mat_;
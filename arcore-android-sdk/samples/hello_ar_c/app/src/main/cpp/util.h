@@ -104,21 +104,6 @@ bool LoadTextFileFromAssetManager(const char* file_name,
 // @return true if png is loaded correctly, otherwise false.
 bool LoadPngFromAssetManager(int target, const std::string& path);
 
-// Load obj file from assets folder from the app.
-//
-// @param asset_manager, AAssetManager pointer.
-// @param file_name, name of the obj file.
-// @param out_vertices, output vertices.
-// @param out_normals, output normals.
-// @param out_uv, output texture UV coordinates.
-// @param out_indices, output triangle indices.
-// @return true if obj is loaded correctly, otherwise false.
-bool LoadObjFile(const std::string& file_name, AAssetManager* asset_manager,
-                 std::vector<GLfloat>* out_vertices,
-                 std::vector<GLfloat>* out_normals,
-                 std::vector<GLfloat>* out_uv,
-                 std::vector<GLushort>* out_indices);
-
 // Format and output the matrix to logcat file.
 // Note that this function output matrix in row major.
 void Log4x4Matrix(const float raw_matrix[16]);
@@ -0,0 +1,1209 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+// Replays recordings made by ArSessionRecorder through the ARCore C API, see
+// arcore_replay.h.  Object handles are plain structs owned by the session, so
+// acquire/release pairs are cheap and releasing is mostly a no-op.
+
+#include "arcore_replay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ar_record_format.h"
+#include "glm.h"
+
+using hello_ar::arrec::ArRecordAnchor;
+using hello_ar::arrec::ArRecordFileHeader;
+using hello_ar::arrec::ArRecordFrame;
+using hello_ar::arrec::ArRecordPlane;
+
+namespace {
+
+std::string g_recording_path;
+bool g_loop = true;
+uint64_t g_api_calls = 0;
+// Session of the last ArSession_update().
+const ArSession* g_updated_session = nullptr;
+
+// Counts a call into the ARCore C API.
+inline void Count() { g_api_calls++; }
+
+glm::mat4 PoseToMatrix(const float* raw) {
+  const glm::quat rotation(raw[3], raw[0], raw[1], raw[2]);
+  return glm::translate(glm::mat4(1.f), glm::vec3(raw[4], raw[5], raw[6])) *
+         glm::mat4_cast(rotation);
+}
+
+// Even-odd test against a polygon of x, z pairs.
+bool PointInPolygon(const std::vector<float>& polygon, float x, float z) {
+  bool inside = false;
+  const size_t count = polygon.size() / 2;
+  for (size_t i = 0, j = count - 1; i < count; j = i++) {
+    const float xi = polygon[i * 2], zi = polygon[i * 2 + 1];
+    const float xj = polygon[j * 2], zj = polygon[j * 2 + 1];
+    if ((zi > z) != (zj > z) && x < (xj - xi) * (z - zi) / (zj - zi) + xi) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+// ARCore's environmental HDR cubemap faces are 16x16.
+constexpr int kCubemapFaceSize = 16;
+
+uint16_t FloatToHalf(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint16_t sign = (bits >> 16) & 0x8000;
+  const int exponent = static_cast<int>((bits >> 23) & 0xff) - 127 + 15;
+  if (exponent <= 0) return sign;
+  if (exponent >= 31) return sign | 0x7bff;
+  return sign | (exponent << 10) | ((bits >> 13) & 0x3ff);
+}
+
+// Direction through the center of texel |x|, |y| of cubemap |face|, in GL
+// cubemap order.
+glm::vec3 CubemapDirection(int face, int x, int y) {
+  const float u = 2.f * (x + 0.5f) / kCubemapFaceSize - 1.f;
+  const float v = 2.f * (y + 0.5f) / kCubemapFaceSize - 1.f;
+  switch (face) {
+    case 0: return glm::normalize(glm::vec3(1.f, -v, -u));
+    case 1: return glm::normalize(glm::vec3(-1.f, -v, u));
+    case 2: return glm::normalize(glm::vec3(u, 1.f, v));
+    case 3: return glm::normalize(glm::vec3(u, -1.f, -v));
+    case 4: return glm::normalize(glm::vec3(u, -v, 1.f));
+    default: return glm::normalize(glm::vec3(-u, -v, -1.f));
+  }
+}
+
+}  // namespace
+
+struct ArPose_ {
+  float raw[7];
+};
+
+struct ArTrackable_ {
+  ArTrackableType type = AR_TRACKABLE_PLANE;
+  uint32_t id = 0;
+  ArTrackable_* subsumed_by = nullptr;
+  ArTrackingState tracking_state = AR_TRACKING_STATE_STOPPED;
+  ArPlaneType plane_type = AR_PLANE_HORIZONTAL_UPWARD_FACING;
+  float center_pose[7] = {0, 0, 0, 1, 0, 0, 0};
+  float extent_x = 0.f;
+  float extent_z = 0.f;
+  std::vector<float> polygon;
+  // Present in the current frame.
+  bool present = false;
+};
+
+struct ArTrackableList_ {
+  std::vector<ArTrackable_*> items;
+};
+
+struct ArAnchor_ {
+  float created_pose[7];
+  // Index of the recorded anchor this one follows.
+  size_t slot;
+  bool released = false;
+};
+
+struct ArHitResult_ {
+  float pose[7];
+  float distance;
+  ArTrackable_* trackable;
+};
+
+struct ArHitResultList_ {
+  std::vector<ArHitResult_> hits;
+};
+
+// Environmental HDR cubemap face, owned by its light estimate.
+struct ArImage_ {
+  int64_t timestamp_ns = 0;
+  std::vector<uint16_t> rgba;
+};
+
+struct ArLightEstimate_ {
+  ArLightEstimateState state = AR_LIGHT_ESTIMATE_STATE_NOT_VALID;
+  int64_t timestamp_ns = 0;
+  float color_correction[4] = {1.f, 1.f, 1.f, 0.466f};
+  float main_light_direction[3] = {0.f, 1.f, 0.f};
+  float main_light_intensity[3] = {};
+  float ambient_spherical_harmonics[27] = {};
+
+  // Recordings do not hold the cubemap.  It is synthesized from the main
+  // light and ambient SH when first acquired for an estimate.
+  ArImage_ cubemap[6];
+  bool cubemap_valid = false;
+
+  void SynthesizeCubemap();
+};
+
+void ArLightEstimate_::SynthesizeCubemap() {
+  const glm::vec3 light_direction = glm::normalize(glm::vec3(
+      main_light_direction[0], main_light_direction[1],
+      main_light_direction[2]));
+  const float* sh = ambient_spherical_harmonics;
+  for (int face = 0; face < 6; ++face) {
+    ArImage_& image = cubemap[face];
+    image.timestamp_ns = timestamp_ns;
+    image.rgba.resize(kCubemapFaceSize * kCubemapFaceSize * 4);
+    for (int y = 0; y < kCubemapFaceSize; ++y) {
+      for (int x = 0; x < kCubemapFaceSize; ++x) {
+        const glm::vec3 d = CubemapDirection(face, x, y);
+        // Real SH basis up to l = 2, coefficients are channel-interleaved.
+        const float basis[9] = {
+            0.282095f,
+            0.488603f * d.y,
+            0.488603f * d.z,
+            0.488603f * d.x,
+            1.092548f * d.x * d.y,
+            1.092548f * d.y * d.z,
+            0.315392f * (3.f * d.z * d.z - 1.f),
+            1.092548f * d.x * d.z,
+            0.546274f * (d.x * d.x - d.y * d.y)};
+        const float highlight =
+            std::pow(std::max(0.f, glm::dot(d, light_direction)), 64.f);
+        uint16_t* texel = &image.rgba[(y * kCubemapFaceSize + x) * 4];
+        for (int c = 0; c < 3; ++c) {
+          float radiance = main_light_intensity[c] * highlight;
+          for (int k = 0; k < 9; ++k) radiance += sh[k * 3 + c] * basis[k];
+          texel[c] = FloatToHalf(std::max(0.f, radiance));
+        }
+        texel[3] = FloatToHalf(1.f);
+      }
+    }
+  }
+  cubemap_valid = true;
+}
+
+struct ArCamera_ {};
+struct ArCameraIntrinsics_ {};
+struct ArCameraConfig_ {};
+struct ArCameraConfigList_ {};
+struct ArCameraConfigFilter_ {};
+struct ArConfig_ {};
+struct ArAugmentedImageDatabase_ {};
+struct ArFrame_ {};
+
+struct ArSession_ {
+  ArRecordFileHeader header;
+  std::vector<uint8_t> data;
+  std::vector<size_t> frame_offsets;
+
+  size_t next_frame = 0;
+  int64_t frames_played = 0;
+  int64_t timestamp_offset_ns = 0;
+  // Recordings hold the light estimate of every frame, not its timestamp.
+  // Like ARCore, keep the timestamp of the frame the estimate last changed.
+  int64_t light_timestamp_ns = 0;
+
+  // Decoded current frame.
+  ArRecordFrame frame = {};
+  std::vector<ArRecordAnchor> anchors;
+  std::unordered_map<uint32_t, std::unique_ptr<ArTrackable_>> planes;
+  std::vector<ArTrackable_*> present_planes;
+  std::vector<uint32_t> subsumed_ids;
+  // Planes that appeared, changed or disappeared in the current frame.
+  std::vector<ArTrackable_*> updated_planes;
+  std::vector<ArTrackable_*> previous_planes;
+
+  std::vector<std::unique_ptr<ArAnchor_>> app_anchors;
+
+  int32_t display_width = 0;
+  int32_t display_height = 0;
+  bool geometry_changed = true;
+
+  ArCamera_ camera;
+
+  bool Load(const std::string& path);
+  void Advance();
+};
+
+bool ArSession_::Load(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) {
+    fprintf(stderr, "arcore_replay: could not open %s\n", path.c_str());
+    return false;
+  }
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  data.resize(size > 0 ? size : 0);
+  const bool read_ok = fread(data.data(), 1, data.size(), file) == data.size();
+  fclose(file);
+
+  if (!read_ok || data.size() < sizeof(header)) {
+    fprintf(stderr, "arcore_replay: %s is truncated\n", path.c_str());
+    return false;
+  }
+  memcpy(&header, data.data(), sizeof(header));
+  if (memcmp(header.magic, hello_ar::arrec::kFileMagic, sizeof(header.magic)) ||
+      header.version != hello_ar::arrec::kFileVersion) {
+    fprintf(stderr, "arcore_replay: %s is not a version %u recording\n",
+            path.c_str(), hello_ar::arrec::kFileVersion);
+    return false;
+  }
+
+  // Index the frames; a partially written last frame is ignored.
+  size_t offset = header.header_size;
+  while (offset + sizeof(ArRecordFrame) <= data.size()) {
+    uint32_t frame_size;
+    memcpy(&frame_size, data.data() + offset, sizeof(frame_size));
+    if (frame_size < sizeof(ArRecordFrame) || offset + frame_size > data.size())
+      break;
+    frame_offsets.push_back(offset);
+    offset += frame_size;
+  }
+  if (frame_offsets.empty()) {
+    fprintf(stderr, "arcore_replay: %s has no frames\n", path.c_str());
+    return false;
+  }
+  return true;
+}
+
+void ArSession_::Advance() {
+  if (next_frame >= frame_offsets.size()) {
+    if (!g_loop) {
+      frames_played++;
+      return;
+    }
+    // Keep timestamps increasing across loops, one frame interval apart.
+    const int64_t first = reinterpret_cast<const ArRecordFrame*>(
+        data.data() + frame_offsets.front())->timestamp_ns;
+    const int64_t interval =
+        frame_offsets.size() > 1
+            ? (frame.timestamp_ns - timestamp_offset_ns - first) /
+                  static_cast<int64_t>(frame_offsets.size() - 1)
+            : 0;
+    timestamp_offset_ns = frame.timestamp_ns + interval - first;
+    next_frame = 0;
+  }
+
+  const uint8_t* cursor = data.data() + frame_offsets[next_frame++];
+  const ArRecordFrame previous = frame;
+  memcpy(&frame, cursor, sizeof(frame));
+  frame.timestamp_ns += timestamp_offset_ns;
+  const size_t light_offset = offsetof(ArRecordFrame, light_state);
+  if (frames_played == 0 ||
+      memcmp(reinterpret_cast<const char*>(&previous) + light_offset,
+             reinterpret_cast<const char*>(&frame) + light_offset,
+             sizeof(frame) - light_offset)) {
+    light_timestamp_ns = frame.timestamp_ns;
+  }
+  cursor += sizeof(frame);
+  frames_played++;
+
+  // Planes keep their state until the frame's record of them is compared.
+  previous_planes.swap(present_planes);
+  present_planes.clear();
+  for (ArTrackable_* plane : previous_planes) plane->present = false;
+  subsumed_ids.clear();
+  updated_planes.clear();
+  for (uint32_t i = 0; i < frame.plane_count; ++i) {
+    ArRecordPlane record;
+    memcpy(&record, cursor, sizeof(record));
+    cursor += sizeof(record);
+    const float* polygon = reinterpret_cast<const float*>(cursor);
+    cursor += record.polygon_size * sizeof(float);
+
+    std::unique_ptr<ArTrackable_>& plane = planes[record.id];
+    bool updated = !plane;
+    if (!plane) plane.reset(new ArTrackable_);
+    const ArTrackingState tracking_state =
+        static_cast<ArTrackingState>(record.tracking_state);
+    updated = updated || plane->tracking_state != tracking_state ||
+              memcmp(plane->center_pose, record.center_pose,
+                     sizeof(record.center_pose)) ||
+              plane->extent_x != record.extent_x ||
+              plane->extent_z != record.extent_z ||
+              plane->polygon.size() != record.polygon_size ||
+              memcmp(plane->polygon.data(), polygon,
+                     record.polygon_size * sizeof(float));
+    plane->id = record.id;
+    plane->tracking_state = tracking_state;
+    plane->plane_type = static_cast<ArPlaneType>(record.type);
+    memcpy(plane->center_pose, record.center_pose, sizeof(record.center_pose));
+    plane->extent_x = record.extent_x;
+    plane->extent_z = record.extent_z;
+    plane->polygon.assign(polygon, polygon + record.polygon_size);
+    plane->present = true;
+    present_planes.push_back(plane.get());
+    subsumed_ids.push_back(record.subsumed_by);
+    if (updated) updated_planes.push_back(plane.get());
+  }
+
+  // Resolve subsumption now that every plane of the frame exists.
+  for (size_t i = 0; i < present_planes.size(); ++i) {
+    ArTrackable_* plane = present_planes[i];
+    ArTrackable_* subsumed_by = nullptr;
+    if (subsumed_ids[i]) {
+      auto it = planes.find(subsumed_ids[i]);
+      if (it != planes.end()) subsumed_by = it->second.get();
+    }
+    if (plane->subsumed_by != subsumed_by) {
+      plane->subsumed_by = subsumed_by;
+      if (std::find(updated_planes.begin(), updated_planes.end(), plane) ==
+          updated_planes.end()) {
+        updated_planes.push_back(plane);
+      }
+    }
+  }
+
+  // Planes missing from the recorded frame have stopped tracking.
+  for (ArTrackable_* plane : previous_planes) {
+    if (plane->present || plane->tracking_state == AR_TRACKING_STATE_STOPPED) {
+      continue;
+    }
+    plane->tracking_state = AR_TRACKING_STATE_STOPPED;
+    updated_planes.push_back(plane);
+  }
+
+  anchors.resize(frame.anchor_count);
+  if (frame.anchor_count) {
+    memcpy(anchors.data(), cursor, frame.anchor_count * sizeof(ArRecordAnchor));
+  }
+}
+
+namespace {
+
+ArTrackable_* ToTrackable(const ArPlane* plane) {
+  return reinterpret_cast<ArTrackable_*>(const_cast<ArPlane*>(plane));
+}
+
+}  // namespace
+
+extern "C" {
+
+void ArReplay_setRecordingPath(const char* path) {
+  g_recording_path = path ? path : "";
+}
+
+void ArReplay_setLoop(int32_t loop) { g_loop = loop != 0; }
+
+int64_t ArReplay_getFrameCount(const ArSession* session) {
+  return session->frame_offsets.size();
+}
+
+int64_t ArReplay_getFramesPlayed(const ArSession* session) {
+  return session->frames_played;
+}
+
+uint64_t ArReplay_getApiCalls(void) { return g_api_calls; }
+
+int32_t ArReplay_getActivePlaneCount(void) {
+  if (!g_updated_session) return 0;
+  int32_t count = 0;
+  for (const ArTrackable_* plane : g_updated_session->present_planes) {
+    if (!plane->subsumed_by &&
+        plane->tracking_state != AR_TRACKING_STATE_STOPPED) {
+      count++;
+    }
+  }
+  return count;
+}
+
+}  // extern "C"
+
+// Session.
+
+ArStatus ArCoreApk_requestInstall(void* env, void* application_activity,
+                                  int32_t user_requested_install,
+                                  ArInstallStatus* out_install_status) {
+  Count();
+  *out_install_status = AR_INSTALL_STATUS_INSTALLED;
+  return AR_SUCCESS;
+}
+
+ArStatus ArSession_create(void* env, void* context,
+                          ArSession** out_session_pointer) {
+  Count();
+  std::string path = g_recording_path;
+  if (path.empty() && getenv("ARCORE_REPLAY_FILE")) {
+    path = getenv("ARCORE_REPLAY_FILE");
+  }
+  std::unique_ptr<ArSession_> session(new ArSession_);
+  if (path.empty() || !session->Load(path)) {
+    *out_session_pointer = nullptr;
+    return AR_ERROR_FATAL;
+  }
+  *out_session_pointer = session.release();
+  return AR_SUCCESS;
+}
+
+void ArSession_destroy(ArSession* session) {
+  Count();
+  if (g_updated_session == session) g_updated_session = nullptr;
+  delete session;
+}
+
+ArStatus ArSession_configure(ArSession* session, const ArConfig* config) {
+  Count();
+  return AR_SUCCESS;
+}
+
+void ArSession_getConfig(ArSession* session, ArConfig* out_config) { Count(); }
+
+ArStatus ArSession_resume(ArSession* session) {
+  Count();
+  return AR_SUCCESS;
+}
+
+ArStatus ArSession_pause(ArSession* session) {
+  Count();
+  return AR_SUCCESS;
+}
+
+ArStatus ArSession_update(ArSession* session, ArFrame* out_frame) {
+  Count();
+  session->Advance();
+  g_updated_session = session;
+  return AR_SUCCESS;
+}
+
+void ArSession_setDisplayGeometry(ArSession* session, int32_t rotation,
+                                  int32_t width, int32_t height) {
+  Count();
+  session->display_width = width;
+  session->display_height = height;
+  session->geometry_changed = true;
+}
+
+void ArSession_setCameraTextureName(ArSession* session, uint32_t texture_id) {
+  Count();
+}
+
+ArStatus ArSession_setCameraConfig(const ArSession* session,
+                                   const ArCameraConfig* camera_config) {
+  Count();
+  return AR_SUCCESS;
+}
+
+void ArSession_getSupportedCameraConfigsWithFilter(
+    const ArSession* session, const ArCameraConfigFilter* filter,
+    ArCameraConfigList* list) { Count(); }
+
+void ArSession_getAllTrackables(const ArSession* session,
+                                ArTrackableType filter_type,
+                                ArTrackableList* out_trackable_list) {
+  Count();
+  out_trackable_list->items.clear();
+  if (filter_type == AR_TRACKABLE_PLANE ||
+      filter_type == AR_TRACKABLE_BASE_TRACKABLE) {
+    out_trackable_list->items = session->present_planes;
+  }
+}
+
+// Config and camera config.
+
+void ArConfig_create(const ArSession* session, ArConfig** out_config) {
+  Count();
+  *out_config = new ArConfig_;
+}
+
+void ArConfig_destroy(ArConfig* config) {
+  Count();
+  delete config;
+}
+
+void ArConfig_setLightEstimationMode(
+    const ArSession* session, ArConfig* config,
+    ArLightEstimationMode light_estimation_mode) { Count(); }
+
+void ArConfig_setAugmentedImageDatabase(
+    const ArSession* session, ArConfig* config,
+    const ArAugmentedImageDatabase* augmented_image_database) { Count(); }
+
+ArStatus ArAugmentedImageDatabase_deserialize(
+    const ArSession* session, const uint8_t* database_raw_bytes,
+    int64_t database_raw_bytes_size,
+    ArAugmentedImageDatabase** out_augmented_image_database) {
+  Count();
+  *out_augmented_image_database = new ArAugmentedImageDatabase_;
+  return AR_SUCCESS;
+}
+
+void ArAugmentedImageDatabase_destroy(
+    ArAugmentedImageDatabase* augmented_image_database) {
+  Count();
+  delete augmented_image_database;
+}
+
+void ArAugmentedImage_getIndex(const ArSession* session,
+                               const ArAugmentedImage* augmented_image,
+                               int32_t* out_index) {
+  Count();
+  *out_index = 0;
+}
+
+void ArAugmentedImage_getCenterPose(const ArSession* session,
+                                    const ArAugmentedImage* augmented_image,
+                                    ArPose* out_pose) {
+  Count();
+  *out_pose = ArPose_{{0, 0, 0, 1, 0, 0, 0}};
+}
+
+void ArCameraConfigFilter_create(const ArSession* session,
+                                 ArCameraConfigFilter** out_filter) {
+  Count();
+  *out_filter = new ArCameraConfigFilter_;
+}
+
+void ArCameraConfigFilter_destroy(ArCameraConfigFilter* filter) {
+  Count();
+  delete filter;
+}
+
+void ArCameraConfigFilter_setTargetFps(const ArSession* session,
+                                       ArCameraConfigFilter* filter,
+                                       const uint32_t fps_filters) { Count(); }
+
+void ArCameraConfigList_create(const ArSession* session,
+                               ArCameraConfigList** out_list) {
+  Count();
+  *out_list = new ArCameraConfigList_;
+}
+
+void ArCameraConfigList_destroy(ArCameraConfigList* list) {
+  Count();
+  delete list;
+}
+
+void ArCameraConfigList_getSize(const ArSession* session,
+                                const ArCameraConfigList* list,
+                                int32_t* out_size) {
+  Count();
+  // A single config matching any filter, like a device with a 60Hz camera.
+  *out_size = 1;
+}
+
+void ArCameraConfigList_getItem(const ArSession* session,
+                                const ArCameraConfigList* list, int32_t index,
+                                ArCameraConfig* out_camera_config) { Count(); }
+
+void ArCameraConfig_create(const ArSession* session,
+                           ArCameraConfig** out_camera_config) {
+  Count();
+  *out_camera_config = new ArCameraConfig_;
+}
+
+void ArCameraConfig_destroy(ArCameraConfig* camera_config) {
+  Count();
+  delete camera_config;
+}
+
+// Frame.
+
+void ArFrame_create(const ArSession* session, ArFrame** out_frame) {
+  Count();
+  *out_frame = new ArFrame_;
+}
+
+void ArFrame_destroy(ArFrame* frame) {
+  Count();
+  delete frame;
+}
+
+void ArFrame_getTimestamp(const ArSession* session, const ArFrame* frame,
+                          int64_t* out_timestamp_ns) {
+  Count();
+  *out_timestamp_ns = session->frame.timestamp_ns;
+}
+
+void ArFrame_getDisplayGeometryChanged(const ArSession* session,
+                                       const ArFrame* frame,
+                                       int32_t* out_geometry_changed) {
+  Count();
+  ArSession_* mutable_session = const_cast<ArSession_*>(session);
+  *out_geometry_changed =
+      mutable_session->geometry_changed || session->frame.display_geometry_changed;
+  mutable_session->geometry_changed = false;
+}
+
+void ArFrame_transformCoordinates2d(const ArSession* session,
+                                    const ArFrame* frame,
+                                    ArCoordinates2dType input_coordinates,
+                                    int32_t number_of_vertices,
+                                    const float* vertices_2d,
+                                    ArCoordinates2dType output_coordinates,
+                                    float* out_vertices_2d) {
+  Count();
+  // Only NDC to texture coordinates is recorded, as used for the background
+  // quad; interpolate between the recorded corners.
+  const float* uv = session->frame.display_uvs;
+  for (int32_t i = 0; i < number_of_vertices; ++i) {
+    const float x = vertices_2d[i * 2];
+    const float y = vertices_2d[i * 2 + 1];
+    if (input_coordinates !=
+            AR_COORDINATES_2D_OPENGL_NORMALIZED_DEVICE_COORDINATES ||
+        output_coordinates != AR_COORDINATES_2D_TEXTURE_NORMALIZED) {
+      out_vertices_2d[i * 2] = x;
+      out_vertices_2d[i * 2 + 1] = y;
+      continue;
+    }
+    const float s = (x + 1.f) * 0.5f;
+    const float t = (y + 1.f) * 0.5f;
+    for (int c = 0; c < 2; ++c) {
+      const float bottom = uv[0 + c] * (1.f - s) + uv[2 + c] * s;
+      const float top = uv[4 + c] * (1.f - s) + uv[6 + c] * s;
+      out_vertices_2d[i * 2 + c] = bottom * (1.f - t) + top * t;
+    }
+  }
+}
+
+void ArFrame_acquireCamera(const ArSession* session, const ArFrame* frame,
+                           ArCamera** out_camera) {
+  Count();
+  *out_camera = const_cast<ArCamera_*>(&session->camera);
+}
+
+void ArFrame_getLightEstimate(const ArSession* session, const ArFrame* frame,
+                              ArLightEstimate* out_light_estimate) {
+  Count();
+  const ArRecordFrame& record = session->frame;
+  out_light_estimate->state =
+      static_cast<ArLightEstimateState>(record.light_state);
+  if (out_light_estimate->timestamp_ns != session->light_timestamp_ns) {
+    out_light_estimate->cubemap_valid = false;
+  }
+  out_light_estimate->timestamp_ns = session->light_timestamp_ns;
+  memcpy(out_light_estimate->color_correction, record.color_correction,
+         sizeof(record.color_correction));
+  memcpy(out_light_estimate->main_light_direction, record.main_light_direction,
+         sizeof(record.main_light_direction));
+  memcpy(out_light_estimate->main_light_intensity, record.main_light_intensity,
+         sizeof(record.main_light_intensity));
+  memcpy(out_light_estimate->ambient_spherical_harmonics,
+         record.ambient_spherical_harmonics,
+         sizeof(record.ambient_spherical_harmonics));
+}
+
+void ArFrame_getUpdatedTrackables(const ArSession* session,
+                                  const ArFrame* frame,
+                                  ArTrackableType filter_type,
+                                  ArTrackableList* out_trackable_list) {
+  Count();
+  out_trackable_list->items.clear();
+  if (filter_type == AR_TRACKABLE_PLANE ||
+      filter_type == AR_TRACKABLE_BASE_TRACKABLE) {
+    out_trackable_list->items = session->updated_planes;
+  }
+}
+
+void ArFrame_hitTest(const ArSession* session, const ArFrame* frame,
+                     float pixel_x, float pixel_y,
+                     ArHitResultList* hit_result_list) {
+  Count();
+  hit_result_list->hits.clear();
+  const ArRecordFrame& record = session->frame;
+  if (record.tracking_state != AR_TRACKING_STATE_TRACKING) return;
+
+  const float width = session->display_width ? session->display_width
+                                             : record.display_width;
+  const float height = session->display_height ? session->display_height
+                                               : record.display_height;
+  if (width <= 0.f || height <= 0.f) return;
+
+  const glm::mat4 inverse_view_projection =
+      glm::inverse(glm::make_mat4(record.projection_matrix) *
+                   glm::make_mat4(record.view_matrix));
+  const float ndc_x = 2.f * pixel_x / width - 1.f;
+  const float ndc_y = 1.f - 2.f * pixel_y / height;
+  glm::vec4 near_point = inverse_view_projection * glm::vec4(ndc_x, ndc_y, -1.f, 1.f);
+  glm::vec4 far_point = inverse_view_projection * glm::vec4(ndc_x, ndc_y, 1.f, 1.f);
+  const glm::vec3 origin = glm::vec3(near_point) / near_point.w;
+  const glm::vec3 direction =
+      glm::normalize(glm::vec3(far_point) / far_point.w - origin);
+
+  for (ArTrackable_* plane : session->present_planes) {
+    if (plane->tracking_state != AR_TRACKING_STATE_TRACKING ||
+        plane->subsumed_by) {
+      continue;
+    }
+    const glm::mat4 model = PoseToMatrix(plane->center_pose);
+    const glm::vec3 normal = glm::vec3(model * glm::vec4(0.f, 1.f, 0.f, 0.f));
+    const glm::vec3 center = glm::vec3(model[3]);
+    const float denominator = glm::dot(normal, direction);
+    if (std::fabs(denominator) < 1e-6f) continue;
+    const float distance = glm::dot(center - origin, normal) / denominator;
+    if (distance < 0.f) continue;
+
+    const glm::vec3 hit = origin + direction * distance;
+    const glm::vec4 local = glm::inverse(model) * glm::vec4(hit, 1.f);
+    if (!PointInPolygon(plane->polygon, local.x, local.z)) continue;
+
+    ArHitResult_ result;
+    memcpy(result.pose, plane->center_pose, sizeof(result.pose));
+    result.pose[4] = hit.x;
+    result.pose[5] = hit.y;
+    result.pose[6] = hit.z;
+    result.distance = distance;
+    result.trackable = plane;
+    hit_result_list->hits.push_back(result);
+  }
+  std::sort(hit_result_list->hits.begin(), hit_result_list->hits.end(),
+            [](const ArHitResult_& a, const ArHitResult_& b) {
+              return a.distance < b.distance;
+            });
+}
+
+// Camera.
+
+void ArCamera_release(ArCamera* camera) { Count(); }
+
+void ArCamera_getTrackingState(const ArSession* session, const ArCamera* camera,
+                               ArTrackingState* out_tracking_state) {
+  Count();
+  *out_tracking_state =
+      static_cast<ArTrackingState>(session->frame.tracking_state);
+}
+
+void ArCamera_getTrackingFailureReason(
+    const ArSession* session, const ArCamera* camera,
+    ArTrackingFailureReason* out_tracking_failure_reason) {
+  Count();
+  *out_tracking_failure_reason = static_cast<ArTrackingFailureReason>(
+      session->frame.tracking_failure_reason);
+}
+
+void ArCamera_getPose(const ArSession* session, const ArCamera* camera,
+                      ArPose* out_pose) {
+  Count();
+  memcpy(out_pose->raw, session->frame.camera_pose, sizeof(out_pose->raw));
+}
+
+void ArCamera_getViewMatrix(const ArSession* session, const ArCamera* camera,
+                            float* out_col_major_4x4) {
+  Count();
+  memcpy(out_col_major_4x4, session->frame.view_matrix,
+         sizeof(session->frame.view_matrix));
+}
+
+void ArCamera_getProjectionMatrix(const ArSession* session,
+                                  const ArCamera* camera, float near, float far,
+                                  float* dest_col_major_4x4) {
+  Count();
+  memcpy(dest_col_major_4x4, session->frame.projection_matrix,
+         sizeof(session->frame.projection_matrix));
+  // The recording used kProjectionNear/Far; only the depth terms differ.
+  dest_col_major_4x4[10] = -(far + near) / (far - near);
+  dest_col_major_4x4[14] = -2.f * far * near / (far - near);
+}
+
+void ArCamera_getTextureIntrinsics(const ArSession* session,
+                                   const ArCamera* camera,
+                                   ArCameraIntrinsics* out_camera_intrinsics) {
+  Count();
+}
+
+void ArCameraIntrinsics_create(const ArSession* session,
+                               ArCameraIntrinsics** out_camera_intrinsics) {
+  Count();
+  *out_camera_intrinsics = new ArCameraIntrinsics_;
+}
+
+void ArCameraIntrinsics_destroy(ArCameraIntrinsics* camera_intrinsics) {
+  Count();
+  delete camera_intrinsics;
+}
+
+void ArCameraIntrinsics_getImageDimensions(
+    const ArSession* session, const ArCameraIntrinsics* intrinsics,
+    int32_t* out_width, int32_t* out_height) {
+  Count();
+  *out_width = session->header.camera_image_width;
+  *out_height = session->header.camera_image_height;
+}
+
+// Light estimate.
+
+void ArLightEstimate_create(const ArSession* session,
+                            ArLightEstimate** out_light_estimate) {
+  Count();
+  *out_light_estimate = new ArLightEstimate_;
+}
+
+void ArLightEstimate_destroy(ArLightEstimate* light_estimate) {
+  Count();
+  delete light_estimate;
+}
+
+void ArLightEstimate_getState(const ArSession* session,
+                              const ArLightEstimate* light_estimate,
+                              ArLightEstimateState* out_light_estimate_state) {
+  Count();
+  *out_light_estimate_state = light_estimate->state;
+}
+
+void ArLightEstimate_getTimestamp(const ArSession* session,
+                                  const ArLightEstimate* light_estimate,
+                                  int64_t* out_timestamp_ns) {
+  Count();
+  *out_timestamp_ns = light_estimate->timestamp_ns;
+}
+
+void ArLightEstimate_getColorCorrection(const ArSession* session,
+                                        const ArLightEstimate* light_estimate,
+                                        float* out_color_correction_4) {
+  Count();
+  memcpy(out_color_correction_4, light_estimate->color_correction,
+         sizeof(light_estimate->color_correction));
+}
+
+void ArLightEstimate_getEnvironmentalHdrMainLightDirection(
+    const ArSession* session, const ArLightEstimate* light_estimate,
+    float* out_direction_3) {
+  Count();
+  memcpy(out_direction_3, light_estimate->main_light_direction,
+         sizeof(light_estimate->main_light_direction));
+}
+
+void ArLightEstimate_getEnvironmentalHdrMainLightIntensity(
+    const ArSession* session, const ArLightEstimate* light_estimate,
+    float* out_intensity_3) {
+  Count();
+  memcpy(out_intensity_3, light_estimate->main_light_intensity,
+         sizeof(light_estimate->main_light_intensity));
+}
+
+void ArLightEstimate_getEnvironmentalHdrAmbientSphericalHarmonics(
+    const ArSession* session, const ArLightEstimate* light_estimate,
+    float* out_coefficients_27) {
+  Count();
+  memcpy(out_coefficients_27, light_estimate->ambient_spherical_harmonics,
+         sizeof(light_estimate->ambient_spherical_harmonics));
+}
+
+void ArLightEstimate_acquireEnvironmentalHdrCubemap(
+    const ArSession* session, const ArLightEstimate* light_estimate,
+    ArImageCubemap out_textures_6) {
+  Count();
+  ArLightEstimate_* estimate = const_cast<ArLightEstimate_*>(light_estimate);
+  if (!estimate->cubemap_valid) estimate->SynthesizeCubemap();
+  for (int face = 0; face < 6; ++face) {
+    out_textures_6[face] = &estimate->cubemap[face];
+  }
+}
+
+// Images.  Only the cubemap faces above exist.
+
+void ArImage_getWidth(const ArSession* session, const ArImage* image,
+                      int32_t* out_width) {
+  Count();
+  *out_width = kCubemapFaceSize;
+}
+
+void ArImage_getHeight(const ArSession* session, const ArImage* image,
+                       int32_t* out_height) {
+  Count();
+  *out_height = kCubemapFaceSize;
+}
+
+void ArImage_getTimestamp(const ArSession* session, const ArImage* image,
+                          int64_t* out_timestamp_ns) {
+  Count();
+  *out_timestamp_ns = image->timestamp_ns;
+}
+
+void ArImage_getFormat(const ArSession* session, const ArImage* image,
+                       ArImageFormat* out_format) {
+  Count();
+  *out_format = AR_IMAGE_FORMAT_RGBA_FP16;
+}
+
+void ArImage_getNumberOfPlanes(const ArSession* session, const ArImage* image,
+                               int32_t* out_num_planes) {
+  Count();
+  *out_num_planes = 1;
+}
+
+void ArImage_getPlanePixelStride(const ArSession* session,
+                                 const ArImage* image, int32_t plane_index,
+                                 int32_t* out_pixel_stride) {
+  Count();
+  *out_pixel_stride = 4 * sizeof(uint16_t);
+}
+
+void ArImage_getPlaneRowStride(const ArSession* session, const ArImage* image,
+                               int32_t plane_index, int32_t* out_row_stride) {
+  Count();
+  *out_row_stride = kCubemapFaceSize * 4 * sizeof(uint16_t);
+}
+
+void ArImage_getPlaneData(const ArSession* session, const ArImage* image,
+                          int32_t plane_index, const uint8_t** out_data,
+                          int32_t* out_data_length) {
+  Count();
+  *out_data = reinterpret_cast<const uint8_t*>(image->rgba.data());
+  *out_data_length =
+      static_cast<int32_t>(image->rgba.size() * sizeof(uint16_t));
+}
+
+void ArImage_release(ArImage* image) { Count(); }
+
+// Pose.
+
+void ArPose_create(const ArSession* session, const float* pose_raw,
+                   ArPose** out_pose) {
+  Count();
+  static const float kIdentity[7] = {0, 0, 0, 1, 0, 0, 0};
+  *out_pose = new ArPose_;
+  memcpy((*out_pose)->raw, pose_raw ? pose_raw : kIdentity, sizeof(kIdentity));
+}
+
+void ArPose_destroy(ArPose* pose) {
+  Count();
+  delete pose;
+}
+
+void ArPose_getPoseRaw(const ArSession* session, const ArPose* pose,
+                       float* out_pose_raw) {
+  Count();
+  memcpy(out_pose_raw, pose->raw, sizeof(pose->raw));
+}
+
+void ArPose_getMatrix(const ArSession* session, const ArPose* pose,
+                      float* out_matrix_col_major_4x4) {
+  Count();
+  const glm::mat4 matrix = PoseToMatrix(pose->raw);
+  memcpy(out_matrix_col_major_4x4, glm::value_ptr(matrix), sizeof(matrix));
+}
+
+// Trackables and planes.
+
+void ArTrackableList_create(const ArSession* session,
+                            ArTrackableList** out_trackable_list) {
+  Count();
+  *out_trackable_list = new ArTrackableList_;
+}
+
+void ArTrackableList_destroy(ArTrackableList* trackable_list) {
+  Count();
+  delete trackable_list;
+}
+
+void ArTrackableList_getSize(const ArSession* session,
+                             const ArTrackableList* trackable_list,
+                             int32_t* out_size) {
+  Count();
+  *out_size = static_cast<int32_t>(trackable_list->items.size());
+}
+
+void ArTrackableList_acquireItem(const ArSession* session,
+                                 const ArTrackableList* trackable_list,
+                                 int32_t index, ArTrackable** out_trackable) {
+  Count();
+  *out_trackable = trackable_list->items[index];
+}
+
+void ArTrackable_release(ArTrackable* trackable) { Count(); }
+
+void ArTrackable_getType(const ArSession* session, const ArTrackable* trackable,
+                         ArTrackableType* out_trackable_type) {
+  Count();
+  *out_trackable_type = trackable->type;
+}
+
+void ArTrackable_getTrackingState(const ArSession* session,
+                                  const ArTrackable* trackable,
+                                  ArTrackingState* out_tracking_state) {
+  Count();
+  *out_tracking_state = trackable->present ? trackable->tracking_state
+                                           : AR_TRACKING_STATE_STOPPED;
+}
+
+void ArPlane_acquireSubsumedBy(const ArSession* session, const ArPlane* plane,
+                               ArPlane** out_subsumed_by) {
+  Count();
+  *out_subsumed_by = reinterpret_cast<ArPlane*>(ToTrackable(plane)->subsumed_by);
+}
+
+void ArPlane_getType(const ArSession* session, const ArPlane* plane,
+                     ArPlaneType* out_plane_type) {
+  Count();
+  *out_plane_type = ToTrackable(plane)->plane_type;
+}
+
+void ArPlane_getCenterPose(const ArSession* session, const ArPlane* plane,
+                           ArPose* out_pose) {
+  Count();
+  memcpy(out_pose->raw, ToTrackable(plane)->center_pose, sizeof(out_pose->raw));
+}
+
+void ArPlane_getExtentX(const ArSession* session, const ArPlane* plane,
+                        float* out_extent_x) {
+  Count();
+  *out_extent_x = ToTrackable(plane)->extent_x;
+}
+
+void ArPlane_getExtentZ(const ArSession* session, const ArPlane* plane,
+                        float* out_extent_z) {
+  Count();
+  *out_extent_z = ToTrackable(plane)->extent_z;
+}
+
+void ArPlane_getPolygonSize(const ArSession* session, const ArPlane* plane,
+                            int32_t* out_polygon_size) {
+  Count();
+  *out_polygon_size = static_cast<int32_t>(ToTrackable(plane)->polygon.size());
+}
+
+void ArPlane_getPolygon(const ArSession* session, const ArPlane* plane,
+                        float* out_polygon_xz) {
+  Count();
+  const std::vector<float>& polygon = ToTrackable(plane)->polygon;
+  std::copy(polygon.begin(), polygon.end(), out_polygon_xz);
+}
+
+void ArPlane_isPoseInPolygon(const ArSession* session, const ArPlane* plane,
+                             const ArPose* pose, int32_t* out_pose_in_polygon) {
+  Count();
+  const ArTrackable_* trackable = ToTrackable(plane);
+  const glm::vec4 local = glm::inverse(PoseToMatrix(trackable->center_pose)) *
+                          glm::vec4(pose->raw[4], pose->raw[5], pose->raw[6], 1.f);
+  *out_pose_in_polygon = PointInPolygon(trackable->polygon, local.x, local.z);
+}
+
+void ArPoint_getOrientationMode(const ArSession* session, const ArPoint* point,
+                                ArPointOrientationMode* out_orientation_mode) {
+  Count();
+  *out_orientation_mode = AR_POINT_ORIENTATION_INITIALIZED_TO_IDENTITY;
+}
+
+// Hit results.
+
+void ArHitResultList_create(const ArSession* session,
+                            ArHitResultList** out_hit_result_list) {
+  Count();
+  *out_hit_result_list = new ArHitResultList_;
+}
+
+void ArHitResultList_destroy(ArHitResultList* hit_result_list) {
+  Count();
+  delete hit_result_list;
+}
+
+void ArHitResultList_getSize(const ArSession* session,
+                             const ArHitResultList* hit_result_list,
+                             int32_t* out_size) {
+  Count();
+  *out_size = static_cast<int32_t>(hit_result_list->hits.size());
+}
+
+void ArHitResultList_getItem(const ArSession* session,
+                             const ArHitResultList* hit_result_list,
+                             int32_t index, ArHitResult* out_hit_result) {
+  Count();
+  *out_hit_result = hit_result_list->hits[index];
+}
+
+void ArHitResult_create(const ArSession* session,
+                        ArHitResult** out_hit_result) {
+  Count();
+  *out_hit_result = new ArHitResult_();
+}
+
+void ArHitResult_destroy(ArHitResult* hit_result) {
+  Count();
+  delete hit_result;
+}
+
+void ArHitResult_getHitPose(const ArSession* session,
+                            const ArHitResult* hit_result, ArPose* out_pose) {
+  Count();
+  memcpy(out_pose->raw, hit_result->pose, sizeof(out_pose->raw));
+}
+
+void ArHitResult_acquireTrackable(const ArSession* session,
+                                  const ArHitResult* hit_result,
+                                  ArTrackable** out_trackable) {
+  Count();
+  *out_trackable = hit_result->trackable;
+}
+
+// Anchors.
+
+namespace {
+
+ArAnchor_* NewAnchor(ArSession* session, const float* pose) {
+  size_t live = 0;
+  for (const auto& anchor : session->app_anchors) live += !anchor->released;
+  std::unique_ptr<ArAnchor_> anchor(new ArAnchor_);
+  memcpy(anchor->created_pose, pose, sizeof(anchor->created_pose));
+  anchor->slot = live;
+  session->app_anchors.push_back(std::move(anchor));
+  return session->app_anchors.back().get();
+}
+
+}  // namespace
+
+ArStatus ArHitResult_acquireNewAnchor(ArSession* session,
+                                      ArHitResult* hit_result,
+                                      ArAnchor** out_anchor) {
+  Count();
+  *out_anchor = NewAnchor(session, hit_result->pose);
+  return AR_SUCCESS;
+}
+
+ArStatus ArTrackable_acquireNewAnchor(ArSession* session,
+                                      ArTrackable* trackable, ArPose* pose,
+                                      ArAnchor** out_anchor) {
+  Count();
+  *out_anchor = NewAnchor(session, pose->raw);
+  return AR_SUCCESS;
+}
+
+void ArAnchor_release(ArAnchor* anchor) {
+  Count();
+  anchor->released = true;
+}
+
+void ArAnchor_getTrackingState(const ArSession* session, const ArAnchor* anchor,
+                               ArTrackingState* out_tracking_state) {
+  Count();
+  if (anchor->slot < session->anchors.size()) {
+    *out_tracking_state = static_cast<ArTrackingState>(
+        session->anchors[anchor->slot].tracking_state);
+  } else {
+    *out_tracking_state =
+        static_cast<ArTrackingState>(session->frame.tracking_state);
+  }
+}
+
+void ArAnchor_getPose(const ArSession* session, const ArAnchor* anchor,
+                      ArPose* out_pose) {
+  Count();
+  const float* pose = anchor->slot < session->anchors.size()
+                          ? session->anchors[anchor->slot].pose
+                          : anchor->created_pose;
+  memcpy(out_pose->raw, pose, sizeof(out_pose->raw));
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#ifndef C_ARCORE_HELLO_AR_ARCORE_REPLAY_H_
+#define C_ARCORE_HELLO_AR_ARCORE_REPLAY_H_
+
+#include <stdint.h>
+
+#include "arcore_c_api.h"
+
+// Host-side stand-in for libarcore_sdk_c.so that plays back a session
+// recorded with the client's -arr launch option (see ar_record_format.h).  It
+// implements the subset of the ARCore C API the client uses; each
+// ArSession_update() advances one recorded frame without waiting, so the
+// frame loop runs as fast as the host allows.
+//
+// Planes, light estimates, camera matrices and tracking state come from the
+// recording.  Hit tests intersect the ray with the recorded planes, and
+// anchors follow the recorded application anchors in creation order, or stay
+// where they were created if the recording has none.  The environmental HDR
+// cubemap is synthesized from the recorded main light and ambient SH.
+// Planes missing from a recorded frame stop tracking, and
+// ArFrame_getUpdatedTrackables() reports the planes that changed in a frame.
+// Augmented images and point clouds are not recorded and come back empty.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sets the recording opened by the next ArSession_create().  Defaults to the
+// ARCORE_REPLAY_FILE environment variable.
+void ArReplay_setRecordingPath(const char* path);
+
+// When enabled (the default) playback restarts at the first frame after the
+// last one, with timestamps continuing to increase.  Otherwise the last frame
+// is repeated.
+void ArReplay_setLoop(int32_t loop);
+
+// Number of frames in the session's recording.
+int64_t ArReplay_getFrameCount(const ArSession* session);
+
+// Frames played so far, counting loops.
+int64_t ArReplay_getFramesPlayed(const ArSession* session);
+
+// Calls into the ARCore C API since startup, across all sessions.
+uint64_t ArReplay_getApiCalls(void);
+
+// Planes of the current frame of the last updated session that are neither
+// stopped nor subsumed, which are the planes an app should be tracking.
+int32_t ArReplay_getActivePlaneCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // C_ARCORE_HELLO_AR_ARCORE_REPLAY_H_
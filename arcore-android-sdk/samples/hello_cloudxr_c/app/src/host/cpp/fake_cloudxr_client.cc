@@ -0,0 +1,453 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+// Link-compatible stand-in for the CloudXR 3.1 client library, see
+// fake_cloudxr_client.h.  Signatures follow CloudXRClient.h from the SDK
+// (CLOUDXR_INCLUDE); only the entry points used by the sample are provided.
+
+#include "fake_cloudxr_client.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "CloudXRClient.h"
+#include "CloudXRInputEvents.h"
+#include "CloudXRMatrixHelpers.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Frames waiting in the simulated network/decoder before the oldest is
+// dropped, roughly the depth of the real client's decode queue.
+constexpr size_t kMaxPendingFrames = 8;
+
+float EnvFloat(const char* name, float fallback) {
+  const char* value = getenv(name);
+  return value ? strtof(value, nullptr) : fallback;
+}
+
+uint32_t EnvUint(const char* name, uint32_t fallback) {
+  const char* value = getenv(name);
+  return value ? static_cast<uint32_t>(strtoul(value, nullptr, 10)) : fallback;
+}
+
+std::mutex g_config_mutex;
+bool g_config_set = false;
+cxrFakeConfig g_config;
+uint32_t g_connect_failures_left = 0;
+cxrFakeCounters g_counters = {};
+
+cxrFakeConfig CurrentConfig() {
+  std::lock_guard<std::mutex> lock(g_config_mutex);
+  if (!g_config_set) {
+    cxrFakeGetDefaultConfig(&g_config);
+    g_connect_failures_left = g_config.connectFailures;
+    g_config_set = true;
+  }
+  return g_config;
+}
+
+struct PendingFrame {
+  Clock::time_point rendered;
+  Clock::time_point arrival;
+  cxrMatrix34 pose;
+};
+
+class FakeReceiver {
+ public:
+  FakeReceiver(const cxrReceiverDesc& desc, const cxrFakeConfig& config)
+      : desc_(desc), config_(config), rng_(config.seed) {}
+
+  ~FakeReceiver() { Disconnect(); }
+
+  cxrError Connect() {
+    {
+      std::lock_guard<std::mutex> lock(g_config_mutex);
+      if (g_connect_failures_left > 0) {
+        g_connect_failures_left--;
+        return cxrError_Server_Handshake_Failed;
+      }
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (running_) return cxrError_Success;
+    // A disconnect forced from Latch() only stops the producer, join it
+    // before starting the next one.
+    if (producer_.joinable()) {
+      lock.unlock();
+      producer_.join();
+      lock.lock();
+    }
+
+    // Each connection starts with empty queues and statistics.
+    pending_.clear();
+    stats_window_start_ = Clock::now();
+    window_rendered_ = 0;
+    window_latched_ = 0;
+    latched_total_ = 0;
+    frames_dropped_ = 0;
+    delivery_ms_sum_ = 0.f;
+    queue_ms_sum_ = 0.f;
+    packets_received_ = 0;
+    packets_lost_ = 0;
+
+    running_ = true;
+    producer_ = std::thread(&FakeReceiver::Produce, this);
+    return cxrError_Success;
+  }
+
+  void Disconnect() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_ = false;
+    }
+    cv_.notify_all();
+    if (producer_.joinable()) producer_.join();
+  }
+
+  bool IsRunning() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+  }
+
+  cxrError Latch(cxrFramesLatched* latched, uint32_t timeout_ms) {
+    const Clock::time_point deadline =
+        Clock::now() + std::chrono::milliseconds(timeout_ms);
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      if (!running_) return cxrError_Receiver_Not_Running;
+      const Clock::time_point now = Clock::now();
+      if (!pending_.empty() && pending_.front().arrival <= now) break;
+      if (now >= deadline) {
+        Count(&cxrFakeCounters::latchTimeouts);
+        return cxrError_Frame_Not_Ready;
+      }
+      Clock::time_point wake = deadline;
+      if (!pending_.empty()) wake = std::min(wake, pending_.front().arrival);
+      cv_.wait_until(lock, wake);
+    }
+
+    // Latch the newest frame that has arrived, like a client that is behind.
+    const Clock::time_point now = Clock::now();
+    PendingFrame frame = pending_.front();
+    pending_.pop_front();
+    while (!pending_.empty() && pending_.front().arrival <= now) {
+      frame = pending_.front();
+      pending_.pop_front();
+      Count(&cxrFakeCounters::framesSkipped);
+    }
+
+    memset(latched, 0, sizeof(*latched));
+    latched->count = desc_.numStreams;
+    for (uint32_t i = 0; i < desc_.numStreams; ++i) {
+      latched->frames[i].widthFinal = desc_.deviceDesc.width;
+      latched->frames[i].heightFinal = desc_.deviceDesc.height;
+    }
+    latched->poseMatrix = frame.pose;
+
+    delivery_ms_sum_ += std::chrono::duration<float, std::milli>(
+                            frame.arrival - frame.rendered).count();
+    queue_ms_sum_ +=
+        std::chrono::duration<float, std::milli>(now - frame.arrival).count();
+    window_latched_++;
+    latched_total_++;
+    Count(&cxrFakeCounters::framesLatched);
+
+    if (config_.disconnectAfterFrames != 0 &&
+        latched_total_ >= config_.disconnectAfterFrames) {
+      // Simulate the server going away; the frame in hand is still valid.
+      running_ = false;
+      pending_.clear();
+    }
+    return cxrError_Success;
+  }
+
+  void GetStats(cxrConnectionStats* stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Clock::time_point now = Clock::now();
+    const float window_s =
+        std::chrono::duration<float>(now - stats_window_start_).count();
+
+    const uint32_t packets = static_cast<uint32_t>(
+        window_rendered_ * config_.packetsPerFrame);
+    const uint32_t lost = static_cast<uint32_t>(packets * config_.packetLossRate);
+    packets_received_ += packets - lost;
+    packets_lost_ += lost;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->framesPerSecond = window_s > 0.f ? window_latched_ / window_s : 0.f;
+    if (window_latched_ > 0) {
+      stats->frameDeliveryTimeMs = delivery_ms_sum_ / window_latched_;
+      stats->frameQueueTimeMs = queue_ms_sum_ / window_latched_;
+    }
+    stats->bandwidthAvailableKbps = config_.bandwidthKbps;
+    stats->bandwidthUtilizationKbps = static_cast<uint32_t>(
+        config_.bandwidthKbps * std::min(1.f, config_.frameRateHz / 90.f));
+    stats->bandwidthUtilizationPercent =
+        config_.bandwidthKbps
+            ? 100 * stats->bandwidthUtilizationKbps / config_.bandwidthKbps
+            : 0;
+    stats->roundTripDelayMs = config_.roundTripDelayMs;
+    stats->jitterUs = config_.jitterUs;
+    stats->totalPacketsReceived = packets_received_;
+    stats->totalPacketsLost = packets_lost_;
+    stats->totalPacketsDropped = static_cast<uint32_t>(
+        frames_dropped_ * config_.packetsPerFrame);
+
+    // Same thresholds the client uses to explain quality to the user.
+    uint32_t reasons = 0;
+    if (config_.roundTripDelayMs > 80) reasons |= cxrConnectionQualityReason_HighLatency;
+    if (config_.bandwidthKbps < 10000) reasons |= cxrConnectionQualityReason_LowBandwidth;
+    if (config_.packetLossRate > 0.01f) reasons |= cxrConnectionQualityReason_HighPacketLoss;
+    stats->qualityReasons = reasons;
+    const int issues = !!(reasons & cxrConnectionQualityReason_HighLatency) +
+                       !!(reasons & cxrConnectionQualityReason_LowBandwidth) +
+                       !!(reasons & cxrConnectionQualityReason_HighPacketLoss);
+    stats->quality = issues == 0   ? cxrConnectionQuality_Excellent
+                     : issues == 1 ? cxrConnectionQuality_Fair
+                                   : cxrConnectionQuality_Bad;
+
+    stats_window_start_ = now;
+    window_rendered_ = 0;
+    window_latched_ = 0;
+    delivery_ms_sum_ = 0.f;
+    queue_ms_sum_ = 0.f;
+  }
+
+  static void Count(uint64_t cxrFakeCounters::*counter) {
+    std::lock_guard<std::mutex> lock(g_config_mutex);
+    g_counters.*counter += 1;
+  }
+
+ private:
+  // Stands in for the server: samples the client pose at render time, then
+  // schedules the frame's arrival after the simulated network latency.
+  void Produce() {
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float>(1.f / std::max(config_.frameRateHz, 1.f)));
+    std::normal_distribution<float> latency(config_.latencyMeanMs,
+                                            config_.latencyStddevMs);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    Clock::time_point next = Clock::now();
+    Clock::time_point last_arrival = next;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+      if (cv_.wait_until(lock, next, [this] { return !running_; })) break;
+      next += period;
+
+      PendingFrame frame;
+      frame.rendered = Clock::now();
+      cxrMatrix34 identity = {{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}}};
+      frame.pose = identity;
+      if (config_.echoPose && desc_.clientCallbacks.GetTrackingState) {
+        // Call out without the lock, the client takes its own.
+        lock.unlock();
+        cxrVRTrackingState state = {};
+        desc_.clientCallbacks.GetTrackingState(desc_.clientContext, &state);
+        cxrVecQuatToMatrix(&state.hmd.pose.position, &state.hmd.pose.rotation,
+                           &frame.pose);
+        lock.lock();
+        if (!running_) break;
+      }
+      window_rendered_++;
+      Count(&cxrFakeCounters::framesRendered);
+
+      if (unit(rng_) < config_.frameLossRate) {
+        frames_dropped_++;
+        Count(&cxrFakeCounters::framesLost);
+        continue;
+      }
+
+      float delay_ms = std::max(0.f, latency(rng_));
+      if (unit(rng_) < config_.latencySpikeRate) delay_ms += config_.latencySpikeMs;
+      // Frames are delivered in order, a late frame holds back the next ones.
+      frame.arrival = std::max(
+          last_arrival, frame.rendered + std::chrono::duration_cast<Clock::duration>(
+                                             std::chrono::duration<float, std::milli>(delay_ms)));
+      last_arrival = frame.arrival;
+
+      if (pending_.size() >= kMaxPendingFrames) {
+        pending_.pop_front();
+        frames_dropped_++;
+        Count(&cxrFakeCounters::framesSkipped);
+      }
+      pending_.push_back(frame);
+      cv_.notify_all();
+    }
+  }
+
+  const cxrReceiverDesc desc_;
+  const cxrFakeConfig config_;
+  std::mt19937 rng_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread producer_;
+  bool running_ = false;
+  std::deque<PendingFrame> pending_;
+
+  Clock::time_point stats_window_start_;
+  uint64_t window_rendered_ = 0;
+  uint64_t window_latched_ = 0;
+  uint64_t latched_total_ = 0;
+  uint64_t frames_dropped_ = 0;
+  float delivery_ms_sum_ = 0.f;
+  float queue_ms_sum_ = 0.f;
+  uint32_t packets_received_ = 0;
+  uint32_t packets_lost_ = 0;
+};
+
+FakeReceiver* FromHandle(cxrReceiverHandle receiver) {
+  return reinterpret_cast<FakeReceiver*>(receiver);
+}
+
+}  // namespace
+
+void cxrFakeGetDefaultConfig(cxrFakeConfig* config) {
+  config->frameRateHz = EnvFloat("CXR_FAKE_FPS", 60.f);
+  config->latencyMeanMs = EnvFloat("CXR_FAKE_LATENCY_MS", 30.f);
+  config->latencyStddevMs = EnvFloat("CXR_FAKE_LATENCY_STDDEV_MS", 4.f);
+  config->latencySpikeRate = EnvFloat("CXR_FAKE_SPIKE_RATE", 0.f);
+  config->latencySpikeMs = EnvFloat("CXR_FAKE_SPIKE_MS", 100.f);
+  config->frameLossRate = EnvFloat("CXR_FAKE_FRAME_LOSS", 0.f);
+  config->packetLossRate = EnvFloat("CXR_FAKE_PACKET_LOSS", 0.f);
+  config->packetsPerFrame = EnvUint("CXR_FAKE_PACKETS_PER_FRAME", 64);
+  config->bandwidthKbps = EnvUint("CXR_FAKE_BANDWIDTH_KBPS", 50000);
+  config->roundTripDelayMs = EnvUint("CXR_FAKE_RTT_MS", 20);
+  config->jitterUs = EnvUint("CXR_FAKE_JITTER_US", 500);
+  config->echoPose = EnvUint("CXR_FAKE_ECHO_POSE", 1);
+  config->connectFailures = EnvUint("CXR_FAKE_CONNECT_FAILURES", 0);
+  config->disconnectAfterFrames = EnvUint("CXR_FAKE_DISCONNECT_AFTER", 0);
+  config->seed = EnvUint("CXR_FAKE_SEED", 1);
+}
+
+void cxrFakeSetConfig(const cxrFakeConfig* config) {
+  std::lock_guard<std::mutex> lock(g_config_mutex);
+  g_config = *config;
+  g_connect_failures_left = config->connectFailures;
+  g_config_set = true;
+}
+
+void cxrFakeGetCounters(cxrFakeCounters* counters) {
+  std::lock_guard<std::mutex> lock(g_config_mutex);
+  *counters = g_counters;
+}
+
+const char* cxrErrorString(cxrError E) {
+  switch (E) {
+    case cxrError_Success: return "Success";
+    case cxrError_Frame_Not_Ready: return "Frame not ready";
+    case cxrError_Receiver_Not_Running: return "Receiver not running";
+    case cxrError_Required_Parameter: return "Required parameter missing";
+    case cxrError_Server_Handshake_Failed: return "Server handshake failed";
+    default: return "Error";
+  }
+}
+
+cxrError cxrCreateReceiver(const cxrReceiverDesc* description,
+                           cxrReceiverHandle* receiver) {
+  if (!description || !receiver) return cxrError_Required_Parameter;
+  const cxrFakeConfig config = CurrentConfig();
+  {
+    std::lock_guard<std::mutex> lock(g_config_mutex);
+    g_counters = {};
+  }
+  *receiver = reinterpret_cast<cxrReceiverHandle>(
+      new FakeReceiver(*description, config));
+  return cxrError_Success;
+}
+
+cxrError cxrConnect(cxrReceiverHandle receiver, const char* serverAddr,
+                    cxrConnectionDesc* description) {
+  if (!receiver || !serverAddr) return cxrError_Required_Parameter;
+  (void)description;
+  return FromHandle(receiver)->Connect();
+}
+
+void cxrDestroyReceiver(cxrReceiverHandle receiver) {
+  delete FromHandle(receiver);
+}
+
+cxrError cxrLatchFrame(cxrReceiverHandle receiver,
+                       cxrFramesLatched* framesLatched, uint32_t frameMask,
+                       uint32_t timeoutMs) {
+  if (!receiver || !framesLatched) return cxrError_Required_Parameter;
+  (void)frameMask;
+  return FromHandle(receiver)->Latch(framesLatched, timeoutMs);
+}
+
+void cxrBlitFrame(cxrReceiverHandle receiver, cxrFramesLatched* framesLatched,
+                  uint32_t frameMask) {
+  // No GL on the host; only account for the call.
+  (void)receiver;
+  (void)framesLatched;
+  (void)frameMask;
+  FakeReceiver::Count(&cxrFakeCounters::framesBlitted);
+}
+
+void cxrReleaseFrame(cxrReceiverHandle receiver,
+                     cxrFramesLatched* framesLatched) {
+  (void)receiver;
+  if (framesLatched) memset(framesLatched, 0, sizeof(*framesLatched));
+}
+
+cxrError cxrGetConnectionStats(cxrReceiverHandle receiver,
+                               cxrConnectionStats* stats) {
+  if (!receiver || !stats) return cxrError_Required_Parameter;
+  FakeReceiver* fake = FromHandle(receiver);
+  if (!fake->IsRunning()) return cxrError_Receiver_Not_Running;
+  fake->GetStats(stats);
+  return cxrError_Success;
+}
+
+cxrError cxrSendAudio(cxrReceiverHandle receiver,
+                      const cxrAudioFrame* audioFrame) {
+  if (!receiver || !audioFrame) return cxrError_Required_Parameter;
+  if (!FromHandle(receiver)->IsRunning()) return cxrError_Receiver_Not_Running;
+  FakeReceiver::Count(&cxrFakeCounters::audioFramesSent);
+  return cxrError_Success;
+}
+
+cxrError cxrSendLightProperties(cxrReceiverHandle receiver,
+                                const cxrLightProperties* lightProps) {
+  if (!receiver || !lightProps) return cxrError_Required_Parameter;
+  if (!FromHandle(receiver)->IsRunning()) return cxrError_Receiver_Not_Running;
+  FakeReceiver::Count(&cxrFakeCounters::lightUpdates);
+  return cxrError_Success;
+}
+
+cxrError cxrSendInputEvent(cxrReceiverHandle receiver,
+                           const cxrInputEvent* inputEvent) {
+  if (!receiver || !inputEvent) return cxrError_Required_Parameter;
+  if (!FromHandle(receiver)->IsRunning()) return cxrError_Receiver_Not_Running;
+  FakeReceiver::Count(&cxrFakeCounters::inputEvents);
+  return cxrError_Success;
+}
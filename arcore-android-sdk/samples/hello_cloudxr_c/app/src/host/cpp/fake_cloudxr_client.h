@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#ifndef C_ARCORE_HELLO_AR_FAKE_CLOUDXR_CLIENT_H_
+#define C_ARCORE_HELLO_AR_FAKE_CLOUDXR_CLIENT_H_
+
+#include <stdint.h>
+
+// Host-side stand-in for libCloudXRClient.so.  It implements the receiver
+// entry points the client uses (create/connect/latch/blit/release/stats/send)
+// without a server or GPU: a producer thread "renders" frames at a fixed rate
+// with the pose returned by the client's GetTrackingState callback, and each
+// frame becomes latchable after a simulated network latency.  Link it in place
+// of the real library to benchmark latch policies, pose correlation and
+// reconnect handling on a workstation.
+//
+// The defaults can be overridden without recompiling through the environment
+// variables listed next to each field, or in-process with cxrFakeSetConfig().
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct cxrFakeConfig {
+  float frameRateHz;            // CXR_FAKE_FPS, default 60.
+  float latencyMeanMs;          // CXR_FAKE_LATENCY_MS, default 30.
+  float latencyStddevMs;        // CXR_FAKE_LATENCY_STDDEV_MS, default 4.
+  float latencySpikeRate;       // CXR_FAKE_SPIKE_RATE, fraction of frames, default 0.
+  float latencySpikeMs;         // CXR_FAKE_SPIKE_MS, added on a spike, default 100.
+  float frameLossRate;          // CXR_FAKE_FRAME_LOSS, fraction never delivered, default 0.
+  float packetLossRate;         // CXR_FAKE_PACKET_LOSS, fraction reported lost, default 0.
+  uint32_t packetsPerFrame;     // CXR_FAKE_PACKETS_PER_FRAME, default 64.
+  uint32_t bandwidthKbps;       // CXR_FAKE_BANDWIDTH_KBPS, default 50000.
+  uint32_t roundTripDelayMs;    // CXR_FAKE_RTT_MS, default 20.
+  uint32_t jitterUs;            // CXR_FAKE_JITTER_US, default 500.
+  uint32_t echoPose;            // CXR_FAKE_ECHO_POSE, 0 latches an identity pose, default 1.
+  uint32_t connectFailures;     // CXR_FAKE_CONNECT_FAILURES, cxrConnect calls that fail first, default 0.
+  uint32_t disconnectAfterFrames;  // CXR_FAKE_DISCONNECT_AFTER, frames latched per connection, 0 never disconnects.
+  uint32_t seed;                // CXR_FAKE_SEED, default 1.
+} cxrFakeConfig;
+
+// Fills |config| with the defaults, including any environment overrides.
+void cxrFakeGetDefaultConfig(cxrFakeConfig* config);
+
+// Replaces the configuration used by receivers created after this call.
+// Resets the remaining connection failure count.
+void cxrFakeSetConfig(const cxrFakeConfig* config);
+
+// Counters for the most recently created receiver, for assertions in
+// benchmarks.
+typedef struct cxrFakeCounters {
+  uint64_t framesRendered;
+  uint64_t framesLost;
+  uint64_t framesLatched;
+  uint64_t framesSkipped;   // arrived but superseded before being latched
+  uint64_t latchTimeouts;
+  uint64_t framesBlitted;
+  uint64_t inputEvents;
+  uint64_t audioFramesSent;
+  uint64_t lightUpdates;
+} cxrFakeCounters;
+
+void cxrFakeGetCounters(cxrFakeCounters* counters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // C_ARCORE_HELLO_AR_FAKE_CLOUDXR_CLIENT_H_
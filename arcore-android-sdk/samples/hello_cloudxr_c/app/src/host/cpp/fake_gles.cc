@@ -0,0 +1,1254 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "fake_gles.h"
+
+// Declares the GL_OES_get_program_binary and GL_EXT_disjoint_timer_query
+// entry points defined below.
+#define GL_GLEXT_PROTOTYPES
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+#define FAKE_GL_ENTRY_POINTS(X) \
+  X(ActiveTexture) \
+  X(AttachShader) \
+  X(BeginQueryEXT) \
+  X(BindAttribLocation) \
+  X(BindBuffer) \
+  X(BindFramebuffer) \
+  X(BindRenderbuffer) \
+  X(BindTexture) \
+  X(BlendColor) \
+  X(BlendEquation) \
+  X(BlendEquationSeparate) \
+  X(BlendFunc) \
+  X(BlendFuncSeparate) \
+  X(BufferData) \
+  X(BufferSubData) \
+  X(CheckFramebufferStatus) \
+  X(Clear) \
+  X(ClearColor) \
+  X(ClearDepthf) \
+  X(ClearStencil) \
+  X(ColorMask) \
+  X(CompileShader) \
+  X(CompressedTexImage2D) \
+  X(CompressedTexSubImage2D) \
+  X(CopyTexImage2D) \
+  X(CopyTexSubImage2D) \
+  X(CreateProgram) \
+  X(CreateShader) \
+  X(CullFace) \
+  X(DeleteBuffers) \
+  X(DeleteFramebuffers) \
+  X(DeleteProgram) \
+  X(DeleteQueriesEXT) \
+  X(DeleteRenderbuffers) \
+  X(DeleteShader) \
+  X(DeleteTextures) \
+  X(DepthFunc) \
+  X(DepthMask) \
+  X(DepthRangef) \
+  X(DetachShader) \
+  X(Disable) \
+  X(DisableVertexAttribArray) \
+  X(DrawArrays) \
+  X(DrawElements) \
+  X(Enable) \
+  X(EnableVertexAttribArray) \
+  X(EndQueryEXT) \
+  X(Finish) \
+  X(Flush) \
+  X(FramebufferRenderbuffer) \
+  X(FramebufferTexture2D) \
+  X(FrontFace) \
+  X(GenBuffers) \
+  X(GenerateMipmap) \
+  X(GenFramebuffers) \
+  X(GenQueriesEXT) \
+  X(GenRenderbuffers) \
+  X(GenTextures) \
+  X(GetActiveAttrib) \
+  X(GetActiveUniform) \
+  X(GetAttachedShaders) \
+  X(GetAttribLocation) \
+  X(GetBooleanv) \
+  X(GetBufferParameteriv) \
+  X(GetError) \
+  X(GetFloatv) \
+  X(GetFramebufferAttachmentParameteriv) \
+  X(GetIntegerv) \
+  X(GetProgramBinaryOES) \
+  X(GetProgramiv) \
+  X(GetProgramInfoLog) \
+  X(GetQueryObjectui64vEXT) \
+  X(GetQueryObjectuivEXT) \
+  X(GetRenderbufferParameteriv) \
+  X(GetShaderiv) \
+  X(GetShaderInfoLog) \
+  X(GetShaderPrecisionFormat) \
+  X(GetShaderSource) \
+  X(GetString) \
+  X(GetTexParameterfv) \
+  X(GetTexParameteriv) \
+  X(GetUniformfv) \
+  X(GetUniformiv) \
+  X(GetUniformLocation) \
+  X(GetVertexAttribfv) \
+  X(GetVertexAttribiv) \
+  X(GetVertexAttribPointerv) \
+  X(Hint) \
+  X(IsBuffer) \
+  X(IsEnabled) \
+  X(IsFramebuffer) \
+  X(IsProgram) \
+  X(IsRenderbuffer) \
+  X(IsShader) \
+  X(IsTexture) \
+  X(LineWidth) \
+  X(LinkProgram) \
+  X(PixelStorei) \
+  X(PolygonOffset) \
+  X(ProgramBinaryOES) \
+  X(ReadPixels) \
+  X(ReleaseShaderCompiler) \
+  X(RenderbufferStorage) \
+  X(SampleCoverage) \
+  X(Scissor) \
+  X(ShaderBinary) \
+  X(ShaderSource) \
+  X(StencilFunc) \
+  X(StencilFuncSeparate) \
+  X(StencilMask) \
+  X(StencilMaskSeparate) \
+  X(StencilOp) \
+  X(StencilOpSeparate) \
+  X(TexImage2D) \
+  X(TexParameterf) \
+  X(TexParameterfv) \
+  X(TexParameteri) \
+  X(TexParameteriv) \
+  X(TexSubImage2D) \
+  X(Uniform1f) \
+  X(Uniform1fv) \
+  X(Uniform1i) \
+  X(Uniform1iv) \
+  X(Uniform2f) \
+  X(Uniform2fv) \
+  X(Uniform2i) \
+  X(Uniform2iv) \
+  X(Uniform3f) \
+  X(Uniform3fv) \
+  X(Uniform3i) \
+  X(Uniform3iv) \
+  X(Uniform4f) \
+  X(Uniform4fv) \
+  X(Uniform4i) \
+  X(Uniform4iv) \
+  X(UniformMatrix2fv) \
+  X(UniformMatrix3fv) \
+  X(UniformMatrix4fv) \
+  X(UseProgram) \
+  X(ValidateProgram) \
+  X(VertexAttrib1f) \
+  X(VertexAttrib1fv) \
+  X(VertexAttrib2f) \
+  X(VertexAttrib2fv) \
+  X(VertexAttrib3f) \
+  X(VertexAttrib3fv) \
+  X(VertexAttrib4f) \
+  X(VertexAttrib4fv) \
+  X(VertexAttribPointer) \
+  X(Viewport)
+
+enum EntryPoint {
+#define FAKE_GL_ENUM(name) k##name,
+  FAKE_GL_ENTRY_POINTS(FAKE_GL_ENUM)
+#undef FAKE_GL_ENUM
+  kNumEntryPoints
+};
+
+constexpr const char* kEntryPointNames[kNumEntryPoints] = {
+#define FAKE_GL_NAME(name) "gl" #name,
+    FAKE_GL_ENTRY_POINTS(FAKE_GL_NAME)
+#undef FAKE_GL_NAME
+};
+
+constexpr int kMaxTextureUnits = 32;
+constexpr int kMaxTextureLevels = 16;
+constexpr int kCubeFaces = 6;
+// GPU time charged per draw call by the timer queries.
+constexpr uint64_t kDrawCallNs = 10000;
+
+enum TextureTarget { kTexture2D, kTextureCubeMap, kTextureExternal,
+                     kNumTextureTargets };
+
+// Storage specified for a texture, per face and mip level.
+struct TextureMemory {
+  uint64_t level_bytes[kCubeFaces][kMaxTextureLevels];
+  // Level 0 of each face, for glGenerateMipmap().  0 bytes per texel if the
+  // level is compressed.
+  GLsizei width[kCubeFaces];
+  GLsizei height[kCubeFaces];
+  uint32_t bytes_per_texel[kCubeFaces];
+};
+
+// GL is only called from the render thread, like on the device.
+struct State {
+  FakeGlCounters counters;
+  uint64_t entry_point_calls[kNumEntryPoints];
+  GLuint next_name;
+  GLint next_location;
+  // Programs whose glProgramBinaryOES() was given a foreign binary.
+  std::unordered_set<GLuint> unlinked_programs;
+
+  // Bindings and storage of the live objects, for FakeGl_getMemory().
+  FakeGlMemory memory;
+  int active_texture_unit;
+  GLuint bound_textures[kMaxTextureUnits][kNumTextureTargets];
+  GLuint array_buffer;
+  GLuint element_array_buffer;
+  GLuint renderbuffer;
+  std::unordered_map<GLuint, TextureMemory> textures;
+  std::unordered_map<GLuint, uint64_t> buffers;
+  std::unordered_map<GLuint, uint64_t> renderbuffers;
+
+  // The GL_TIME_ELAPSED_EXT query begun, the draw calls when it was, and the
+  // results of the ended queries.
+  GLuint active_query;
+  uint64_t active_query_draw_calls;
+  std::unordered_map<GLuint, uint64_t> query_elapsed_ns;
+} g_state = {{}, {}, 1, 0, {}};
+
+// The program binary handed out by glGetProgramBinaryOES(), accepted back by
+// glProgramBinaryOES().
+constexpr GLenum kProgramBinaryFormat = 0x4641;
+constexpr char kProgramBinary[] = "fake program binary";
+
+inline void Count(EntryPoint entry_point) {
+  g_state.counters.calls++;
+  g_state.entry_point_calls[entry_point]++;
+}
+
+void GenNames(GLsizei n, GLuint* names) {
+  for (GLsizei i = 0; i < n; ++i) names[i] = g_state.next_name++;
+}
+
+uint32_t BytesPerPixel(GLenum format, GLenum type) {
+  if (type == GL_UNSIGNED_SHORT_5_6_5 || type == GL_UNSIGNED_SHORT_4_4_4_4 ||
+      type == GL_UNSIGNED_SHORT_5_5_5_1) {
+    return 2;
+  }
+  switch (format) {
+    case GL_RGBA: return 4;
+    case GL_RGB: return 3;
+    case GL_LUMINANCE_ALPHA: return 2;
+    default: return 1;
+  }
+}
+
+uint32_t RenderbufferBytesPerPixel(GLenum internalformat) {
+  switch (internalformat) {
+    case GL_RGBA4:
+    case GL_RGB5_A1:
+    case GL_RGB565:
+    case GL_DEPTH_COMPONENT16: return 2;
+    case GL_STENCIL_INDEX8: return 1;
+    default: return 4;
+  }
+}
+
+// The binding of the texture |target| on the active unit, and the cube map
+// face it addresses in |face|.
+GLuint* BoundTexture(GLenum target, int* face) {
+  GLuint* bindings = g_state.bound_textures[g_state.active_texture_unit];
+  *face = 0;
+  switch (target) {
+    case GL_TEXTURE_2D: return &bindings[kTexture2D];
+    case GL_TEXTURE_CUBE_MAP: return &bindings[kTextureCubeMap];
+    case GL_TEXTURE_EXTERNAL_OES: return &bindings[kTextureExternal];
+    default:
+      if (target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X &&
+          target < GL_TEXTURE_CUBE_MAP_POSITIVE_X + kCubeFaces) {
+        *face = target - GL_TEXTURE_CUBE_MAP_POSITIVE_X;
+        return &bindings[kTextureCubeMap];
+      }
+      return nullptr;
+  }
+}
+
+void SetLevelBytes(TextureMemory* texture, int face, int level,
+                   uint64_t bytes) {
+  g_state.memory.texture_bytes += bytes - texture->level_bytes[face][level];
+  texture->level_bytes[face][level] = bytes;
+}
+
+// Records the storage of |level| of the texture bound to |target|.
+void SpecifyTextureLevel(GLenum target, GLint level, GLsizei width,
+                         GLsizei height, uint32_t bytes_per_texel,
+                         uint64_t bytes) {
+  int face;
+  const GLuint* name = BoundTexture(target, &face);
+  if (!name || *name == 0 || level < 0 || level >= kMaxTextureLevels) return;
+  TextureMemory& texture = g_state.textures[*name];
+  SetLevelBytes(&texture, face, level, bytes);
+  if (level == 0) {
+    texture.width[face] = width;
+    texture.height[face] = height;
+    texture.bytes_per_texel[face] = bytes_per_texel;
+  }
+}
+
+void SetBufferBytes(std::unordered_map<GLuint, uint64_t>* objects, GLuint name,
+                    uint64_t bytes, uint64_t* total) {
+  if (name == 0) return;
+  uint64_t& object_bytes = (*objects)[name];
+  *total += bytes - object_bytes;
+  object_bytes = bytes;
+}
+
+void DeleteObjects(std::unordered_map<GLuint, uint64_t>* objects, GLsizei n,
+                   const GLuint* names, uint64_t* total) {
+  for (GLsizei i = 0; i < n; ++i) {
+    auto it = objects->find(names[i]);
+    if (it == objects->end()) continue;
+    *total -= it->second;
+    objects->erase(it);
+  }
+}
+
+}  // namespace
+
+extern "C" {
+
+void FakeGl_getCounters(FakeGlCounters* counters) {
+  *counters = g_state.counters;
+}
+
+void FakeGl_getMemory(FakeGlMemory* memory) { *memory = g_state.memory; }
+
+void FakeGl_loseContext(void) {
+  g_state.memory = {};
+  g_state.active_texture_unit = 0;
+  memset(g_state.bound_textures, 0, sizeof(g_state.bound_textures));
+  g_state.array_buffer = 0;
+  g_state.element_array_buffer = 0;
+  g_state.renderbuffer = 0;
+  g_state.textures.clear();
+  g_state.buffers.clear();
+  g_state.renderbuffers.clear();
+  g_state.unlinked_programs.clear();
+  g_state.active_query = 0;
+  g_state.query_elapsed_ns.clear();
+}
+
+void FakeGl_resetCounters(void) {
+  memset(&g_state.counters, 0, sizeof(g_state.counters));
+  memset(g_state.entry_point_calls, 0, sizeof(g_state.entry_point_calls));
+}
+
+int FakeGl_getEntryPointCount(void) { return kNumEntryPoints; }
+
+const char* FakeGl_getEntryPointName(int index) {
+  return kEntryPointNames[index];
+}
+
+uint64_t FakeGl_getEntryPointCalls(int index) {
+  return g_state.entry_point_calls[index];
+}
+
+// EGL, the client passes the current context on to CloudXR and looks up the
+// extension entry points.
+
+EGLDisplay EGLAPIENTRY eglGetCurrentDisplay(void) { return EGL_NO_DISPLAY; }
+
+EGLContext EGLAPIENTRY eglGetCurrentContext(void) { return EGL_NO_CONTEXT; }
+
+__eglMustCastToProperFunctionPointerType EGLAPIENTRY
+eglGetProcAddress(const char* procname) {
+#define FAKE_GL_PROC(name)                                              \
+  if (strcmp(procname, #name) == 0) {                                   \
+    return reinterpret_cast<__eglMustCastToProperFunctionPointerType>( \
+        name);                                                          \
+  }
+  FAKE_GL_PROC(glGetProgramBinaryOES)
+  FAKE_GL_PROC(glProgramBinaryOES)
+  FAKE_GL_PROC(glBeginQueryEXT)
+  FAKE_GL_PROC(glDeleteQueriesEXT)
+  FAKE_GL_PROC(glEndQueryEXT)
+  FAKE_GL_PROC(glGenQueriesEXT)
+  FAKE_GL_PROC(glGetQueryObjectui64vEXT)
+  FAKE_GL_PROC(glGetQueryObjectuivEXT)
+#undef FAKE_GL_PROC
+  return nullptr;
+}
+
+// OpenGL ES 2.0.
+
+void GL_APIENTRY glActiveTexture(GLenum texture) {
+  Count(kActiveTexture);
+  const int unit = texture - GL_TEXTURE0;
+  if (unit >= 0 && unit < kMaxTextureUnits) g_state.active_texture_unit = unit;
+}
+
+void GL_APIENTRY glAttachShader(GLuint program, GLuint shader) {
+  Count(kAttachShader);
+}
+
+void GL_APIENTRY glBindAttribLocation(GLuint program, GLuint index,
+                                      const GLchar* name) {
+  Count(kBindAttribLocation);
+}
+
+void GL_APIENTRY glBindBuffer(GLenum target, GLuint buffer) {
+  Count(kBindBuffer);
+  if (target == GL_ARRAY_BUFFER) g_state.array_buffer = buffer;
+  if (target == GL_ELEMENT_ARRAY_BUFFER) g_state.element_array_buffer = buffer;
+}
+
+void GL_APIENTRY glBindFramebuffer(GLenum target, GLuint framebuffer) {
+  Count(kBindFramebuffer);
+}
+
+void GL_APIENTRY glBindRenderbuffer(GLenum target, GLuint renderbuffer) {
+  Count(kBindRenderbuffer);
+  g_state.renderbuffer = renderbuffer;
+}
+
+void GL_APIENTRY glBindTexture(GLenum target, GLuint texture) {
+  Count(kBindTexture);
+  int face;
+  GLuint* binding = BoundTexture(target, &face);
+  if (binding) *binding = texture;
+}
+
+void GL_APIENTRY glBlendColor(GLfloat red, GLfloat green, GLfloat blue,
+                              GLfloat alpha) {
+  Count(kBlendColor);
+}
+
+void GL_APIENTRY glBlendEquation(GLenum mode) {
+  Count(kBlendEquation);
+}
+
+void GL_APIENTRY glBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha) {
+  Count(kBlendEquationSeparate);
+}
+
+void GL_APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor) {
+  Count(kBlendFunc);
+}
+
+void GL_APIENTRY glBlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB,
+                                     GLenum sfactorAlpha, GLenum dfactorAlpha) {
+  Count(kBlendFuncSeparate);
+}
+
+void GL_APIENTRY glBufferData(GLenum target, GLsizeiptr size, const void* data,
+                              GLenum usage) {
+  Count(kBufferData);
+  g_state.counters.buffer_upload_bytes += size;
+  SetBufferBytes(&g_state.buffers,
+                 target == GL_ELEMENT_ARRAY_BUFFER ? g_state.element_array_buffer
+                                                   : g_state.array_buffer,
+                 size, &g_state.memory.buffer_bytes);
+}
+
+void GL_APIENTRY glBufferSubData(GLenum target, GLintptr offset,
+                                 GLsizeiptr size, const void* data) {
+  Count(kBufferSubData);
+  g_state.counters.buffer_upload_bytes += size;
+}
+
+GLenum GL_APIENTRY glCheckFramebufferStatus(GLenum target) {
+  Count(kCheckFramebufferStatus);
+  return GL_FRAMEBUFFER_COMPLETE;
+}
+
+void GL_APIENTRY glClear(GLbitfield mask) {
+  Count(kClear);
+}
+
+void GL_APIENTRY glClearColor(GLfloat red, GLfloat green, GLfloat blue,
+                              GLfloat alpha) {
+  Count(kClearColor);
+}
+
+void GL_APIENTRY glClearDepthf(GLfloat d) {
+  Count(kClearDepthf);
+}
+
+void GL_APIENTRY glClearStencil(GLint s) {
+  Count(kClearStencil);
+}
+
+void GL_APIENTRY glColorMask(GLboolean red, GLboolean green, GLboolean blue,
+                             GLboolean alpha) {
+  Count(kColorMask);
+}
+
+void GL_APIENTRY glCompileShader(GLuint shader) {
+  Count(kCompileShader);
+  g_state.counters.shader_compiles++;
+}
+
+void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level,
+                                        GLenum internalformat, GLsizei width,
+                                        GLsizei height, GLint border,
+                                        GLsizei imageSize, const void* data) {
+  Count(kCompressedTexImage2D);
+  g_state.counters.texture_upload_bytes += imageSize;
+  SpecifyTextureLevel(target, level, width, height, 0, imageSize);
+}
+
+void GL_APIENTRY glCompressedTexSubImage2D(
+    GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width,
+    GLsizei height, GLenum format, GLsizei imageSize, const void* data) {
+  Count(kCompressedTexSubImage2D);
+  g_state.counters.texture_upload_bytes += imageSize;
+}
+
+void GL_APIENTRY glCopyTexImage2D(GLenum target, GLint level,
+                                  GLenum internalformat, GLint x, GLint y,
+                                  GLsizei width, GLsizei height, GLint border) {
+  Count(kCopyTexImage2D);
+  const uint32_t bytes_per_texel =
+      BytesPerPixel(internalformat, GL_UNSIGNED_BYTE);
+  SpecifyTextureLevel(target, level, width, height, bytes_per_texel,
+                      static_cast<uint64_t>(width) * height * bytes_per_texel);
+}
+
+void GL_APIENTRY glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset,
+                                     GLint yoffset, GLint x, GLint y,
+                                     GLsizei width, GLsizei height) {
+  Count(kCopyTexSubImage2D);
+}
+
+GLuint GL_APIENTRY glCreateProgram(void) {
+  Count(kCreateProgram);
+  return g_state.next_name++;
+}
+
+GLuint GL_APIENTRY glCreateShader(GLenum type) {
+  Count(kCreateShader);
+  return g_state.next_name++;
+}
+
+void GL_APIENTRY glCullFace(GLenum mode) {
+  Count(kCullFace);
+}
+
+void GL_APIENTRY glDeleteBuffers(GLsizei n, const GLuint* buffers) {
+  Count(kDeleteBuffers);
+  DeleteObjects(&g_state.buffers, n, buffers, &g_state.memory.buffer_bytes);
+}
+
+void GL_APIENTRY glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers) {
+  Count(kDeleteFramebuffers);
+}
+
+void GL_APIENTRY glDeleteProgram(GLuint program) {
+  Count(kDeleteProgram);
+}
+
+void GL_APIENTRY glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) {
+  Count(kDeleteRenderbuffers);
+  DeleteObjects(&g_state.renderbuffers, n, renderbuffers,
+                &g_state.memory.renderbuffer_bytes);
+}
+
+void GL_APIENTRY glDeleteShader(GLuint shader) {
+  Count(kDeleteShader);
+}
+
+void GL_APIENTRY glDeleteTextures(GLsizei n, const GLuint* textures) {
+  Count(kDeleteTextures);
+  for (GLsizei i = 0; i < n; ++i) {
+    auto it = g_state.textures.find(textures[i]);
+    if (it == g_state.textures.end()) continue;
+    for (int face = 0; face < kCubeFaces; ++face) {
+      for (int level = 0; level < kMaxTextureLevels; ++level) {
+        SetLevelBytes(&it->second, face, level, 0);
+      }
+    }
+    g_state.textures.erase(it);
+  }
+}
+
+void GL_APIENTRY glDepthFunc(GLenum func) {
+  Count(kDepthFunc);
+}
+
+void GL_APIENTRY glDepthMask(GLboolean flag) {
+  Count(kDepthMask);
+}
+
+void GL_APIENTRY glDepthRangef(GLfloat n, GLfloat f) {
+  Count(kDepthRangef);
+}
+
+void GL_APIENTRY glDetachShader(GLuint program, GLuint shader) {
+  Count(kDetachShader);
+}
+
+void GL_APIENTRY glDisable(GLenum cap) {
+  Count(kDisable);
+}
+
+void GL_APIENTRY glDisableVertexAttribArray(GLuint index) {
+  Count(kDisableVertexAttribArray);
+}
+
+void GL_APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count) {
+  Count(kDrawArrays);
+  g_state.counters.draw_calls++;
+}
+
+void GL_APIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type,
+                                const void* indices) {
+  Count(kDrawElements);
+  g_state.counters.draw_calls++;
+}
+
+void GL_APIENTRY glEnable(GLenum cap) {
+  Count(kEnable);
+}
+
+void GL_APIENTRY glEnableVertexAttribArray(GLuint index) {
+  Count(kEnableVertexAttribArray);
+}
+
+void GL_APIENTRY glFinish(void) {
+  Count(kFinish);
+}
+
+void GL_APIENTRY glFlush(void) {
+  Count(kFlush);
+}
+
+void GL_APIENTRY glFramebufferRenderbuffer(GLenum target, GLenum attachment,
+                                           GLenum renderbuffertarget,
+                                           GLuint renderbuffer) {
+  Count(kFramebufferRenderbuffer);
+}
+
+void GL_APIENTRY glFramebufferTexture2D(GLenum target, GLenum attachment,
+                                        GLenum textarget, GLuint texture,
+                                        GLint level) {
+  Count(kFramebufferTexture2D);
+}
+
+void GL_APIENTRY glFrontFace(GLenum mode) {
+  Count(kFrontFace);
+}
+
+void GL_APIENTRY glGenBuffers(GLsizei n, GLuint* buffers) {
+  Count(kGenBuffers);
+  GenNames(n, buffers);
+}
+
+void GL_APIENTRY glGenerateMipmap(GLenum target) {
+  Count(kGenerateMipmap);
+  int face;
+  const GLuint* name = BoundTexture(target, &face);
+  if (!name) return;
+  auto it = g_state.textures.find(*name);
+  if (it == g_state.textures.end()) return;
+  TextureMemory& texture = it->second;
+  const int faces = target == GL_TEXTURE_CUBE_MAP ? kCubeFaces : 1;
+  for (face = 0; face < faces; ++face) {
+    // Compressed levels cannot be generated.
+    if (texture.bytes_per_texel[face] == 0) continue;
+    GLsizei width = texture.width[face];
+    GLsizei height = texture.height[face];
+    for (int level = 1; level < kMaxTextureLevels; ++level) {
+      uint64_t bytes = 0;
+      if (width > 1 || height > 1) {
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+        bytes = static_cast<uint64_t>(width) * height *
+                texture.bytes_per_texel[face];
+      }
+      SetLevelBytes(&texture, face, level, bytes);
+    }
+  }
+}
+
+void GL_APIENTRY glGenFramebuffers(GLsizei n, GLuint* framebuffers) {
+  Count(kGenFramebuffers);
+  GenNames(n, framebuffers);
+}
+
+void GL_APIENTRY glGenRenderbuffers(GLsizei n, GLuint* renderbuffers) {
+  Count(kGenRenderbuffers);
+  GenNames(n, renderbuffers);
+}
+
+void GL_APIENTRY glGenTextures(GLsizei n, GLuint* textures) {
+  Count(kGenTextures);
+  GenNames(n, textures);
+}
+
+void GL_APIENTRY glGetActiveAttrib(GLuint program, GLuint index,
+                                   GLsizei bufSize, GLsizei* length,
+                                   GLint* size, GLenum* type, GLchar* name) {
+  Count(kGetActiveAttrib);
+}
+
+void GL_APIENTRY glGetActiveUniform(GLuint program, GLuint index,
+                                    GLsizei bufSize, GLsizei* length,
+                                    GLint* size, GLenum* type, GLchar* name) {
+  Count(kGetActiveUniform);
+}
+
+void GL_APIENTRY glGetAttachedShaders(GLuint program, GLsizei maxCount,
+                                      GLsizei* count, GLuint* shaders) {
+  Count(kGetAttachedShaders);
+}
+
+GLint GL_APIENTRY glGetAttribLocation(GLuint program, const GLchar* name) {
+  Count(kGetAttribLocation);
+  return g_state.next_location++ % 16;
+}
+
+void GL_APIENTRY glGetBooleanv(GLenum pname, GLboolean* data) {
+  Count(kGetBooleanv);
+  *data = 0;
+}
+
+void GL_APIENTRY glGetBufferParameteriv(GLenum target, GLenum pname,
+                                        GLint* params) {
+  Count(kGetBufferParameteriv);
+  *params = 0;
+}
+
+GLenum GL_APIENTRY glGetError(void) {
+  Count(kGetError);
+  return GL_NO_ERROR;
+}
+
+void GL_APIENTRY glGetFloatv(GLenum pname, GLfloat* data) {
+  Count(kGetFloatv);
+  *data = 0;
+}
+
+void GL_APIENTRY glGetFramebufferAttachmentParameteriv(GLenum target,
+                                                       GLenum attachment,
+                                                       GLenum pname,
+                                                       GLint* params) {
+  Count(kGetFramebufferAttachmentParameteriv);
+  *params = 0;
+}
+
+void GL_APIENTRY glGetIntegerv(GLenum pname, GLint* data) {
+  Count(kGetIntegerv);
+  switch (pname) {
+    case GL_MAX_TEXTURE_SIZE: *data = 4096; break;
+    case GL_MAX_VERTEX_ATTRIBS: *data = 16; break;
+    case GL_MAX_TEXTURE_IMAGE_UNITS: *data = 16; break;
+    case GL_NUM_PROGRAM_BINARY_FORMATS_OES: *data = 1; break;
+    case GL_PROGRAM_BINARY_FORMATS_OES: *data = kProgramBinaryFormat; break;
+    default: *data = 0; break;
+  }
+}
+
+void GL_APIENTRY glGetProgramBinaryOES(GLuint program, GLsizei bufSize,
+                                       GLsizei* length, GLenum* binaryFormat,
+                                       void* binary) {
+  Count(kGetProgramBinaryOES);
+  const GLsizei size =
+      bufSize < GLsizei(sizeof(kProgramBinary)) ? 0 : sizeof(kProgramBinary);
+  memcpy(binary, kProgramBinary, size);
+  if (length) *length = size;
+  *binaryFormat = kProgramBinaryFormat;
+}
+
+void GL_APIENTRY glGetProgramiv(GLuint program, GLenum pname, GLint* params) {
+  Count(kGetProgramiv);
+  switch (pname) {
+    case GL_LINK_STATUS:
+      *params = g_state.unlinked_programs.count(program) ? GL_FALSE : GL_TRUE;
+      break;
+    case GL_VALIDATE_STATUS: *params = GL_TRUE; break;
+    case GL_PROGRAM_BINARY_LENGTH_OES: *params = sizeof(kProgramBinary); break;
+    default: *params = 0; break;
+  }
+}
+
+void GL_APIENTRY glGetProgramInfoLog(GLuint program, GLsizei bufSize,
+                                     GLsizei* length, GLchar* infoLog) {
+  Count(kGetProgramInfoLog);
+  if (length) *length = 0;
+  if (bufSize > 0) infoLog[0] = '\0';
+}
+
+void GL_APIENTRY glGetRenderbufferParameteriv(GLenum target, GLenum pname,
+                                              GLint* params) {
+  Count(kGetRenderbufferParameteriv);
+  *params = 0;
+}
+
+void GL_APIENTRY glGetShaderiv(GLuint shader, GLenum pname, GLint* params) {
+  Count(kGetShaderiv);
+  *params = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+}
+
+void GL_APIENTRY glGetShaderInfoLog(GLuint shader, GLsizei bufSize,
+                                    GLsizei* length, GLchar* infoLog) {
+  Count(kGetShaderInfoLog);
+  if (length) *length = 0;
+  if (bufSize > 0) infoLog[0] = '\0';
+}
+
+void GL_APIENTRY glGetShaderPrecisionFormat(GLenum shadertype,
+                                            GLenum precisiontype, GLint* range,
+                                            GLint* precision) {
+  Count(kGetShaderPrecisionFormat);
+}
+
+void GL_APIENTRY glGetShaderSource(GLuint shader, GLsizei bufSize,
+                                   GLsizei* length, GLchar* source) {
+  Count(kGetShaderSource);
+}
+
+const GLubyte* GL_APIENTRY glGetString(GLenum name) {
+  Count(kGetString);
+  const char* value = "";
+  switch (name) {
+    case GL_VENDOR: value = "NVIDIA"; break;
+    case GL_RENDERER: value = "Fake GL"; break;
+    case GL_VERSION: value = "OpenGL ES 2.0 Fake GL"; break;
+    case GL_SHADING_LANGUAGE_VERSION: value = "OpenGL ES GLSL ES 1.00"; break;
+    case GL_EXTENSIONS:
+      value =
+          "GL_OES_get_program_binary GL_OES_element_index_uint "
+          "GL_EXT_disjoint_timer_query";
+      break;
+  }
+  return reinterpret_cast<const GLubyte*>(value);
+}
+
+void GL_APIENTRY glGetTexParameterfv(GLenum target, GLenum pname,
+                                     GLfloat* params) {
+  Count(kGetTexParameterfv);
+  *params = 0;
+}
+
+void GL_APIENTRY glGetTexParameteriv(GLenum target, GLenum pname,
+                                     GLint* params) {
+  Count(kGetTexParameteriv);
+  *params = 0;
+}
+
+void GL_APIENTRY glGetUniformfv(GLuint program, GLint location,
+                                GLfloat* params) {
+  Count(kGetUniformfv);
+  *params = 0;
+}
+
+void GL_APIENTRY glGetUniformiv(GLuint program, GLint location, GLint* params) {
+  Count(kGetUniformiv);
+  *params = 0;
+}
+
+GLint GL_APIENTRY glGetUniformLocation(GLuint program, const GLchar* name) {
+  Count(kGetUniformLocation);
+  return g_state.next_location++ % 64;
+}
+
+void GL_APIENTRY glGetVertexAttribfv(GLuint index, GLenum pname,
+                                     GLfloat* params) {
+  Count(kGetVertexAttribfv);
+  *params = 0;
+}
+
+void GL_APIENTRY glGetVertexAttribiv(GLuint index, GLenum pname,
+                                     GLint* params) {
+  Count(kGetVertexAttribiv);
+  *params = 0;
+}
+
+void GL_APIENTRY glGetVertexAttribPointerv(GLuint index, GLenum pname,
+                                           void** pointer) {
+  Count(kGetVertexAttribPointerv);
+}
+
+void GL_APIENTRY glHint(GLenum target, GLenum mode) {
+  Count(kHint);
+}
+
+GLboolean GL_APIENTRY glIsBuffer(GLuint buffer) {
+  Count(kIsBuffer);
+  return GL_TRUE;
+}
+
+GLboolean GL_APIENTRY glIsEnabled(GLenum cap) {
+  Count(kIsEnabled);
+  return GL_TRUE;
+}
+
+GLboolean GL_APIENTRY glIsFramebuffer(GLuint framebuffer) {
+  Count(kIsFramebuffer);
+  return GL_TRUE;
+}
+
+GLboolean GL_APIENTRY glIsProgram(GLuint program) {
+  Count(kIsProgram);
+  return GL_TRUE;
+}
+
+GLboolean GL_APIENTRY glIsRenderbuffer(GLuint renderbuffer) {
+  Count(kIsRenderbuffer);
+  return GL_TRUE;
+}
+
+GLboolean GL_APIENTRY glIsShader(GLuint shader) {
+  Count(kIsShader);
+  return GL_TRUE;
+}
+
+GLboolean GL_APIENTRY glIsTexture(GLuint texture) {
+  Count(kIsTexture);
+  return GL_TRUE;
+}
+
+void GL_APIENTRY glLineWidth(GLfloat width) {
+  Count(kLineWidth);
+}
+
+void GL_APIENTRY glLinkProgram(GLuint program) {
+  Count(kLinkProgram);
+  g_state.counters.program_links++;
+  g_state.unlinked_programs.erase(program);
+}
+
+void GL_APIENTRY glProgramBinaryOES(GLuint program, GLenum binaryFormat,
+                                    const void* binary, GLint length) {
+  Count(kProgramBinaryOES);
+  g_state.counters.program_binary_loads++;
+  if (binaryFormat == kProgramBinaryFormat &&
+      length == GLint(sizeof(kProgramBinary)) &&
+      memcmp(binary, kProgramBinary, length) == 0) {
+    g_state.unlinked_programs.erase(program);
+  } else {
+    g_state.unlinked_programs.insert(program);
+  }
+}
+
+void GL_APIENTRY glPixelStorei(GLenum pname, GLint param) {
+  Count(kPixelStorei);
+}
+
+void GL_APIENTRY glPolygonOffset(GLfloat factor, GLfloat units) {
+  Count(kPolygonOffset);
+}
+
+void GL_APIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height,
+                              GLenum format, GLenum type, void* pixels) {
+  Count(kReadPixels);
+}
+
+void GL_APIENTRY glReleaseShaderCompiler(void) {
+  Count(kReleaseShaderCompiler);
+}
+
+void GL_APIENTRY glRenderbufferStorage(GLenum target, GLenum internalformat,
+                                       GLsizei width, GLsizei height) {
+  Count(kRenderbufferStorage);
+  SetBufferBytes(&g_state.renderbuffers, g_state.renderbuffer,
+                 static_cast<uint64_t>(width) * height *
+                     RenderbufferBytesPerPixel(internalformat),
+                 &g_state.memory.renderbuffer_bytes);
+}
+
+void GL_APIENTRY glSampleCoverage(GLfloat value, GLboolean invert) {
+  Count(kSampleCoverage);
+}
+
+void GL_APIENTRY glScissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+  Count(kScissor);
+}
+
+void GL_APIENTRY glShaderBinary(GLsizei count, const GLuint* shaders,
+                                GLenum binaryFormat, const void* binary,
+                                GLsizei length) {
+  Count(kShaderBinary);
+}
+
+void GL_APIENTRY glShaderSource(GLuint shader, GLsizei count,
+                                const GLchar* const*string,
+                                const GLint* length) {
+  Count(kShaderSource);
+}
+
+void GL_APIENTRY glStencilFunc(GLenum func, GLint ref, GLuint mask) {
+  Count(kStencilFunc);
+}
+
+void GL_APIENTRY glStencilFuncSeparate(GLenum face, GLenum func, GLint ref,
+                                       GLuint mask) {
+  Count(kStencilFuncSeparate);
+}
+
+void GL_APIENTRY glStencilMask(GLuint mask) {
+  Count(kStencilMask);
+}
+
+void GL_APIENTRY glStencilMaskSeparate(GLenum face, GLuint mask) {
+  Count(kStencilMaskSeparate);
+}
+
+void GL_APIENTRY glStencilOp(GLenum fail, GLenum zfail, GLenum zpass) {
+  Count(kStencilOp);
+}
+
+void GL_APIENTRY glStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail,
+                                     GLenum dppass) {
+  Count(kStencilOpSeparate);
+}
+
+void GL_APIENTRY glTexImage2D(GLenum target, GLint level, GLint internalformat,
+                              GLsizei width, GLsizei height, GLint border,
+                              GLenum format, GLenum type, const void* pixels) {
+  Count(kTexImage2D);
+  const uint32_t bytes_per_texel = BytesPerPixel(format, type);
+  const uint64_t bytes = static_cast<uint64_t>(width) * height * bytes_per_texel;
+  if (pixels) g_state.counters.texture_upload_bytes += bytes;
+  SpecifyTextureLevel(target, level, width, height, bytes_per_texel, bytes);
+}
+
+void GL_APIENTRY glTexParameterf(GLenum target, GLenum pname, GLfloat param) {
+  Count(kTexParameterf);
+}
+
+void GL_APIENTRY glTexParameterfv(GLenum target, GLenum pname,
+                                  const GLfloat* params) {
+  Count(kTexParameterfv);
+}
+
+void GL_APIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param) {
+  Count(kTexParameteri);
+}
+
+void GL_APIENTRY glTexParameteriv(GLenum target, GLenum pname,
+                                  const GLint* params) {
+  Count(kTexParameteriv);
+}
+
+void GL_APIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset,
+                                 GLint yoffset, GLsizei width, GLsizei height,
+                                 GLenum format, GLenum type,
+                                 const void* pixels) {
+  Count(kTexSubImage2D);
+  g_state.counters.texture_upload_bytes +=
+      static_cast<uint64_t>(width) * height * BytesPerPixel(format, type);
+}
+
+void GL_APIENTRY glUniform1f(GLint location, GLfloat v0) {
+  Count(kUniform1f);
+}
+
+void GL_APIENTRY glUniform1fv(GLint location, GLsizei count,
+                              const GLfloat* value) {
+  Count(kUniform1fv);
+}
+
+void GL_APIENTRY glUniform1i(GLint location, GLint v0) {
+  Count(kUniform1i);
+}
+
+void GL_APIENTRY glUniform1iv(GLint location, GLsizei count,
+                              const GLint* value) {
+  Count(kUniform1iv);
+}
+
+void GL_APIENTRY glUniform2f(GLint location, GLfloat v0, GLfloat v1) {
+  Count(kUniform2f);
+}
+
+void GL_APIENTRY glUniform2fv(GLint location, GLsizei count,
+                              const GLfloat* value) {
+  Count(kUniform2fv);
+}
+
+void GL_APIENTRY glUniform2i(GLint location, GLint v0, GLint v1) {
+  Count(kUniform2i);
+}
+
+void GL_APIENTRY glUniform2iv(GLint location, GLsizei count,
+                              const GLint* value) {
+  Count(kUniform2iv);
+}
+
+void GL_APIENTRY glUniform3f(GLint location, GLfloat v0, GLfloat v1,
+                             GLfloat v2) {
+  Count(kUniform3f);
+}
+
+void GL_APIENTRY glUniform3fv(GLint location, GLsizei count,
+                              const GLfloat* value) {
+  Count(kUniform3fv);
+}
+
+void GL_APIENTRY glUniform3i(GLint location, GLint v0, GLint v1, GLint v2) {
+  Count(kUniform3i);
+}
+
+void GL_APIENTRY glUniform3iv(GLint location, GLsizei count,
+                              const GLint* value) {
+  Count(kUniform3iv);
+}
+
+void GL_APIENTRY glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2,
+                             GLfloat v3) {
+  Count(kUniform4f);
+}
+
+void GL_APIENTRY glUniform4fv(GLint location, GLsizei count,
+                              const GLfloat* value) {
+  Count(kUniform4fv);
+}
+
+void GL_APIENTRY glUniform4i(GLint location, GLint v0, GLint v1, GLint v2,
+                             GLint v3) {
+  Count(kUniform4i);
+}
+
+void GL_APIENTRY glUniform4iv(GLint location, GLsizei count,
+                              const GLint* value) {
+  Count(kUniform4iv);
+}
+
+void GL_APIENTRY glUniformMatrix2fv(GLint location, GLsizei count,
+                                    GLboolean transpose, const GLfloat* value) {
+  Count(kUniformMatrix2fv);
+}
+
+void GL_APIENTRY glUniformMatrix3fv(GLint location, GLsizei count,
+                                    GLboolean transpose, const GLfloat* value) {
+  Count(kUniformMatrix3fv);
+}
+
+void GL_APIENTRY glUniformMatrix4fv(GLint location, GLsizei count,
+                                    GLboolean transpose, const GLfloat* value) {
+  Count(kUniformMatrix4fv);
+}
+
+void GL_APIENTRY glUseProgram(GLuint program) {
+  Count(kUseProgram);
+}
+
+void GL_APIENTRY glValidateProgram(GLuint program) {
+  Count(kValidateProgram);
+}
+
+void GL_APIENTRY glVertexAttrib1f(GLuint index, GLfloat x) {
+  Count(kVertexAttrib1f);
+}
+
+void GL_APIENTRY glVertexAttrib1fv(GLuint index, const GLfloat* v) {
+  Count(kVertexAttrib1fv);
+}
+
+void GL_APIENTRY glVertexAttrib2f(GLuint index, GLfloat x, GLfloat y) {
+  Count(kVertexAttrib2f);
+}
+
+void GL_APIENTRY glVertexAttrib2fv(GLuint index, const GLfloat* v) {
+  Count(kVertexAttrib2fv);
+}
+
+void GL_APIENTRY glVertexAttrib3f(GLuint index, GLfloat x, GLfloat y,
+                                  GLfloat z) {
+  Count(kVertexAttrib3f);
+}
+
+void GL_APIENTRY glVertexAttrib3fv(GLuint index, const GLfloat* v) {
+  Count(kVertexAttrib3fv);
+}
+
+void GL_APIENTRY glVertexAttrib4f(GLuint index, GLfloat x, GLfloat y, GLfloat z,
+                                  GLfloat w) {
+  Count(kVertexAttrib4f);
+}
+
+void GL_APIENTRY glVertexAttrib4fv(GLuint index, const GLfloat* v) {
+  Count(kVertexAttrib4fv);
+}
+
+void GL_APIENTRY glVertexAttribPointer(GLuint index, GLint size, GLenum type,
+                                       GLboolean normalized, GLsizei stride,
+                                       const void* pointer) {
+  Count(kVertexAttribPointer);
+}
+
+void GL_APIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+  Count(kViewport);
+}
+
+// GL_EXT_disjoint_timer_query.
+
+void GL_APIENTRY glBeginQueryEXT(GLenum target, GLuint id) {
+  Count(kBeginQueryEXT);
+  g_state.active_query = id;
+  g_state.active_query_draw_calls = g_state.counters.draw_calls;
+}
+
+void GL_APIENTRY glDeleteQueriesEXT(GLsizei n, const GLuint* ids) {
+  Count(kDeleteQueriesEXT);
+  for (GLsizei i = 0; i < n; ++i) g_state.query_elapsed_ns.erase(ids[i]);
+}
+
+void GL_APIENTRY glEndQueryEXT(GLenum target) {
+  Count(kEndQueryEXT);
+  g_state.query_elapsed_ns[g_state.active_query] =
+      (g_state.counters.draw_calls - g_state.active_query_draw_calls) *
+      kDrawCallNs;
+  g_state.active_query = 0;
+}
+
+void GL_APIENTRY glGenQueriesEXT(GLsizei n, GLuint* ids) {
+  Count(kGenQueriesEXT);
+  GenNames(n, ids);
+}
+
+void GL_APIENTRY glGetQueryObjectui64vEXT(GLuint id, GLenum pname,
+                                         GLuint64* params) {
+  Count(kGetQueryObjectui64vEXT);
+  *params = pname == GL_QUERY_RESULT_EXT ? g_state.query_elapsed_ns[id] : 0;
+}
+
+void GL_APIENTRY glGetQueryObjectuivEXT(GLuint id, GLenum pname,
+                                       GLuint* params) {
+  Count(kGetQueryObjectuivEXT);
+  *params = pname == GL_QUERY_RESULT_AVAILABLE_EXT ? GL_TRUE : 0;
+}
+
+}  // extern "C"
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_FAKE_GLES_H_
+#define C_ARCORE_HELLO_AR_FAKE_GLES_H_
+
+#include <stdint.h>
+
+// Host-side stand-in for libGLESv2 and the few EGL calls the client makes.
+// Every OpenGL ES 2.0 entry point is defined and counted but renders nothing:
+// names are handed out sequentially, shaders always compile and link, and
+// queries return zero apart from a few limits.  GL_OES_get_program_binary
+// hands out a fixed binary, and programs loaded from any other fail to link.
+// GL_EXT_disjoint_timer_query results are available at once and charge a
+// fixed 10us per draw call, which only exercises the client's plumbing.
+// Link it into host benchmarks to measure the CPU cost and call volume of the
+// render code without a GPU.
+// The storage specified for textures, renderbuffers and buffers is summed,
+// to check the client's own GPU memory accounting against.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct FakeGlCounters {
+  uint64_t calls;
+  uint64_t draw_calls;
+  uint64_t buffer_upload_bytes;
+  uint64_t texture_upload_bytes;
+  uint64_t shader_compiles;
+  uint64_t program_links;
+  uint64_t program_binary_loads;
+} FakeGlCounters;
+
+void FakeGl_getCounters(FakeGlCounters* counters);
+
+typedef struct FakeGlMemory {
+  uint64_t texture_bytes;
+  uint64_t renderbuffer_bytes;
+  uint64_t buffer_bytes;
+} FakeGlMemory;
+
+// Memory held by the live objects: every mip level specified through
+// glTexImage2D(), glCompressedTexImage2D(), glCopyTexImage2D() and
+// glGenerateMipmap(), glRenderbufferStorage() and glBufferData().  Not
+// affected by FakeGl_resetCounters().
+void FakeGl_getMemory(FakeGlMemory* memory);
+
+// Forgets every object and binding, as if the context was lost.  Call before
+// handing the client a new context.
+void FakeGl_loseContext(void);
+
+// Resets the counters and the per entry point call counts.
+void FakeGl_resetCounters(void);
+
+// Per entry point call counts since the last reset, |index| in
+// [0, FakeGl_getEntryPointCount()).
+int FakeGl_getEntryPointCount(void);
+const char* FakeGl_getEntryPointName(int index);
+uint64_t FakeGl_getEntryPointCalls(int index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // C_ARCORE_HELLO_AR_FAKE_GLES_H_
@@ -0,0 +1,1816 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+// Headless benchmark of HelloArApplication::OnDrawFrame().  The application
+// runs unmodified against the host stand-ins for ARCore (replaying a session
+// recorded with -arr), CloudXR and OpenGL ES, and for each scenario reports
+// per frame:
+//   - CPU time of the render thread, and the client's own phase timers,
+//   - heap allocations made by the render thread, through an interposed
+//     allocator,
+//   - GL calls, draw calls and upload volume, from the fake GL,
+//   - calls into the ARCore C API, from the replay.
+// Each scenario also reports the startup time, heap use and texture uploads
+// up to the end of the first OnDrawFrame(), which creates the GL resources,
+// and the run reports its peak RSS.
+// Results go to stdout or --out as JSON, for comparison between builds.
+//
+// Scenarios:
+//   calibration  no anchor is placed: camera background, planes and HUD.
+//   streaming    an anchor is placed on a detected plane and frames are
+//                latched from the fake CloudXR server.
+//   reconnect    streaming with a pause/resume cycle every
+//                --reconnect-interval frames, so the client tears down and
+//                reconnects.  Reports the time from OnResume() to the end of
+//                the next frame with the EGL context preserved.
+//   context_loss like reconnect, but every resume also gets a new context
+//                through OnSurfaceCreated(), so the GL resources are created
+//                again.
+//   recalibration
+//                streaming with a long press every --reconnect-interval
+//                frames, which drops the anchor, after which a new one is
+//                placed.
+// The frame loop scenarios check every frame that the client tracks the
+// planes of the recording that are neither stopped nor subsumed.
+//   cubemap_encode
+//                no frame loop: times the cubemap downsampling and RGB9E5
+//                encoding, SIMD and scalar, on a synthetic HDR cubemap, and
+//                checks both encode NaN, infinite, negative and denormal
+//                values the same way.
+//   obj_parse    no frame loop: times ParseObj() against util::LoadObjFile()
+//                on synthetic spheres and any --obj files, and loading the
+//                same model converted to a quantized binary mesh.
+//   texture_load no frame loop: times decoding the plane grid PNG, as the
+//                app did before it shipped textures as KTX, against loading
+//                the ETC2 KTX with LoadKtxTexture(), and compares their
+//                texture memory.  Needs libpng.
+//   log_cost     no frame loop: times a LOGI call, which formats and writes
+//                on the caller, against LOGI_RL calls that are queued for the
+//                logger thread or suppressed by the rate limit.
+//
+// Checks, which run no frame loop and fail the run when the component
+// misbehaves:
+//   metrics_server  scrapes the Prometheus endpoint over loopback while a
+//                   stand-in render thread publishes metrics.
+//   receiver_reconnect
+//                   reconnects a fake CloudXR receiver after the server
+//                   dropped the connection.
+//
+// With --cubemap-rate N the frame loop scenarios stream the environment
+// cubemap at up to N bytes per second to a sink that discards it, and report
+// the bytes sent per second of recording time.
+//
+// With --program-cache DIR the shader programs are cached under DIR, which
+// stands in for the app's code cache.  Run twice to compare compiling against
+// loading cached binaries; the fake GL makes both cheap, so this mostly checks
+// the plumbing.
+//
+// With --synthetic-planes N the frame loop scenarios replay a generated
+// recording of N planes on the floor in front of the camera instead of
+// --recording.  Each plane's polygon has --plane-vertices vertices and grows
+// every --plane-update-interval frames, staggered across the planes.
+//
+// The frame loop scenarios check every measured frame's GPU memory
+// accounting, ClientMetrics::gpu_*_bytes, against the storage the fake GL saw
+// specified, and fail on a mismatch.  Pass -gpu-budget-mb N in --args to
+// exercise the budget.
+//
+// With --max-allocations N a scenario fails if any measured frame, other than
+// the first frame after a reconnect or a context loss, makes more than N heap
+// allocations.  Use
+// --max-allocations 0 to check that the steady frame loop does not allocate.
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CloudXRClient.h"
+#include "ar_record_format.h"
+#include "arcore_replay.h"
+#include "asset_view.h"
+#include "async_log.h"
+#include "client_metrics.h"
+#include "cubemap_encoder.h"
+#include "fake_cloudxr_client.h"
+#include "fake_gles.h"
+#include "hello_ar_application.h"
+#include "host_platform.h"
+#include "mesh_asset.h"
+#include "metrics_server.h"
+#include "obj_loader.h"
+#include "texture_asset.h"
+#include "util.h"
+#ifdef HELLO_AR_HAVE_PNG
+#include "texture_encoder.h"
+#endif
+
+#ifndef HELLO_AR_ASSETS_DIR
+#define HELLO_AR_ASSETS_DIR "src/main/assets"
+#endif
+
+// Allocation accounting.  Only allocations made by the thread that enables
+// counting are recorded, so the fake server and logging threads do not skew
+// the render thread's numbers.
+
+namespace {
+
+thread_local bool t_count_allocations = false;
+thread_local uint64_t t_allocations = 0;
+thread_local uint64_t t_allocated_bytes = 0;
+
+inline void CountAllocation(size_t size) {
+  if (t_count_allocations) {
+    t_allocations++;
+    t_allocated_bytes += size;
+  }
+}
+
+}  // namespace
+
+#if defined(__GLIBC__)
+// Interpose malloc itself so C allocations (strdup, snprintf buffers, ...) are
+// counted along with operator new.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+  CountAllocation(size);
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+  CountAllocation(count * size);
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+  CountAllocation(size);
+  return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) { __libc_free(ptr); }
+}  // extern "C"
+#else
+void* operator new(size_t size) {
+  CountAllocation(size);
+  if (void* ptr = std::malloc(size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+#endif
+
+namespace {
+
+struct Options {
+  std::string recording;
+  std::string assets = HELLO_AR_ASSETS_DIR;
+  std::string out;
+  std::string args = "-s 127.0.0.1";
+  std::vector<std::string> scenarios = {"calibration", "streaming",
+                                        "reconnect"};
+  int frames = 3000;
+  int warmup_frames = 600;
+  int reconnect_interval = 300;
+  // Negative disables the check.
+  int max_allocations = -1;
+  // Cubemap streaming budget in bytes per second, 0 disables streaming.
+  int cubemap_rate = 0;
+  // Shader program cache directory, empty disables the cache.
+  std::string program_cache;
+  // OBJ files for the obj_parse scenario, besides the synthetic meshes.
+  std::vector<std::string> obj_files;
+  // Planes of the generated recording, 0 to replay --recording.
+  int synthetic_planes = 0;
+  int plane_update_interval = 30;
+  int plane_vertices = 24;
+};
+
+struct Distribution {
+  double mean = 0.0;
+  double p50 = 0.0;
+  double p99 = 0.0;
+  double max = 0.0;
+};
+
+Distribution Summarize(std::vector<double> samples) {
+  Distribution d;
+  if (samples.empty()) return d;
+  std::sort(samples.begin(), samples.end());
+  double sum = 0.0;
+  for (double sample : samples) sum += sample;
+  d.mean = sum / samples.size();
+  d.p50 = samples[samples.size() / 2];
+  d.p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+  d.max = samples.back();
+  return d;
+}
+
+struct ScenarioResult {
+  std::string name;
+  std::string error;
+  int frames = 0;
+  int reconnects = 0;
+  int recalibrations = 0;
+  // Wall time from OnResume() to the end of the first frame after it.
+  Distribution resume_to_first_frame_ms;
+  Distribution frame_cpu_us;
+  Distribution allocations;
+  Distribution allocated_bytes;
+  Distribution gl_calls;
+  Distribution draw_calls;
+  Distribution ar_calls;
+  double gl_upload_bytes_per_frame = 0.0;
+  // Client phase timers over the measured frames, mean milliseconds.
+  double phase_mean_ms[hello_ar::kNumFramePhases] = {};
+  uint64_t phase_count[hello_ar::kNumFramePhases] = {};
+  uint64_t latch_success = 0;
+  uint64_t latch_not_ready = 0;
+  uint64_t light_sends = 0;
+  uint64_t light_sends_skipped = 0;
+  uint64_t cubemap_updates = 0;
+  uint64_t cubemap_bytes = 0;
+  double cubemap_bytes_per_second = 0.0;
+  double plane_mesh_rebuilds_per_frame = 0.0;
+  double plane_upload_bytes_per_frame = 0.0;
+  // Plane batch of the last measured frame.
+  uint32_t plane_vertices = 0;
+  uint32_t plane_triangles = 0;
+  // Wall time from creating the application to the end of the first
+  // OnDrawFrame(), which loads the shaders and textures.
+  double startup_ms = 0.0;
+  uint64_t startup_allocated_bytes = 0;
+  uint64_t startup_texture_bytes = 0;
+  // Shader programs created for the first frame, before the measured frames.
+  uint32_t shader_programs_cached = 0;
+  uint32_t shader_programs_compiled = 0;
+  double shader_program_ms = 0.0;
+  // GPU memory held by the client at the end of the measured frames.
+  uint64_t gpu_texture_bytes = 0;
+  uint64_t gpu_buffer_bytes = 0;
+  uint32_t camera_history_frames = 0;
+  uint32_t camera_history_scale = 0;
+  // Measured frames whose pose was not in the camera history.
+  uint64_t camera_offsets_clamped = 0;
+  // GPU time of the performance overlay in the last frame, from the fake GL's
+  // timer queries.  0 unless -hud 1 is passed in --args.
+  double hud_gpu_ms = 0.0;
+  std::vector<std::pair<std::string, double>> gl_entry_points;
+};
+
+struct EncoderResult {
+  bool ran = false;
+  std::string error;
+  int iterations = 0;
+  // Texels per iteration, at the source and encoded resolution.
+  size_t source_texels = 0;
+  size_t encoded_texels = 0;
+  double downsample_ns_per_texel = 0.0;
+  double encode_ns_per_texel = 0.0;
+  double scalar_encode_ns_per_texel = 0.0;
+  // Largest decoded error relative to the texel's brightest channel.
+  double max_relative_error = 0.0;
+};
+
+struct LogCostResult {
+  bool ran = false;
+  int iterations = 0;
+  // LOGI, which formats and writes on the calling thread.
+  double sync_ns_per_call = 0.0;
+  // LOGI_RL whose message is queued for the logger thread.
+  double async_ns_per_call = 0.0;
+  // LOGI_RL suppressed by its rate limit, as with a message every frame.
+  double suppressed_ns_per_call = 0.0;
+};
+
+struct ObjLoaderResult {
+  std::string name;
+  std::string error;
+  size_t bytes = 0;
+  int iterations = 0;
+  double legacy_ms = 0.0;
+  double ms = 0.0;
+  // Opening the binary mesh and copying its buffers out, as glBufferData()
+  // does.
+  double mesh_ms = 0.0;
+  size_t mesh_bytes = 0;
+  // Heap bytes allocated by one load with each loader.
+  uint64_t legacy_heap_bytes = 0;
+  uint64_t heap_bytes = 0;
+  uint64_t mesh_heap_bytes = 0;
+  // Vertices drawn: one per triangle corner for the legacy loader, one per
+  // distinct position/uv/normal combination for ParseObj().
+  size_t legacy_vertices = 0;
+  size_t vertices = 0;
+  size_t indices = 0;
+  int index_bits = 0;
+  // Largest position difference between the two loaders' triangles, -1 when
+  // not compared because the legacy loader's 16-bit indices overflow.
+  double max_position_error = -1.0;
+};
+
+struct TextureLoadResult {
+  bool ran = false;
+  std::string error;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  // Decoding the PNG to RGBA, which BitmapFactory did before the texture
+  // went to glTexImage2D() and glGenerateMipmap().
+  size_t png_file_bytes = 0;
+  double png_ms = 0.0;
+  // RGBA8 with the generated mip chain.
+  size_t png_texture_bytes = 0;
+  // LoadKtxTexture() of the ETC2 file shipped alongside.
+  size_t ktx_file_bytes = 0;
+  double ktx_ms = 0.0;
+  size_t ktx_texture_bytes = 0;
+  double ktx_psnr_db = 0.0;
+};
+
+// Result of a scenario that checks a component's behavior rather than timing
+// the frame loop.
+struct CheckResult {
+  std::string name;
+  std::string error;
+  double ms = 0.0;
+};
+
+double ThreadCpuUs() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec * 1e-3;
+}
+
+struct RecordingInfo {
+  int width = 1080;
+  int height = 2160;
+  int rotation = 0;
+  // Time between the first two frames, 0 for a single frame recording.
+  int64_t frame_interval_ns = 0;
+};
+
+// Reads the display geometry and frame interval from the recording's first
+// frames.
+bool ReadRecordingInfo(const std::string& path, RecordingInfo* info) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) return false;
+  hello_ar::arrec::ArRecordFileHeader header;
+  hello_ar::arrec::ArRecordFrame frame;
+  hello_ar::arrec::ArRecordFrame next;
+  const bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+                  fseek(file, header.header_size, SEEK_SET) == 0 &&
+                  fread(&frame, sizeof(frame), 1, file) == 1;
+  const bool has_next =
+      ok && fseek(file, header.header_size + frame.frame_size, SEEK_SET) == 0 &&
+      fread(&next, sizeof(next), 1, file) == 1;
+  fclose(file);
+  if (!ok) return false;
+  info->width = frame.display_width;
+  info->height = frame.display_height;
+  info->rotation = frame.display_rotation;
+  info->frame_interval_ns =
+      has_next ? next.timestamp_ns - frame.timestamp_ns : 0;
+  return true;
+}
+
+// Writes a 10 second recording at 60 Hz of |options.synthetic_planes| round
+// planes, on a grid on the floor in front of a camera that slowly pans.
+bool WriteSyntheticRecording(const Options& options, const std::string& path) {
+  namespace arrec = hello_ar::arrec;
+  constexpr int kFrames = 600;
+  constexpr float kSpacing = 2.5f;
+  FILE* file = fopen(path.c_str(), "wb");
+  if (!file) return false;
+
+  arrec::ArRecordFileHeader header = {};
+  memcpy(header.magic, arrec::kFileMagic, sizeof(header.magic));
+  header.version = arrec::kFileVersion;
+  header.header_size = sizeof(header);
+  header.camera_image_width = 1920;
+  header.camera_image_height = 1080;
+  fwrite(&header, sizeof(header), 1, file);
+
+  const int planes = options.synthetic_planes;
+  const int columns = static_cast<int>(std::ceil(std::sqrt(planes)));
+  const int interval = std::max(1, options.plane_update_interval);
+  const int polygon_vertices = std::max(3, options.plane_vertices);
+  std::vector<float> polygon(polygon_vertices * 2);
+  for (int i = 0; i < kFrames; ++i) {
+    arrec::ArRecordFrame frame = {};
+    const size_t plane_size =
+        sizeof(arrec::ArRecordPlane) + polygon.size() * sizeof(float);
+    frame.frame_size = sizeof(frame) + planes * plane_size;
+    frame.plane_count = planes;
+    frame.timestamp_ns = 1000000000LL + i * 16666667LL;
+    frame.display_width = 1080;
+    frame.display_height = 2160;
+    frame.display_geometry_changed = i == 0;
+    frame.tracking_state = AR_TRACKING_STATE_TRACKING;
+
+    const glm::mat4 camera = glm::rotate(
+        glm::mat4(1.0f), 0.2f * std::sin(i * 0.01f), glm::vec3(0, 1, 0));
+    const glm::quat rotation = glm::quat_cast(camera);
+    const float camera_pose[7] = {rotation.x, rotation.y, rotation.z,
+                                  rotation.w, 0.0f, 0.0f, 0.0f};
+    memcpy(frame.camera_pose, camera_pose, sizeof(camera_pose));
+    const glm::mat4 view = glm::inverse(camera);
+    const glm::mat4 projection = glm::perspective(
+        1.0f, 0.5f, arrec::kProjectionNear, arrec::kProjectionFar);
+    memcpy(frame.view_matrix, glm::value_ptr(view), sizeof(frame.view_matrix));
+    memcpy(frame.projection_matrix, glm::value_ptr(projection),
+           sizeof(frame.projection_matrix));
+    const float display_uvs[8] = {0, 1, 1, 1, 0, 0, 1, 0};
+    memcpy(frame.display_uvs, display_uvs, sizeof(display_uvs));
+
+    frame.light_state = AR_LIGHT_ESTIMATE_STATE_VALID;
+    for (int c = 0; c < 4; ++c) frame.color_correction[c] = 1.0f;
+    frame.main_light_direction[1] = 1.0f;
+    for (int c = 0; c < 3; ++c) frame.main_light_intensity[c] = 1.0f;
+    fwrite(&frame, sizeof(frame), 1, file);
+
+    for (int k = 0; k < planes; ++k) {
+      arrec::ArRecordPlane plane = {};
+      plane.id = k + 1;
+      plane.tracking_state = AR_TRACKING_STATE_TRACKING;
+      plane.type = AR_PLANE_HORIZONTAL_UPWARD_FACING;
+      const float x = (k % columns - 0.5f * (columns - 1)) * kSpacing;
+      const float z = -2.0f - (k / columns) * kSpacing;
+      const float center_pose[7] = {0.0f, 0.0f, 0.0f, 1.0f, x, -1.5f, z};
+      memcpy(plane.center_pose, center_pose, sizeof(center_pose));
+      // Grows by a millimeter per update.
+      const float radius = 1.0f + 0.001f * ((i + k) / interval);
+      plane.extent_x = 2.0f * radius;
+      plane.extent_z = 2.0f * radius;
+      plane.polygon_size = polygon.size();
+      for (int v = 0; v < polygon_vertices; ++v) {
+        const float angle = v * 6.2831853f / polygon_vertices;
+        polygon[v * 2] = radius * std::cos(angle);
+        polygon[v * 2 + 1] = -radius * std::sin(angle);
+      }
+      fwrite(&plane, sizeof(plane), 1, file);
+      fwrite(polygon.data(), sizeof(float), polygon.size(), file);
+    }
+  }
+  return fclose(file) == 0;
+}
+
+// Taps a grid over the lower part of the screen, one point per call, until
+// one of them hits a plane and the client starts streaming.
+void TapNextPoint(hello_ar::HelloArApplication* app, int width, int height,
+                  int* tap) {
+  constexpr int kGrid = 5;
+  const int column = *tap % kGrid;
+  const int row = (*tap / kGrid) % kGrid;
+  app->OnTouched(width * (column + 0.5f) / kGrid,
+                 height * (0.4f + 0.6f * (row + 0.5f) / kGrid), false);
+  (*tap)++;
+}
+
+ScenarioResult RunScenario(const Options& options, const std::string& name,
+                           AAssetManager* assets) {
+  ScenarioResult result;
+  result.name = name;
+  const bool streaming = name != "calibration";
+  const bool context_loss = name == "context_loss";
+  const bool reconnect = name == "reconnect" || context_loss;
+  const bool recalibrate = name == "recalibration";
+
+  RecordingInfo info;
+  if (!ReadRecordingInfo(options.recording, &info)) {
+    result.error = "could not read " + options.recording;
+    return result;
+  }
+  const int width = info.width;
+  const int height = info.height;
+
+  // Frames are always ready, so latches return immediately.
+  cxrFakeConfig config;
+  cxrFakeGetDefaultConfig(&config);
+  config.frameRateHz = 1000.f;
+  config.latencyMeanMs = 0.f;
+  config.latencyStddevMs = 0.f;
+  cxrFakeSetConfig(&config);
+
+  ArReplay_setRecordingPath(options.recording.c_str());
+  ArReplay_setLoop(1);
+
+  t_allocated_bytes = 0;
+  t_count_allocations = true;
+  // Every application gets a new context.
+  FakeGl_loseContext();
+  FakeGl_resetCounters();
+  const auto startup_start = std::chrono::steady_clock::now();
+  std::unique_ptr<hello_ar::HelloArApplication> app(
+      new hello_ar::HelloArApplication(assets));
+  app->Init();
+  app->SetArgs(options.args);
+  if (!options.program_cache.empty()) {
+    // Stands in for the app's code cache directory, which always exists.
+    mkdir(options.program_cache.c_str(), 0700);
+    app->SetCacheDirectory(options.program_cache);
+  }
+  if (options.cubemap_rate > 0) {
+    hello_ar::CubemapStreamer::Config cubemap_config;
+    cubemap_config.max_bytes_per_second = options.cubemap_rate;
+    app->SetCubemapSink(cubemap_config, [](const uint8_t*, size_t) {});
+  }
+  app->OnResume(nullptr, nullptr, nullptr);
+  app->OnSurfaceCreated();
+  app->OnDisplayGeometryChanged(info.rotation, width, height);
+  if (app->OnDrawFrame() != 0) {
+    result.error = "first OnDrawFrame failed";
+    return result;
+  }
+  result.startup_ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - startup_start)
+                          .count();
+  t_count_allocations = false;
+  result.startup_allocated_bytes = t_allocated_bytes;
+  FakeGlCounters startup_gl = {};
+  FakeGl_getCounters(&startup_gl);
+  result.startup_texture_bytes = startup_gl.texture_upload_bytes;
+  result.shader_programs_cached = app->GetMetrics().shader_programs_cached;
+  result.shader_programs_compiled = app->GetMetrics().shader_programs_compiled;
+  result.shader_program_ms = app->GetMetrics().shader_program_ms;
+
+  // Warm up, and for the streaming scenarios place the anchor and wait for
+  // the first latched frame.
+  int tap = 0;
+  for (int i = 0; i < options.warmup_frames; ++i) {
+    if (app->OnDrawFrame() != 0) {
+      result.error = "OnDrawFrame failed during warmup";
+      return result;
+    }
+    if (!streaming) continue;
+    if (app->GetMetrics().latch_success > 0) break;
+    if (app->HasDetectedPlanes()) TapNextPoint(app.get(), width, height, &tap);
+  }
+  if (streaming && app->GetMetrics().latch_success == 0) {
+    result.error = "no anchor could be placed on the recorded planes";
+    return result;
+  }
+
+  const hello_ar::ClientMetrics start_metrics = app->GetMetrics();
+  FakeGl_resetCounters();
+  FakeGlCounters gl_before = {};
+
+  std::vector<double> cpu_us, allocations, allocated_bytes, gl_calls,
+      draw_calls, ar_calls, resume_ms;
+  cpu_us.reserve(options.frames);
+  allocations.reserve(options.frames);
+  allocated_bytes.reserve(options.frames);
+  gl_calls.reserve(options.frames);
+  draw_calls.reserve(options.frames);
+  ar_calls.reserve(options.frames);
+
+  bool recalibration_pending = false;
+  for (int i = 0; i < options.frames; ++i) {
+    const bool reconnecting =
+        reconnect && i > 0 && i % options.reconnect_interval == 0;
+    if (recalibrate && i > 0 && i % options.reconnect_interval == 0) {
+      if (recalibration_pending && result.error.empty()) {
+        result.error = "no anchor placed within " +
+                       std::to_string(options.reconnect_interval) +
+                       " frames of a long press";
+      }
+      // Away from the HUD toggle region.
+      app->OnTouched(width * 0.5f, height * 0.5f, true);
+      recalibration_pending = true;
+      result.recalibrations++;
+    }
+    std::chrono::steady_clock::time_point resume_start;
+    if (reconnecting) {
+      app->OnPause();
+      resume_start = std::chrono::steady_clock::now();
+      app->OnResume(nullptr, nullptr, nullptr);
+      if (context_loss) {
+        FakeGl_loseContext();
+        app->OnSurfaceCreated();
+        app->OnDisplayGeometryChanged(info.rotation, width, height);
+      }
+      result.reconnects++;
+    }
+
+    // The frame reports the GPU memory the previous frame left.
+    FakeGlMemory gl_memory;
+    FakeGl_getMemory(&gl_memory);
+
+    t_allocations = 0;
+    t_allocated_bytes = 0;
+    const uint64_t ar_calls_start = ArReplay_getApiCalls();
+    const double cpu_start = ThreadCpuUs();
+    t_count_allocations = true;
+    const int status = app->OnDrawFrame();
+    t_count_allocations = false;
+    const double cpu_end = ThreadCpuUs();
+    const uint64_t ar_calls_end = ArReplay_getApiCalls();
+    if (status != 0) {
+      result.error = "OnDrawFrame returned " + std::to_string(status);
+      break;
+    }
+    // The registry must follow the planes however the frame returned.
+    if (app->GetPlaneCount() !=
+            static_cast<size_t>(ArReplay_getActivePlaneCount()) &&
+        result.error.empty()) {
+      result.error = "frame " + std::to_string(i) + " tracks " +
+                     std::to_string(app->GetPlaneCount()) +
+                     " planes, the recording has " +
+                     std::to_string(ArReplay_getActivePlaneCount());
+    }
+    if (recalibration_pending) {
+      if (app->IsCalibrated()) {
+        recalibration_pending = false;
+      } else if (app->HasDetectedPlanes()) {
+        TapNextPoint(app.get(), width, height, &tap);
+      }
+    }
+    if (reconnecting) {
+      resume_ms.push_back(std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - resume_start)
+                              .count());
+    }
+    if (options.max_allocations >= 0 && !reconnecting &&
+        t_allocations > static_cast<uint64_t>(options.max_allocations) &&
+        result.error.empty()) {
+      result.error = "frame " + std::to_string(i) + " made " +
+                     std::to_string(t_allocations) + " heap allocations";
+    }
+    const hello_ar::ClientMetrics& frame_metrics = app->GetMetrics();
+    if ((frame_metrics.gpu_texture_bytes != gl_memory.texture_bytes ||
+         frame_metrics.gpu_renderbuffer_bytes !=
+             gl_memory.renderbuffer_bytes ||
+         frame_metrics.gpu_buffer_bytes != gl_memory.buffer_bytes) &&
+        result.error.empty()) {
+      result.error =
+          "frame " + std::to_string(i) + " accounts " +
+          std::to_string(frame_metrics.gpu_texture_bytes) + " texture and " +
+          std::to_string(frame_metrics.gpu_buffer_bytes) +
+          " buffer bytes, GL holds " + std::to_string(gl_memory.texture_bytes) +
+          " and " + std::to_string(gl_memory.buffer_bytes);
+    }
+
+    FakeGlCounters gl_after;
+    FakeGl_getCounters(&gl_after);
+    cpu_us.push_back(cpu_end - cpu_start);
+    allocations.push_back(t_allocations);
+    allocated_bytes.push_back(t_allocated_bytes);
+    gl_calls.push_back(gl_after.calls - gl_before.calls);
+    draw_calls.push_back(gl_after.draw_calls - gl_before.draw_calls);
+    ar_calls.push_back(ar_calls_end - ar_calls_start);
+    gl_before = gl_after;
+    result.frames++;
+  }
+
+  if (result.frames == 0) return result;
+
+  result.frame_cpu_us = Summarize(cpu_us);
+  result.allocations = Summarize(allocations);
+  result.allocated_bytes = Summarize(allocated_bytes);
+  result.gl_calls = Summarize(gl_calls);
+  result.draw_calls = Summarize(draw_calls);
+  result.ar_calls = Summarize(ar_calls);
+  result.resume_to_first_frame_ms = Summarize(resume_ms);
+  result.gl_upload_bytes_per_frame =
+      static_cast<double>(gl_before.buffer_upload_bytes +
+                          gl_before.texture_upload_bytes) /
+      result.frames;
+
+  const hello_ar::ClientMetrics& metrics = app->GetMetrics();
+  for (int phase = 0; phase < hello_ar::kNumFramePhases; ++phase) {
+    const hello_ar::LatencyHistogram& end = metrics.frame_phases[phase];
+    const hello_ar::LatencyHistogram& start = start_metrics.frame_phases[phase];
+    result.phase_count[phase] = end.count - start.count;
+    if (result.phase_count[phase]) {
+      result.phase_mean_ms[phase] =
+          (end.sum_ms - start.sum_ms) / result.phase_count[phase];
+    }
+  }
+  result.latch_success = metrics.latch_success - start_metrics.latch_success;
+  result.latch_not_ready =
+      metrics.latch_not_ready - start_metrics.latch_not_ready;
+  result.light_sends = metrics.light_sends - start_metrics.light_sends;
+  result.gpu_texture_bytes = metrics.gpu_texture_bytes;
+  result.gpu_buffer_bytes = metrics.gpu_buffer_bytes;
+  result.camera_history_frames = metrics.camera_history_frames;
+  result.camera_history_scale = metrics.camera_history_scale;
+  result.camera_offsets_clamped =
+      metrics.camera_offsets_clamped - start_metrics.camera_offsets_clamped;
+  result.hud_gpu_ms = metrics.hud_gpu_ms;
+  result.light_sends_skipped =
+      metrics.light_sends_skipped - start_metrics.light_sends_skipped;
+  result.cubemap_updates =
+      metrics.cubemap_updates - start_metrics.cubemap_updates;
+  result.cubemap_bytes =
+      metrics.cubemap_bytes_sent - start_metrics.cubemap_bytes_sent;
+  result.plane_mesh_rebuilds_per_frame =
+      static_cast<double>(metrics.plane_mesh_rebuilds -
+                          start_metrics.plane_mesh_rebuilds) /
+      result.frames;
+  result.plane_upload_bytes_per_frame =
+      static_cast<double>(metrics.plane_upload_bytes -
+                          start_metrics.plane_upload_bytes) /
+      result.frames;
+  result.plane_vertices = metrics.plane_vertices;
+  result.plane_triangles = metrics.plane_triangles;
+  if (info.frame_interval_ns > 0) {
+    result.cubemap_bytes_per_second =
+        result.cubemap_bytes / (result.frames * info.frame_interval_ns * 1e-9);
+  }
+
+  for (int i = 0; i < FakeGl_getEntryPointCount(); ++i) {
+    if (const uint64_t calls = FakeGl_getEntryPointCalls(i)) {
+      result.gl_entry_points.emplace_back(
+          FakeGl_getEntryPointName(i),
+          static_cast<double>(calls) / result.frames);
+    }
+  }
+  std::sort(result.gl_entry_points.begin(), result.gl_entry_points.end(),
+            [](const std::pair<std::string, double>& a,
+               const std::pair<std::string, double>& b) {
+              return a.second > b.second;
+            });
+  return result;
+}
+
+// Times the cubemap pipeline of CubemapStreamer on a synthetic cubemap: six
+// 16x16 RGBA16F faces, like ARCore's, downsampled to 8x8 and encoded.  Every
+// iteration processes a batch of cubemaps so the clock resolution does not
+// matter.
+EncoderResult RunEncoderBenchmark(const Options& options) {
+  constexpr int kSourceSize = 16;
+  constexpr int kFaceSize = 8;
+  constexpr int kBatch = 64;
+  constexpr size_t kSourceTexels = 6 * kSourceSize * kSourceSize;
+  constexpr size_t kEncodedTexels = 6 * kFaceSize * kFaceSize;
+
+  EncoderResult result;
+  result.ran = true;
+  result.iterations = options.frames;
+  result.source_texels = kSourceTexels * kBatch;
+  result.encoded_texels = kEncodedTexels * kBatch;
+
+  // Radiance spanning the range ARCore produces, 2^-8 to 2^8, through a
+  // simple hash so the batch is not uniform.
+  std::vector<uint16_t> source(kSourceTexels * 4 * kBatch);
+  std::vector<float> source_float(source.size());
+  uint32_t state = 1;
+  for (size_t i = 0; i < source.size(); ++i) {
+    state = state * 1664525u + 1013904223u;
+    const int exponent = 7 + static_cast<int>(state >> 28);  // 2^-8..2^7
+    const uint16_t half = static_cast<uint16_t>(
+        (i % 4 == 3) ? 0x3c00 : (exponent << 10) | ((state >> 12) & 0x3ff));
+    source[i] = half;
+    source_float[i] = hello_ar::HalfToFloat(half);
+  }
+  std::vector<float> downsampled(kEncodedTexels * 4 * kBatch);
+  std::vector<uint32_t> encoded(result.encoded_texels);
+  std::vector<uint32_t> scalar_encoded(result.encoded_texels);
+
+  using Clock = std::chrono::steady_clock;
+  auto elapsed_ns = [](Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start)
+        .count();
+  };
+  const size_t face_bytes = kSourceSize * kSourceSize * 4 * sizeof(uint16_t);
+  double downsample_ns = 0.0, encode_ns = 0.0, scalar_ns = 0.0;
+  for (int i = 0; i < options.frames; ++i) {
+    Clock::time_point start = Clock::now();
+    for (int face = 0; face < 6 * kBatch; ++face) {
+      hello_ar::DownsampleCubemapFace(
+          reinterpret_cast<const uint8_t*>(source.data()) + face * face_bytes,
+          kSourceSize, kSourceSize * 4 * sizeof(uint16_t),
+          4 * sizeof(uint16_t), kFaceSize,
+          &downsampled[face * kFaceSize * kFaceSize * 4]);
+    }
+    downsample_ns += elapsed_ns(start);
+
+    start = Clock::now();
+    hello_ar::EncodeRgb9e5(downsampled.data(), encoded.size(), encoded.data());
+    encode_ns += elapsed_ns(start);
+
+    start = Clock::now();
+    hello_ar::EncodeRgb9e5Scalar(downsampled.data(), scalar_encoded.size(),
+                                 scalar_encoded.data());
+    scalar_ns += elapsed_ns(start);
+  }
+  const double iterations = std::max(1, options.frames);
+  result.downsample_ns_per_texel =
+      downsample_ns / (iterations * result.source_texels);
+  result.encode_ns_per_texel = encode_ns / (iterations * result.encoded_texels);
+  result.scalar_encode_ns_per_texel =
+      scalar_ns / (iterations * result.encoded_texels);
+
+  for (size_t i = 0; i < encoded.size(); ++i) {
+    if (encoded[i] != scalar_encoded[i]) {
+      result.error = "SIMD and scalar encodings differ at texel " +
+                     std::to_string(i);
+      break;
+    }
+    float rgb[3];
+    hello_ar::DecodeRgb9e5(encoded[i], rgb);
+    const float* texel = &downsampled[i * 4];
+    const float reference =
+        std::max(texel[0], std::max(texel[1], texel[2]));
+    for (int c = 0; c < 3; ++c) {
+      result.max_relative_error =
+          std::max<double>(result.max_relative_error,
+                           std::fabs(rgb[c] - texel[c]) / reference);
+    }
+  }
+  // Half a step of the 9 bit mantissa, plus float rounding.
+  if (result.error.empty() && result.max_relative_error > 1.0 / 512 + 1e-6) {
+    result.error = "RGB9E5 error above the format's precision";
+  }
+
+  // Every combination of values a broken estimate could hold, which the
+  // synthetic cubemap never does.  The SIMD path must match the scalar one,
+  // and NaN and negative channels must decode to 0.
+  const float kEdgeValues[] = {
+      std::numeric_limits<float>::quiet_NaN(),
+      -std::numeric_limits<float>::quiet_NaN(),
+      std::numeric_limits<float>::infinity(),
+      -std::numeric_limits<float>::infinity(),
+      -1.f,
+      -0.f,
+      0.f,
+      std::numeric_limits<float>::denorm_min(),
+      std::numeric_limits<float>::min() * 0.5f,
+      std::numeric_limits<float>::min(),
+      1.f,
+      65408.f,
+      65504.f,
+      std::numeric_limits<float>::max()};
+  constexpr size_t kEdgeCount = sizeof(kEdgeValues) / sizeof(kEdgeValues[0]);
+  std::vector<float> edge(kEdgeCount * kEdgeCount * kEdgeCount * 4);
+  for (size_t i = 0; i < edge.size() / 4; ++i) {
+    edge[i * 4] = kEdgeValues[i % kEdgeCount];
+    edge[i * 4 + 1] = kEdgeValues[i / kEdgeCount % kEdgeCount];
+    edge[i * 4 + 2] = kEdgeValues[i / (kEdgeCount * kEdgeCount)];
+    edge[i * 4 + 3] = 1.f;
+  }
+  std::vector<uint32_t> edge_encoded(edge.size() / 4);
+  std::vector<uint32_t> edge_scalar(edge.size() / 4);
+  hello_ar::EncodeRgb9e5(edge.data(), edge_encoded.size(), edge_encoded.data());
+  hello_ar::EncodeRgb9e5Scalar(edge.data(), edge_scalar.size(),
+                               edge_scalar.data());
+  for (size_t i = 0; i < edge_encoded.size() && result.error.empty(); ++i) {
+    if (edge_encoded[i] != edge_scalar[i]) {
+      result.error = "SIMD and scalar encodings differ on edge case texel " +
+                     std::to_string(i);
+      break;
+    }
+    float rgb[3];
+    hello_ar::DecodeRgb9e5(edge_encoded[i], rgb);
+    for (int c = 0; c < 3; ++c) {
+      if (!(edge[i * 4 + c] > 0.f) && rgb[c] != 0.f) {
+        result.error = "NaN or negative channel not encoded as 0 in texel " +
+                       std::to_string(i);
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+// Sends a GET for |path| to the loopback |port| and reads the whole response.
+bool HttpGet(uint16_t port, const char* path, std::string* response) {
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return false;
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    close(fd);
+    return false;
+  }
+  const std::string request =
+      std::string("GET ") + path + " HTTP/1.0\r\nHost: localhost\r\n\r\n";
+  if (send(fd, request.data(), request.size(), 0) !=
+      static_cast<ssize_t>(request.size())) {
+    close(fd);
+    return false;
+  }
+  response->clear();
+  char buffer[4096];
+  ssize_t n;
+  while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+    response->append(buffer, n);
+  }
+  close(fd);
+  return n == 0;
+}
+
+// Serves metrics published by a stand-in render thread and scrapes them over
+// loopback, as Prometheus would through adb forward.
+CheckResult RunMetricsServerCheck() {
+  CheckResult result;
+  result.name = "metrics_server";
+
+  hello_ar::MetricsSnapshot snapshot;
+  hello_ar::MetricsServer server(&snapshot);
+  if (!server.Start(0)) {
+    result.error = "could not start the metrics server";
+    return result;
+  }
+
+  // Publishes like the render thread, only when a scrape asked for it.
+  std::atomic<bool> rendering{true};
+  std::thread render([&] {
+    hello_ar::ClientMetrics metrics;
+    while (rendering.load()) {
+      metrics.frames++;
+      metrics.frame_phases[hello_ar::kFramePhaseTotal].Add(3.f);
+      metrics.gpu_texture_bytes = 4096;
+      metrics.camera_offsets_clamped = 3;
+      if (snapshot.Requested()) snapshot.Publish(metrics);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  const auto start = std::chrono::steady_clock::now();
+  std::string response;
+  std::string not_found;
+  const bool scraped = HttpGet(server.port(), "/metrics", &response);
+  result.ms = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  const bool scraped_other = HttpGet(server.port(), "/other", &not_found);
+  rendering = false;
+  render.join();
+  server.Stop();
+
+  const size_t body = response.find("\r\n\r\n");
+  const char* kExpected[] = {
+      "# TYPE cloudxr_client_frames_total counter\n",
+      "cloudxr_client_frame_phase_seconds_bucket{phase=\"total\",le=\"0.004\"} ",
+      "cloudxr_client_gpu_object_bytes{type=\"texture\"} 4096\n",
+      "cloudxr_client_camera_offsets_clamped_total 3\n",
+  };
+  if (!scraped || !scraped_other) {
+    result.error = "could not scrape the metrics server";
+  } else if (response.compare(0, 15, "HTTP/1.0 200 OK") != 0 ||
+             body == std::string::npos) {
+    result.error = "bad /metrics response";
+  } else if (not_found.compare(0, 22, "HTTP/1.0 404 Not Found") != 0) {
+    result.error = "unknown path not answered with 404";
+  } else if (response.find("\ncloudxr_client_frames_total ", body) ==
+                 std::string::npos ||
+             response.find("\ncloudxr_client_frames_total 0\n", body) !=
+                 std::string::npos) {
+    result.error = "scrape did not get the render thread's metrics";
+  } else {
+    for (const char* expected : kExpected) {
+      if (response.find(expected, body) == std::string::npos) {
+        // Up to the labels, which would need escaping in the JSON.
+        const std::string line = expected;
+        result.error = "missing " + line.substr(0, line.find_first_of("{ "));
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+// Connects to the fake server, latches until it drops the connection after
+// disconnectAfterFrames, then reconnects the same receiver, twice over.
+CheckResult RunReceiverReconnectCheck() {
+  constexpr uint32_t kFramesPerConnection = 5;
+  constexpr int kConnections = 3;
+  CheckResult result;
+  result.name = "receiver_reconnect";
+
+  cxrFakeConfig config;
+  cxrFakeGetDefaultConfig(&config);
+  config.frameRateHz = 1000.f;
+  config.latencyMeanMs = 0.f;
+  config.latencyStddevMs = 0.f;
+  config.echoPose = 0;
+  config.disconnectAfterFrames = kFramesPerConnection;
+  cxrFakeSetConfig(&config);
+
+  cxrReceiverDesc desc = {};
+  cxrReceiverHandle receiver = nullptr;
+  if (cxrCreateReceiver(&desc, &receiver) != cxrError_Success) {
+    result.error = "could not create a receiver";
+    return result;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int connection = 0; connection < kConnections && result.error.empty();
+       ++connection) {
+    if (cxrConnect(receiver, "127.0.0.1", nullptr) != cxrError_Success) {
+      result.error = "reconnect failed";
+      break;
+    }
+    uint32_t latched = 0;
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+      cxrFramesLatched frames;
+      const cxrError status = cxrLatchFrame(receiver, &frames, 0xff, 100);
+      if (status == cxrError_Receiver_Not_Running) break;
+      if (status == cxrError_Success) {
+        latched++;
+        cxrReleaseFrame(receiver, &frames);
+      }
+    }
+    if (latched != kFramesPerConnection) {
+      result.error = "connection " + std::to_string(connection) + " latched " +
+                     std::to_string(latched) + " frames, expected " +
+                     std::to_string(kFramesPerConnection);
+    }
+  }
+  result.ms = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  cxrDestroyReceiver(receiver);
+  return result;
+}
+
+struct Check {
+  const char* name;
+  CheckResult (*run)();
+};
+
+const Check kChecks[] = {
+    {"metrics_server", RunMetricsServerCheck},
+    {"receiver_reconnect", RunReceiverReconnectCheck},
+};
+
+const Check* FindCheck(const std::string& name) {
+  for (const Check& check : kChecks) {
+    if (name == check.name) return &check;
+  }
+  return nullptr;
+}
+
+// Per call cost of the logging macros on the calling thread.  The log output
+// goes to /dev/null, which stands in for the logd socket write.
+LogCostResult RunLogCostBenchmark(const Options& options) {
+  // Below the async queue's capacity, so a batch is never dropped.
+  constexpr int kBatch = 512;
+  const int batches = std::max(1, options.frames / kBatch);
+
+  LogCostResult result;
+  result.ran = true;
+  result.iterations = batches * kBatch;
+
+  fflush(stderr);
+  const int saved_stderr = dup(STDERR_FILENO);
+  const int null_fd = open("/dev/null", O_WRONLY);
+  dup2(null_fd, STDERR_FILENO);
+  close(null_fd);
+  const int saved_priority = HostLog_getMinPriority();
+  HostLog_setMinPriority(ANDROID_LOG_INFO);
+
+  using Clock = std::chrono::steady_clock;
+  const char* status = "cxrError_Frame_Not_Ready";
+  double sync_ns = 0.0;
+  double async_ns = 0.0;
+  double suppressed_ns = 0.0;
+  for (int batch = 0; batch < batches; ++batch) {
+    auto start = Clock::now();
+    for (int i = 0; i < kBatch; ++i) {
+      LOGI("Latch failed, %s frame %d", status, i);
+    }
+    sync_ns += std::chrono::duration<double, std::nano>(Clock::now() - start)
+                   .count();
+
+    start = Clock::now();
+    for (int i = 0; i < kBatch; ++i) {
+      LOGI_RL(0, "Latch failed, %s frame %d", status, i);
+    }
+    async_ns += std::chrono::duration<double, std::nano>(Clock::now() - start)
+                    .count();
+    hello_ar::async_log::Flush();
+
+    start = Clock::now();
+    for (int i = 0; i < kBatch; ++i) {
+      LOGI_RL(3600 * 1000, "Latch failed, %s frame %d", status, i);
+    }
+    suppressed_ns +=
+        std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  }
+  hello_ar::async_log::Flush();
+
+  HostLog_setMinPriority(saved_priority);
+  fflush(stderr);
+  dup2(saved_stderr, STDERR_FILENO);
+  close(saved_stderr);
+
+  result.sync_ns_per_call = sync_ns / result.iterations;
+  result.async_ns_per_call = async_ns / result.iterations;
+  result.suppressed_ns_per_call = suppressed_ns / result.iterations;
+  return result;
+}
+
+void WriteDistribution(FILE* out, const char* name, const Distribution& d) {
+  fprintf(out,
+          "      \"%s\": {\"mean\": %.3f, \"p50\": %.3f, \"p99\": %.3f, "
+          "\"max\": %.3f},\n",
+          name, d.mean, d.p50, d.p99, d.max);
+}
+
+// OBJ text of a UV sphere with |rings| x |segments| quads, each vertex
+// referencing shared position, uv and normal lists like exporters write them.
+std::string MakeSphereObj(int rings, int segments) {
+  std::string obj;
+  char line[256];
+  for (const char* element : {"v", "vt", "vn"}) {
+    for (int r = 0; r <= rings; ++r) {
+      const float theta = 3.14159265f * r / rings;
+      for (int s = 0; s <= segments; ++s) {
+        const float phi = 6.28318531f * s / segments;
+        const float x = std::sin(theta) * std::cos(phi);
+        const float y = std::cos(theta);
+        const float z = std::sin(theta) * std::sin(phi);
+        if (element[1] == 't') {
+          snprintf(line, sizeof(line), "vt %.6f %.6f\n",
+                   static_cast<float>(s) / segments,
+                   static_cast<float>(r) / rings);
+        } else {
+          snprintf(line, sizeof(line), "%s %.6f %.6f %.6f\n", element, x, y,
+                   z);
+        }
+        obj += line;
+      }
+    }
+  }
+  for (int r = 0; r < rings; ++r) {
+    for (int s = 0; s < segments; ++s) {
+      const int a = r * (segments + 1) + s + 1;
+      const int b = a + segments + 1;
+      snprintf(line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n",
+               a, a, a, b, b, b, b + 1, b + 1, b + 1, a + 1, a + 1, a + 1);
+      obj += line;
+    }
+  }
+  return obj;
+}
+
+// Times both OBJ loaders on |dir|/|file|, and the binary mesh converted from
+// it, each for at least half a second.
+ObjLoaderResult RunObjLoader(const std::string& name, const std::string& dir,
+                             const std::string& file) {
+  ObjLoaderResult result;
+  result.name = name;
+  AAssetManager* assets = HostAssetManager_create(dir.c_str());
+
+  using Clock = std::chrono::steady_clock;
+  constexpr double kMinMs = 500.0;
+  auto elapsed_ms = [](Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start)
+        .count();
+  };
+
+  std::vector<GLfloat> legacy_vertices, legacy_normals, legacy_uvs;
+  std::vector<GLushort> legacy_indices;
+  double legacy_ms = 0.0;
+  int legacy_iterations = 0;
+  while (legacy_ms < kMinMs) {
+    legacy_vertices.clear();
+    legacy_normals.clear();
+    legacy_uvs.clear();
+    legacy_indices.clear();
+    const Clock::time_point start = Clock::now();
+    const bool ok = hello_ar::util::LoadObjFile(
+        file, assets, &legacy_vertices, &legacy_normals, &legacy_uvs,
+        &legacy_indices);
+    legacy_ms += elapsed_ms(start);
+    ++legacy_iterations;
+    if (!ok) {
+      result.error = "LoadObjFile failed";
+      break;
+    }
+  }
+
+  hello_ar::ObjMesh mesh;
+  double ms = 0.0;
+  int iterations = 0;
+  while (result.error.empty() && ms < kMinMs) {
+    const Clock::time_point start = Clock::now();
+    const bool ok = hello_ar::LoadObjMesh(assets, file.c_str(), &mesh);
+    ms += elapsed_ms(start);
+    ++iterations;
+    if (!ok) result.error = "LoadObjMesh failed";
+  }
+
+  // The heap use of one more load of each kind.
+  auto heap_bytes = [](const std::function<void()>& load) {
+    t_allocated_bytes = 0;
+    t_count_allocations = true;
+    load();
+    t_count_allocations = false;
+    return t_allocated_bytes;
+  };
+  if (result.error.empty()) {
+    result.legacy_heap_bytes = heap_bytes([&] {
+      std::vector<GLfloat> vertices, normals, uvs;
+      std::vector<GLushort> indices;
+      hello_ar::util::LoadObjFile(file, assets, &vertices, &normals, &uvs,
+                                  &indices);
+    });
+    result.heap_bytes = heap_bytes([&] {
+      hello_ar::ObjMesh heap_mesh;
+      hello_ar::LoadObjMesh(assets, file.c_str(), &heap_mesh);
+    });
+  }
+  HostAssetManager_destroy(assets);
+  if (!result.error.empty()) return result;
+
+  // Converts the model as mesh_convert --quantize does, into a directory of
+  // its own so that --obj directories are left alone.
+  char mesh_dir[] = "/tmp/mesh_load_XXXXXX";
+  if (!mkdtemp(mesh_dir)) {
+    result.error = "could not create a temporary directory";
+    return result;
+  }
+  const std::string mesh_path = std::string(mesh_dir) + "/model.mesh";
+  std::vector<uint8_t> encoded;
+  hello_ar::EncodeMesh(mesh, true, &encoded);
+  result.mesh_bytes = encoded.size();
+  FILE* mesh_file = fopen(mesh_path.c_str(), "wb");
+  if (mesh_file) {
+    fwrite(encoded.data(), 1, encoded.size(), mesh_file);
+    fclose(mesh_file);
+  }
+
+  AAssetManager* mesh_assets = HostAssetManager_create(mesh_dir);
+  std::vector<uint8_t> uploaded(encoded.size());
+  auto load_mesh = [&]() {
+    hello_ar::MeshAsset asset;
+    if (!asset.Open(mesh_assets, "model.mesh")) return false;
+    const hello_ar::mesh::MeshFileHeader& header = asset.header();
+    memcpy(uploaded.data(), asset.vertex_data(), header.vertex_size);
+    memcpy(uploaded.data() + header.vertex_size, asset.index_data(),
+           header.index_size);
+    return true;
+  };
+  double mesh_ms = 0.0;
+  int mesh_iterations = 0;
+  while (result.error.empty() && mesh_ms < kMinMs) {
+    const Clock::time_point start = Clock::now();
+    const bool ok = load_mesh();
+    mesh_ms += elapsed_ms(start);
+    ++mesh_iterations;
+    if (!ok) result.error = "MeshAsset::Open failed";
+  }
+  result.mesh_ms = mesh_iterations ? mesh_ms / mesh_iterations : 0.0;
+  result.mesh_heap_bytes = heap_bytes([&] { load_mesh(); });
+  HostAssetManager_destroy(mesh_assets);
+  remove(mesh_path.c_str());
+  rmdir(mesh_dir);
+  if (!result.error.empty()) return result;
+
+  FILE* f = fopen((dir + "/" + file).c_str(), "rb");
+  if (f) {
+    fseek(f, 0, SEEK_END);
+    result.bytes = ftell(f);
+    fclose(f);
+  }
+  result.iterations = iterations;
+  result.legacy_ms = legacy_ms / legacy_iterations;
+  result.ms = ms / iterations;
+  result.legacy_vertices = legacy_vertices.size() / 3;
+  result.vertices = mesh.vertex_count();
+  result.indices = mesh.index_count();
+  result.index_bits = mesh.index_type == GL_UNSIGNED_SHORT ? 16 : 32;
+
+  // The legacy loader writes every triangle corner in order, so corner i
+  // must match the vertex at index i of the new mesh.
+  if (result.legacy_vertices <= 0x10000 &&
+      result.legacy_vertices == result.indices) {
+    result.max_position_error = 0.0;
+    for (size_t i = 0; i < result.indices; ++i) {
+      const size_t index =
+          mesh.index_type == GL_UNSIGNED_SHORT ? mesh.indices16[i]
+                                               : mesh.indices32[i];
+      for (int c = 0; c < 3; ++c) {
+        result.max_position_error = std::max<double>(
+            result.max_position_error,
+            std::fabs(legacy_vertices[i * 3 + c] -
+                      mesh.positions[index * 3 + c]));
+      }
+    }
+  }
+  return result;
+}
+
+std::vector<ObjLoaderResult> RunObjLoaderBenchmark(const Options& options) {
+  std::vector<ObjLoaderResult> results;
+  char dir[] = "/tmp/obj_parse_XXXXXX";
+  if (!mkdtemp(dir)) {
+    results.emplace_back();
+    results.back().error = "could not create a temporary directory";
+    return results;
+  }
+  // The legacy loader keeps 16-bit indices, so only the small sphere is
+  // compared for correctness.
+  const std::pair<const char*, std::pair<int, int>> spheres[] = {
+      {"sphere_2k", {32, 64}}, {"sphere_130k", {256, 512}}};
+  for (const auto& sphere : spheres) {
+    const std::string file = std::string(sphere.first) + ".obj";
+    const std::string path = std::string(dir) + "/" + file;
+    const std::string obj =
+        MakeSphereObj(sphere.second.first, sphere.second.second);
+    FILE* f = fopen(path.c_str(), "wb");
+    if (f) {
+      fwrite(obj.data(), 1, obj.size(), f);
+      fclose(f);
+    }
+    results.push_back(RunObjLoader(sphere.first, dir, file));
+    remove(path.c_str());
+  }
+  rmdir(dir);
+
+  for (const std::string& path : options.obj_files) {
+    const size_t slash = path.rfind('/');
+    const std::string file_dir =
+        slash == std::string::npos ? "." : path.substr(0, slash);
+    const std::string file =
+        slash == std::string::npos ? path : path.substr(slash + 1);
+    results.push_back(RunObjLoader(path, file_dir, file));
+  }
+  return results;
+}
+
+// Times loading the plane grid both ways, each for at least half a second.
+TextureLoadResult RunTextureLoadBenchmark(const Options& options,
+                                          AAssetManager* assets) {
+  constexpr char kPngFile[] = "models/trigrid.png";
+  constexpr char kKtxFile[] = "models/trigrid.ktx";
+  TextureLoadResult result;
+  result.ran = true;
+#ifdef HELLO_AR_HAVE_PNG
+  using Clock = std::chrono::steady_clock;
+  constexpr double kMinMs = 500.0;
+  auto elapsed_ms = [](Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start)
+        .count();
+  };
+
+  const std::string png_path = options.assets + "/" + kPngFile;
+  hello_ar::Image image;
+  double png_ms = 0.0;
+  int png_iterations = 0;
+  while (png_ms < kMinMs) {
+    const Clock::time_point start = Clock::now();
+    const bool ok = hello_ar::DecodePng(png_path.c_str(), &image);
+    png_ms += elapsed_ms(start);
+    ++png_iterations;
+    if (!ok) {
+      result.error = "could not decode " + png_path;
+      return result;
+    }
+  }
+  result.width = image.width;
+  result.height = image.height;
+  result.png_ms = png_ms / png_iterations;
+  result.png_texture_bytes = image.rgba.size() * 4 / 3;
+
+  double ktx_ms = 0.0;
+  int ktx_iterations = 0;
+  while (ktx_ms < kMinMs) {
+    const Clock::time_point start = Clock::now();
+    const bool ok = hello_ar::LoadKtxTexture(assets, kKtxFile,
+                                             &result.ktx_texture_bytes);
+    ktx_ms += elapsed_ms(start);
+    ++ktx_iterations;
+    if (!ok) {
+      result.error = std::string("could not load ") + kKtxFile;
+      return result;
+    }
+  }
+  result.ktx_ms = ktx_ms / ktx_iterations;
+
+  hello_ar::AssetView png_file, ktx_file;
+  png_file.OpenAsset(assets, kPngFile);
+  ktx_file.OpenAsset(assets, kKtxFile);
+  result.png_file_bytes = png_file.size();
+  result.ktx_file_bytes = ktx_file.size();
+  hello_ar::Image decoded;
+  if (!hello_ar::DecodeKtxLevel(ktx_file.data(), ktx_file.size(), 0,
+                                &decoded) ||
+      decoded.width != image.width || decoded.height != image.height) {
+    result.error = std::string("could not decode ") + kKtxFile;
+    return result;
+  }
+  result.ktx_psnr_db =
+      hello_ar::ImagePsnr(image, decoded, hello_ar::HasAlpha(image));
+#else
+  result.error = "built without libpng";
+#endif
+  return result;
+}
+
+void WriteJson(FILE* out, const Options& options,
+               const std::vector<ScenarioResult>& results,
+               const EncoderResult& encoder,
+               const std::vector<ObjLoaderResult>& obj_loader,
+               const TextureLoadResult& texture_load,
+               const LogCostResult& log_cost,
+               const std::vector<CheckResult>& checks) {
+  // Peak resident set of the whole run, all scenarios included.
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  if (options.synthetic_planes > 0) {
+    fprintf(out, "{\n  \"synthetic_planes\": %d,\n",
+            options.synthetic_planes);
+    fprintf(out, "  \"plane_update_interval\": %d,\n",
+            options.plane_update_interval);
+    fprintf(out, "  \"plane_vertices\": %d,\n", options.plane_vertices);
+  } else {
+    fprintf(out, "{\n  \"recording\": \"%s\",\n", options.recording.c_str());
+  }
+  fprintf(out, "  \"frames\": %d,\n", options.frames);
+  fprintf(out, "  \"peak_rss_kb\": %ld,\n", usage.ru_maxrss);
+  fprintf(out, "  \"scenarios\": [\n");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const ScenarioResult& r = results[i];
+    fprintf(out, "    {\n      \"name\": \"%s\",\n", r.name.c_str());
+    if (!r.error.empty()) {
+      fprintf(out, "      \"error\": \"%s\",\n", r.error.c_str());
+    }
+    fprintf(out, "      \"frames\": %d,\n      \"reconnects\": %d,\n", r.frames,
+            r.reconnects);
+    fprintf(out, "      \"recalibrations\": %d,\n", r.recalibrations);
+    WriteDistribution(out, "frame_cpu_us", r.frame_cpu_us);
+    WriteDistribution(out, "allocations_per_frame", r.allocations);
+    WriteDistribution(out, "allocated_bytes_per_frame", r.allocated_bytes);
+    WriteDistribution(out, "gl_calls_per_frame", r.gl_calls);
+    WriteDistribution(out, "draw_calls_per_frame", r.draw_calls);
+    WriteDistribution(out, "ar_calls_per_frame", r.ar_calls);
+    WriteDistribution(out, "resume_to_first_frame_ms",
+                      r.resume_to_first_frame_ms);
+    fprintf(out, "      \"gl_upload_bytes_per_frame\": %.1f,\n",
+            r.gl_upload_bytes_per_frame);
+    fprintf(out, "      \"latch_success\": %llu,\n",
+            static_cast<unsigned long long>(r.latch_success));
+    fprintf(out, "      \"latch_not_ready\": %llu,\n",
+            static_cast<unsigned long long>(r.latch_not_ready));
+    fprintf(out, "      \"light_sends\": %llu,\n",
+            static_cast<unsigned long long>(r.light_sends));
+    fprintf(out, "      \"light_sends_skipped\": %llu,\n",
+            static_cast<unsigned long long>(r.light_sends_skipped));
+    fprintf(out, "      \"cubemap_updates\": %llu,\n",
+            static_cast<unsigned long long>(r.cubemap_updates));
+    fprintf(out, "      \"cubemap_bytes\": %llu,\n",
+            static_cast<unsigned long long>(r.cubemap_bytes));
+    fprintf(out, "      \"cubemap_bytes_per_second\": %.1f,\n",
+            r.cubemap_bytes_per_second);
+    fprintf(out, "      \"plane_mesh_rebuilds_per_frame\": %.3f,\n",
+            r.plane_mesh_rebuilds_per_frame);
+    fprintf(out, "      \"plane_upload_bytes_per_frame\": %.1f,\n",
+            r.plane_upload_bytes_per_frame);
+    fprintf(out, "      \"plane_vertices\": %u,\n", r.plane_vertices);
+    fprintf(out, "      \"plane_triangles\": %u,\n", r.plane_triangles);
+    fprintf(out, "      \"startup_ms\": %.3f,\n", r.startup_ms);
+    fprintf(out, "      \"startup_allocated_bytes\": %llu,\n",
+            static_cast<unsigned long long>(r.startup_allocated_bytes));
+    fprintf(out, "      \"startup_texture_bytes\": %llu,\n",
+            static_cast<unsigned long long>(r.startup_texture_bytes));
+    fprintf(out, "      \"shader_programs_cached\": %u,\n",
+            r.shader_programs_cached);
+    fprintf(out, "      \"shader_programs_compiled\": %u,\n",
+            r.shader_programs_compiled);
+    fprintf(out, "      \"shader_program_ms\": %.3f,\n",
+            r.shader_program_ms);
+    fprintf(out, "      \"gpu_texture_bytes\": %llu,\n",
+            static_cast<unsigned long long>(r.gpu_texture_bytes));
+    fprintf(out, "      \"gpu_buffer_bytes\": %llu,\n",
+            static_cast<unsigned long long>(r.gpu_buffer_bytes));
+    fprintf(out, "      \"camera_history_frames\": %u,\n",
+            r.camera_history_frames);
+    fprintf(out, "      \"camera_history_scale\": %u,\n",
+            r.camera_history_scale);
+    fprintf(out, "      \"camera_offsets_clamped\": %llu,\n",
+            static_cast<unsigned long long>(r.camera_offsets_clamped));
+    fprintf(out, "      \"hud_gpu_ms\": %.3f,\n", r.hud_gpu_ms);
+
+    fprintf(out, "      \"phases_ms\": {");
+    for (int phase = 0; phase < hello_ar::kNumFramePhases; ++phase) {
+      fprintf(out, "%s\n        \"%s\": {\"mean\": %.4f, \"count\": %llu}",
+              phase ? "," : "",
+              hello_ar::FramePhaseName(static_cast<hello_ar::FramePhase>(phase)),
+              r.phase_mean_ms[phase],
+              static_cast<unsigned long long>(r.phase_count[phase]));
+    }
+    fprintf(out, "\n      },\n");
+
+    fprintf(out, "      \"gl_calls_by_entry_point\": {");
+    for (size_t e = 0; e < r.gl_entry_points.size(); ++e) {
+      fprintf(out, "%s\n        \"%s\": %.2f", e ? "," : "",
+              r.gl_entry_points[e].first.c_str(), r.gl_entry_points[e].second);
+    }
+    fprintf(out, "\n      }\n    }%s\n", i + 1 < results.size() ? "," : "");
+  }
+  fprintf(out, "  ]");
+
+  if (encoder.ran) {
+    fprintf(out, ",\n  \"cubemap_encoder\": {\n");
+    if (!encoder.error.empty()) {
+      fprintf(out, "    \"error\": \"%s\",\n", encoder.error.c_str());
+    }
+    fprintf(out, "    \"iterations\": %d,\n", encoder.iterations);
+    fprintf(out, "    \"source_texels\": %zu,\n", encoder.source_texels);
+    fprintf(out, "    \"encoded_texels\": %zu,\n", encoder.encoded_texels);
+    fprintf(out, "    \"downsample_ns_per_texel\": %.3f,\n",
+            encoder.downsample_ns_per_texel);
+    fprintf(out, "    \"encode_ns_per_texel\": %.3f,\n",
+            encoder.encode_ns_per_texel);
+    fprintf(out, "    \"scalar_encode_ns_per_texel\": %.3f,\n",
+            encoder.scalar_encode_ns_per_texel);
+    fprintf(out, "    \"max_relative_error\": %.6f\n  }",
+            encoder.max_relative_error);
+  }
+
+  if (!obj_loader.empty()) {
+    fprintf(out, ",\n  \"obj_loader\": [");
+    for (size_t i = 0; i < obj_loader.size(); ++i) {
+      const ObjLoaderResult& r = obj_loader[i];
+      fprintf(out, "%s\n    {\n      \"name\": \"%s\",\n", i ? "," : "",
+              r.name.c_str());
+      if (!r.error.empty()) {
+        fprintf(out, "      \"error\": \"%s\",\n", r.error.c_str());
+      }
+      fprintf(out, "      \"bytes\": %zu,\n", r.bytes);
+      fprintf(out, "      \"iterations\": %d,\n", r.iterations);
+      fprintf(out, "      \"legacy_ms\": %.3f,\n", r.legacy_ms);
+      fprintf(out, "      \"ms\": %.3f,\n", r.ms);
+      fprintf(out, "      \"speedup\": %.2f,\n",
+              r.ms > 0.0 ? r.legacy_ms / r.ms : 0.0);
+      fprintf(out, "      \"mesh_ms\": %.3f,\n", r.mesh_ms);
+      fprintf(out, "      \"mesh_bytes\": %zu,\n", r.mesh_bytes);
+      fprintf(out, "      \"legacy_heap_bytes\": %llu,\n",
+              static_cast<unsigned long long>(r.legacy_heap_bytes));
+      fprintf(out, "      \"heap_bytes\": %llu,\n",
+              static_cast<unsigned long long>(r.heap_bytes));
+      fprintf(out, "      \"mesh_heap_bytes\": %llu,\n",
+              static_cast<unsigned long long>(r.mesh_heap_bytes));
+      fprintf(out, "      \"legacy_vertices\": %zu,\n", r.legacy_vertices);
+      fprintf(out, "      \"vertices\": %zu,\n", r.vertices);
+      fprintf(out, "      \"indices\": %zu,\n", r.indices);
+      fprintf(out, "      \"index_bits\": %d,\n", r.index_bits);
+      fprintf(out, "      \"max_position_error\": %g\n    }",
+              r.max_position_error);
+    }
+    fprintf(out, "\n  ]");
+  }
+
+  if (texture_load.ran) {
+    fprintf(out, ",\n  \"texture_load\": {\n");
+    if (!texture_load.error.empty()) {
+      fprintf(out, "    \"error\": \"%s\",\n", texture_load.error.c_str());
+    }
+    fprintf(out, "    \"width\": %u,\n", texture_load.width);
+    fprintf(out, "    \"height\": %u,\n", texture_load.height);
+    fprintf(out, "    \"png_file_bytes\": %zu,\n", texture_load.png_file_bytes);
+    fprintf(out, "    \"png_ms\": %.3f,\n", texture_load.png_ms);
+    fprintf(out, "    \"png_texture_bytes\": %zu,\n",
+            texture_load.png_texture_bytes);
+    fprintf(out, "    \"ktx_file_bytes\": %zu,\n", texture_load.ktx_file_bytes);
+    fprintf(out, "    \"ktx_ms\": %.3f,\n", texture_load.ktx_ms);
+    fprintf(out, "    \"ktx_texture_bytes\": %zu,\n",
+            texture_load.ktx_texture_bytes);
+    fprintf(out, "    \"ktx_psnr_db\": %.2f\n  }", texture_load.ktx_psnr_db);
+  }
+
+  if (log_cost.ran) {
+    fprintf(out, ",\n  \"log_cost\": {\n");
+    fprintf(out, "    \"iterations\": %d,\n", log_cost.iterations);
+    fprintf(out, "    \"sync_ns_per_call\": %.1f,\n",
+            log_cost.sync_ns_per_call);
+    fprintf(out, "    \"async_ns_per_call\": %.1f,\n",
+            log_cost.async_ns_per_call);
+    fprintf(out, "    \"suppressed_ns_per_call\": %.1f\n  }",
+            log_cost.suppressed_ns_per_call);
+  }
+
+  if (!checks.empty()) {
+    fprintf(out, ",\n  \"checks\": [");
+    for (size_t i = 0; i < checks.size(); ++i) {
+      fprintf(out, "%s\n    {\"name\": \"%s\", ", i ? "," : "",
+              checks[i].name.c_str());
+      if (!checks[i].error.empty()) {
+        fprintf(out, "\"error\": \"%s\", ", checks[i].error.c_str());
+      }
+      fprintf(out, "\"ms\": %.3f}", checks[i].ms);
+    }
+    fprintf(out, "\n  ]");
+  }
+  fprintf(out, "\n}\n");
+}
+
+void PrintUsage() {
+  fprintf(stderr,
+          "usage: frame_loop_benchmark --recording FILE|--synthetic-planes N\n"
+          "           [--plane-update-interval N] [--plane-vertices N]\n"
+          "           [--assets DIR]\n"
+          "           [--frames N] [--warmup N] [--reconnect-interval N]\n"
+          "           [--scenario calibration|streaming|reconnect|\n"
+          "                       context_loss|recalibration|\n"
+          "                       cubemap_encode|obj_parse|\n"
+          "                       texture_load|log_cost|metrics_server|\n"
+          "                       receiver_reconnect]...\n"
+          "           [--args \"LAUNCH OPTIONS\"] [--max-allocations N]\n"
+          "           [--cubemap-rate BYTES_PER_SECOND]\n"
+          "           [--program-cache DIR] [--obj FILE]... [--out FILE]\n");
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  bool scenarios_given = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (i + 1 >= argc) return false;
+    const char* value = argv[++i];
+    if (arg == "--recording") {
+      options->recording = value;
+    } else if (arg == "--assets") {
+      options->assets = value;
+    } else if (arg == "--out") {
+      options->out = value;
+    } else if (arg == "--args") {
+      options->args = value;
+    } else if (arg == "--frames") {
+      options->frames = atoi(value);
+    } else if (arg == "--warmup") {
+      options->warmup_frames = atoi(value);
+    } else if (arg == "--reconnect-interval") {
+      options->reconnect_interval = std::max(1, atoi(value));
+    } else if (arg == "--max-allocations") {
+      options->max_allocations = atoi(value);
+    } else if (arg == "--cubemap-rate") {
+      options->cubemap_rate = std::max(0, atoi(value));
+    } else if (arg == "--obj") {
+      options->obj_files.push_back(value);
+    } else if (arg == "--synthetic-planes") {
+      options->synthetic_planes = std::max(0, atoi(value));
+    } else if (arg == "--plane-update-interval") {
+      options->plane_update_interval = std::max(1, atoi(value));
+    } else if (arg == "--plane-vertices") {
+      options->plane_vertices = std::max(3, atoi(value));
+    } else if (arg == "--program-cache") {
+      options->program_cache = value;
+    } else if (arg == "--scenario") {
+      if (!scenarios_given) options->scenarios.clear();
+      scenarios_given = true;
+      options->scenarios.push_back(value);
+    } else {
+      return false;
+    }
+  }
+  for (const std::string& scenario : options->scenarios) {
+    if (scenario != "calibration" && scenario != "streaming" &&
+        scenario != "reconnect" && scenario != "context_loss" &&
+        scenario != "recalibration" && scenario != "cubemap_encode" &&
+        scenario != "obj_parse" && scenario != "texture_load" &&
+        scenario != "log_cost" && !FindCheck(scenario)) {
+      return false;
+    }
+  }
+  return (!options->recording.empty() || options->synthetic_planes > 0) &&
+         options->frames > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    PrintUsage();
+    return 2;
+  }
+
+  std::string synthetic_recording;
+  if (options.synthetic_planes > 0) {
+    char path[] = "/tmp/synthetic_planes_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) {
+      fprintf(stderr, "could not create a temporary file\n");
+      return 1;
+    }
+    close(fd);
+    synthetic_recording = path;
+    if (!WriteSyntheticRecording(options, synthetic_recording)) {
+      fprintf(stderr, "could not write %s\n", path);
+      remove(path);
+      return 1;
+    }
+    options.recording = synthetic_recording;
+  }
+
+  AAssetManager* assets = HostAssetManager_create(options.assets.c_str());
+  std::vector<ScenarioResult> results;
+  EncoderResult encoder;
+  std::vector<ObjLoaderResult> obj_loader;
+  TextureLoadResult texture_load;
+  LogCostResult log_cost;
+  std::vector<CheckResult> checks;
+  bool failed = false;
+  for (const std::string& scenario : options.scenarios) {
+    if (const Check* check = FindCheck(scenario)) {
+      checks.push_back(check->run());
+      if (!checks.back().error.empty()) {
+        fprintf(stderr, "%s: %s\n", scenario.c_str(),
+                checks.back().error.c_str());
+        failed = true;
+      }
+      continue;
+    }
+    if (scenario == "cubemap_encode") {
+      encoder = RunEncoderBenchmark(options);
+      if (!encoder.error.empty()) {
+        fprintf(stderr, "%s: %s\n", scenario.c_str(), encoder.error.c_str());
+        failed = true;
+      }
+      continue;
+    }
+    if (scenario == "obj_parse") {
+      obj_loader = RunObjLoaderBenchmark(options);
+      for (const ObjLoaderResult& result : obj_loader) {
+        if (result.error.empty()) continue;
+        fprintf(stderr, "%s: %s: %s\n", scenario.c_str(), result.name.c_str(),
+                result.error.c_str());
+        failed = true;
+      }
+      continue;
+    }
+    if (scenario == "log_cost") {
+      log_cost = RunLogCostBenchmark(options);
+      continue;
+    }
+    if (scenario == "texture_load") {
+      texture_load = RunTextureLoadBenchmark(options, assets);
+      if (!texture_load.error.empty()) {
+        fprintf(stderr, "%s: %s\n", scenario.c_str(),
+                texture_load.error.c_str());
+        failed = true;
+      }
+      continue;
+    }
+    results.push_back(RunScenario(options, scenario, assets));
+    if (!results.back().error.empty()) {
+      fprintf(stderr, "%s: %s\n", scenario.c_str(),
+              results.back().error.c_str());
+      failed = true;
+    }
+  }
+  HostAssetManager_destroy(assets);
+  if (!synthetic_recording.empty()) remove(synthetic_recording.c_str());
+
+  FILE* out = options.out.empty() ? stdout : fopen(options.out.c_str(), "w");
+  if (!out) {
+    fprintf(stderr, "could not write %s\n", options.out.c_str());
+    return 1;
+  }
+  WriteJson(out, options, results, encoder, obj_loader, texture_load, log_cost,
+            checks);
+  if (out != stdout) fclose(out);
+  return failed ? 1 : 0;
+}
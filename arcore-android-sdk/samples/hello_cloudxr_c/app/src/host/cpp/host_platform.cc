@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "host_platform.h"
+
+#include <android/log.h>
+#include <fcntl.h>
+#include <oboe/Oboe.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+struct AAssetManager {
+  std::string root;
+};
+
+// AASSET_MODE_BUFFER maps the file, like an uncompressed asset in an APK, the
+// other modes read it.
+struct AAsset {
+  std::vector<char> data;
+  void* mapping = nullptr;
+  size_t mapping_size = 0;
+  size_t position = 0;
+
+  const char* bytes() const {
+    return mapping ? static_cast<const char*>(mapping) : data.data();
+  }
+  size_t size() const { return mapping ? mapping_size : data.size(); }
+};
+
+namespace {
+
+int MinPriorityFromEnv() {
+  const char* level = getenv("HELLO_AR_HOST_LOG_LEVEL");
+  return level ? atoi(level) : ANDROID_LOG_WARN;
+}
+
+int g_min_log_priority = MinPriorityFromEnv();
+
+char PriorityChar(int prio) {
+  switch (prio) {
+    case ANDROID_LOG_VERBOSE: return 'V';
+    case ANDROID_LOG_DEBUG: return 'D';
+    case ANDROID_LOG_INFO: return 'I';
+    case ANDROID_LOG_WARN: return 'W';
+    case ANDROID_LOG_ERROR: return 'E';
+    case ANDROID_LOG_FATAL: return 'F';
+    default: return '?';
+  }
+}
+
+}  // namespace
+
+extern "C" {
+
+// Log.
+
+void HostLog_setMinPriority(int priority) { g_min_log_priority = priority; }
+
+int HostLog_getMinPriority(void) { return g_min_log_priority; }
+
+int __android_log_write(int prio, const char* tag, const char* text) {
+  if (prio < g_min_log_priority) return 0;
+  return fprintf(stderr, "%c/%s: %s\n", PriorityChar(prio), tag, text);
+}
+
+int __android_log_print(int prio, const char* tag, const char* fmt, ...) {
+  if (prio < g_min_log_priority) return 0;
+  char text[1024];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(text, sizeof(text), fmt, args);
+  va_end(args);
+  return __android_log_write(prio, tag, text);
+}
+
+// Assets.
+
+AAssetManager* HostAssetManager_create(const char* root) {
+  AAssetManager* manager = new AAssetManager;
+  manager->root = root ? root : ".";
+  return manager;
+}
+
+void HostAssetManager_destroy(AAssetManager* manager) { delete manager; }
+
+AAsset* AAssetManager_open(AAssetManager* mgr, const char* filename,
+                           int mode) {
+  const std::string path = mgr->root + "/" + filename;
+  if (mode == AASSET_MODE_BUFFER) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    AAsset* asset = new AAsset;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping != MAP_FAILED) {
+        asset->mapping = mapping;
+        asset->mapping_size = st.st_size;
+      }
+    }
+    close(fd);
+    return asset;
+  }
+
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) return nullptr;
+
+  AAsset* asset = new AAsset;
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  asset->data.resize(size > 0 ? size : 0);
+  if (fread(asset->data.data(), 1, asset->data.size(), file) !=
+      asset->data.size()) {
+    asset->data.clear();
+  }
+  fclose(file);
+  return asset;
+}
+
+void AAsset_close(AAsset* asset) {
+  if (asset->mapping) munmap(asset->mapping, asset->mapping_size);
+  delete asset;
+}
+
+int AAsset_read(AAsset* asset, void* buf, size_t count) {
+  const size_t remaining = asset->size() - asset->position;
+  if (count > remaining) count = remaining;
+  std::copy(asset->bytes() + asset->position,
+            asset->bytes() + asset->position + count, static_cast<char*>(buf));
+  asset->position += count;
+  return static_cast<int>(count);
+}
+
+off_t AAsset_getLength(AAsset* asset) { return asset->size(); }
+
+const void* AAsset_getBuffer(AAsset* asset) { return asset->bytes(); }
+
+}  // extern "C"
+
+// Oboe.
+
+namespace oboe {
+
+const char* convertToText(Result result) {
+  return result == Result::OK ? "OK" : "ErrorInternal";
+}
+
+Result AudioStream::start() {
+  started_ = true;
+  return Result::OK;
+}
+
+Result AudioStream::close() {
+  started_ = false;
+  return Result::OK;
+}
+
+ResultWithValue<int32_t> AudioStream::write(const void* buffer,
+                                            int32_t num_frames,
+                                            int64_t timeout_nanoseconds) {
+  if (!started_) return ResultWithValue<int32_t>(Result::ErrorInternal);
+  return ResultWithValue<int32_t>(num_frames);
+}
+
+Result AudioStream::setBufferSizeInFrames(int32_t frames) {
+  buffer_size_frames_ = frames;
+  return Result::OK;
+}
+
+Result AudioStreamBuilder::openStream(std::shared_ptr<AudioStream>& stream) {
+  stream = std::make_shared<AudioStream>(direction_);
+  return Result::OK;
+}
+
+}  // namespace oboe
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_HOST_PLATFORM_H_
+#define C_ARCORE_HELLO_AR_HOST_PLATFORM_H_
+
+#include <android/asset_manager.h>
+
+// Host implementations of the Android platform calls the client makes (log,
+// assets and Oboe), so the native code can run in a workstation process.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Creates an asset manager that opens files relative to |root|, normally the
+// app's src/main/assets directory.
+AAssetManager* HostAssetManager_create(const char* root);
+void HostAssetManager_destroy(AAssetManager* manager);
+
+// Messages below |priority| (an android_LogPriority) are dropped.  Defaults to
+// ANDROID_LOG_WARN, or the HELLO_AR_HOST_LOG_LEVEL environment variable.
+void HostLog_setMinPriority(int priority);
+int HostLog_getMinPriority(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // C_ARCORE_HELLO_AR_HOST_PLATFORM_H_
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+// Converts OBJ models into the binary mesh format of mesh_format.h, for
+// loading with MeshAsset:
+//   mesh_convert [--quantize] model.obj model.mesh
+// --quantize stores normals as 16-bit snorm and uvs in [0, 1] as 16-bit unorm.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "asset_view.h"
+#include "mesh_asset.h"
+#include "obj_loader.h"
+
+int main(int argc, char** argv) {
+  bool quantize = false;
+  std::vector<const char*> paths;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--quantize") == 0) {
+      quantize = true;
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+  if (paths.size() != 2) {
+    fprintf(stderr, "usage: mesh_convert [--quantize] INPUT.obj OUTPUT.mesh\n");
+    return 2;
+  }
+
+  hello_ar::AssetView obj;
+  if (!obj.MapFile(paths[0])) {
+    fprintf(stderr, "could not read %s\n", paths[0]);
+    return 1;
+  }
+  hello_ar::ObjMesh mesh;
+  if (!hello_ar::ParseObj(obj.chars(), obj.size(), &mesh)) {
+    fprintf(stderr, "could not parse %s\n", paths[0]);
+    return 1;
+  }
+
+  std::vector<uint8_t> encoded;
+  hello_ar::EncodeMesh(mesh, quantize, &encoded);
+  FILE* out = fopen(paths[1], "wb");
+  bool ok = out && fwrite(encoded.data(), 1, encoded.size(), out) ==
+                             encoded.size();
+  if (out) ok = fclose(out) == 0 && ok;
+  if (!ok) {
+    fprintf(stderr, "could not write %s\n", paths[1]);
+    return 1;
+  }
+
+  hello_ar::mesh::MeshFileHeader header;
+  memcpy(&header, encoded.data(), sizeof(header));
+  printf("%s: %u vertices of %u bytes, %u %d-bit indices, %zu bytes "
+         "(OBJ %zu bytes)\n",
+         paths[1], header.vertex_count, header.vertex_stride,
+         header.index_count,
+         (header.flags & hello_ar::mesh::kMeshIndex32) ? 32 : 16,
+         encoded.size(), obj.size());
+  return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+// Converts PNG images into KTX textures with a precomputed mip chain, see
+// texture_format.h, for loading with LoadKtxTexture():
+//   texture_convert [--format etc2|etc2a|rgba8] image.png image.ktx
+// The format defaults to etc2 (ETC2 RGB) for opaque images and etc2a (ETC2
+// RGB with EAC alpha) otherwise.
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "texture_encoder.h"
+
+int main(int argc, char** argv) {
+  const char* format_name = nullptr;
+  std::vector<const char*> paths;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+      format_name = argv[++i];
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+  if (paths.size() != 2) {
+    fprintf(stderr,
+            "usage: texture_convert [--format etc2|etc2a|rgba8] INPUT.png "
+            "OUTPUT.ktx\n");
+    return 2;
+  }
+
+  hello_ar::Image image;
+  if (!hello_ar::DecodePng(paths[0], &image)) {
+    fprintf(stderr, "could not read %s\n", paths[0]);
+    return 1;
+  }
+
+  const bool alpha = hello_ar::HasAlpha(image);
+  hello_ar::TextureFormat format = alpha ? hello_ar::TextureFormat::kEtc2Rgba
+                                         : hello_ar::TextureFormat::kEtc2Rgb;
+  if (format_name != nullptr) {
+    if (strcmp(format_name, "etc2") == 0) {
+      format = hello_ar::TextureFormat::kEtc2Rgb;
+    } else if (strcmp(format_name, "etc2a") == 0) {
+      format = hello_ar::TextureFormat::kEtc2Rgba;
+    } else if (strcmp(format_name, "rgba8") == 0) {
+      format = hello_ar::TextureFormat::kRgba8;
+    } else {
+      fprintf(stderr, "unknown format %s\n", format_name);
+      return 2;
+    }
+  }
+
+  std::vector<uint8_t> encoded;
+  hello_ar::EncodeKtx(image, format, &encoded);
+  FILE* out = fopen(paths[1], "wb");
+  bool ok = out && fwrite(encoded.data(), 1, encoded.size(), out) ==
+                             encoded.size();
+  if (out) ok = fclose(out) == 0 && ok;
+  if (!ok) {
+    fprintf(stderr, "could not write %s\n", paths[1]);
+    return 1;
+  }
+
+  hello_ar::Image decoded;
+  hello_ar::DecodeKtxLevel(encoded.data(), encoded.size(), 0, &decoded);
+  // Uncompressed RGBA8 with generated mipmaps takes 4/3 of the base level.
+  const size_t rgba_bytes = image.rgba.size() * 4 / 3;
+  printf("%s: %ux%u, %zu bytes with mipmaps (RGBA8 %zu bytes), "
+         "PSNR %.1f dB\n",
+         paths[1], image.width, image.height, encoded.size(), rgba_bytes,
+         hello_ar::ImagePsnr(image, decoded, alpha));
+  return 0;
+}
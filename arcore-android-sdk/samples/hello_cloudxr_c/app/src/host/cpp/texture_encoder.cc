@@ -0,0 +1,474 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "texture_encoder.h"
+
+#include <png.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "texture_format.h"
+
+namespace hello_ar {
+namespace {
+
+// ETC1/ETC2 intensity modifiers, the small and large one of each table.
+constexpr int kEtcModifiers[8][2] = {{2, 8},   {5, 17},  {9, 29},   {13, 42},
+                                     {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+
+// EAC alpha modifiers, scaled by the block's multiplier.
+constexpr int kEacModifiers[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},  {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},  {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},  {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},   {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+int Clamp255(int value) { return std::min(255, std::max(0, value)); }
+
+// Modifier of 2-bit pixel index |code| in |table|: +small, +large, -small,
+// -large.
+int EtcModifier(int table, int code) {
+  const int modifier = kEtcModifiers[table][code & 1];
+  return (code & 2) ? -modifier : modifier;
+}
+
+// Pixels of a 4x4 block are numbered by column, i = x * 4 + y, and a block is
+// split into two 2x4 halves, or two 4x2 halves if flipped.
+int SubblockOf(int i, bool flip) { return flip ? (i & 3) >= 2 : i >= 8; }
+
+struct Block {
+  uint8_t rgba[16][4];
+};
+
+Block ReadBlock(const Image& image, uint32_t block_x, uint32_t block_y) {
+  Block block;
+  for (int i = 0; i < 16; ++i) {
+    // Blocks over the edge of small mip levels repeat the last pixels.
+    const uint32_t x = std::min(block_x * 4 + i / 4, image.width - 1);
+    const uint32_t y = std::min(block_y * 4 + i % 4, image.height - 1);
+    memcpy(block.rgba[i], &image.rgba[(y * image.width + x) * 4], 4);
+  }
+  return block;
+}
+
+void WriteBlock(const Block& block, uint32_t block_x, uint32_t block_y,
+                Image* image) {
+  for (int i = 0; i < 16; ++i) {
+    const uint32_t x = block_x * 4 + i / 4;
+    const uint32_t y = block_y * 4 + i % 4;
+    if (x < image->width && y < image->height) {
+      memcpy(&image->rgba[(y * image->width + x) * 4], block.rgba[i], 4);
+    }
+  }
+}
+
+void PutBigEndian(uint64_t value, uint8_t* out) {
+  for (int i = 0; i < 8; ++i) {
+    out[i] = static_cast<uint8_t>(value >> (56 - 8 * i));
+  }
+}
+
+uint64_t GetBigEndian(const uint8_t* in) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) value = value << 8 | in[i];
+  return value;
+}
+
+// Picks the modifier table and pixel indices for the pixels of |subblock|
+// around |base|.  Returns the squared error.
+int FitSubblock(const Block& block, bool flip, int subblock, const int base[3],
+                int* best_table, uint32_t* indices) {
+  int best_error = std::numeric_limits<int>::max();
+  for (int table = 0; table < 8; ++table) {
+    int error = 0;
+    uint32_t table_indices = 0;
+    for (int i = 0; i < 16 && error < best_error; ++i) {
+      if (SubblockOf(i, flip) != subblock) continue;
+      int best_pixel_error = std::numeric_limits<int>::max();
+      int best_code = 0;
+      for (int code = 0; code < 4; ++code) {
+        const int modifier = EtcModifier(table, code);
+        int pixel_error = 0;
+        for (int c = 0; c < 3; ++c) {
+          const int d = Clamp255(base[c] + modifier) - block.rgba[i][c];
+          pixel_error += d * d;
+        }
+        if (pixel_error < best_pixel_error) {
+          best_pixel_error = pixel_error;
+          best_code = code;
+        }
+      }
+      error += best_pixel_error;
+      table_indices |= (best_code >> 1) << (16 + i) | (best_code & 1) << i;
+    }
+    if (error < best_error) {
+      best_error = error;
+      *best_table = table;
+      *indices = table_indices;
+    }
+  }
+  return best_error;
+}
+
+// Encodes the color of |block| in the individual or differential mode,
+// whichever fits better.  The differential mode is only used when the
+// second base color is in range, so ETC2 decoders never see its T, H or
+// planar modes.
+uint64_t EncodeEtcBlock(const Block& block) {
+  uint64_t best_code = 0;
+  int best_error = std::numeric_limits<int>::max();
+  for (int flip = 0; flip < 2; ++flip) {
+    float average[2][3] = {};
+    for (int i = 0; i < 16; ++i) {
+      for (int c = 0; c < 3; ++c) {
+        average[SubblockOf(i, flip)][c] += block.rgba[i][c] / 8.f;
+      }
+    }
+
+    for (int differential = 0; differential < 2; ++differential) {
+      const int levels = differential ? 31 : 15;
+      int quantized[2][3];
+      int base[2][3];
+      for (int s = 0; s < 2; ++s) {
+        for (int c = 0; c < 3; ++c) {
+          quantized[s][c] =
+              static_cast<int>(std::lround(average[s][c] * levels / 255.f));
+          base[s][c] = differential
+                           ? quantized[s][c] << 3 | quantized[s][c] >> 2
+                           : quantized[s][c] * 17;
+        }
+      }
+      int delta[3];
+      if (differential) {
+        bool in_range = true;
+        for (int c = 0; c < 3; ++c) {
+          delta[c] = quantized[1][c] - quantized[0][c];
+          in_range = in_range && delta[c] >= -4 && delta[c] <= 3;
+        }
+        if (!in_range) continue;
+      }
+
+      int tables[2];
+      uint32_t indices[2];
+      const int error =
+          FitSubblock(block, flip, 0, base[0], &tables[0], &indices[0]) +
+          FitSubblock(block, flip, 1, base[1], &tables[1], &indices[1]);
+      if (error >= best_error) continue;
+
+      uint64_t colors = 0;
+      for (int c = 0; c < 3; ++c) {
+        const int shift = 24 - 8 * c;
+        colors |= differential
+                      ? uint64_t(quantized[0][c]) << (shift + 3) |
+                            uint64_t(delta[c] & 7) << shift
+                      : uint64_t(quantized[0][c]) << (shift + 4) |
+                            uint64_t(quantized[1][c]) << shift;
+      }
+      const uint64_t high = colors | tables[0] << 5 | tables[1] << 2 |
+                            differential << 1 | flip;
+      best_error = error;
+      best_code = high << 32 | indices[0] | indices[1];
+    }
+  }
+  return best_code;
+}
+
+void DecodeEtcBlock(uint64_t code, Block* block) {
+  const uint32_t high = static_cast<uint32_t>(code >> 32);
+  const bool differential = (high >> 1) & 1;
+  const bool flip = high & 1;
+  int base[2][3];
+  for (int c = 0; c < 3; ++c) {
+    const int shift = 24 - 8 * c;
+    if (differential) {
+      const int first = (high >> (shift + 3)) & 31;
+      int delta = static_cast<int>((high >> shift) & 7);
+      if (delta >= 4) delta -= 8;
+      const int second = first + delta;
+      base[0][c] = first << 3 | first >> 2;
+      base[1][c] = second << 3 | second >> 2;
+    } else {
+      base[0][c] = ((high >> (shift + 4)) & 15) * 17;
+      base[1][c] = ((high >> shift) & 15) * 17;
+    }
+  }
+  const int tables[2] = {static_cast<int>((high >> 5) & 7),
+                         static_cast<int>((high >> 2) & 7)};
+  for (int i = 0; i < 16; ++i) {
+    const int s = SubblockOf(i, flip);
+    const int index = static_cast<int>((code >> (16 + i)) & 1) << 1 |
+                      static_cast<int>((code >> i) & 1);
+    const int modifier = EtcModifier(tables[s], index);
+    for (int c = 0; c < 3; ++c) {
+      block->rgba[i][c] = static_cast<uint8_t>(Clamp255(base[s][c] + modifier));
+    }
+  }
+}
+
+uint64_t EncodeEacBlock(const Block& block) {
+  int low = 255, high = 0;
+  for (int i = 0; i < 16; ++i) {
+    low = std::min<int>(low, block.rgba[i][3]);
+    high = std::max<int>(high, block.rgba[i][3]);
+  }
+
+  uint64_t best_code = 0;
+  int best_error = std::numeric_limits<int>::max();
+  for (int table = 0; table < 16 && best_error > 0; ++table) {
+    const int* modifiers = kEacModifiers[table];
+    const int span = modifiers[7] - modifiers[3];
+    // Multipliers around the one stretching the table over the block's range.
+    const int fit = (high - low + span - 1) / span;
+    for (int multiplier = std::max(1, fit - 1);
+         multiplier <= std::min(15, fit + 1); ++multiplier) {
+      const int base = Clamp255(static_cast<int>(std::lround(
+          (low + high) / 2.f - multiplier * (modifiers[7] + modifiers[3]) / 2.f)));
+      int error = 0;
+      uint64_t indices = 0;
+      for (int i = 0; i < 16; ++i) {
+        int best_pixel_error = std::numeric_limits<int>::max();
+        int best_index = 0;
+        for (int index = 0; index < 8; ++index) {
+          const int d = Clamp255(base + modifiers[index] * multiplier) -
+                        block.rgba[i][3];
+          if (d * d < best_pixel_error) {
+            best_pixel_error = d * d;
+            best_index = index;
+          }
+        }
+        error += best_pixel_error;
+        indices |= uint64_t(best_index) << (45 - 3 * i);
+      }
+      if (error < best_error) {
+        best_error = error;
+        best_code = uint64_t(base) << 56 | uint64_t(multiplier) << 52 |
+                    uint64_t(table) << 48 | indices;
+      }
+    }
+  }
+  return best_code;
+}
+
+void DecodeEacBlock(uint64_t code, Block* block) {
+  const int base = static_cast<int>(code >> 56);
+  const int multiplier = static_cast<int>((code >> 52) & 15);
+  const int* modifiers = kEacModifiers[(code >> 48) & 15];
+  for (int i = 0; i < 16; ++i) {
+    const int index = static_cast<int>((code >> (45 - 3 * i)) & 7);
+    block->rgba[i][3] =
+        static_cast<uint8_t>(Clamp255(base + modifiers[index] * multiplier));
+  }
+}
+
+uint32_t BlockBytes(TextureFormat format) {
+  return format == TextureFormat::kEtc2Rgba ? 16 : 8;
+}
+
+uint32_t LevelSize(const Image& level, TextureFormat format) {
+  if (format == TextureFormat::kRgba8) return level.width * level.height * 4;
+  return ((level.width + 3) / 4) * ((level.height + 3) / 4) *
+         BlockBytes(format);
+}
+
+void EncodeLevel(const Image& level, TextureFormat format, uint8_t* out) {
+  if (format == TextureFormat::kRgba8) {
+    memcpy(out, level.rgba.data(), level.rgba.size());
+    return;
+  }
+  const uint32_t blocks_x = (level.width + 3) / 4;
+  const uint32_t blocks_y = (level.height + 3) / 4;
+  for (uint32_t by = 0; by < blocks_y; ++by) {
+    for (uint32_t bx = 0; bx < blocks_x; ++bx) {
+      const Block block = ReadBlock(level, bx, by);
+      if (format == TextureFormat::kEtc2Rgba) {
+        PutBigEndian(EncodeEacBlock(block), out);
+        out += 8;
+      }
+      PutBigEndian(EncodeEtcBlock(block), out);
+      out += 8;
+    }
+  }
+}
+
+}  // namespace
+
+bool DecodePng(const char* path, Image* image) {
+  png_image png;
+  memset(&png, 0, sizeof(png));
+  png.version = PNG_IMAGE_VERSION;
+  if (!png_image_begin_read_from_file(&png, path)) return false;
+  png.format = PNG_FORMAT_RGBA;
+  image->width = png.width;
+  image->height = png.height;
+  image->rgba.resize(PNG_IMAGE_SIZE(png));
+  if (!png_image_finish_read(&png, nullptr, image->rgba.data(), 0, nullptr)) {
+    png_image_free(&png);
+    return false;
+  }
+  return true;
+}
+
+bool HasAlpha(const Image& image) {
+  for (size_t i = 3; i < image.rgba.size(); i += 4) {
+    if (image.rgba[i] != 255) return true;
+  }
+  return false;
+}
+
+Image DownsampleImage(const Image& image) {
+  Image half;
+  half.width = std::max(1u, image.width / 2);
+  half.height = std::max(1u, image.height / 2);
+  half.rgba.resize(size_t(half.width) * half.height * 4);
+  for (uint32_t y = 0; y < half.height; ++y) {
+    const uint32_t y0 = std::min(2 * y, image.height - 1);
+    const uint32_t y1 = std::min(2 * y + 1, image.height - 1);
+    for (uint32_t x = 0; x < half.width; ++x) {
+      const uint32_t x0 = std::min(2 * x, image.width - 1);
+      const uint32_t x1 = std::min(2 * x + 1, image.width - 1);
+      for (int c = 0; c < 4; ++c) {
+        const int sum = image.rgba[(y0 * image.width + x0) * 4 + c] +
+                        image.rgba[(y0 * image.width + x1) * 4 + c] +
+                        image.rgba[(y1 * image.width + x0) * 4 + c] +
+                        image.rgba[(y1 * image.width + x1) * 4 + c];
+        half.rgba[(y * half.width + x) * 4 + c] =
+            static_cast<uint8_t>((sum + 2) / 4);
+      }
+    }
+  }
+  return half;
+}
+
+void EncodeKtx(const Image& image, TextureFormat format,
+               std::vector<uint8_t>* out) {
+  ktx::KtxFileHeader header = {};
+  memcpy(header.identifier, ktx::kFileIdentifier, sizeof(header.identifier));
+  header.endianness = ktx::kEndianness;
+  switch (format) {
+    case TextureFormat::kEtc2Rgb:
+      header.gl_type_size = 1;
+      header.gl_internal_format = ktx::kGlCompressedRgb8Etc2;
+      header.gl_base_internal_format = ktx::kGlRgb;
+      break;
+    case TextureFormat::kEtc2Rgba:
+      header.gl_type_size = 1;
+      header.gl_internal_format = ktx::kGlCompressedRgba8Etc2Eac;
+      header.gl_base_internal_format = ktx::kGlRgba;
+      break;
+    case TextureFormat::kRgba8:
+      header.gl_type = ktx::kGlUnsignedByte;
+      header.gl_type_size = 1;
+      header.gl_format = ktx::kGlRgba;
+      header.gl_internal_format = ktx::kGlRgba8;
+      header.gl_base_internal_format = ktx::kGlRgba;
+      break;
+  }
+  header.pixel_width = image.width;
+  header.pixel_height = image.height;
+  header.number_of_faces = 1;
+  header.number_of_mipmap_levels = 1;
+  while ((image.width | image.height) >> header.number_of_mipmap_levels) {
+    ++header.number_of_mipmap_levels;
+  }
+
+  out->assign(reinterpret_cast<const uint8_t*>(&header),
+              reinterpret_cast<const uint8_t*>(&header) + sizeof(header));
+  Image level = image;
+  for (uint32_t i = 0; i < header.number_of_mipmap_levels; ++i) {
+    if (i > 0) level = DownsampleImage(level);
+    const uint32_t size = LevelSize(level, format);
+    const size_t offset = out->size();
+    out->resize(offset + sizeof(size) + ktx::PadLevelSize(size));
+    memcpy(out->data() + offset, &size, sizeof(size));
+    EncodeLevel(level, format, out->data() + offset + sizeof(size));
+  }
+}
+
+bool DecodeKtxLevel(const uint8_t* data, size_t size, uint32_t level,
+                    Image* image) {
+  ktx::KtxFileHeader header;
+  ktx::KtxLevel levels[ktx::kMaxLevels];
+  if (!ktx::ParseKtxFile(data, size, &header, levels) ||
+      level >= header.number_of_mipmap_levels) {
+    return false;
+  }
+  TextureFormat format;
+  if (header.gl_internal_format == ktx::kGlCompressedRgb8Etc2) {
+    format = TextureFormat::kEtc2Rgb;
+  } else if (header.gl_internal_format == ktx::kGlCompressedRgba8Etc2Eac) {
+    format = TextureFormat::kEtc2Rgba;
+  } else if (header.gl_internal_format == ktx::kGlRgba8) {
+    format = TextureFormat::kRgba8;
+  } else {
+    return false;
+  }
+
+  image->width = levels[level].width;
+  image->height = levels[level].height;
+  image->rgba.assign(size_t(image->width) * image->height * 4, 255);
+  if (levels[level].size != LevelSize(*image, format)) return false;
+  const uint8_t* in = data + levels[level].offset;
+  if (format == TextureFormat::kRgba8) {
+    memcpy(image->rgba.data(), in, image->rgba.size());
+    return true;
+  }
+  const uint32_t blocks_x = (image->width + 3) / 4;
+  const uint32_t blocks_y = (image->height + 3) / 4;
+  for (uint32_t by = 0; by < blocks_y; ++by) {
+    for (uint32_t bx = 0; bx < blocks_x; ++bx) {
+      Block block;
+      memset(&block, 255, sizeof(block));
+      if (format == TextureFormat::kEtc2Rgba) {
+        DecodeEacBlock(GetBigEndian(in), &block);
+        in += 8;
+      }
+      DecodeEtcBlock(GetBigEndian(in), &block);
+      in += 8;
+      WriteBlock(block, bx, by, image);
+    }
+  }
+  return true;
+}
+
+double ImagePsnr(const Image& reference, const Image& decoded, bool alpha) {
+  const int channels = alpha ? 4 : 3;
+  double squared_error = 0.0;
+  for (size_t i = 0; i < reference.rgba.size(); i += 4) {
+    for (int c = 0; c < channels; ++c) {
+      const double d = double(reference.rgba[i + c]) - decoded.rgba[i + c];
+      squared_error += d * d;
+    }
+  }
+  const double mean = squared_error / (reference.rgba.size() / 4 * channels);
+  return mean > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mean)
+                    : std::numeric_limits<double>::infinity();
+}
+
+}  // namespace hello_ar
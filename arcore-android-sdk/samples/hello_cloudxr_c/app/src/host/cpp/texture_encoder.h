@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_TEXTURE_ENCODER_H_
+#define C_ARCORE_HELLO_AR_TEXTURE_ENCODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Encoding of textures into the KTX files of texture_format.h, for
+// texture_convert and the benchmark.  ETC2 blocks use only the modes shared
+// with ETC1 (individual and differential), plus EAC for alpha.
+namespace hello_ar {
+
+// 8-bit RGBA pixels, rows top to bottom.
+struct Image {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<uint8_t> rgba;
+};
+
+enum class TextureFormat {
+  kEtc2Rgb,
+  kEtc2Rgba,
+  kRgba8,
+};
+
+bool DecodePng(const char* path, Image* image);
+
+// True if any pixel is not fully opaque.
+bool HasAlpha(const Image& image);
+
+// Halves |image| with a box filter, down to a minimum of 1 pixel.
+Image DownsampleImage(const Image& image);
+
+// Encodes |image| with its full mip chain down to 1x1.
+void EncodeKtx(const Image& image, TextureFormat format,
+               std::vector<uint8_t>* out);
+
+// Decodes mip level |level| of a KTX file written by EncodeKtx().
+bool DecodeKtxLevel(const uint8_t* data, size_t size, uint32_t level,
+                    Image* image);
+
+// Peak signal to noise ratio of |decoded| against |reference| in dB, over the
+// color channels and also alpha if |alpha| is set.
+double ImagePsnr(const Image& reference, const Image& decoded, bool alpha);
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_TEXTURE_ENCODER_H_
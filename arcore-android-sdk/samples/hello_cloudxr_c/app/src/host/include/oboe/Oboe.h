@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+// Host build stand-in for Oboe, covering the stream builder and stream calls
+// the client makes.  Streams open successfully, accept every write and never
+// invoke the data callback, see host_platform.cc.
+
+#ifndef C_ARCORE_HELLO_AR_HOST_OBOE_H_
+#define C_ARCORE_HELLO_AR_HOST_OBOE_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+namespace oboe {
+
+constexpr int64_t kNanosPerMillisecond = 1000000;
+
+enum class Result : int32_t { OK = 0, ErrorInternal = -896 };
+enum class DataCallbackResult : int32_t { Continue = 0, Stop };
+enum class Direction : int32_t { Output = 0, Input };
+enum class PerformanceMode : int32_t { None = 10, PowerSaving, LowLatency };
+enum class SharingMode : int32_t { Exclusive = 0, Shared };
+enum class AudioFormat : int32_t { I16 = 1, Float };
+enum class InputPreset : int32_t { VoiceCommunication = 7 };
+enum ChannelCount : int32_t { Mono = 1, Stereo = 2 };
+
+const char* convertToText(Result result);
+
+template <typename T>
+class ResultWithValue {
+ public:
+  explicit ResultWithValue(T value) : value_(value), error_(Result::OK) {}
+  explicit ResultWithValue(Result error) : value_(), error_(error) {}
+
+  T value() const { return value_; }
+  Result error() const { return error_; }
+  explicit operator bool() const { return error_ == Result::OK; }
+
+ private:
+  T value_;
+  Result error_;
+};
+
+class AudioStream;
+
+class AudioStreamDataCallback {
+ public:
+  virtual ~AudioStreamDataCallback() = default;
+  virtual DataCallbackResult onAudioReady(AudioStream* stream,
+                                          void* audio_data,
+                                          int32_t num_frames) = 0;
+};
+
+class AudioStream {
+ public:
+  explicit AudioStream(Direction direction) : direction_(direction) {}
+
+  Result start();
+  Result close();
+  ResultWithValue<int32_t> write(const void* buffer, int32_t num_frames,
+                                 int64_t timeout_nanoseconds);
+  int32_t getFramesPerBurst() const { return 192; }
+  Result setBufferSizeInFrames(int32_t frames);
+  int32_t getBufferSizeInFrames() const { return buffer_size_frames_; }
+  Direction getDirection() const { return direction_; }
+
+ private:
+  Direction direction_;
+  int32_t buffer_size_frames_ = 384;
+  bool started_ = false;
+};
+
+class AudioStreamBuilder {
+ public:
+  AudioStreamBuilder& setDirection(Direction direction) {
+    direction_ = direction;
+    return *this;
+  }
+  AudioStreamBuilder& setPerformanceMode(PerformanceMode) { return *this; }
+  AudioStreamBuilder& setSharingMode(SharingMode) { return *this; }
+  AudioStreamBuilder& setFormat(AudioFormat) { return *this; }
+  AudioStreamBuilder& setChannelCount(int32_t) { return *this; }
+  AudioStreamBuilder& setSampleRate(int32_t) { return *this; }
+  AudioStreamBuilder& setInputPreset(InputPreset) { return *this; }
+  AudioStreamBuilder& setDataCallback(AudioStreamDataCallback*) {
+    return *this;
+  }
+
+  Result openStream(std::shared_ptr<AudioStream>& stream);
+
+ private:
+  Direction direction_ = Direction::Output;
+};
+
+}  // namespace oboe
+
+#endif  // C_ARCORE_HELLO_AR_HOST_OBOE_H_
@@ -17,11 +17,10 @@
 precision highp float;
 precision highp int;
 uniform sampler2D texture;
-uniform vec3 color;
 varying vec2 v_textureCoords;
-varying float v_alpha;
+varying vec4 v_color;
 
 void main() {
   float r = texture2D(texture, v_textureCoords).r;
-  gl_FragColor = vec4(color.xyz, r * v_alpha);
+  gl_FragColor = vec4(v_color.rgb, r * v_color.a);
 }
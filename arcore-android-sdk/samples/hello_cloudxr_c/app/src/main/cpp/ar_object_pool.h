@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#ifndef C_ARCORE_HELLO_AR_AR_OBJECT_POOL_H_
+#define C_ARCORE_HELLO_AR_AR_OBJECT_POOL_H_
+
+#include <vector>
+
+#include "arcore_c_api.h"
+
+namespace hello_ar {
+
+// How to create and destroy each pooled ARCore object type.
+template <typename T>
+struct ArObjectTraits;
+
+template <>
+struct ArObjectTraits<ArPose> {
+  static void Create(const ArSession* session, ArPose** out) {
+    ArPose_create(session, nullptr, out);
+  }
+  static void Destroy(ArPose* pose) { ArPose_destroy(pose); }
+};
+
+template <>
+struct ArObjectTraits<ArTrackableList> {
+  static void Create(const ArSession* session, ArTrackableList** out) {
+    ArTrackableList_create(session, out);
+  }
+  static void Destroy(ArTrackableList* list) { ArTrackableList_destroy(list); }
+};
+
+// Recycles ARCore objects the frame loop would otherwise create and destroy
+// every frame.  Released objects keep whatever they last held; every user
+// overwrites them (ArFrame_getLightEstimate, ArSession_getAllTrackables,
+// ArCamera_getPose, ...) before reading.
+template <typename T>
+class ArObjectPool {
+ public:
+  ArObjectPool() { free_.reserve(8); }
+  ~ArObjectPool() { Clear(); }
+
+  ArObjectPool(const ArObjectPool&) = delete;
+  void operator=(const ArObjectPool&) = delete;
+
+  T* Acquire(const ArSession* session) {
+    if (free_.empty()) {
+      T* object = nullptr;
+      ArObjectTraits<T>::Create(session, &object);
+      return object;
+    }
+    T* object = free_.back();
+    free_.pop_back();
+    return object;
+  }
+
+  void Release(T* object) {
+    if (object) free_.push_back(object);
+  }
+
+  // Destroys the pooled objects.  Call before destroying the session.
+  void Clear() {
+    for (T* object : free_) ArObjectTraits<T>::Destroy(object);
+    free_.clear();
+  }
+
+ private:
+  std::vector<T*> free_;
+};
+
+// The pools used by the frame loop, cleared together with the session.
+struct ArObjectPools {
+  ArObjectPool<ArPose> poses;
+  ArObjectPool<ArTrackableList> trackable_lists;
+
+  void Clear() {
+    poses.Clear();
+    trackable_lists.Clear();
+  }
+};
+
+// Acquires an object from a pool for the enclosing scope.
+template <typename T>
+class ScopedArObject {
+ public:
+  ScopedArObject(ArObjectPool<T>* pool, const ArSession* session)
+      : pool_(pool), object_(pool->Acquire(session)) {}
+  ~ScopedArObject() { pool_->Release(object_); }
+
+  ScopedArObject(const ScopedArObject&) = delete;
+  void operator=(const ScopedArObject&) = delete;
+
+  T* get() const { return object_; }
+
+ private:
+  ArObjectPool<T>* pool_;
+  T* object_;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_AR_OBJECT_POOL_H_
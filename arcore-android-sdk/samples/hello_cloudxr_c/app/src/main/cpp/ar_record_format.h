@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#ifndef C_ARCORE_HELLO_AR_AR_RECORD_FORMAT_H_
+#define C_ARCORE_HELLO_AR_AR_RECORD_FORMAT_H_
+
+#include <cstdint>
+
+// On-disk layout of the ARCore session recordings written by ArSessionRecorder
+// and played back by the host-side replay shim (src/host/cpp/arcore_replay.cc).
+// This header must stay free of Android and ARCore dependencies.
+//
+// A file is an ArRecordFileHeader followed by a stream of frames.  Each frame
+// is an ArRecordFrame, then |plane_count| ArRecordPlanes each followed by
+// |polygon_size| floats (x, z pairs in the plane's local frame), then
+// |anchor_count| ArRecordAnchors.  |frame_size| covers all of it, so readers
+// can skip frames without parsing them.  Poses are ARCore raw poses:
+// qx, qy, qz, qw, tx, ty, tz.
+namespace hello_ar {
+namespace arrec {
+
+constexpr char kFileMagic[8] = {'A', 'R', 'R', 'E', 'C', '\0', '\0', '\0'};
+constexpr uint32_t kFileVersion = 1;
+
+// Clip planes the projection matrix is recorded with.  Replay recomputes the
+// depth terms for the planes the caller asks for.
+constexpr float kProjectionNear = 0.1f;
+constexpr float kProjectionFar = 100.f;
+
+struct ArRecordFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  int32_t camera_image_width;
+  int32_t camera_image_height;
+  // Wall clock time the recording was started, in milliseconds since the epoch.
+  uint64_t start_time_ms;
+  uint32_t reserved[8];
+};
+static_assert(sizeof(ArRecordFileHeader) == 64,
+              "ArRecordFileHeader layout changed");
+
+struct ArRecordFrame {
+  uint32_t frame_size;
+  uint32_t plane_count;
+  uint32_t anchor_count;
+  uint32_t reserved;
+  int64_t timestamp_ns;
+
+  int32_t display_width;
+  int32_t display_height;
+  int32_t display_rotation;
+  int32_t display_geometry_changed;
+
+  // Camera.
+  int32_t tracking_state;
+  int32_t tracking_failure_reason;
+  float camera_pose[7];
+  float view_matrix[16];
+  float projection_matrix[16];
+  // Texture coordinates of the NDC corners (-1,-1) (1,-1) (-1,1) (1,1).
+  float display_uvs[8];
+
+  // Light estimate.
+  int32_t light_state;
+  float color_correction[4];
+  float main_light_direction[3];
+  float main_light_intensity[3];
+  float ambient_spherical_harmonics[27];
+};
+static_assert(sizeof(ArRecordFrame) == 392, "ArRecordFrame layout changed");
+
+struct ArRecordPlane {
+  // Stable for the lifetime of the plane within a recording, never 0.
+  uint32_t id;
+  // Id of the plane that subsumed this one, or 0.
+  uint32_t subsumed_by;
+  int32_t tracking_state;
+  int32_t type;
+  float center_pose[7];
+  float extent_x;
+  float extent_z;
+  uint32_t polygon_size;
+};
+static_assert(sizeof(ArRecordPlane) == 56, "ArRecordPlane layout changed");
+
+// Anchors the application holds, in the order it created them.
+struct ArRecordAnchor {
+  int32_t tracking_state;
+  float pose[7];
+};
+static_assert(sizeof(ArRecordAnchor) == 32, "ArRecordAnchor layout changed");
+
+}  // namespace arrec
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_AR_RECORD_FORMAT_H_
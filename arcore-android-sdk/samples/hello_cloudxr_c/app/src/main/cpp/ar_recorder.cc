@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "ar_recorder.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "util.h"
+
+namespace hello_ar {
+namespace {
+// Large enough for a few frames with planes, so the render thread rarely
+// waits on the file system.
+constexpr size_t kFileBufferSize = 256 * 1024;
+
+// NDC corners, in the order ArRecordFrame::display_uvs stores them.
+constexpr float kNdcCorners[8] = {-1.f, -1.f, 1.f, -1.f, -1.f, 1.f, 1.f, 1.f};
+}  // namespace
+
+ArSessionRecorder::~ArSessionRecorder() { Stop(); }
+
+void ArSessionRecorder::SetOutputPath(const std::string& path) {
+  if (path == path_) return;
+  Stop();
+  path_ = path;
+  failed_ = false;
+}
+
+bool ArSessionRecorder::Open(const ArSession* session, const ArFrame* frame) {
+  file_ = fopen(path_.c_str(), "wb");
+  if (!file_) {
+    LOGE("ArSessionRecorder: could not open %s", path_.c_str());
+    return false;
+  }
+  setvbuf(file_, nullptr, _IOFBF, kFileBufferSize);
+
+  arrec::ArRecordFileHeader header = {};
+  memcpy(header.magic, arrec::kFileMagic, sizeof(header.magic));
+  header.version = arrec::kFileVersion;
+  header.header_size = sizeof(header);
+  header.start_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+
+  ArCamera* camera;
+  ArFrame_acquireCamera(session, frame, &camera);
+  ArCameraIntrinsics* intrinsics;
+  ArCameraIntrinsics_create(session, &intrinsics);
+  ArCamera_getTextureIntrinsics(session, camera, intrinsics);
+  ArCameraIntrinsics_getImageDimensions(session, intrinsics,
+                                        &header.camera_image_width,
+                                        &header.camera_image_height);
+  ArCameraIntrinsics_destroy(intrinsics);
+  ArCamera_release(camera);
+
+  if (fwrite(&header, sizeof(header), 1, file_) != 1) {
+    LOGE("ArSessionRecorder: could not write %s", path_.c_str());
+    fclose(file_);
+    file_ = nullptr;
+    return false;
+  }
+
+  ArPose_create(session, nullptr, &pose_);
+  ArLightEstimate_create(session, &light_estimate_);
+  ArTrackableList_create(session, &plane_list_);
+  LOGI("Recording ARCore session to %s", path_.c_str());
+  return true;
+}
+
+void ArSessionRecorder::Append(const void* data, size_t size) {
+  const size_t offset = buffer_.size();
+  buffer_.resize(offset + size);
+  memcpy(buffer_.data() + offset, data, size);
+}
+
+uint32_t ArSessionRecorder::PlaneId(ArPlane* plane) {
+  auto it = plane_ids_.find(plane);
+  if (it != plane_ids_.end()) {
+    // The entry already holds a reference.
+    ArTrackable_release(ArAsTrackable(plane));
+    it->second.last_seen_frame = frames_written_;
+    return it->second.id;
+  }
+  const uint32_t id = next_plane_id_++;
+  plane_ids_.emplace(plane,
+                     PlaneEntry{ArAsTrackable(plane), id, frames_written_});
+  return id;
+}
+
+void ArSessionRecorder::ReleasePlanes(bool all) {
+  for (auto it = plane_ids_.begin(); it != plane_ids_.end();) {
+    if (all || it->second.last_seen_frame != frames_written_) {
+      ArTrackable_release(it->second.trackable);
+      it = plane_ids_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ArSessionRecorder::RecordFrame(const ArSession* session,
+                                    const ArFrame* frame, int display_width,
+                                    int display_height, int display_rotation,
+                                    const ArAnchor* const* anchors,
+                                    int anchor_count) {
+  if (!IsEnabled()) return;
+  if (!file_ && !Open(session, frame)) {
+    failed_ = true;
+    return;
+  }
+
+  buffer_.clear();
+  arrec::ArRecordFrame record = {};
+  ArFrame_getTimestamp(session, frame, &record.timestamp_ns);
+  record.display_width = display_width;
+  record.display_height = display_height;
+  record.display_rotation = display_rotation;
+  ArFrame_getDisplayGeometryChanged(session, frame,
+                                    &record.display_geometry_changed);
+
+  ArCamera* camera;
+  ArFrame_acquireCamera(session, frame, &camera);
+  ArTrackingState tracking_state;
+  ArCamera_getTrackingState(session, camera, &tracking_state);
+  ArTrackingFailureReason failure_reason;
+  ArCamera_getTrackingFailureReason(session, camera, &failure_reason);
+  record.tracking_state = tracking_state;
+  record.tracking_failure_reason = failure_reason;
+  ArCamera_getPose(session, camera, pose_);
+  ArPose_getPoseRaw(session, pose_, record.camera_pose);
+  ArCamera_getViewMatrix(session, camera, record.view_matrix);
+  ArCamera_getProjectionMatrix(session, camera, arrec::kProjectionNear,
+                               arrec::kProjectionFar,
+                               record.projection_matrix);
+  ArCamera_release(camera);
+  ArFrame_transformCoordinates2d(
+      session, frame, AR_COORDINATES_2D_OPENGL_NORMALIZED_DEVICE_COORDINATES,
+      4, kNdcCorners, AR_COORDINATES_2D_TEXTURE_NORMALIZED,
+      record.display_uvs);
+
+  ArFrame_getLightEstimate(session, frame, light_estimate_);
+  ArLightEstimateState light_state;
+  ArLightEstimate_getState(session, light_estimate_, &light_state);
+  record.light_state = light_state;
+  if (light_state == AR_LIGHT_ESTIMATE_STATE_VALID) {
+    ArLightEstimate_getColorCorrection(session, light_estimate_,
+                                       record.color_correction);
+    ArLightEstimate_getEnvironmentalHdrMainLightDirection(
+        session, light_estimate_, record.main_light_direction);
+    ArLightEstimate_getEnvironmentalHdrMainLightIntensity(
+        session, light_estimate_, record.main_light_intensity);
+    ArLightEstimate_getEnvironmentalHdrAmbientSphericalHarmonics(
+        session, light_estimate_, record.ambient_spherical_harmonics);
+  }
+
+  // Reserve the frame header, it is completed once the counts are known.
+  Append(record);
+
+  ArSession_getAllTrackables(session, AR_TRACKABLE_PLANE, plane_list_);
+  int32_t plane_count = 0;
+  ArTrackableList_getSize(session, plane_list_, &plane_count);
+  for (int32_t i = 0; i < plane_count; ++i) {
+    ArTrackable* trackable = nullptr;
+    ArTrackableList_acquireItem(session, plane_list_, i, &trackable);
+    ArPlane* plane = ArAsPlane(trackable);
+
+    arrec::ArRecordPlane plane_record = {};
+    ArPlane* subsumed_by = nullptr;
+    ArPlane_acquireSubsumedBy(session, plane, &subsumed_by);
+    if (subsumed_by) {
+      plane_record.subsumed_by = PlaneId(subsumed_by);
+    }
+    ArTrackingState plane_state;
+    ArTrackable_getTrackingState(session, trackable, &plane_state);
+    plane_record.tracking_state = plane_state;
+    ArPlaneType plane_type;
+    ArPlane_getType(session, plane, &plane_type);
+    plane_record.type = plane_type;
+    ArPlane_getCenterPose(session, plane, pose_);
+    ArPose_getPoseRaw(session, pose_, plane_record.center_pose);
+    ArPlane_getExtentX(session, plane, &plane_record.extent_x);
+    ArPlane_getExtentZ(session, plane, &plane_record.extent_z);
+    int32_t polygon_size = 0;
+    ArPlane_getPolygonSize(session, plane, &polygon_size);
+    plane_record.polygon_size = polygon_size;
+    polygon_.resize(polygon_size);
+    if (polygon_size > 0) {
+      ArPlane_getPolygon(session, plane, polygon_.data());
+    }
+    // Hands the list's reference to the id map.
+    plane_record.id = PlaneId(plane);
+
+    Append(plane_record);
+    Append(polygon_.data(), polygon_size * sizeof(float));
+  }
+
+  for (int i = 0; i < anchor_count; ++i) {
+    arrec::ArRecordAnchor anchor_record = {};
+    ArTrackingState anchor_state;
+    ArAnchor_getTrackingState(session, anchors[i], &anchor_state);
+    anchor_record.tracking_state = anchor_state;
+    ArAnchor_getPose(session, anchors[i], pose_);
+    ArPose_getPoseRaw(session, pose_, anchor_record.pose);
+    Append(anchor_record);
+  }
+
+  // Planes no longer reported lose their ids, and their handles may be
+  // reused by new planes.
+  ReleasePlanes(false);
+
+  auto* header = reinterpret_cast<arrec::ArRecordFrame*>(buffer_.data());
+  header->frame_size = static_cast<uint32_t>(buffer_.size());
+  header->plane_count = static_cast<uint32_t>(plane_count);
+  header->anchor_count = static_cast<uint32_t>(anchor_count);
+
+  if (fwrite(buffer_.data(), buffer_.size(), 1, file_) != 1) {
+    LOGE("ArSessionRecorder: write failed after %llu frames, stopping.",
+         static_cast<unsigned long long>(frames_written_));
+    Stop();
+    failed_ = true;
+    return;
+  }
+  frames_written_++;
+}
+
+void ArSessionRecorder::Flush() {
+  if (file_) fflush(file_);
+}
+
+void ArSessionRecorder::Stop() {
+  if (file_) {
+    fclose(file_);
+    file_ = nullptr;
+    LOGI("ARCore recording %s closed, %llu frames.", path_.c_str(),
+         static_cast<unsigned long long>(frames_written_));
+  }
+  if (pose_) {
+    ArPose_destroy(pose_);
+    pose_ = nullptr;
+  }
+  if (light_estimate_) {
+    ArLightEstimate_destroy(light_estimate_);
+    light_estimate_ = nullptr;
+  }
+  if (plane_list_) {
+    ArTrackableList_destroy(plane_list_);
+    plane_list_ = nullptr;
+  }
+  ReleasePlanes(true);
+  next_plane_id_ = 1;
+  frames_written_ = 0;
+}
+
+}  // namespace hello_ar
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#ifndef C_ARCORE_HELLO_AR_AR_RECORDER_H_
+#define C_ARCORE_HELLO_AR_AR_RECORDER_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ar_record_format.h"
+#include "arcore_c_api.h"
+
+namespace hello_ar {
+
+// Serializes what the client reads from ARCore each frame (camera poses and
+// matrices, tracking state, light estimate, planes and the application's
+// anchors) to a file in the ar_record_format.h layout.  The host-side replay
+// shim plays such a file back through the same ARCore C API, so the frame
+// loop can run headless against real captured motion.
+//
+// All methods must be called on the render thread.
+class ArSessionRecorder {
+ public:
+  ArSessionRecorder() = default;
+  ~ArSessionRecorder();
+
+  // Sets the output file.  The file is opened by the next RecordFrame(); an
+  // empty path disables recording.
+  void SetOutputPath(const std::string& path);
+
+  bool IsEnabled() const { return !path_.empty() && !failed_; }
+
+  // Appends the state of |frame|, which must have just been updated.
+  void RecordFrame(const ArSession* session, const ArFrame* frame,
+                   int display_width, int display_height, int display_rotation,
+                   const ArAnchor* const* anchors, int anchor_count);
+
+  // Pushes buffered frames to disk, e.g. when the app is paused.
+  void Flush();
+
+  void Stop();
+
+ private:
+  bool Open(const ArSession* session, const ArFrame* frame);
+  // Returns the id of |plane| and takes over the reference the caller
+  // acquired on it.
+  uint32_t PlaneId(ArPlane* plane);
+  void ReleasePlanes(bool all);
+  template <typename T>
+  void Append(const T& value) {
+    Append(&value, sizeof(T));
+  }
+  void Append(const void* data, size_t size);
+
+  std::string path_;
+  FILE* file_ = nullptr;
+  bool failed_ = false;
+  uint64_t frames_written_ = 0;
+
+  // Reused across frames so steady-state recording does not allocate.
+  std::vector<uint8_t> buffer_;
+  std::vector<float> polygon_;
+  ArPose* pose_ = nullptr;
+  ArLightEstimate* light_estimate_ = nullptr;
+  ArTrackableList* plane_list_ = nullptr;
+
+  // ARCore hands out the same handle for a trackable while it is
+  // referenced, but may reuse the address once the last reference is
+  // released.  Each entry holds a reference until the plane is no longer
+  // reported, so a handle never maps to the id of a different plane.
+  struct PlaneEntry {
+    ArTrackable* trackable;
+    uint32_t id;
+    uint64_t last_seen_frame;
+  };
+  std::unordered_map<const ArPlane*, PlaneEntry> plane_ids_;
+  uint32_t next_plane_id_ = 1;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_AR_RECORDER_H_
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "asset_view.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include "util.h"
+
+namespace hello_ar {
+
+AssetView::~AssetView() { Close(); }
+
+AssetView::AssetView(AssetView&& other) { *this = std::move(other); }
+
+AssetView& AssetView::operator=(AssetView&& other) {
+  if (this != &other) {
+    Close();
+    asset_ = other.asset_;
+    mapping_ = other.mapping_;
+    data_ = other.data_;
+    size_ = other.size_;
+    other.asset_ = nullptr;
+    other.mapping_ = nullptr;
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+bool AssetView::OpenAsset(AAssetManager* asset_manager,
+                          const char* file_name) {
+  Close();
+  asset_ = AAssetManager_open(asset_manager, file_name, AASSET_MODE_BUFFER);
+  if (asset_ == nullptr) {
+    LOGE("Error opening asset %s", file_name);
+    return false;
+  }
+  data_ = static_cast<const uint8_t*>(AAsset_getBuffer(asset_));
+  size_ = AAsset_getLength(asset_);
+  if (data_ == nullptr) {
+    LOGE("Failed to read asset %s", file_name);
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool AssetView::MapFile(const char* path) {
+  Close();
+  const int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    void* mapping =
+        mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED) {
+      mapping_ = mapping;
+      data_ = static_cast<const uint8_t*>(mapping);
+      size_ = st.st_size;
+    }
+  }
+  // The mapping keeps the file alive.
+  close(fd);
+  if (!mapping_) LOGE("Could not map %s", path);
+  return mapping_ != nullptr;
+}
+
+void AssetView::Close() {
+  if (asset_) AAsset_close(asset_);
+  if (mapping_) munmap(mapping_, size_);
+  asset_ = nullptr;
+  mapping_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+}
+
+}  // namespace hello_ar
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_ASSET_VIEW_H_
+#define C_ARCORE_HELLO_AR_ASSET_VIEW_H_
+
+#include <android/asset_manager.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hello_ar {
+
+// Read-only view of an asset or file's bytes, valid until the view is closed
+// or destroyed.  Assets are opened with AASSET_MODE_BUFFER, so uncompressed
+// assets are memory mapped from the APK and only compressed ones are inflated
+// into a buffer; files are memory mapped.  Either way nothing is copied into
+// a string or stream on the way to the parser.
+//
+// The bytes are not nul terminated, use size().
+class AssetView {
+ public:
+  AssetView() = default;
+  ~AssetView();
+
+  AssetView(AssetView&& other);
+  AssetView& operator=(AssetView&& other);
+
+  AssetView(const AssetView&) = delete;
+  void operator=(const AssetView&) = delete;
+
+  // Opens |file_name|, relative to the assets folder.  Returns false and
+  // logs if it does not exist.
+  bool OpenAsset(AAssetManager* asset_manager, const char* file_name);
+
+  // Maps the file at |path|.  Returns false if it cannot be mapped.  A file
+  // that cannot be opened is not logged, as optional files are mapped too;
+  // one that opens but cannot be mapped, e.g. when empty, is.
+  bool MapFile(const char* path);
+
+  void Close();
+
+  bool is_open() const { return data_ != nullptr; }
+  const uint8_t* data() const { return data_; }
+  const char* chars() const { return reinterpret_cast<const char*>(data_); }
+  size_t size() const { return size_; }
+
+ private:
+  AAsset* asset_ = nullptr;
+  void* mapping_ = nullptr;
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_ASSET_VIEW_H_
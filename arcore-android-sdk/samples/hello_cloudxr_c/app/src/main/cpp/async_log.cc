@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "async_log.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace hello_ar {
+namespace async_log {
+namespace {
+constexpr char kLogTag[] = "hello_ar_example_c";
+constexpr uint32_t kQueueCapacity = 1024;  // Must be a power of two.
+
+// Set once the logger is destroyed, at exit or library unload, after which
+// messages are dropped.
+std::atomic<bool> g_shut_down{false};
+
+struct Message {
+  // Slot sequence number, see MessageQueue.
+  std::atomic<uint32_t> sequence;
+  int priority;
+  uint32_t suppressed;
+  const char* format;
+  FormatFn format_fn;
+  alignas(8) unsigned char payload[kMaxPayloadSize];
+};
+
+// Bounded multi-producer/single-consumer queue.  Each slot carries a sequence
+// number telling producers and the consumer whose turn it is, so neither side
+// takes a lock.
+class MessageQueue {
+ public:
+  MessageQueue() {
+    for (uint32_t i = 0; i < kQueueCapacity; i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  Message* BeginPush() {
+    uint32_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Message* slot = &slots_[pos & (kQueueCapacity - 1)];
+      const uint32_t seq = slot->sequence.load(std::memory_order_acquire);
+      const int32_t diff = static_cast<int32_t>(seq - pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          return slot;
+        }
+      } else if (diff < 0) {
+        return nullptr;  // Full.
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void EndPush(Message* slot) {
+    const uint32_t seq = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(seq + 1, std::memory_order_release);
+  }
+
+  Message* Front() {
+    Message* slot = &slots_[dequeue_pos_ & (kQueueCapacity - 1)];
+    const uint32_t seq = slot->sequence.load(std::memory_order_acquire);
+    return seq == dequeue_pos_ + 1 ? slot : nullptr;
+  }
+
+  void Pop(Message* slot) {
+    slot->sequence.store(dequeue_pos_ + kQueueCapacity,
+                         std::memory_order_release);
+    dequeue_pos_++;
+  }
+
+ private:
+  Message slots_[kQueueCapacity];
+  std::atomic<uint32_t> enqueue_pos_{0};
+  uint32_t dequeue_pos_ = 0;
+};
+
+// The background thread blocks on an eventfd until a message is queued or a
+// Flush() asks for a drain.  Producers never take a lock, and only the first
+// message after the thread went to sleep pays for the write() that wakes it.
+class Logger {
+ public:
+  Logger()
+      : event_fd_(eventfd(0, EFD_CLOEXEC)), thread_(&Logger::Run, this) {}
+
+  ~Logger() {
+    g_shut_down.store(true);
+    running_.store(false);
+    Wake();
+    thread_.join();
+    close(event_fd_);
+  }
+
+  bool Enqueue(int priority, const char* format, FormatFn format_fn,
+               const void* payload, size_t payload_size, uint32_t suppressed) {
+    Message* message = queue_.BeginPush();
+    if (!message) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    message->priority = priority;
+    message->suppressed = suppressed;
+    message->format = format;
+    message->format_fn = format_fn;
+    memcpy(message->payload, payload, payload_size);
+    queue_.EndPush(message);
+
+    // Pairs with the fence in Run(): either the logger thread sees the
+    // message before it sleeps, or this thread sees it asleep and wakes it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) && sleeping_.exchange(false)) {
+      Wake();
+    }
+    return true;
+  }
+
+  void Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // A drain already under way may have passed the caller's last message,
+    // so wait for the one after it.
+    const uint64_t target = drain_count_ + 2;
+    flush_target_ = std::max(flush_target_, target);
+    Wake();
+    drained_.wait_for(lock, std::chrono::seconds(1),
+                      [&] { return drain_count_ >= target; });
+  }
+
+ private:
+  // The eventfd counter keeps a wake that comes before the read().
+  void Wake() {
+    const uint64_t one = 1;
+    if (write(event_fd_, &one, sizeof(one)) < 0) {
+      // Only fails if the counter would overflow, it is already signaled.
+    }
+  }
+
+  void Run() {
+    for (;;) {
+      Drain();
+      bool flush_pending;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        drain_count_++;
+        flush_pending = drain_count_ < flush_target_;
+      }
+      drained_.notify_all();
+      if (!running_.load()) break;
+      if (flush_pending) continue;
+
+      sleeping_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (queue_.Front()) {
+        sleeping_.store(false, std::memory_order_relaxed);
+        continue;
+      }
+      uint64_t count;
+      while (read(event_fd_, &count, sizeof(count)) < 0 && errno == EINTR) {
+      }
+      sleeping_.store(false, std::memory_order_relaxed);
+    }
+  }
+
+  void Drain() {
+    while (Message* message = queue_.Front()) {
+      Write(*message);
+      queue_.Pop(message);
+    }
+
+    const uint32_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+    if (dropped) {
+      __android_log_print(ANDROID_LOG_WARN, kLogTag,
+                          "Async log queue full, dropped %u messages", dropped);
+    }
+  }
+
+  void Write(const Message& message) {
+    char text[512];
+    int length =
+        message.format_fn(text, sizeof(text), message.format, message.payload);
+    if (length < 0) return;
+    if (message.suppressed && static_cast<size_t>(length) < sizeof(text)) {
+      snprintf(text + length, sizeof(text) - length,
+               " [%u similar messages suppressed]", message.suppressed);
+    }
+    __android_log_write(message.priority, kLogTag, text);
+  }
+
+  MessageQueue queue_;
+  std::atomic<uint32_t> dropped_{0};
+
+  const int event_fd_;
+  std::atomic<bool> running_{true};
+  std::atomic<bool> sleeping_{false};
+
+  std::mutex mutex_;
+  std::condition_variable drained_;
+  uint64_t drain_count_ = 0;
+  uint64_t flush_target_ = 0;
+
+  std::thread thread_;
+};
+
+Logger& GetLogger() {
+  // Destroyed with the other statics, which stops and joins the thread after
+  // a last drain.
+  static Logger logger;
+  return logger;
+}
+}  // namespace
+
+bool Enqueue(int priority, const char* format, FormatFn format_fn,
+             const void* payload, size_t payload_size, uint32_t suppressed) {
+  if (g_shut_down.load(std::memory_order_relaxed)) return false;
+  return GetLogger().Enqueue(priority, format, format_fn, payload,
+                             payload_size, suppressed);
+}
+
+void Flush() {
+  if (g_shut_down.load(std::memory_order_relaxed)) return;
+  GetLogger().Flush();
+}
+
+}  // namespace async_log
+}  // namespace hello_ar
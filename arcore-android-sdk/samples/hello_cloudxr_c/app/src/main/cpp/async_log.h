@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_ASYNC_LOG_H_
+#define C_ARCORE_HELLO_AR_ASYNC_LOG_H_
+
+#include <android/log.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+// Asynchronous, rate-limited logging for messages that can fire every frame.
+//
+//   LOGE_RL(1000, "Latch failed, %s", cxrErrorString(status));
+//
+// logs at most once per second from that call site and reports how many
+// messages were suppressed in between.  The calling thread only copies the
+// format string pointer and the raw argument values into a lock-free ring;
+// printf formatting and the write to logcat happen on a background thread.
+// Because formatting is deferred, string arguments must be literals or
+// otherwise remain valid for the life of the process (cxrErrorString() is).
+//
+// Messages below HELLO_AR_MIN_LOG_LEVEL (an android_LogPriority value,
+// default ANDROID_LOG_INFO) are compiled out.
+#ifndef HELLO_AR_MIN_LOG_LEVEL
+#define HELLO_AR_MIN_LOG_LEVEL 4  // ANDROID_LOG_INFO
+#endif
+
+namespace hello_ar {
+namespace async_log {
+
+// Per call site rate limiting state, one static instance per macro use.
+class CallSite {
+ public:
+  explicit CallSite(uint32_t interval_ms)
+      : interval_ns_(static_cast<int64_t>(interval_ms) * 1000000) {}
+
+  // Returns true if the message should be logged now, otherwise counts it as
+  // suppressed.
+  bool ShouldLog() {
+    const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count();
+    int64_t next = next_allowed_ns_.load(std::memory_order_relaxed);
+    if (now >= next && next_allowed_ns_.compare_exchange_strong(
+                           next, now + interval_ns_, std::memory_order_relaxed)) {
+      return true;
+    }
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  uint32_t TakeSuppressed() {
+    return suppressed_.exchange(0, std::memory_order_relaxed);
+  }
+
+ private:
+  const int64_t interval_ns_;
+  std::atomic<int64_t> next_allowed_ns_{0};
+  std::atomic<uint32_t> suppressed_{0};
+};
+
+constexpr size_t kMaxPayloadSize = 64;
+
+using FormatFn = int (*)(char* out, size_t size, const char* format,
+                         const void* payload);
+
+// Queues a message for the background thread.  Returns false if the queue is
+// full and the message was dropped.
+bool Enqueue(int priority, const char* format, FormatFn format_fn,
+             const void* payload, size_t payload_size, uint32_t suppressed);
+
+// Blocks until all queued messages have been written.
+void Flush();
+
+// Trivially copyable argument pack (std::tuple is not guaranteed to be).
+template <typename... Args>
+struct Pack {};
+
+template <typename T, typename... Rest>
+struct Pack<T, Rest...> {
+  T first;
+  Pack<Rest...> rest;
+};
+
+inline Pack<> MakePack() { return {}; }
+
+template <typename T, typename... Rest>
+Pack<T, Rest...> MakePack(T first, Rest... rest) {
+  return {first, MakePack(rest...)};
+}
+
+template <typename... Done>
+int FormatPack(char* out, size_t size, const char* format, const Pack<>&,
+               Done... done) {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+  return snprintf(out, size, format, done...);
+#pragma GCC diagnostic pop
+}
+
+template <typename T, typename... Rest, typename... Done>
+int FormatPack(char* out, size_t size, const char* format,
+               const Pack<T, Rest...>& pack, Done... done) {
+  return FormatPack(out, size, format, pack.rest, done..., pack.first);
+}
+
+template <typename... Args>
+int FormatPayload(char* out, size_t size, const char* format,
+                  const void* payload) {
+  Pack<Args...> args;
+  memcpy(&args, payload, sizeof(args));
+  return FormatPack(out, size, format, args);
+}
+
+// Arguments are taken by value, so arrays and string literals decay to
+// pointers here.
+template <typename... Args>
+void Write(int priority, CallSite* site, const char* format, Args... args) {
+  using Payload = Pack<Args...>;
+  static_assert(sizeof(Payload) <= kMaxPayloadSize,
+                "Too many arguments for an async log message");
+  static_assert(std::is_trivially_copyable<Payload>::value,
+                "Async log arguments must be trivially copyable");
+  const Payload payload = MakePack(args...);
+  Enqueue(priority, format, &FormatPayload<Args...>, &payload, sizeof(payload),
+          site->TakeSuppressed());
+}
+
+// Never called, only gives the macros below the compiler's printf format
+// checks, which Write() loses by taking its arguments through a template.
+inline void CheckFormat(const char* format, ...)
+    __attribute__((format(printf, 1, 2)));
+inline void CheckFormat(const char*, ...) {}
+
+}  // namespace async_log
+}  // namespace hello_ar
+
+#define HELLO_AR_ASYNC_LOG_RL(priority, interval_ms, ...)                  \
+  do {                                                                     \
+    if (false) hello_ar::async_log::CheckFormat(__VA_ARGS__);              \
+    static hello_ar::async_log::CallSite hello_ar_log_site(interval_ms);   \
+    if (hello_ar_log_site.ShouldLog())                                     \
+      hello_ar::async_log::Write(priority, &hello_ar_log_site, __VA_ARGS__); \
+  } while (0)
+
+#define HELLO_AR_LOG_DISABLED(...) \
+  do {                             \
+  } while (0)
+
+#if HELLO_AR_MIN_LOG_LEVEL <= 4
+#define LOGI_RL(interval_ms, ...) \
+  HELLO_AR_ASYNC_LOG_RL(ANDROID_LOG_INFO, interval_ms, __VA_ARGS__)
+#else
+#define LOGI_RL(interval_ms, ...) HELLO_AR_LOG_DISABLED()
+#endif
+
+#if HELLO_AR_MIN_LOG_LEVEL <= 5
+#define LOGW_RL(interval_ms, ...) \
+  HELLO_AR_ASYNC_LOG_RL(ANDROID_LOG_WARN, interval_ms, __VA_ARGS__)
+#else
+#define LOGW_RL(interval_ms, ...) HELLO_AR_LOG_DISABLED()
+#endif
+
+#if HELLO_AR_MIN_LOG_LEVEL <= 6
+#define LOGE_RL(interval_ms, ...) \
+  HELLO_AR_ASYNC_LOG_RL(ANDROID_LOG_ERROR, interval_ms, __VA_ARGS__)
+#else
+#define LOGE_RL(interval_ms, ...) HELLO_AR_LOG_DISABLED()
+#endif
+
+#endif  // C_ARCORE_HELLO_AR_ASYNC_LOG_H_
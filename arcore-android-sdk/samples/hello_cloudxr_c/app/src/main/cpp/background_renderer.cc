@@ -39,6 +39,7 @@
 // This modules handles drawing the passthrough camera image into the OpenGL
 // scene.
 
+#include <algorithm>
 #include <type_traits>
 
 #include "background_renderer.h"
@@ -60,22 +61,25 @@ const GLfloat kUVs[] = {
 constexpr char kVertexShaderFilename[] = "shaders/screenquad.vert";
 constexpr char kFragmentShaderFilename[] = "shaders/screenquad_ext.frag";
 constexpr char kFragmentShaderFilenameScreen[] = "shaders/screenquad.frag";
+constexpr char kGpuMemoryOwner[] = "background";
 }  // namespace
 
 void BackgroundRenderer::InitializeGlContent(AAssetManager* asset_manager,
-    int width, int height) {
+    ProgramCache* program_cache, int width, int height, int history_length) {
   width_ = width;
   height_ = height;
+  history_length_ =
+      std::max(1, std::min(history_length, static_cast<int>(kQueueLen)));
+  current_texture_ = 0;
 
-  shader_program_ = util::CreateProgram(kVertexShaderFilename,
-                                        kFragmentShaderFilename, asset_manager);
+  shader_program_ = program_cache->CreateProgram(
+      kVertexShaderFilename, kFragmentShaderFilename, asset_manager);
   if (!shader_program_) {
     LOGE("Could not create program.");
   }
 
-  shader_program_screen_ = util::CreateProgram(kVertexShaderFilename,
-                                               kFragmentShaderFilenameScreen,
-                                               asset_manager);
+  shader_program_screen_ = program_cache->CreateProgram(
+      kVertexShaderFilename, kFragmentShaderFilenameScreen, asset_manager);
 
   if (!shader_program_screen_) {
     LOGE("Could not create program.");
@@ -86,16 +90,20 @@ void BackgroundRenderer::InitializeGlContent(AAssetManager* asset_manager,
   glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-  glGenTextures(kQueueLen, texture_ids_);
+  glGenTextures(history_length_, texture_ids_);
   glGenFramebuffers(1, &fbo_);
 
-  for (uint32_t idx = 0; idx < kQueueLen; idx++) {
+  const uint64_t texture_bytes =
+      GpuMemoryTracker::ImageBytes(width_, height_, 4, false);
+  for (int idx = 0; idx < history_length_; idx++) {
     glBindTexture(GL_TEXTURE_2D, texture_ids_[idx]);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width_, height_, 0,
         GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    gpu_memory_->Track(GpuObjectType::kTexture, texture_ids_[idx],
+                       kGpuMemoryOwner, texture_bytes);
   }
 
   uniform_texture_ = glGetUniformLocation(shader_program_, "sTexture");
@@ -103,6 +111,16 @@ void BackgroundRenderer::InitializeGlContent(AAssetManager* asset_manager,
   attribute_uvs_ = glGetAttribLocation(shader_program_, "a_TexCoord");
 }
 
+void BackgroundRenderer::ReleaseGlContent() {
+  gpu_memory_->Untrack(GpuObjectType::kTexture, history_length_,
+                       texture_ids_);
+  glDeleteFramebuffers(1, &fbo_);
+  glDeleteTextures(history_length_, texture_ids_);
+  glDeleteTextures(1, &texture_id_);
+  glDeleteProgram(shader_program_screen_);
+  glDeleteProgram(shader_program_);
+}
+
 void BackgroundRenderer::Draw(const ArSession* session, const ArFrame* frame,
     int offset) {
   static_assert(std::extent<decltype(kVertices)>::value == kNumVertices * 2,
@@ -145,18 +163,18 @@ void BackgroundRenderer::Draw(const ArSession* session, const ArFrame* frame,
 
     glViewport(0, 0, width_, height_);
 
-    current_texture_ = (current_texture_ + 1)%kQueueLen;
+    current_texture_ = (current_texture_ + 1)%history_length_;
   }
 
   glUniform1i(uniform_texture_, 1);
   glActiveTexture(GL_TEXTURE1);
 
   if (render_to_screen) {
-    offset++;
+    offset = std::min(offset + 1, history_length_);
 
     const int idx = current_texture_ < offset ?
-        (kQueueLen + (current_texture_ - offset))%kQueueLen :
-        (current_texture_ - offset)%kQueueLen;
+        (history_length_ + (current_texture_ - offset))%history_length_ :
+        (current_texture_ - offset)%history_length_;
 
     glBindTexture(GL_TEXTURE_2D, texture_ids_[idx]);
   } else {
@@ -182,4 +200,9 @@ void BackgroundRenderer::Draw(const ArSession* session, const ArFrame* frame,
 
 GLuint BackgroundRenderer::GetTextureId() const { return texture_id_; }
 
+uint64_t BackgroundRenderer::GetGpuMemoryBytes() const {
+  return history_length_ *
+         GpuMemoryTracker::ImageBytes(width_, height_, 4, false);
+}
+
 }  // namespace hello_ar
@@ -45,6 +45,8 @@
 #include <cstdlib>
 
 #include "arcore_c_api.h"
+#include "gpu_memory.h"
+#include "program_cache.h"
 #include "util.h"
 
 namespace hello_ar {
@@ -54,18 +56,29 @@ class BackgroundRenderer {
  public:
   static constexpr int kQueueLen = 16;
 
-  BackgroundRenderer() = default;
+  // The camera history textures are accounted in |gpu_memory|.
+  explicit BackgroundRenderer(GpuMemoryTracker* gpu_memory)
+      : gpu_memory_(gpu_memory) {}
   ~BackgroundRenderer() = default;
 
   // Sets up OpenGL state.  Must be called on the OpenGL thread and before any
-  // other methods below.
-  void InitializeGlContent(AAssetManager* asset_manager, int width, int height);
+  // other methods below.  The history holds |history_length| camera images,
+  // at most kQueueLen, of |width| x |height|.
+  void InitializeGlContent(AAssetManager* asset_manager,
+                           ProgramCache* program_cache, int width, int height,
+                           int history_length = kQueueLen);
+
+  // Deletes the objects created by InitializeGlContent() while the context is
+  // still current, e.g. before initializing again for a new camera size.
+  void ReleaseGlContent();
 
   // Draws the background image.  This methods must be called for every ArFrame
   // returned by ArSession_update() to catch display geometry change events.
   //
-  // Maintains internal look-back circular array of camera images of kQueueLen length.
-  // frame_offset is an offset from the current pointer in camera images array.
+  // Maintains internal look-back circular array of camera images of
+  // history_length() length.
+  // frame_offset is an offset from the current pointer in camera images array,
+  // clamped to the oldest image.
   // When image_offset < 0 draws image to the internal array and advances the
   // array pointer.
   void Draw(const ArSession* session, const ArFrame* frame, int frame_offset=-1);
@@ -73,6 +86,14 @@ class BackgroundRenderer {
   // Returns the generated texture name for the GL_TEXTURE_EXTERNAL_OES target.
   GLuint GetTextureId() const;
 
+  // Returns the size of the camera history textures, in bytes.
+  uint64_t GetGpuMemoryBytes() const;
+
+  // Size and number of the camera history textures.
+  int width() const { return width_; }
+  int height() const { return height_; }
+  int history_length() const { return history_length_; }
+
  private:
   static constexpr int kNumVertices = 4;
 
@@ -83,6 +104,7 @@ class BackgroundRenderer {
   GLuint fbo_;
 
   GLuint texture_ids_[kQueueLen];
+  int history_length_ = kQueueLen;
   int current_texture_ = 0;
 
   GLuint attribute_vertices_;
@@ -94,6 +116,8 @@ class BackgroundRenderer {
 
   float transformed_uvs_[kNumVertices * 2];
   bool uvs_initialized_ = false;
+
+  GpuMemoryTracker* const gpu_memory_;
 };
 }  // namespace hello_ar
 #endif  // C_ARCORE_HELLO_AR_BACKGROUND_RENDERER_H_
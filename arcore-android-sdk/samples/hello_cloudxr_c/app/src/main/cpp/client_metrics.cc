@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "client_metrics.h"
+
+#include <cstdio>
+#include <thread>
+
+namespace hello_ar {
+
+constexpr float LatencyHistogram::kBucketBoundsMs[];
+
+namespace {
+constexpr const char* kFramePhaseNames[kNumFramePhases] = {
+    "total",      "ar_update",      "camera_queue", "latch",
+    "background", "light_estimate", "composite",    "planes"};
+
+void AppendHeader(std::string* out, const char* name, const char* type,
+                  const char* help) {
+  out->append("# HELP ").append(name).append(" ").append(help);
+  out->append("\n# TYPE ").append(name).append(" ").append(type).append("\n");
+}
+
+void AppendValue(std::string* out, const char* name, const char* labels,
+                 double value) {
+  // " %.17g\n" needs at most 26 characters.
+  char text[32];
+  snprintf(text, sizeof(text), " %.17g\n", value);
+  out->append(name).append(labels).append(text);
+}
+
+void AppendMetric(std::string* out, const char* name, const char* type,
+                  const char* help, double value) {
+  AppendHeader(out, name, type, help);
+  AppendValue(out, name, "", value);
+}
+}  // namespace
+
+void MetricsSnapshot::Publish(const ClientMetrics& metrics) {
+  const int slot = 1 - published_.load();
+  if (readers_[slot].load() != 0) {
+    return;
+  }
+  slots_[slot] = metrics;
+  published_.store(slot);
+  version_.fetch_add(1);
+  requested_.store(false, std::memory_order_relaxed);
+}
+
+ClientMetrics MetricsSnapshot::Read(int timeout_ms) {
+  const uint32_t version = version_.load();
+  requested_.store(true, std::memory_order_relaxed);
+  for (int waited = 0; waited < timeout_ms && version_.load() == version;
+       waited++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // The slot is only used if it is still the published one after this reader
+  // marked it, otherwise the render thread may already be refilling it.
+  for (;;) {
+    const int slot = published_.load();
+    readers_[slot].fetch_add(1);
+    if (published_.load() == slot) {
+      ClientMetrics metrics = slots_[slot];
+      readers_[slot].fetch_sub(1);
+      return metrics;
+    }
+    readers_[slot].fetch_sub(1);
+  }
+}
+
+const char* FramePhaseName(FramePhase phase) {
+  return kFramePhaseNames[phase];
+}
+
+std::string SerializePrometheus(const ClientMetrics& m) {
+  std::string out;
+  out.reserve(8192);
+
+  AppendMetric(&out, "cloudxr_client_frames_total", "counter",
+               "Frames rendered by the client.", m.frames);
+
+  const char* kPhaseMetric = "cloudxr_client_frame_phase_seconds";
+  AppendHeader(&out, kPhaseMetric, "histogram",
+               "CPU time spent in each phase of OnDrawFrame.");
+  char name[128];
+  char labels[128];
+  for (int phase = 0; phase < kNumFramePhases; phase++) {
+    const LatencyHistogram& h = m.frame_phases[phase];
+    uint64_t cumulative = 0;
+    snprintf(name, sizeof(name), "%s_bucket", kPhaseMetric);
+    for (int b = 0; b < LatencyHistogram::kNumBuckets; b++) {
+      cumulative += h.buckets[b];
+      if (b < LatencyHistogram::kNumBuckets - 1) {
+        snprintf(labels, sizeof(labels), "{phase=\"%s\",le=\"%g\"}",
+                 kFramePhaseNames[phase],
+                 LatencyHistogram::kBucketBoundsMs[b] / 1000.0);
+      } else {
+        snprintf(labels, sizeof(labels), "{phase=\"%s\",le=\"+Inf\"}",
+                 kFramePhaseNames[phase]);
+      }
+      AppendValue(&out, name, labels, cumulative);
+    }
+    snprintf(labels, sizeof(labels), "{phase=\"%s\"}", kFramePhaseNames[phase]);
+    snprintf(name, sizeof(name), "%s_sum", kPhaseMetric);
+    AppendValue(&out, name, labels, h.sum_ms / 1000.0);
+    snprintf(name, sizeof(name), "%s_count", kPhaseMetric);
+    AppendValue(&out, name, labels, h.count);
+  }
+
+  const char* kLatchMetric = "cloudxr_client_latch_total";
+  AppendHeader(&out, kLatchMetric, "counter",
+               "Frame latch attempts by outcome.");
+  AppendValue(&out, kLatchMetric, "{result=\"success\"}", m.latch_success);
+  AppendValue(&out, kLatchMetric, "{result=\"not_ready\"}", m.latch_not_ready);
+  AppendValue(&out, kLatchMetric, "{result=\"error\"}", m.latch_error);
+
+  const char* kLightMetric = "cloudxr_client_light_estimates_total";
+  AppendHeader(&out, kLightMetric, "counter",
+               "Valid light estimates by outcome.");
+  AppendValue(&out, kLightMetric, "{result=\"sent\"}", m.light_sends);
+  AppendValue(&out, kLightMetric, "{result=\"skipped\"}",
+              m.light_sends_skipped);
+  AppendValue(&out, kLightMetric, "{result=\"unchanged\"}",
+              m.light_estimates_unchanged);
+
+  AppendMetric(&out, "cloudxr_client_cubemap_updates_total", "counter",
+               "Environment cubemap updates sent.", m.cubemap_updates);
+  AppendMetric(&out, "cloudxr_client_cubemap_sent_bytes_total", "counter",
+               "Bytes of environment cubemap updates sent.",
+               m.cubemap_bytes_sent);
+
+  AppendMetric(&out, "cloudxr_client_plane_mesh_rebuilds_total", "counter",
+               "Plane meshes rebuilt after their polygon changed.",
+               m.plane_mesh_rebuilds);
+  AppendMetric(&out, "cloudxr_client_plane_upload_bytes_total", "counter",
+               "Bytes uploaded to the plane vertex and index buffers.",
+               m.plane_upload_bytes);
+  AppendMetric(&out, "cloudxr_client_plane_vertices", "gauge",
+               "Vertices of the planes drawn in the last frame.",
+               m.plane_vertices);
+  AppendMetric(&out, "cloudxr_client_plane_triangles", "gauge",
+               "Triangles of the planes drawn in the last frame.",
+               m.plane_triangles);
+
+  AppendMetric(&out, "cloudxr_client_audio_played_frames_total", "counter",
+               "Audio frames received from the server and played.",
+               m.audio_frames_played);
+  AppendMetric(&out, "cloudxr_client_audio_write_errors_total", "counter",
+               "Failed or short writes to the playback stream.",
+               m.audio_write_errors);
+  AppendMetric(&out, "cloudxr_client_audio_recorded_frames_total", "counter",
+               "Audio frames recorded and sent to the server.",
+               m.audio_frames_recorded);
+
+  AppendMetric(&out, "cloudxr_client_stream_fps", "gauge",
+               "Stream frame rate reported by the connection.", m.stream_fps);
+  AppendMetric(&out, "cloudxr_client_bandwidth_available_kbps", "gauge",
+               "Estimated available bandwidth.", m.bandwidth_available_kbps);
+  AppendMetric(&out, "cloudxr_client_bandwidth_utilization_kbps", "gauge",
+               "Bandwidth used by the stream.", m.bandwidth_utilization_kbps);
+  AppendMetric(&out, "cloudxr_client_round_trip_delay_ms", "gauge",
+               "Network round trip delay.", m.round_trip_delay_ms);
+  AppendMetric(&out, "cloudxr_client_jitter_us", "gauge",
+               "Network jitter.", m.jitter_us);
+  AppendMetric(&out, "cloudxr_client_packets_received", "gauge",
+               "Packets received this connection.", m.total_packets_received);
+  AppendMetric(&out, "cloudxr_client_packets_lost", "gauge",
+               "Packets lost this connection.", m.total_packets_lost);
+  AppendMetric(&out, "cloudxr_client_packets_dropped", "gauge",
+               "Packets dropped this connection.", m.total_packets_dropped);
+  AppendMetric(&out, "cloudxr_client_connection_quality", "gauge",
+               "cxrConnectionQuality, 0 (unstable) to 5 (excellent).",
+               m.connection_quality);
+  AppendMetric(&out, "cloudxr_client_connection_quality_reasons", "gauge",
+               "cxrConnectionQualityReason bit mask.",
+               m.connection_quality_reasons);
+
+  AppendMetric(&out, "cloudxr_client_gpu_memory_bytes", "gauge",
+               "GPU memory held by client renderers.", m.gpu_memory_bytes);
+  const char* kGpuObjectMetric = "cloudxr_client_gpu_object_bytes";
+  AppendHeader(&out, kGpuObjectMetric, "gauge",
+               "GPU memory held by client renderers, by object type.");
+  AppendValue(&out, kGpuObjectMetric, "{type=\"texture\"}",
+              m.gpu_texture_bytes);
+  AppendValue(&out, kGpuObjectMetric, "{type=\"renderbuffer\"}",
+              m.gpu_renderbuffer_bytes);
+  AppendValue(&out, kGpuObjectMetric, "{type=\"buffer\"}",
+              m.gpu_buffer_bytes);
+  AppendMetric(&out, "cloudxr_client_gpu_memory_budget_bytes", "gauge",
+               "GPU memory budget of client renderers, 0 for none.",
+               m.gpu_memory_budget_bytes);
+  AppendMetric(&out, "cloudxr_client_camera_history_frames", "gauge",
+               "Camera images kept for latency compensation.",
+               m.camera_history_frames);
+  AppendMetric(&out, "cloudxr_client_camera_history_scale", "gauge",
+               "Factor the camera history resolution is divided by.",
+               m.camera_history_scale);
+  AppendMetric(&out, "cloudxr_client_camera_offsets_clamped_total", "counter",
+               "Frames whose pose was not in the camera history.",
+               m.camera_offsets_clamped);
+
+  const char* kProgramMetric = "cloudxr_client_shader_programs";
+  AppendHeader(&out, kProgramMetric, "gauge",
+               "Shader programs created with the last GL surface.");
+  AppendValue(&out, kProgramMetric, "{source=\"cache\"}",
+              m.shader_programs_cached);
+  AppendValue(&out, kProgramMetric, "{source=\"compiled\"}",
+              m.shader_programs_compiled);
+  AppendMetric(&out, "cloudxr_client_shader_program_seconds", "gauge",
+               "Time spent creating shader programs with the last GL surface.",
+               m.shader_program_ms / 1000.0);
+  AppendMetric(&out, "cloudxr_client_hud_gpu_seconds", "gauge",
+               "GPU time of the last measured performance overlay draw.",
+               m.hud_gpu_ms / 1000.0);
+  return out;
+}
+
+}  // namespace hello_ar
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_CLIENT_METRICS_H_
+#define C_ARCORE_HELLO_AR_CLIENT_METRICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace hello_ar {
+
+// Fixed-bucket latency histogram, cheap enough to update every frame.
+struct LatencyHistogram {
+  // Upper bounds of the buckets in milliseconds, the last bucket is +Inf.
+  static constexpr int kNumBuckets = 9;
+  static constexpr float kBucketBoundsMs[kNumBuckets - 1] = {
+      0.5f, 1.f, 2.f, 4.f, 8.f, 16.7f, 33.3f, 66.7f};
+
+  uint64_t buckets[kNumBuckets] = {};
+  uint64_t count = 0;
+  double sum_ms = 0.0;
+
+  void Add(float ms) {
+    int bucket = 0;
+    while (bucket < kNumBuckets - 1 && ms > kBucketBoundsMs[bucket]) bucket++;
+    buckets[bucket]++;
+    count++;
+    sum_ms += ms;
+  }
+};
+
+enum FramePhase {
+  kFramePhaseTotal,
+  kFramePhaseArUpdate,
+  kFramePhaseCameraQueue,
+  kFramePhaseLatch,
+  kFramePhaseBackground,
+  kFramePhaseLightEstimate,
+  kFramePhaseComposite,
+  kFramePhasePlanes,
+  kNumFramePhases
+};
+
+// Counters and gauges describing client performance.  The render thread owns
+// one instance and periodically publishes a copy through MetricsSnapshot.
+struct ClientMetrics {
+  uint64_t frames = 0;
+  LatencyHistogram frame_phases[kNumFramePhases];
+
+  uint64_t latch_success = 0;
+  uint64_t latch_not_ready = 0;
+  uint64_t latch_error = 0;
+
+  // Light estimate handling: frames whose estimate had not changed, new
+  // estimates sent to the server, and new estimates not worth sending.
+  uint64_t light_estimates_unchanged = 0;
+  uint64_t light_sends = 0;
+  uint64_t light_sends_skipped = 0;
+
+  // Environmental HDR cubemap updates handed to the cubemap sink.
+  uint64_t cubemap_updates = 0;
+  uint64_t cubemap_bytes_sent = 0;
+
+  // Plane meshes rebuilt because their polygon changed, and the bytes
+  // uploaded to the plane buffers.
+  uint64_t plane_mesh_rebuilds = 0;
+  uint64_t plane_upload_bytes = 0;
+  // Size of the last frame's plane batch.
+  uint32_t plane_vertices = 0;
+  uint32_t plane_triangles = 0;
+
+  uint64_t audio_frames_played = 0;
+  uint64_t audio_write_errors = 0;
+  uint64_t audio_frames_recorded = 0;
+
+  // Last cxrConnectionStats sample, |stats_samples| counts fetches.
+  uint64_t stats_samples = 0;
+  float stream_fps = 0.f;
+  uint32_t bandwidth_available_kbps = 0;
+  uint32_t bandwidth_utilization_kbps = 0;
+  uint32_t round_trip_delay_ms = 0;
+  uint32_t jitter_us = 0;
+  uint32_t total_packets_received = 0;
+  uint32_t total_packets_lost = 0;
+  uint32_t total_packets_dropped = 0;
+  uint32_t connection_quality = 0;
+  uint32_t connection_quality_reasons = 0;
+
+  // GPU memory held by the renderers, in total and by object type, and its
+  // budget, 0 for none.
+  uint64_t gpu_memory_bytes = 0;
+  uint64_t gpu_texture_bytes = 0;
+  uint64_t gpu_renderbuffer_bytes = 0;
+  uint64_t gpu_buffer_bytes = 0;
+  uint64_t gpu_memory_budget_bytes = 0;
+  // Camera images kept for latency compensation, and the factor their
+  // resolution is divided by, both reduced to fit the budget.
+  uint32_t camera_history_frames = 0;
+  uint32_t camera_history_scale = 1;
+  // Latched frames whose pose was not in the camera history, drawn over the
+  // latest camera image instead.
+  uint64_t camera_offsets_clamped = 0;
+
+  // Shader programs of the last surface creation, loaded from the program
+  // cache or compiled, and the time spent on both.
+  uint32_t shader_programs_cached = 0;
+  uint32_t shader_programs_compiled = 0;
+  float shader_program_ms = 0.f;
+
+  // GPU time of the last measured performance overlay draw, 0 while hidden
+  // or without GL_EXT_disjoint_timer_query.
+  float hud_gpu_ms = 0.f;
+};
+
+// Short name of |phase|, e.g. "ar_update".
+const char* FramePhaseName(FramePhase phase);
+
+// Writes |metrics| in the Prometheus text exposition format.
+std::string SerializePrometheus(const ClientMetrics& metrics);
+
+// Hands copies of the render thread's metrics to a reader thread through two
+// slots: the render thread fills the slot that is not published and then
+// publishes its index, the reader copies the published slot.  The render
+// thread never takes a lock, and only copies the metrics when a reader has
+// asked for them, so frames between scrapes cost a single relaxed load.
+class MetricsSnapshot {
+ public:
+  // Render thread.  True if Publish() should be called this frame.
+  bool Requested() const { return requested_.load(std::memory_order_relaxed); }
+
+  // Render thread.  Skipped, and retried on a later frame, if a reader still
+  // holds the slot that would be overwritten.
+  void Publish(const ClientMetrics& metrics);
+
+  // Reader thread.  Asks the render thread for a fresh copy and waits up to
+  // |timeout_ms| for it, then returns the last published metrics.
+  ClientMetrics Read(int timeout_ms = 100);
+
+ private:
+  ClientMetrics slots_[2];
+  std::atomic<int> published_{0};
+  std::atomic<int> readers_[2] = {{0}, {0}};
+  std::atomic<uint32_t> version_{0};
+  std::atomic<bool> requested_{false};
+};
+
+// Adds the duration of the enclosing scope to a LatencyHistogram.
+class ScopedPhaseTimer {
+ public:
+  explicit ScopedPhaseTimer(LatencyHistogram* histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+  ~ScopedPhaseTimer() {
+    histogram_->Add(std::chrono::duration<float, std::milli>(
+                        std::chrono::steady_clock::now() - start_)
+                        .count());
+  }
+  ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+  void operator=(const ScopedPhaseTimer&) = delete;
+
+ private:
+  LatencyHistogram* histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_CLIENT_METRICS_H_
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "cubemap_encoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define HELLO_AR_RGB9E5_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define HELLO_AR_RGB9E5_SSE2 1
+#endif
+
+namespace hello_ar {
+namespace {
+
+// GL_EXT_texture_shared_exponent: 9 bit mantissas, 5 bit exponent biased by
+// 15.  Each step below computes 2^(24 - exponent) directly from its float
+// bits, so the scalar and SIMD versions do the same float math.
+constexpr int kMantissaBits = 9;
+constexpr int kExponentBias = 15;
+constexpr float kMaxValue = 65408.f;  // (511 / 512) * 2^16
+
+inline float Pow2(int exponent) {
+  const uint32_t bits = static_cast<uint32_t>(exponent + 127) << 23;
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+inline int FloorLog2(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return static_cast<int>(bits >> 23) - 127;
+}
+
+inline float Clamp(float value) {
+  // Negative values and NaN become 0.
+  return value > 0.f ? std::min(value, kMaxValue) : 0.f;
+}
+
+inline uint32_t EncodeTexel(const float* rgba) {
+  const float r = Clamp(rgba[0]);
+  const float g = Clamp(rgba[1]);
+  const float b = Clamp(rgba[2]);
+  const float max_channel = std::max(r, std::max(g, b));
+
+  // Exponent such that the largest channel gets a mantissa in [256, 511].
+  int exponent =
+      std::max(-kExponentBias - 1, FloorLog2(max_channel)) + 1 + kExponentBias;
+  float scale = Pow2(kExponentBias + kMantissaBits - exponent);
+  if (static_cast<int>(max_channel * scale + 0.5f) == 1 << kMantissaBits) {
+    exponent++;
+    scale *= 0.5f;
+  }
+  const uint32_t rs = static_cast<uint32_t>(r * scale + 0.5f);
+  const uint32_t gs = static_cast<uint32_t>(g * scale + 0.5f);
+  const uint32_t bs = static_cast<uint32_t>(b * scale + 0.5f);
+  return rs | (gs << 9) | (bs << 18) | (static_cast<uint32_t>(exponent) << 27);
+}
+
+#if defined(HELLO_AR_RGB9E5_NEON)
+// Clamp() for 4 values.  vmaxq_f32 returns NaN if either operand is NaN, so
+// NaN lanes, the only ones not equal to themselves, are replaced by 0 first.
+inline float32x4_t Clamp4(float32x4_t value) {
+  const float32x4_t zero = vdupq_n_f32(0.f);
+  value = vbslq_f32(vceqq_f32(value, value), value, zero);
+  return vminq_f32(vmaxq_f32(value, zero), vdupq_n_f32(kMaxValue));
+}
+
+// Encodes 4 texels: vld4q splits them into R, G, B and A vectors.
+inline void EncodeTexels4(const float* rgba, uint32_t* out) {
+  const float32x4x4_t texels = vld4q_f32(rgba);
+  const float32x4_t half = vdupq_n_f32(0.5f);
+  const float32x4_t r = Clamp4(texels.val[0]);
+  const float32x4_t g = Clamp4(texels.val[1]);
+  const float32x4_t b = Clamp4(texels.val[2]);
+  const float32x4_t max_channel = vmaxq_f32(r, vmaxq_f32(g, b));
+
+  int32x4_t exponent = vsubq_s32(
+      vreinterpretq_s32_u32(
+          vshrq_n_u32(vreinterpretq_u32_f32(max_channel), 23)),
+      vdupq_n_s32(127));
+  exponent = vaddq_s32(vmaxq_s32(exponent, vdupq_n_s32(-kExponentBias - 1)),
+                       vdupq_n_s32(1 + kExponentBias));
+  const int32x4_t scale_bias =
+      vdupq_n_s32(kExponentBias + kMantissaBits + 127);
+  float32x4_t scale = vreinterpretq_f32_s32(
+      vshlq_n_s32(vsubq_s32(scale_bias, exponent), 23));
+  const int32x4_t max_mantissa = vcvtq_s32_f32(
+      vaddq_f32(vmulq_f32(max_channel, scale), half));
+  // The mask is -1 where rounding overflowed the mantissa.
+  const int32x4_t overflow = vreinterpretq_s32_u32(
+      vceqq_s32(max_mantissa, vdupq_n_s32(1 << kMantissaBits)));
+  exponent = vsubq_s32(exponent, overflow);
+  scale = vreinterpretq_f32_s32(
+      vshlq_n_s32(vsubq_s32(scale_bias, exponent), 23));
+
+  const uint32x4_t rs =
+      vcvtq_u32_f32(vaddq_f32(vmulq_f32(r, scale), half));
+  const uint32x4_t gs =
+      vcvtq_u32_f32(vaddq_f32(vmulq_f32(g, scale), half));
+  const uint32x4_t bs =
+      vcvtq_u32_f32(vaddq_f32(vmulq_f32(b, scale), half));
+  uint32x4_t packed = vorrq_u32(rs, vshlq_n_u32(gs, 9));
+  packed = vorrq_u32(packed, vshlq_n_u32(bs, 18));
+  packed = vorrq_u32(packed,
+                     vshlq_n_u32(vreinterpretq_u32_s32(exponent), 27));
+  vst1q_u32(out, packed);
+}
+#elif defined(HELLO_AR_RGB9E5_SSE2)
+// Encodes 4 texels, transposed so each vector holds one channel.
+inline void EncodeTexels4(const float* rgba, uint32_t* out) {
+  __m128 r = _mm_loadu_ps(rgba);
+  __m128 g = _mm_loadu_ps(rgba + 4);
+  __m128 b = _mm_loadu_ps(rgba + 8);
+  __m128 a = _mm_loadu_ps(rgba + 12);
+  _MM_TRANSPOSE4_PS(r, g, b, a);
+
+  // _mm_max_ps returns the second operand for NaN.
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 max_value = _mm_set1_ps(kMaxValue);
+  const __m128 half = _mm_set1_ps(0.5f);
+  r = _mm_min_ps(_mm_max_ps(r, zero), max_value);
+  g = _mm_min_ps(_mm_max_ps(g, zero), max_value);
+  b = _mm_min_ps(_mm_max_ps(b, zero), max_value);
+  const __m128 max_channel = _mm_max_ps(r, _mm_max_ps(g, b));
+
+  __m128i exponent = _mm_sub_epi32(
+      _mm_srli_epi32(_mm_castps_si128(max_channel), 23), _mm_set1_epi32(127));
+  // SSE2 has no signed 32 bit max.
+  const __m128i min_exponent = _mm_set1_epi32(-kExponentBias - 1);
+  const __m128i above = _mm_cmpgt_epi32(exponent, min_exponent);
+  exponent = _mm_or_si128(_mm_and_si128(above, exponent),
+                          _mm_andnot_si128(above, min_exponent));
+  exponent = _mm_add_epi32(exponent, _mm_set1_epi32(1 + kExponentBias));
+  const __m128i scale_bias =
+      _mm_set1_epi32(kExponentBias + kMantissaBits + 127);
+  __m128 scale = _mm_castsi128_ps(
+      _mm_slli_epi32(_mm_sub_epi32(scale_bias, exponent), 23));
+  const __m128i max_mantissa = _mm_cvttps_epi32(
+      _mm_add_ps(_mm_mul_ps(max_channel, scale), half));
+  // The mask is -1 where rounding overflowed the mantissa.
+  const __m128i overflow =
+      _mm_cmpeq_epi32(max_mantissa, _mm_set1_epi32(1 << kMantissaBits));
+  exponent = _mm_sub_epi32(exponent, overflow);
+  scale = _mm_castsi128_ps(
+      _mm_slli_epi32(_mm_sub_epi32(scale_bias, exponent), 23));
+
+  const __m128i rs = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(r, scale), half));
+  const __m128i gs = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(g, scale), half));
+  const __m128i bs = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(b, scale), half));
+  __m128i packed = _mm_or_si128(rs, _mm_slli_epi32(gs, 9));
+  packed = _mm_or_si128(packed, _mm_slli_epi32(bs, 18));
+  packed = _mm_or_si128(packed, _mm_slli_epi32(exponent, 27));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+}
+#endif
+
+}  // namespace
+
+float HalfToFloat(uint16_t half) {
+  const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+  const uint32_t exponent = (half >> 10) & 0x1f;
+  uint32_t mantissa = half & 0x3ff;
+  uint32_t bits;
+  if (exponent == 0x1f) {
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  } else if (exponent != 0) {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  } else if (mantissa == 0) {
+    bits = sign;
+  } else {
+    // Denormal: normalize the mantissa.
+    int shift = 0;
+    while (!(mantissa & 0x400)) {
+      mantissa <<= 1;
+      shift++;
+    }
+    bits = sign | ((113 - shift) << 23) | ((mantissa & 0x3ff) << 13);
+  }
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void DownsampleCubemapFace(const uint8_t* src, int src_size,
+                           int src_row_stride, int src_pixel_stride,
+                           int dst_size, float* dst_rgba) {
+  const int ratio = src_size / dst_size;
+  const float weight = 1.f / (ratio * ratio);
+  for (int y = 0; y < dst_size; ++y) {
+    for (int x = 0; x < dst_size; ++x) {
+      float sum[3] = {0.f, 0.f, 0.f};
+      for (int sy = 0; sy < ratio; ++sy) {
+        const uint8_t* row = src + (y * ratio + sy) * src_row_stride;
+        for (int sx = 0; sx < ratio; ++sx) {
+          uint16_t texel[3];
+          memcpy(texel, row + (x * ratio + sx) * src_pixel_stride,
+                 sizeof(texel));
+          sum[0] += HalfToFloat(texel[0]);
+          sum[1] += HalfToFloat(texel[1]);
+          sum[2] += HalfToFloat(texel[2]);
+        }
+      }
+      float* out = dst_rgba + (y * dst_size + x) * 4;
+      out[0] = sum[0] * weight;
+      out[1] = sum[1] * weight;
+      out[2] = sum[2] * weight;
+      out[3] = 1.f;
+    }
+  }
+}
+
+void EncodeRgb9e5Scalar(const float* rgba, size_t count, uint32_t* out) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = EncodeTexel(rgba + i * 4);
+  }
+}
+
+void EncodeRgb9e5(const float* rgba, size_t count, uint32_t* out) {
+  size_t i = 0;
+#if defined(HELLO_AR_RGB9E5_NEON) || defined(HELLO_AR_RGB9E5_SSE2)
+  for (; i + 4 <= count; i += 4) {
+    EncodeTexels4(rgba + i * 4, out + i);
+  }
+#endif
+  EncodeRgb9e5Scalar(rgba + i * 4, count - i, out + i);
+}
+
+void DecodeRgb9e5(uint32_t texel, float rgb[3]) {
+  const float scale =
+      Pow2(static_cast<int>(texel >> 27) - kExponentBias - kMantissaBits);
+  rgb[0] = (texel & 0x1ff) * scale;
+  rgb[1] = ((texel >> 9) & 0x1ff) * scale;
+  rgb[2] = ((texel >> 18) & 0x1ff) * scale;
+}
+
+}  // namespace hello_ar
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_CUBEMAP_ENCODER_H_
+#define C_ARCORE_HELLO_AR_CUBEMAP_ENCODER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// Conversion of ARCore's environmental HDR cubemap faces (RGBA half floats)
+// into the compact shared-exponent GL_RGB9_E5 format for streaming: 4 bytes
+// per texel instead of 8, with 9 bits of mantissa per channel, which is below
+// what the server's reflections can resolve.
+namespace hello_ar {
+
+// Averages a |src_size| x |src_size| RGBA16F face into |dst_size| x
+// |dst_size| linear RGBA floats (alpha is 1).  |dst_size| must divide
+// |src_size|.  Strides are in bytes.
+void DownsampleCubemapFace(const uint8_t* src, int src_size,
+                           int src_row_stride, int src_pixel_stride,
+                           int dst_size, float* dst_rgba);
+
+// Encodes |count| linear RGBA float texels (alpha ignored) to RGB9E5.
+// Negative values and NaN encode as 0 and values above the format's maximum
+// (65408), including infinity, are clamped.  Uses NEON or SSE2 where available.
+void EncodeRgb9e5(const float* rgba, size_t count, uint32_t* out);
+
+// Portable version of EncodeRgb9e5(), for comparison in host benchmarks.
+void EncodeRgb9e5Scalar(const float* rgba, size_t count, uint32_t* out);
+
+// Decodes one RGB9E5 texel.
+void DecodeRgb9e5(uint32_t texel, float rgb[3]);
+
+// Converts an IEEE half float to float.
+float HalfToFloat(uint16_t half);
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_CUBEMAP_ENCODER_H_
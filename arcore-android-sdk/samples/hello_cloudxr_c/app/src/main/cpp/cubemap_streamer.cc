@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "cubemap_streamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "async_log.h"
+#include "cubemap_encoder.h"
+#include "trace.h"
+#include "util.h"
+
+namespace hello_ar {
+namespace {
+constexpr int kFaces = 6;
+// Keeps the change threshold meaningful for black texels.
+constexpr float kMinReference = 1e-3f;
+}  // namespace
+
+bool CubemapStreamer::Start(const Config& config, Sink sink) {
+  if (!sink || config.face_size <= 0 || config.tile_size <= 0 ||
+      config.face_size % config.tile_size != 0 ||
+      config.face_size / config.tile_size > 255 ||
+      config.max_bytes_per_second == 0) {
+    LOGE("Invalid cubemap streaming config");
+    return false;
+  }
+  config_ = config;
+  sink_ = std::move(sink);
+
+  const size_t face_texels = config_.face_size * config_.face_size;
+  tiles_per_edge_ = config_.face_size / config_.tile_size;
+  tile_count_ = kFaces * tiles_per_edge_ * tiles_per_edge_;
+  tile_bytes_ = sizeof(cubemap::CubemapTileHeader) +
+                config_.tile_size * config_.tile_size * sizeof(uint32_t);
+  faces_.assign(kFaces * face_texels * 4, 0.f);
+  sent_faces_.assign(faces_.size(), 0.f);
+  pending_tiles_.assign(tile_count_, 1);
+  tile_texels_.assign(config_.tile_size * config_.tile_size * 4, 0.f);
+  tile_encoded_.assign(config_.tile_size * config_.tile_size, 0);
+  message_.assign(sizeof(cubemap::CubemapUpdateHeader) +
+                      tile_count_ * tile_bytes_, 0);
+  Reset();
+  return true;
+}
+
+void CubemapStreamer::Stop() { sink_ = nullptr; }
+
+void CubemapStreamer::Reset() {
+  std::fill(pending_tiles_.begin(), pending_tiles_.end(), 1);
+  next_tile_ = 0;
+  // Enough budget for one full cubemap straight away.
+  budget_bytes_ = message_.size();
+  has_read_ = false;
+}
+
+size_t CubemapStreamer::Update(const ArSession* session,
+                               const ArLightEstimate* estimate,
+                               int64_t timestamp_ns) {
+  if (!IsRunning()) return 0;
+
+  // Refill the budget, capped at one second or one full cubemap.
+  if (has_read_ && timestamp_ns > budget_timestamp_ns_) {
+    const double cap = std::max<double>(config_.max_bytes_per_second,
+                                        message_.size());
+    budget_bytes_ = std::min(
+        cap, budget_bytes_ + (timestamp_ns - budget_timestamp_ns_) * 1e-9 *
+                                 config_.max_bytes_per_second);
+  }
+  budget_timestamp_ns_ = timestamp_ns;
+
+  if (has_read_ && timestamp_ns >= read_timestamp_ns_ &&
+      timestamp_ns - read_timestamp_ns_ < config_.min_interval_ns) {
+    return 0;
+  }
+  const size_t header_size = sizeof(cubemap::CubemapUpdateHeader);
+  if (budget_bytes_ < header_size + tile_bytes_) return 0;
+
+  TRACE_SCOPE("CubemapUpdate");
+  if (!ReadCubemap(session, estimate)) return 0;
+  has_read_ = true;
+  read_timestamp_ns_ = timestamp_ns;
+  MarkChangedTiles();
+
+  // Send pending tiles round robin, as many as the budget allows.
+  const size_t max_tiles = std::min<size_t>(
+      tile_count_,
+      static_cast<size_t>((budget_bytes_ - header_size) / tile_bytes_));
+  size_t offset = header_size;
+  uint32_t sent_tiles = 0;
+  for (size_t i = 0; i < tile_count_ && sent_tiles < max_tiles; ++i) {
+    const size_t tile = (next_tile_ + i) % tile_count_;
+    if (!pending_tiles_[tile]) continue;
+    offset = AppendTile(tile, offset);
+    pending_tiles_[tile] = 0;
+    sent_tiles++;
+    next_tile_ = (tile + 1) % tile_count_;
+  }
+  if (sent_tiles == 0) return 0;
+
+  cubemap::CubemapUpdateHeader header = {};
+  memcpy(header.magic, cubemap::kMagic, sizeof(header.magic));
+  header.face_size = static_cast<uint16_t>(config_.face_size);
+  header.tile_size = static_cast<uint16_t>(config_.tile_size);
+  header.tile_count = sent_tiles;
+  header.timestamp_ns = timestamp_ns;
+  memcpy(message_.data(), &header, sizeof(header));
+
+  sink_(message_.data(), offset);
+  budget_bytes_ -= offset;
+  return offset;
+}
+
+bool CubemapStreamer::ReadCubemap(const ArSession* session,
+                                  const ArLightEstimate* estimate) {
+  ArImageCubemap images = {};
+  ArLightEstimate_acquireEnvironmentalHdrCubemap(session, estimate, images);
+
+  bool ok = true;
+  const size_t face_floats = config_.face_size * config_.face_size * 4;
+  for (int face = 0; face < kFaces && ok; ++face) {
+    int32_t width = 0, height = 0;
+    ArImageFormat format = AR_IMAGE_FORMAT_INVALID;
+    if (images[face] != nullptr) {
+      ArImage_getWidth(session, images[face], &width);
+      ArImage_getHeight(session, images[face], &height);
+      ArImage_getFormat(session, images[face], &format);
+    }
+    if (format != AR_IMAGE_FORMAT_RGBA_FP16 || width != height ||
+        width < config_.face_size || width % config_.face_size != 0) {
+      LOGE_RL(5000, "Unexpected cubemap face %d: %dx%d format %d", face,
+              width, height, format);
+      ok = false;
+      break;
+    }
+
+    int32_t pixel_stride = 0, row_stride = 0, length = 0;
+    const uint8_t* data = nullptr;
+    ArImage_getPlanePixelStride(session, images[face], 0, &pixel_stride);
+    ArImage_getPlaneRowStride(session, images[face], 0, &row_stride);
+    ArImage_getPlaneData(session, images[face], 0, &data, &length);
+    if (data == nullptr || length < row_stride * (height - 1) +
+                                        pixel_stride * width) {
+      ok = false;
+      break;
+    }
+    DownsampleCubemapFace(data, width, row_stride, pixel_stride,
+                          config_.face_size, &faces_[face * face_floats]);
+  }
+
+  for (ArImage* image : images) ArImage_release(image);
+  return ok;
+}
+
+void CubemapStreamer::MarkChangedTiles() {
+  const int face_size = config_.face_size;
+  const int tile_size = config_.tile_size;
+  for (size_t tile = 0; tile < tile_count_; ++tile) {
+    if (pending_tiles_[tile]) continue;
+    const int face = tile / (tiles_per_edge_ * tiles_per_edge_);
+    const int index = tile % (tiles_per_edge_ * tiles_per_edge_);
+    const int x0 = (index % tiles_per_edge_) * tile_size;
+    const int y0 = (index / tiles_per_edge_) * tile_size;
+    for (int y = y0; y < y0 + tile_size && !pending_tiles_[tile]; ++y) {
+      for (int x = x0; x < x0 + tile_size; ++x) {
+        const size_t texel = ((face * face_size + y) * face_size + x) * 4;
+        const float* current = &faces_[texel];
+        const float* sent = &sent_faces_[texel];
+        const float reference = std::max(
+            kMinReference, std::max(sent[0], std::max(sent[1], sent[2])));
+        const float limit = config_.change_threshold * reference;
+        if (std::fabs(current[0] - sent[0]) > limit ||
+            std::fabs(current[1] - sent[1]) > limit ||
+            std::fabs(current[2] - sent[2]) > limit) {
+          pending_tiles_[tile] = 1;
+          break;
+        }
+      }
+    }
+  }
+}
+
+size_t CubemapStreamer::AppendTile(size_t tile, size_t offset) {
+  const int face_size = config_.face_size;
+  const int tile_size = config_.tile_size;
+  const int face = tile / (tiles_per_edge_ * tiles_per_edge_);
+  const int index = tile % (tiles_per_edge_ * tiles_per_edge_);
+  const int x0 = (index % tiles_per_edge_) * tile_size;
+  const int y0 = (index / tiles_per_edge_) * tile_size;
+
+  cubemap::CubemapTileHeader header = {};
+  header.face = static_cast<uint8_t>(face);
+  header.tile_x = static_cast<uint8_t>(x0 / tile_size);
+  header.tile_y = static_cast<uint8_t>(y0 / tile_size);
+  memcpy(&message_[offset], &header, sizeof(header));
+  offset += sizeof(header);
+
+  // Gather the tile's rows, and remember them as sent.
+  const size_t row_floats = tile_size * 4;
+  for (int y = 0; y < tile_size; ++y) {
+    const size_t texel = ((face * face_size + y0 + y) * face_size + x0) * 4;
+    memcpy(&tile_texels_[y * row_floats], &faces_[texel],
+           row_floats * sizeof(float));
+    memcpy(&sent_faces_[texel], &faces_[texel], row_floats * sizeof(float));
+  }
+
+  const size_t texels = tile_size * tile_size;
+  EncodeRgb9e5(tile_texels_.data(), texels, tile_encoded_.data());
+  memcpy(&message_[offset], tile_encoded_.data(), texels * sizeof(uint32_t));
+  return offset + texels * sizeof(uint32_t);
+}
+
+}  // namespace hello_ar
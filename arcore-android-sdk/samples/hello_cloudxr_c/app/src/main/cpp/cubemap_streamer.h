@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_CUBEMAP_STREAMER_H_
+#define C_ARCORE_HELLO_AR_CUBEMAP_STREAMER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "arcore_c_api.h"
+
+namespace hello_ar {
+
+// Layout of one cubemap update as handed to the sink: a CubemapUpdateHeader
+// followed by |tile_count| tiles, each a CubemapTileHeader and tile_size *
+// tile_size RGB9E5 texels in row-major order.  Faces are in GL cubemap order
+// (+X, -X, +Y, -Y, +Z, -Z), as ARCore returns them.
+namespace cubemap {
+
+constexpr char kMagic[4] = {'E', 'C', 'M', '1'};
+
+struct CubemapUpdateHeader {
+  char magic[4];
+  uint16_t face_size;
+  uint16_t tile_size;
+  uint32_t tile_count;
+  uint32_t reserved;
+  // ARCore timestamp of the light estimate the cubemap belongs to.
+  int64_t timestamp_ns;
+};
+static_assert(sizeof(CubemapUpdateHeader) == 24,
+              "CubemapUpdateHeader layout changed");
+
+struct CubemapTileHeader {
+  uint8_t face;
+  uint8_t tile_x;
+  uint8_t tile_y;
+  uint8_t reserved;
+};
+static_assert(sizeof(CubemapTileHeader) == 4,
+              "CubemapTileHeader layout changed");
+
+}  // namespace cubemap
+
+// Streams ARCore's environmental HDR cubemap upstream.  Each new estimate is
+// downsampled to |face_size| and split into tiles; only tiles that changed
+// noticeably since they were last sent go out, RGB9E5 encoded, and never more
+// than |max_bytes_per_second| on average.  Tiles that do not fit the budget
+// stay pending and go out with a later update.
+//
+// The CloudXR client API has no upstream channel for custom data, so the
+// messages go to a sink provided with Start().
+//
+// Not thread safe: owned and used by the render thread.
+class CubemapStreamer {
+ public:
+  struct Config {
+    // Texels per face edge sent.  Must divide ARCore's face size (16).
+    int face_size = 8;
+    // Texels per tile edge.  Must divide |face_size|.
+    int tile_size = 4;
+    // Change of a texel relative to its brightest channel when last sent.
+    float change_threshold = 0.05f;
+    uint32_t max_bytes_per_second = 4096;
+    // Cubemaps are read at most this often.
+    int64_t min_interval_ns = 250000000;
+  };
+
+  using Sink = std::function<void(const uint8_t* data, size_t size)>;
+
+  CubemapStreamer() = default;
+
+  CubemapStreamer(const CubemapStreamer&) = delete;
+  void operator=(const CubemapStreamer&) = delete;
+
+  // Allocates the buffers for |config|.  Returns false if the config is
+  // invalid.
+  bool Start(const Config& config, Sink sink);
+  void Stop();
+  bool IsRunning() const { return static_cast<bool>(sink_); }
+
+  // Marks every tile for resending, e.g. after reconnecting to the server.
+  void Reset();
+
+  // Handles a new environmental HDR light estimate.  Returns the number of
+  // bytes sent, 0 if nothing was.
+  size_t Update(const ArSession* session, const ArLightEstimate* estimate,
+                int64_t timestamp_ns);
+
+ private:
+  bool ReadCubemap(const ArSession* session, const ArLightEstimate* estimate);
+  void MarkChangedTiles();
+  size_t AppendTile(size_t tile, size_t offset);
+
+  Config config_;
+  Sink sink_;
+  int tiles_per_edge_ = 0;
+  size_t tile_count_ = 0;
+  size_t tile_bytes_ = 0;
+
+  // Linear RGBA texels of the six faces, as read and as last sent.
+  std::vector<float> faces_;
+  std::vector<float> sent_faces_;
+  std::vector<uint8_t> pending_tiles_;
+  std::vector<float> tile_texels_;
+  std::vector<uint32_t> tile_encoded_;
+  std::vector<uint8_t> message_;
+
+  size_t next_tile_ = 0;
+  double budget_bytes_ = 0.0;
+  int64_t budget_timestamp_ns_ = 0;
+  int64_t read_timestamp_ns_ = 0;
+  bool has_read_ = false;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_CUBEMAP_STREAMER_H_
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "util.h"
+
+namespace hello_ar {
+namespace {
+
+inline size_t AlignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+char* AllocateBlock(size_t size) {
+  char* block = static_cast<char*>(malloc(size));
+  CHECK(block);
+  return block;
+}
+
+}  // namespace
+
+FrameArena::FrameArena(size_t initial_capacity)
+    : block_(AllocateBlock(initial_capacity)), capacity_(initial_capacity) {
+  overflow_blocks_.reserve(8);
+}
+
+FrameArena::~FrameArena() {
+  for (char* block : overflow_blocks_) free(block);
+  free(block_);
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+  // Account for worst case padding so the high water mark is a safe size.
+  frame_bytes_ += size + alignment - 1;
+  const size_t start =
+      AlignUp(reinterpret_cast<uintptr_t>(block_) + offset_, alignment) -
+      reinterpret_cast<uintptr_t>(block_);
+  if (start + size <= capacity_) {
+    offset_ = start + size;
+    return block_ + start;
+  }
+  return AllocateOverflow(size, alignment);
+}
+
+void* FrameArena::AllocateOverflow(size_t size, size_t alignment) {
+  char* block = AllocateBlock(size + alignment - 1);
+  overflow_blocks_.push_back(block);
+  return reinterpret_cast<void*>(
+      AlignUp(reinterpret_cast<uintptr_t>(block), alignment));
+}
+
+void FrameArena::Reset() {
+  high_water_mark_ = std::max(high_water_mark_, frame_bytes_);
+  if (!overflow_blocks_.empty()) {
+    for (char* block : overflow_blocks_) free(block);
+    overflow_blocks_.clear();
+    // Grow to fit the largest frame seen, with headroom.
+    free(block_);
+    capacity_ = AlignUp(high_water_mark_ + high_water_mark_ / 2, 4096);
+    block_ = AllocateBlock(capacity_);
+  }
+  offset_ = 0;
+  frame_bytes_ = 0;
+}
+
+}  // namespace hello_ar
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#ifndef C_ARCORE_HELLO_AR_FRAME_ARENA_H_
+#define C_ARCORE_HELLO_AR_FRAME_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hello_ar {
+
+// Bump allocator for transient data that lives for one frame.  Reset() at the
+// start of the frame releases everything at once.  A frame that outgrows the
+// current block spills into overflow blocks; the next Reset() replaces them
+// with one block large enough for the whole frame, so once the frame loop has
+// seen its largest frame it stops touching the heap.
+//
+// Not thread safe: owned and used by the render thread.
+class FrameArena {
+ public:
+  explicit FrameArena(size_t initial_capacity = 64 * 1024);
+  ~FrameArena();
+
+  FrameArena(const FrameArena&) = delete;
+  void operator=(const FrameArena&) = delete;
+
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  template <typename T>
+  T* AllocateArray(size_t count) {
+    return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  // Frees all allocations made since the last Reset().
+  void Reset();
+
+  size_t capacity() const { return capacity_; }
+  // Largest number of bytes requested in a single frame so far.
+  size_t high_water_mark() const { return high_water_mark_; }
+
+ private:
+  void* AllocateOverflow(size_t size, size_t alignment);
+
+  char* block_ = nullptr;
+  size_t capacity_ = 0;
+  size_t offset_ = 0;
+
+  std::vector<char*> overflow_blocks_;
+  size_t frame_bytes_ = 0;
+  size_t high_water_mark_ = 0;
+};
+
+// Standard allocator backed by a FrameArena, for containers that are built
+// and discarded within a frame.  deallocate() is a no-op, so reserve() the
+// final size up front rather than growing incrementally.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit ArenaAllocator(FrameArena* arena) noexcept : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+      : arena_(other.arena()) {}
+
+  T* allocate(size_t count) { return arena_->AllocateArray<T>(count); }
+  void deallocate(T*, size_t) noexcept {}
+
+  FrameArena* arena() const { return arena_; }
+
+ private:
+  FrameArena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return !(a == b);
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_FRAME_ARENA_H_
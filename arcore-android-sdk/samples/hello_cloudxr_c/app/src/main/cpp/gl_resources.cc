@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "gl_resources.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "util.h"
+
+namespace hello_ar {
+namespace {
+
+float MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<float, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+}  // namespace
+
+int GlResourceManager::Register(const char* name, int priority,
+                                Function create, Function release) {
+  const int id = static_cast<int>(groups_.size());
+  groups_.push_back(
+      {name, priority, std::move(create), std::move(release), false});
+  order_.insert(std::upper_bound(order_.begin(), order_.end(), priority,
+                                 [this](int value, int index) {
+                                   return value < groups_[index].priority;
+                                 }),
+                id);
+  ++pending_;
+  return id;
+}
+
+void GlResourceManager::OnContextCreated() {
+  for (Group& group : groups_) group.ready = false;
+  pending_ = static_cast<int>(groups_.size());
+}
+
+void GlResourceManager::Invalidate(int id) {
+  Group& group = groups_[id];
+  if (!group.ready) return;
+  if (group.release) group.release();
+  group.ready = false;
+  ++pending_;
+}
+
+bool GlResourceManager::CreatePending(float budget_ms) {
+  if (pending_ == 0) return false;
+
+  const auto start = std::chrono::steady_clock::now();
+  bool created = false;
+  for (int index : order_) {
+    Group& group = groups_[index];
+    if (group.ready) continue;
+    if (created && MillisecondsSince(start) >= budget_ms) break;
+
+    const auto group_start = std::chrono::steady_clock::now();
+    group.create();
+    group.ready = true;
+    --pending_;
+    created = true;
+    LOGI("GL resources: created %s in %.2f ms", group.name,
+         MillisecondsSince(group_start));
+  }
+  return created;
+}
+
+}  // namespace hello_ar
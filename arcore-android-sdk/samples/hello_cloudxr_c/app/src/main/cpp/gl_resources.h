@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_GL_RESOURCES_H_
+#define C_ARCORE_HELLO_AR_GL_RESOURCES_H_
+
+#include <functional>
+#include <vector>
+
+namespace hello_ar {
+
+// Creates the client's GL resources on the render thread, lazily and in
+// priority order.  GLSurfaceView preserves the EGL context across pause and
+// resume, so normally everything is created once; only a new context (the
+// old one was lost) or an explicit Invalidate() recreates a group.  After a
+// context loss the highest priority group, the camera passthrough, is created
+// first so a frame can be shown before the rest is ready.
+//
+// Not thread safe: owned and used by the render thread.
+class GlResourceManager {
+ public:
+  using Function = std::function<void()>;
+
+  // Registers a group of resources made by |create|.  Lower |priority| values
+  // are created first.  |release| deletes the group's objects while the
+  // context is still current, before Invalidate() recreates it; it may be
+  // empty.  Returns the group's id.
+  int Register(const char* name, int priority, Function create,
+               Function release = nullptr);
+
+  // A new context was created and every object of the previous one is gone,
+  // so all groups are created again.
+  void OnContextCreated();
+
+  // Releases group |id| and creates it again on the next CreatePending().
+  void Invalidate(int id);
+
+  // Creates pending groups in priority order.  The first one is always
+  // created; later ones only until |budget_ms| has passed, so a cold start
+  // is spread over a few frames.  Returns true if any group was created.
+  bool CreatePending(float budget_ms);
+
+  bool IsReady(int id) const { return groups_[id].ready; }
+  bool AllReady() const { return pending_ == 0; }
+
+ private:
+  struct Group {
+    const char* name;
+    int priority;
+    Function create;
+    Function release;
+    bool ready;
+  };
+
+  std::vector<Group> groups_;
+  // Indices into |groups_| sorted by priority.
+  std::vector<int> order_;
+  int pending_ = 0;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_GL_RESOURCES_H_
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "gpu_memory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace hello_ar {
+
+GpuMemoryTracker::GpuMemoryTracker() {
+  objects_.reserve(64);
+  owners_.reserve(8);
+}
+
+void GpuMemoryTracker::Track(GpuObjectType type, GLuint name,
+                             const char* owner, uint64_t bytes) {
+  int owner_index = FindOwner(owner);
+  if (owner_index < 0) {
+    owner_index = static_cast<int>(owners_.size());
+    owners_.push_back({owner, 0, 0});
+  }
+
+  auto it = std::find_if(objects_.begin(), objects_.end(),
+                         [type, name](const Object& object) {
+                           return object.type == type && object.name == name;
+                         });
+  if (it != objects_.end()) Remove(it - objects_.begin());
+
+  objects_.push_back({type, name, owner_index, bytes});
+  owners_[owner_index].bytes += bytes;
+  owners_[owner_index].objects++;
+  type_bytes_[static_cast<int>(type)] += bytes;
+  total_bytes_ += bytes;
+}
+
+void GpuMemoryTracker::Untrack(GpuObjectType type, GLsizei count,
+                               const GLuint* names) {
+  for (GLsizei i = 0; i < count; ++i) {
+    for (size_t index = 0; index < objects_.size(); ++index) {
+      if (objects_[index].type == type && objects_[index].name == names[i]) {
+        Remove(index);
+        break;
+      }
+    }
+  }
+}
+
+void GpuMemoryTracker::Clear() {
+  objects_.clear();
+  for (Owner& owner : owners_) {
+    owner.bytes = 0;
+    owner.objects = 0;
+  }
+  std::fill(std::begin(type_bytes_), std::end(type_bytes_), 0);
+  total_bytes_ = 0;
+}
+
+uint64_t GpuMemoryTracker::owner_bytes(const char* owner) const {
+  const int index = FindOwner(owner);
+  return index < 0 ? 0 : owners_[index].bytes;
+}
+
+uint64_t GpuMemoryTracker::ImageBytes(int width, int height,
+                                      int bytes_per_texel, bool mipmapped) {
+  uint64_t bytes = 0;
+  for (;;) {
+    bytes += static_cast<uint64_t>(width) * height * bytes_per_texel;
+    if (!mipmapped || (width == 1 && height == 1)) break;
+    width = std::max(1, width / 2);
+    height = std::max(1, height / 2);
+  }
+  return bytes;
+}
+
+int GpuMemoryTracker::FindOwner(const char* owner) const {
+  for (size_t i = 0; i < owners_.size(); ++i) {
+    if (owners_[i].name == owner || strcmp(owners_[i].name, owner) == 0) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void GpuMemoryTracker::Remove(size_t index) {
+  const Object& object = objects_[index];
+  owners_[object.owner].bytes -= object.bytes;
+  owners_[object.owner].objects--;
+  type_bytes_[static_cast<int>(object.type)] -= object.bytes;
+  total_bytes_ -= object.bytes;
+  objects_[index] = objects_.back();
+  objects_.pop_back();
+}
+
+}  // namespace hello_ar
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_GPU_MEMORY_H_
+#define C_ARCORE_HELLO_AR_GPU_MEMORY_H_
+
+#include <GLES2/gl2.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hello_ar {
+
+enum class GpuObjectType { kTexture, kRenderbuffer, kBuffer, kNumTypes };
+
+// Registry of the GL textures, renderbuffers and buffers the renderers own,
+// with their sizes, and the GPU memory budget they should stay within.
+// GL has no query for an object's memory, so the renderers report the size
+// of each storage they specify: Track() when creating or resizing an object,
+// Untrack() when deleting it.  Sizes are the specified texels and bytes;
+// drivers may pad them.
+//
+// Not thread safe: owned and used by the render thread.
+class GpuMemoryTracker {
+ public:
+  // Memory held by one owner, e.g. a renderer.
+  struct Owner {
+    const char* name;
+    uint64_t bytes;
+    uint32_t objects;
+  };
+
+  GpuMemoryTracker();
+
+  // Records that object |name| of |type|, owned by |owner|, holds |bytes|.
+  // Replaces the size recorded before for the same object.  |owner| must
+  // outlive the tracker, e.g. a string literal.
+  void Track(GpuObjectType type, GLuint name, const char* owner,
+             uint64_t bytes);
+  // Forgets |count| objects of |type|, e.g. before deleting them.  Unknown
+  // names are ignored.
+  void Untrack(GpuObjectType type, GLsizei count, const GLuint* names);
+  // Forgets every object, when the context they lived in was lost.
+  void Clear();
+
+  uint64_t total_bytes() const { return total_bytes_; }
+  uint64_t bytes(GpuObjectType type) const {
+    return type_bytes_[static_cast<int>(type)];
+  }
+  // Memory held by |owner|, 0 if it holds nothing.
+  uint64_t owner_bytes(const char* owner) const;
+  // Every owner seen so far, in the order they first tracked an object.
+  const std::vector<Owner>& owners() const { return owners_; }
+
+  // Budget in bytes, 0 for none.
+  void set_budget_bytes(uint64_t budget_bytes) { budget_bytes_ = budget_bytes; }
+  uint64_t budget_bytes() const { return budget_bytes_; }
+  bool OverBudget() const {
+    return budget_bytes_ != 0 && total_bytes_ > budget_bytes_;
+  }
+
+  // Bytes of a |width| x |height| image with |bytes_per_texel|, and of its
+  // whole mip chain if |mipmapped|.
+  static uint64_t ImageBytes(int width, int height, int bytes_per_texel,
+                             bool mipmapped);
+
+ private:
+  struct Object {
+    GpuObjectType type;
+    GLuint name;
+    int owner;
+    uint64_t bytes;
+  };
+
+  int FindOwner(const char* owner) const;
+  void Remove(size_t index);
+
+  // Few and rarely changed, so searched linearly.  Removal swaps in the last
+  // object, so a steady frame does not touch the heap.
+  std::vector<Object> objects_;
+  std::vector<Owner> owners_;
+  uint64_t type_bytes_[static_cast<int>(GpuObjectType::kNumTypes)] = {};
+  uint64_t total_bytes_ = 0;
+  uint64_t budget_bytes_ = 0;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_GPU_MEMORY_H_
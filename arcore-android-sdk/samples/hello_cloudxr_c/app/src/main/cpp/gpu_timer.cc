@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "gpu_timer.h"
+
+#include <EGL/egl.h>
+
+#include <cstring>
+
+#include "util.h"
+
+namespace hello_ar {
+
+void GpuTimer::InitializeGlContent() {
+  *this = GpuTimer();
+
+  const char* extensions =
+      reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+  if (!extensions || !strstr(extensions, "GL_EXT_disjoint_timer_query")) {
+    LOGI("GL_EXT_disjoint_timer_query not supported, no GPU timing");
+    return;
+  }
+  gen_queries_ = reinterpret_cast<PFNGLGENQUERIESEXTPROC>(
+      eglGetProcAddress("glGenQueriesEXT"));
+  begin_query_ = reinterpret_cast<PFNGLBEGINQUERYEXTPROC>(
+      eglGetProcAddress("glBeginQueryEXT"));
+  end_query_ = reinterpret_cast<PFNGLENDQUERYEXTPROC>(
+      eglGetProcAddress("glEndQueryEXT"));
+  get_query_objectuiv_ = reinterpret_cast<PFNGLGETQUERYOBJECTUIVEXTPROC>(
+      eglGetProcAddress("glGetQueryObjectuivEXT"));
+  get_query_objectui64v_ = reinterpret_cast<PFNGLGETQUERYOBJECTUI64VEXTPROC>(
+      eglGetProcAddress("glGetQueryObjectui64vEXT"));
+  supported_ = gen_queries_ && begin_query_ && end_query_ &&
+               get_query_objectuiv_ && get_query_objectui64v_;
+  if (supported_) {
+    gen_queries_(kNumQueries, queries_);
+    // Clears a disjoint event left over from before the queries.
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+  }
+}
+
+void GpuTimer::Begin() {
+  if (!supported_ || active_) return;
+  CollectResults();
+  // Skip the measurement rather than wait for the GPU to catch up.
+  if (in_flight_ == kNumQueries) return;
+  begin_query_(GL_TIME_ELAPSED_EXT,
+               queries_[(oldest_ + in_flight_) % kNumQueries]);
+  active_ = true;
+}
+
+void GpuTimer::End() {
+  if (!active_) return;
+  end_query_(GL_TIME_ELAPSED_EXT);
+  active_ = false;
+  in_flight_++;
+}
+
+void GpuTimer::CollectResults() {
+  // Reading the flag clears it, it applies to every query in flight.
+  GLint disjoint = 0;
+  glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+  if (disjoint) discard_ = in_flight_;
+
+  while (in_flight_ > 0) {
+    const GLuint query = queries_[oldest_];
+    GLuint available = 0;
+    get_query_objectuiv_(query, GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+    if (!available) break;
+
+    GLuint64 elapsed_ns = 0;
+    get_query_objectui64v_(query, GL_QUERY_RESULT_EXT, &elapsed_ns);
+    if (discard_ > 0) {
+      discard_--;
+    } else {
+      last_ms_ = static_cast<float>(elapsed_ns * 1e-6);
+      samples_++;
+    }
+    oldest_ = (oldest_ + 1) % kNumQueries;
+    in_flight_--;
+  }
+}
+
+}  // namespace hello_ar
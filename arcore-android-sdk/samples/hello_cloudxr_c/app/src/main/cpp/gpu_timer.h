@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_GPU_TIMER_H_
+#define C_ARCORE_HELLO_AR_GPU_TIMER_H_
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+#include <cstdint>
+
+namespace hello_ar {
+
+// Measures the GPU time of the GL commands between Begin() and End() with
+// GL_EXT_disjoint_timer_query.  Results are read back a few frames later,
+// once the GPU has finished them, so the render thread never waits on a
+// query.  Without the extension Begin() and End() do nothing.
+//
+// Not thread safe: owned and used by the render thread.
+class GpuTimer {
+ public:
+  // Looks up the extension and creates the queries.  Call on the OpenGL
+  // thread for every new context; queries of a lost context are forgotten.
+  void InitializeGlContent();
+
+  bool IsSupported() const { return supported_; }
+
+  void Begin();
+  void End();
+
+  // Last completed measurement in milliseconds, and the number of them so
+  // far.  Measurements spanning a disjoint event, e.g. a GPU clock change,
+  // are discarded.
+  float last_ms() const { return last_ms_; }
+  uint64_t samples() const { return samples_; }
+
+ private:
+  // Queries in flight, the GPU is rarely more than two frames behind.
+  static constexpr int kNumQueries = 4;
+
+  void CollectResults();
+
+  bool supported_ = false;
+  bool active_ = false;
+  GLuint queries_[kNumQueries] = {};
+  // Oldest query in flight, and the number in flight.
+  int oldest_ = 0;
+  int in_flight_ = 0;
+  // Queries in flight when a disjoint event was reported.
+  int discard_ = 0;
+  float last_ms_ = 0.f;
+  uint64_t samples_ = 0;
+
+  PFNGLGENQUERIESEXTPROC gen_queries_ = nullptr;
+  PFNGLBEGINQUERYEXTPROC begin_query_ = nullptr;
+  PFNGLENDQUERYEXTPROC end_query_ = nullptr;
+  PFNGLGETQUERYOBJECTUIVEXTPROC get_query_objectuiv_ = nullptr;
+  PFNGLGETQUERYOBJECTUI64VEXTPROC get_query_objectui64v_ = nullptr;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_GPU_TIMER_H_
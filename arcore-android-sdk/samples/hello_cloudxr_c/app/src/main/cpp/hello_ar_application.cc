@@ -39,13 +39,26 @@
 #include "hello_ar_application.h"
 
 #include <android/asset_manager.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <EGL/egl.h>
 
 #include "oboe/Oboe.h"
 
+#include "asset_view.h"
+#include "async_log.h"
+#include "client_metrics.h"
+#include "metrics_server.h"
 #include "plane_renderer.h"
+#include "qos_recorder.h"
+#include "trace.h"
 #include "util.h"
 
 #include "CloudXRClient.h"
@@ -63,19 +76,67 @@
 namespace hello_ar {
 namespace {
 const glm::vec3 kWhite = {255, 255, 255};
+// Frame time spent creating GL resources beyond the first pending group.
+constexpr float kGlResourceBudgetMs = 4.0f;
+// Limits of the camera history when shrinking it to the GPU memory budget.
+constexpr int kMinCameraHistoryLength = 4;
+constexpr int kMaxCameraHistoryScale = 4;
+
+// Sends each cubemap update as one UDP datagram to |address|:|port|.  Returns
+// an empty sink if the socket can't be set up.
+CubemapStreamer::Sink MakeUdpCubemapSink(const std::string& address,
+                                         uint16_t port) {
+  sockaddr_in to = {};
+  to.sin_family = AF_INET;
+  to.sin_port = htons(port);
+  if (inet_pton(AF_INET, address.c_str(), &to.sin_addr) != 1) {
+    LOGE("Cubemap streaming needs an IPv4 server address, got %s",
+         address.c_str());
+    return nullptr;
+  }
+  const int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    LOGE("Unable to create the cubemap socket");
+    return nullptr;
+  }
+  // Closed with the last copy of the sink.
+  std::shared_ptr<int> socket_fd(new int(fd), [](int* fd) {
+    close(*fd);
+    delete fd;
+  });
+  return [socket_fd, to](const uint8_t* data, size_t size) {
+    if (sendto(*socket_fd, data, size, MSG_DONTWAIT,
+               reinterpret_cast<const sockaddr*>(&to), sizeof(to)) < 0) {
+      LOGE_RL(1000, "Cubemap update of %zu bytes not sent", size);
+    }
+  };
+}
 }  // namespace
 
 class ARLaunchOptions : public CloudXR::ClientOptions {
 public:
     bool using_env_lighting_;
     float res_factor_;
+    std::string trace_file_;
+    std::string ar_record_file_;
+    QosRecorder::Config qos_config_;
+    uint16_t metrics_port_;
+    uint16_t cubemap_port_;
+    bool perf_hud_;
+    float plane_lod_pixels_;
+    uint32_t gpu_budget_mb_;
 
     ARLaunchOptions() :
       ClientOptions(),
       using_env_lighting_(true), // default ON
       // default to 0.75 reduced size, as many devices can't handle full throughput.
       // 0.75 chosen as WAR value for steamvr buffer-odd-size bug, works on galaxytab s6 + pixel 2
-      res_factor_(0.75f)
+      res_factor_(0.75f),
+      metrics_port_(0), // default OFF
+      cubemap_port_(0), // default OFF
+      perf_hud_(false), // default OFF
+      plane_lod_pixels_(1.0f),
+      gpu_budget_mb_(0) // default OFF
     {
       AddOption("env-lighting", "el", true, "Send client environment lighting data to server.  1 enables, 0 disables.",
                  HANDLER_LAMBDA_FN
@@ -97,6 +158,122 @@ public:
                     LOGI("Resolution factor = %0.2f", res_factor_);
                     return ParseStatus_Success;
                  });
+      AddOption("perf-hud", "hud", true, "Show the performance overlay at startup.  1 enables, 0 disables.  Long-press the top-left corner to toggle.",
+                 HANDLER_LAMBDA_FN
+                 {
+                    if (tok=="1") {
+                      perf_hud_ = true;
+                    }
+                    else if (tok=="0") {
+                      perf_hud_ = false;
+                    }
+                    return ParseStatus_Success;
+                });
+      AddOption("plane-lod", "plod", true, "Simplify plane outlines by up to the given number of pixels at the plane's distance. Range [0-16], 0 disables, default 1.",
+                 HANDLER_LAMBDA_FN
+                 {
+                    float pixels = 0.f;
+                    std::stringstream ss(tok);
+                    if ((ss >> pixels) && pixels >= 0.f && pixels <= 16.f)
+                    {
+                      plane_lod_pixels_ = pixels;
+                      return ParseStatus_Success;
+                    }
+                    return ParseStatus_BadVal;
+                 });
+      AddOption("gpu-budget-mb", "gpub", true, "GPU memory budget of the client renderers in megabytes.  Over it the camera history kept for latency compensation is shortened, then reduced in resolution. Range [0-4096], 0 disables, default 0.",
+                 HANDLER_LAMBDA_FN
+                 {
+                    uint32_t mb = 0;
+                    std::stringstream ss(tok);
+                    if ((ss >> mb) && mb <= 4096)
+                    {
+                      gpu_budget_mb_ = mb;
+                      return ParseStatus_Success;
+                    }
+                    return ParseStatus_BadVal;
+                 });
+      AddOption("client-trace", "ct", true, "Write client frame and network trace events to the given file, in Chrome JSON trace format.",
+                 HANDLER_LAMBDA_FN
+                 {
+                    if (tok.empty()) return ParseStatus_BadVal;
+                    trace_file_ = tok;
+                    return ParseStatus_Success;
+                 });
+      AddOption("ar-record", "arr", true, "Record the ARCore session (camera, light estimates, planes and anchors) to the given file for host replay.",
+                 HANDLER_LAMBDA_FN
+                 {
+                    if (tok.empty()) return ParseStatus_BadVal;
+                    ar_record_file_ = tok;
+                    return ParseStatus_Success;
+                 });
+      AddOption("metrics-port", "mp", true, "Serve client performance metrics in Prometheus format on the given loopback port. 0 disables.",
+                 HANDLER_LAMBDA_FN
+                 {
+                    uint32_t port = 0;
+                    std::stringstream ss(tok);
+                    if ((ss >> port) && port <= 65535)
+                    {
+                      metrics_port_ = static_cast<uint16_t>(port);
+                      return ParseStatus_Success;
+                    }
+                    return ParseStatus_BadVal;
+                 });
+      AddOption("cubemap-port", "cmp", true, "Stream the environmental HDR cubemap as UDP datagrams to the given port of the server while environment lighting is on. 0 disables.",
+                 HANDLER_LAMBDA_FN
+                 {
+                    uint32_t port = 0;
+                    std::stringstream ss(tok);
+                    if ((ss >> port) && port <= 65535)
+                    {
+                      cubemap_port_ = static_cast<uint16_t>(port);
+                      return ParseStatus_Success;
+                    }
+                    return ParseStatus_BadVal;
+                 });
+      AddOption("qos-record", "qr", true, "Record connection QoS statistics to binary files in the given directory.",
+                 HANDLER_LAMBDA_FN
+                 {
+                    if (tok.empty()) return ParseStatus_BadVal;
+                    qos_config_.directory = tok;
+                    return ParseStatus_Success;
+                 });
+      AddOption("qos-interval-ms", "qri", true, "Interval between QoS samples in milliseconds. Range [10-60000], default 1000.",
+                 HANDLER_LAMBDA_FN
+                 {
+                    uint32_t interval = 0;
+                    std::stringstream ss(tok);
+                    if ((ss >> interval) && interval >= 10 && interval <= 60000)
+                    {
+                      qos_config_.interval_ms = interval;
+                      return ParseStatus_Success;
+                    }
+                    return ParseStatus_BadVal;
+                 });
+      AddOption("qos-max-kb", "qmk", true, "Maximum size of a single QoS record file in kilobytes. Range [1-64*1024], default 1024.",
+                 HANDLER_LAMBDA_FN
+                 {
+                    uint32_t max = 0;
+                    std::stringstream ss(tok);
+                    if ((ss >> max) && max >= 1 && max <= 64 * 1024)
+                    {
+                      qos_config_.max_file_kb = max;
+                      return ParseStatus_Success;
+                    }
+                    return ParseStatus_BadVal;
+                 });
+      AddOption("qos-max-files", "qmf", true, "Number of QoS record files kept before the oldest is deleted. Range [1-100], default 4.",
+                 HANDLER_LAMBDA_FN
+                 {
+                    uint32_t max = 0;
+                    std::stringstream ss(tok);
+                    if ((ss >> max) && max >= 1 && max <= 100)
+                    {
+                      qos_config_.max_files = max;
+                      return ParseStatus_Success;
+                    }
+                    return ParseStatus_BadVal;
+                 });
     }
 };
 
@@ -105,11 +282,13 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
  public:
   ~CloudXRClient() {
     Teardown();
+    trace::Stop();
   }
 
   // CloudXR interface callbacks
   void TriggerHaptic(const cxrHapticFeedback*) {}
   void GetTrackingState(cxrVRTrackingState* state) {
+    TRACE_SCOPE("GetTrackingState");
     *state = {};
 
     state->hmd.pose.poseIsValid = cxrTrue;
@@ -125,13 +304,19 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
   }
   cxrBool RenderAudio(const cxrAudioFrame *audioFrame)
   {
+    TRACE_SCOPE("RenderAudio");
     if (!playback_stream_ || exiting_) {
       return cxrFalse;
     }
 
     const uint32_t timeout = audioFrame->streamSizeBytes / CXR_AUDIO_BYTES_PER_MS;
     const uint32_t numFrames = timeout * CXR_AUDIO_SAMPLING_RATE / 1000;
-    playback_stream_->write(audioFrame->streamBuffer, numFrames, timeout * oboe::kNanosPerMillisecond);
+    auto result = playback_stream_->write(audioFrame->streamBuffer, numFrames, timeout * oboe::kNanosPerMillisecond);
+    if (result && result.value() == static_cast<int32_t>(numFrames)) {
+      audio_frames_played_.fetch_add(numFrames, std::memory_order_relaxed);
+    } else {
+      audio_write_errors_.fetch_add(1, std::memory_order_relaxed);
+    }
 
     return cxrTrue;
   }
@@ -140,6 +325,7 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
   oboe::DataCallbackResult onAudioReady(oboe::AudioStream *oboeStream,
           void *audioData, int32_t numFrames)
   {
+    TRACE_SCOPE("onAudioReady");
     if (!recording_stream_ || exiting_) {
       return oboe::DataCallbackResult::Stop;
     }
@@ -147,6 +333,7 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
     recordedFrame.streamBuffer = (int16_t*)audioData;
     recordedFrame.streamSizeBytes = numFrames * CXR_AUDIO_CHANNEL_COUNT * CXR_AUDIO_SAMPLE_SIZE;
     cxrSendAudio(cloudxr_receiver_, &recordedFrame);
+    audio_frames_recorded_.fetch_add(numFrames, std::memory_order_relaxed);
 
     return oboe::DataCallbackResult::Continue;
   }
@@ -172,6 +359,7 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
     if (cloudxr_receiver_)
       return cxrError_Success; // already connected, no error? TODO
 
+    TRACE_SCOPE("Connect");
     LOGI("Connecting to CloudXR at %s...", launch_options_.mServerIP.c_str());
 
     cxrGraphicsContext context{cxrGraphicsContext_GLES};
@@ -320,6 +508,10 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
     // else, good to go.
     LOGI("Receiver created!");
 
+    if (!launch_options_.qos_config_.directory.empty()) {
+      qos_recorder_.Start(launch_options_.qos_config_, cloudxr_receiver_);
+    }
+
     // AR shouldn't have an arena, should it?  Maybe something large?
     //LOGI("Setting default 1m radius arena boundary.", result);
     //cxrSetArenaBoundary(Receiver, 10.f, 0, 0);
@@ -340,6 +532,8 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
         recording_stream_.reset();
     }
 
+    qos_recorder_.Stop();
+
     if (cloudxr_receiver_) {
       LOGI("Tearing down CloudXR...");
       cxrDestroyReceiver(cloudxr_receiver_);
@@ -410,8 +604,11 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
     fps_ = fps;
   }
 
-  int DetermineOffset() const {
-    for (int offset = 0; offset < kQueueLen; offset++) {
+  // Returns how many frames back the latched frame's pose was sent, searching
+  // only the |history_length| frames the camera history still holds, or -1 if
+  // the pose is not among them.
+  int DetermineOffset(int history_length) const {
+    for (int offset = 0; offset < history_length; offset++) {
       const int idx = current_idx_ < offset ?
           kQueueLen + (current_idx_ - offset)%kQueueLen :
           (current_idx_ - offset)%kQueueLen;
@@ -429,7 +626,7 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
           return offset;
     }
 
-    return 0;
+    return -1;
   }
 
   cxrError Latch() {
@@ -441,16 +638,23 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
       return cxrError_Receiver_Not_Running;
     }
 
+    TRACE_SCOPE("Latch");
     // Fetch the frame
     const uint32_t timeout_ms = 150;
     cxrError status = cxrLatchFrame(cloudxr_receiver_, &framesLatched_,
             cxrFrameMask_All, timeout_ms);
 
     if (status != cxrError_Success) {
-      LOGI("CloudXR frame is not available!");
+      TRACE_INSTANT("LatchFailed");
+      if (status == cxrError_Frame_Not_Ready)
+        metrics_.latch_not_ready++;
+      else
+        metrics_.latch_error++;
+      LOGI_RL(1000, "CloudXR frame is not available!");
       return status;
     }
 
+    metrics_.latch_success++;
     latched_ = true;
     return cxrError_Success;
   }
@@ -460,6 +664,7 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
       return;
     }
 
+    TRACE_SCOPE("Release");
     cxrReleaseFrame(cloudxr_receiver_, &framesLatched_);
     latched_ = false;
   }
@@ -469,6 +674,7 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
       return;
     }
 
+    TRACE_SCOPE("Render");
     cxrBlitFrame(cloudxr_receiver_, &framesLatched_, cxrFrameMask_All);
   }
 
@@ -479,6 +685,20 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
     if (frames_until_stats_ <= 0 &&
         cxrGetConnectionStats(cloudxr_receiver_, &stats_) == cxrError_Success)
     {
+      TRACE_COUNTER("BitrateKbps", stats_.bandwidthUtilizationKbps);
+      TRACE_COUNTER("RoundTripMs", stats_.roundTripDelayMs);
+
+      metrics_.stats_samples++;
+      metrics_.stream_fps = stats_.framesPerSecond;
+      metrics_.bandwidth_available_kbps = stats_.bandwidthAvailableKbps;
+      metrics_.bandwidth_utilization_kbps = stats_.bandwidthUtilizationKbps;
+      metrics_.round_trip_delay_ms = stats_.roundTripDelayMs;
+      metrics_.jitter_us = stats_.jitterUs;
+      metrics_.total_packets_received = stats_.totalPacketsReceived;
+      metrics_.total_packets_lost = stats_.totalPacketsLost;
+      metrics_.total_packets_dropped = stats_.totalPacketsDropped;
+      metrics_.connection_quality = stats_.quality;
+      metrics_.connection_quality_reasons = stats_.qualityReasons;
       // Capture the key connection statistics
       char statsString[64] = { 0 };
       snprintf(statsString, 64, "FPS: %6.1f    Bitrate (kbps): %5d    Latency (ms): %3d",
@@ -559,12 +779,40 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
     if (launch_options_.mServerIP.empty())
       LOGE("No server IP specified yet to connect to.");
 
+    StartDiagnostics();
     return true;
   }
 
   void SetArgs(const std::string &args) {
     LOGI("App args: %s.", args.c_str());
     launch_options_.ParseString(args);
+    StartDiagnostics();
+  }
+
+  void StartDiagnostics() {
+    if (!launch_options_.trace_file_.empty()) {
+      trace::Start(launch_options_.trace_file_);
+    }
+    if (launch_options_.metrics_port_ != 0) {
+      metrics_server_.Start(launch_options_.metrics_port_);
+    }
+  }
+
+  ClientMetrics& Metrics() {
+    return metrics_;
+  }
+
+  // Hands a copy of the current metrics to the metrics server, if it asked
+  // for one.
+  void PublishMetrics() {
+    if (!metrics_server_.IsRunning() || !metrics_snapshot_.Requested()) {
+      return;
+    }
+
+    metrics_.audio_frames_played = audio_frames_played_.load(std::memory_order_relaxed);
+    metrics_.audio_write_errors = audio_write_errors_.load(std::memory_order_relaxed);
+    metrics_.audio_frames_recorded = audio_frames_recorded_.load(std::memory_order_relaxed);
+    metrics_snapshot_.Publish(metrics_);
   }
 
   std::string GetServerAddr() {
@@ -575,6 +823,26 @@ class HelloArApplication::CloudXRClient : public oboe::AudioStreamDataCallback {
     return launch_options_.using_env_lighting_;
   }
 
+  uint16_t GetCubemapPort() {
+    return launch_options_.cubemap_port_;
+  }
+
+  bool GetShowHud() {
+    return launch_options_.perf_hud_;
+  }
+
+  float GetPlaneLodPixels() {
+    return launch_options_.plane_lod_pixels_;
+  }
+
+  uint64_t GetGpuBudgetBytes() {
+    return static_cast<uint64_t>(launch_options_.gpu_budget_mb_) << 20;
+  }
+
+  const std::string& GetArRecordPath() {
+    return launch_options_.ar_record_file_;
+  }
+
   // this is used to tell the client what the display/surface resolution is.
   // here, we can apply a factor to reduce what we tell the server our desired
   // video resolution should be.
@@ -632,19 +900,56 @@ private:
 
   cxrConnectionStats stats_ = {};
   int frames_until_stats_ = 60;
+
+  QosRecorder qos_recorder_;
+
+  // Written by the render thread, published to the metrics server.
+  ClientMetrics metrics_;
+  MetricsSnapshot metrics_snapshot_;
+  MetricsServer metrics_server_{&metrics_snapshot_};
+  // Updated from the audio callback threads.
+  std::atomic<uint64_t> audio_frames_played_{0};
+  std::atomic<uint64_t> audio_write_errors_{0};
+  std::atomic<uint64_t> audio_frames_recorded_{0};
 };
 
 // need to decl our static variable.
 bool HelloArApplication::exiting_ = false;
 
 HelloArApplication::HelloArApplication(AAssetManager* asset_manager)
-    : asset_manager_(asset_manager) {
+    : asset_manager_(asset_manager),
+      plane_registry_(&ar_object_pools_.trackable_lists),
+      background_renderer_(&gpu_memory_),
+      plane_renderer_(&frame_arena_, &ar_object_pools_.poses, &gpu_memory_),
+      hud_renderer_(&gpu_memory_) {
   cloudxr_client_ = std::make_unique<HelloArApplication::CloudXRClient>();
+
+  // The passthrough comes first so a resumed or restarted app shows the
+  // camera before planes and the HUD are ready.
+  background_resources_ = gl_resources_.Register(
+      "background", 0,
+      [this] {
+        background_renderer_.InitializeGlContent(
+            asset_manager_, &program_cache_,
+            cam_image_width_ / camera_history_scale_,
+            cam_image_height_ / camera_history_scale_, camera_history_length_);
+      },
+      [this] { background_renderer_.ReleaseGlContent(); });
+  plane_resources_ = gl_resources_.Register("planes", 1, [this] {
+    plane_renderer_.InitializeGlContent(asset_manager_, &program_cache_);
+  });
+  hud_resources_ = gl_resources_.Register("hud", 2, [this] {
+    hud_renderer_.InitializeGlContent(asset_manager_, &program_cache_);
+  });
   exiting_ = false; // reset static here in case library remains resident..
 }
 
 HelloArApplication::~HelloArApplication() {
   if (ar_session_ != nullptr) {
+    ar_recorder_.Stop();
+    plane_registry_.Clear();
+    ar_object_pools_.Clear();
+    light_estimator_.Release();
     if (ar_camera_intrinsics_ != nullptr) {
       ArCameraIntrinsics_destroy(ar_camera_intrinsics_);
       ar_camera_intrinsics_ = nullptr;
@@ -666,11 +971,23 @@ bool HelloArApplication::Init() {
 // pass server address direct to client.
 void HelloArApplication::HandleLaunchOptions(std::string &cmdline) {
   cloudxr_client_->HandleLaunchOptions(cmdline);
+  hud_renderer_.SetVisible(cloudxr_client_->GetShowHud());
+  plane_renderer_.SetLodTolerance(cloudxr_client_->GetPlaneLodPixels());
+  ar_recorder_.SetOutputPath(cloudxr_client_->GetArRecordPath());
+  gpu_memory_.set_budget_bytes(cloudxr_client_->GetGpuBudgetBytes());
 }
 
 // pass command line args direct to client.
 void HelloArApplication::SetArgs(const std::string &args) {
   cloudxr_client_->SetArgs(args);
+  hud_renderer_.SetVisible(cloudxr_client_->GetShowHud());
+  plane_renderer_.SetLodTolerance(cloudxr_client_->GetPlaneLodPixels());
+  ar_recorder_.SetOutputPath(cloudxr_client_->GetArRecordPath());
+  gpu_memory_.set_budget_bytes(cloudxr_client_->GetGpuBudgetBytes());
+}
+
+void HelloArApplication::SetCacheDirectory(const std::string& directory) {
+  program_cache_.SetDirectory(directory + "/programs");
 }
 
 // pass server address direct to client.
@@ -678,6 +995,15 @@ std::string HelloArApplication::GetServerIp() {
   return cloudxr_client_->GetServerAddr();
 }
 
+const ClientMetrics& HelloArApplication::GetMetrics() const {
+  return cloudxr_client_->Metrics();
+}
+
+bool HelloArApplication::SetCubemapSink(const CubemapStreamer::Config& config,
+                                        CubemapStreamer::Sink sink) {
+  return cubemap_streamer_.Start(config, std::move(sink));
+}
+
 void HelloArApplication::NotifyUserError(ArStatus stat, const char* filename, const int linenum, bool terminate /*==false*/) {
     LOGE("Error #%d from ARCore at %s:%d", stat, filename, linenum);
     // TODO: should really push back to Java and display a dialog before exiting, and exit cleanly.
@@ -689,6 +1015,9 @@ void HelloArApplication::OnPause() {
   if (ar_session_ != nullptr) {
     ArSession_pause(ar_session_);
   }
+  // Planes may change while the session is paused.
+  plane_registry_.Resync();
+  ar_recorder_.Flush();
 
   cloudxr_client_->Teardown();
 }
@@ -765,26 +1094,18 @@ void HelloArApplication::OnResume(void* env, void* context, void* activity) {
 
     ArAugmentedImageDatabase* ar_augmented_image_database = nullptr;
 
-    if (FILE* f = fopen("/sdcard/image_anchors.imgdb", "rb"))
+    AssetView image_database;
+    if (image_database.MapFile("/sdcard/image_anchors.imgdb"))
     {
       LOGI("Image anchors DB found.");
 
-      fseek(f, 0, SEEK_END);
-      size_t db_size = ftell(f);
-      fseek(f, 0, SEEK_SET);
-
-      uint8_t* raw_buffer = new uint8_t[db_size];
-      fread(raw_buffer, 1, db_size, f);
-      fclose(f);
-
       const ArStatus status = ArAugmentedImageDatabase_deserialize(
-          ar_session_, raw_buffer, db_size, &ar_augmented_image_database);
+          ar_session_, image_database.data(), image_database.size(),
+          &ar_augmented_image_database);
 
       if (status != AR_SUCCESS) {
         LOGI("Unable to deserialize image anchors DB!");
       }
-
-      delete [] raw_buffer;
     }
 
       ArConfig* config = nullptr;
@@ -829,8 +1150,80 @@ void HelloArApplication::OnResume(void* env, void* context, void* activity) {
 void HelloArApplication::OnSurfaceCreated() {
   LOGI("OnSurfaceCreated()");
 
-  background_renderer_.InitializeGlContent(asset_manager_, cam_image_width_, cam_image_height_);
-  plane_renderer_.InitializeGlContent(asset_manager_);
+  // The context is preserved across pause and resume, so this only runs for
+  // a new context.  Everything of the old one is gone; resources are created
+  // again from OnDrawFrame(), passthrough first.
+  program_cache_.OnContextCreated();
+  gl_resources_.OnContextCreated();
+  gpu_memory_.Clear();
+
+  // The receiver renders with a context shared with the lost one.
+  if (cloudxr_client_->IsRunning()) {
+    cloudxr_client_->Teardown();
+  }
+}
+
+void HelloArApplication::CreateGlResources() {
+  if (gl_resources_.IsReady(background_resources_)) {
+    FitGpuMemoryBudget();
+    // The camera resolution is known once the session has resumed.
+    if (background_renderer_.width() !=
+            cam_image_width_ / camera_history_scale_ ||
+        background_renderer_.height() !=
+            cam_image_height_ / camera_history_scale_) {
+      gl_resources_.Invalidate(background_resources_);
+    }
+  }
+
+  if (!gl_resources_.CreatePending(kGlResourceBudgetMs)) return;
+
+  const ProgramCache::Stats& programs = program_cache_.stats();
+  LOGI("Shader programs: %d from cache in %.2f ms, %d compiled in %.2f ms",
+       programs.cache_hits, programs.cache_hit_ms, programs.compiled,
+       programs.compile_ms);
+  ClientMetrics& metrics = cloudxr_client_->Metrics();
+  metrics.shader_programs_cached = programs.cache_hits;
+  metrics.shader_programs_compiled = programs.compiled;
+  metrics.shader_program_ms = programs.cache_hit_ms + programs.compile_ms;
+}
+
+void HelloArApplication::FitGpuMemoryBudget() {
+  if (!gpu_memory_.OverBudget()) return;
+
+  // The camera history is the bulk of the client's GPU memory.  Latency
+  // compensation rarely looks back more than a few frames, so the history is
+  // shortened first and only then reduced in resolution.
+  const uint64_t other_bytes =
+      gpu_memory_.total_bytes() - background_renderer_.GetGpuMemoryBytes();
+  int length = camera_history_length_;
+  int scale = camera_history_scale_;
+  while (other_bytes + length * GpuMemoryTracker::ImageBytes(
+                                    cam_image_width_ / scale,
+                                    cam_image_height_ / scale, 4, false) >
+         gpu_memory_.budget_bytes()) {
+    if (length > kMinCameraHistoryLength) {
+      length = std::max(length / 2, kMinCameraHistoryLength);
+    } else if (scale < kMaxCameraHistoryScale) {
+      scale *= 2;
+    } else {
+      break;
+    }
+  }
+  if (length == camera_history_length_ && scale == camera_history_scale_) {
+    LOGE_RL(10000, "GPU memory of %llu bytes is over the budget of %llu bytes",
+            static_cast<unsigned long long>(gpu_memory_.total_bytes()),
+            static_cast<unsigned long long>(gpu_memory_.budget_bytes()));
+    return;
+  }
+
+  LOGI("GPU memory of %llu bytes is over the budget of %llu bytes, camera "
+       "history reduced to %d frames at 1/%d resolution",
+       static_cast<unsigned long long>(gpu_memory_.total_bytes()),
+       static_cast<unsigned long long>(gpu_memory_.budget_bytes()), length,
+       scale);
+  camera_history_length_ = length;
+  camera_history_scale_ = scale;
+  gl_resources_.Invalidate(background_resources_);
 }
 
 void HelloArApplication::OnDisplayGeometryChanged(int display_rotation,
@@ -840,6 +1233,7 @@ void HelloArApplication::OnDisplayGeometryChanged(int display_rotation,
   display_rotation_ = display_rotation;
   display_width_ = width;
   display_height_ = height;
+  hud_renderer_.SetDisplaySize(width, height);
   if (ar_session_ != nullptr) {
     ArSession_setDisplayGeometry(ar_session_, display_rotation, width, height);
   }
@@ -850,8 +1244,9 @@ void HelloArApplication::UpdateImageAnchors() {
   if (!using_image_anchors_)
     return;
 
-  ArTrackableList* updated_image_list = nullptr;
-  ArTrackableList_create(ar_session_, &updated_image_list);
+  ScopedArObject<ArTrackableList> scoped_image_list(
+      &ar_object_pools_.trackable_lists, ar_session_);
+  ArTrackableList* updated_image_list = scoped_image_list.get();
   CHECK(updated_image_list != nullptr);
   ArFrame_getUpdatedTrackables(
       ar_session_, ar_frame_, AR_TRACKABLE_AUGMENTED_IMAGE, updated_image_list);
@@ -882,14 +1277,14 @@ void HelloArApplication::UpdateImageAnchors() {
         if (augmented_image_map.find(image_index) ==
             augmented_image_map.end()) {
           // Record the image and its anchor.
-          util::ScopedArPose scopedArPose(ar_session_);
+          ScopedArObject<ArPose> center_pose(&ar_object_pools_.poses,
+                                             ar_session_);
           ArAugmentedImage_getCenterPose(ar_session_, image,
-                                         scopedArPose.GetArPose());
+                                         center_pose.get());
 
           ArAnchor* image_anchor = nullptr;
           const ArStatus status = ArTrackable_acquireNewAnchor(
-              ar_session_, ar_trackable, scopedArPose.GetArPose(),
-              &image_anchor);
+              ar_session_, ar_trackable, center_pose.get(), &image_anchor);
           CHECK_NOTIFY_STATUS(status, true);
 
           // Now we have an Anchor, record this image.
@@ -911,9 +1306,6 @@ void HelloArApplication::UpdateImageAnchors() {
     }  // End of switch (tracking_state)
   }    // End of for (int i = 0; i < image_list_size; ++i) {
 
-  ArTrackableList_destroy(updated_image_list);
-  updated_image_list = nullptr;
-
   if (!base_frame_calibrated_ && !augmented_image_map.empty()) {
     anchor_ = augmented_image_map.begin()->second.second;
     base_frame_calibrated_ = true;
@@ -923,6 +1315,8 @@ void HelloArApplication::UpdateImageAnchors() {
 // Render the scene.
 // return value 0 means that Java should finish and clean up.
 int HelloArApplication::OnDrawFrame() {
+  TRACE_SCOPE("OnDrawFrame");
+
   // clearing to dark red to start, so it is obvious if we fail out early or don't render anything
   // but if exiting, just render black on the way out...
   glClearColor(exiting_? 0.0f : 0.3f, 0.0f, 0.0f, 1.0f);
@@ -939,14 +1333,70 @@ int HelloArApplication::OnDrawFrame() {
   // if no AR session, return 0 to java.  no further error, it should already know.
   if (ar_session_ == nullptr) return (0);
 
+  ClientMetrics& metrics = cloudxr_client_->Metrics();
+  // GPU memory as the previous frame left it.
+  metrics.gpu_memory_bytes = gpu_memory_.total_bytes();
+  metrics.gpu_texture_bytes = gpu_memory_.bytes(GpuObjectType::kTexture);
+  metrics.gpu_renderbuffer_bytes =
+      gpu_memory_.bytes(GpuObjectType::kRenderbuffer);
+  metrics.gpu_buffer_bytes = gpu_memory_.bytes(GpuObjectType::kBuffer);
+  metrics.gpu_memory_budget_bytes = gpu_memory_.budget_bytes();
+  metrics.camera_history_frames = background_renderer_.history_length();
+  metrics.camera_history_scale = camera_history_scale_;
+  cloudxr_client_->PublishMetrics();
+  metrics.frames++;
+  ScopedPhaseTimer frame_timer(&metrics.frame_phases[kFramePhaseTotal]);
+  frame_arena_.Reset();
+  CreateGlResources();
+
+  const int status = DrawScene();
+
+  // The performance overlay goes on top of everything else, also on frames
+  // that stop early, e.g. while tracking is lost.
+  {
+    TRACE_SCOPE("Hud");
+    if (gl_resources_.IsReady(hud_resources_)) {
+      hud_renderer_.Draw(metrics);
+      metrics.hud_gpu_ms =
+          hud_renderer_.IsVisible() ? hud_renderer_.gpu_timer().last_ms() : 0.f;
+    }
+  }
+  return status;
+}
+
+int HelloArApplication::DrawScene() {
+  ClientMetrics& metrics = cloudxr_client_->Metrics();
   const GLuint camera_texture = background_renderer_.GetTextureId();
 
   ArSession_setCameraTextureName(ar_session_, camera_texture);
 
   // Update session to get current frame and render camera background.
-  if (ArSession_update(ar_session_, ar_frame_) != AR_SUCCESS) {
-    LOGE("HelloArApplication::OnDrawFrame ArSession_update error");
+  {
+    TRACE_SCOPE("ArSession_update");
+    ScopedPhaseTimer phase_timer(&metrics.frame_phases[kFramePhaseArUpdate]);
+    if (ArSession_update(ar_session_, ar_frame_) != AR_SUCCESS) {
+      LOGE_RL(1000, "HelloArApplication::OnDrawFrame ArSession_update error");
+    }
+  }
+
+  if (ar_recorder_.IsEnabled()) {
+    TRACE_SCOPE("ArRecord");
+    const ArAnchor* anchors[] = {anchor_};
+    ar_recorder_.RecordFrame(ar_session_, ar_frame_, display_width_,
+                             display_height_, display_rotation_, anchors,
+                             anchor_ ? 1 : 0);
+  }
+
+  // Only the planes ARCore updated this frame are queried.  This runs every
+  // frame, also when the planes are not drawn, so none of the updates is
+  // missed.
+  {
+    TRACE_SCOPE("PlaneRegistry");
+    plane_registry_.Update(ar_session_, ar_frame_);
+    plane_count_ = plane_registry_.size();
   }
+  const bool planes_drawn_last_frame = planes_drawn_;
+  planes_drawn_ = false;
 
   ArCamera* ar_camera;
   ArFrame_acquireCamera(ar_session_, ar_frame_, &ar_camera);
@@ -966,7 +1416,11 @@ int HelloArApplication::OnDrawFrame() {
   ArCamera_release(ar_camera);
 
   // Draw to camera queue
-  background_renderer_.Draw(ar_session_, ar_frame_);
+  {
+    TRACE_SCOPE("CameraQueue");
+    ScopedPhaseTimer phase_timer(&metrics.frame_phases[kFramePhaseCameraQueue]);
+    background_renderer_.Draw(ar_session_, ar_frame_);
+  }
 
   glViewport(0, 0, display_width_, display_height_);
 
@@ -1030,7 +1484,10 @@ int HelloArApplication::OnDrawFrame() {
       if (tracking_state == AR_TRACKING_STATE_TRACKING) {
         glm::mat4 anchor_pose_mat(1.0f);
 
+        ScopedArObject<ArPose> anchor_pose(&ar_object_pools_.poses,
+                                           ar_session_);
         util::GetTransformMatrixFromAnchor(*anchor_, ar_session_,
+                                           anchor_pose.get(),
                                            &anchor_pose_mat);
 
         base_frame_ = glm::inverse(anchor_pose_mat);
@@ -1045,11 +1502,24 @@ int HelloArApplication::OnDrawFrame() {
           exiting_ = true;
           return((int)status); // TODO: real error codes?
       }
+      // The new connection starts without lighting, resend it.
+      light_estimator_.Reset();
+      cubemap_streamer_.Reset();
+      if (cloudxr_client_->GetCubemapPort() != 0 &&
+          !cubemap_streamer_.IsRunning()) {
+        CubemapStreamer::Sink sink = MakeUdpCubemapSink(
+            cloudxr_client_->GetServerAddr(), cloudxr_client_->GetCubemapPort());
+        if (sink) cubemap_streamer_.Start(CubemapStreamer::Config(), std::move(sink));
+      }
     }
 
-    const cxrError status = cloudxr_client_->Latch();
+    cxrError status;
+    {
+      ScopedPhaseTimer phase_timer(&metrics.frame_phases[kFramePhaseLatch]);
+      status = cloudxr_client_->Latch();
+    }
     if (status != cxrError_Success) {
-      LOGE("Latch failed, %s", cxrErrorString(status));
+      LOGE_RL(1000, "Latch failed, %s", cxrErrorString(status));
       if (status == cxrError_Receiver_Not_Running) {
         exiting_ = true;
         return status;
@@ -1063,11 +1533,24 @@ int HelloArApplication::OnDrawFrame() {
       //  may be enough to need to disconnect or reset view or other interruption cases.
     }
     const bool have_frame = (status == cxrError_Success);
-    const int pose_offset = have_frame ? cloudxr_client_->DetermineOffset() : 0;
+    int pose_offset = 0;
+    if (have_frame) {
+      pose_offset = cloudxr_client_->DetermineOffset(
+          background_renderer_.history_length());
+      if (pose_offset < 0) {
+        // The camera image for the pose is gone, draw the latest one.
+        metrics.camera_offsets_clamped++;
+        pose_offset = 0;
+      }
+    }
 
     // Render cached camera frame to the screen
     glViewport(0, 0, display_width_, display_height_);
-    background_renderer_.Draw(ar_session_, ar_frame_, pose_offset);
+    {
+      TRACE_SCOPE("Background");
+      ScopedPhaseTimer phase_timer(&metrics.frame_phases[kFramePhaseBackground]);
+      background_renderer_.Draw(ar_session_, ar_frame_, pose_offset);
+    }
 
     // Setup pose matrix with our base frame
     const glm::mat4 cloudxr_pose_mat = base_frame_*glm::inverse(view_mat);
@@ -1078,44 +1561,56 @@ int HelloArApplication::OnDrawFrame() {
     // The last one is the average pixel intensity in gamma space.
     float color_correction[4] = {1.f, 1.f, 1.f, 0.466f};
     {
-      // Get light estimation
-      ArLightEstimate* ar_light_estimate;
-      ArLightEstimateState ar_light_estimate_state;
-      ArLightEstimate_create(ar_session_, &ar_light_estimate);
-
-      ArFrame_getLightEstimate(ar_session_, ar_frame_, ar_light_estimate);
-      ArLightEstimate_getState(ar_session_, ar_light_estimate,
-                               &ar_light_estimate_state);
-
-      if (ar_light_estimate_state == AR_LIGHT_ESTIMATE_STATE_VALID) {
-        if (cloudxr_client_->GetUseEnvLighting()) {
-          float direction[3];
-          ArLightEstimate_getEnvironmentalHdrMainLightDirection(ar_session_,
-              ar_light_estimate, direction);
-
-          float intensity[3];
-          ArLightEstimate_getEnvironmentalHdrMainLightIntensity(ar_session_,
-              ar_light_estimate, intensity);
-
-          float ambient_spherical_harmonics[27];
-          ArLightEstimate_getEnvironmentalHdrAmbientSphericalHarmonics(ar_session_,
-              ar_light_estimate, ambient_spherical_harmonics);
-
-          cloudxr_client_->UpdateLightProps(direction, intensity, ambient_spherical_harmonics);
-
-        } else {
-          ArLightEstimate_getColorCorrection(ar_session_, ar_light_estimate,
-                                             color_correction);
+      TRACE_SCOPE("LightEstimate");
+      ScopedPhaseTimer phase_timer(&metrics.frame_phases[kFramePhaseLightEstimate]);
+      const LightEstimator::Result result = light_estimator_.Update(
+          ar_session_, ar_frame_, cloudxr_client_->GetUseEnvLighting());
+      switch (result) {
+        case LightEstimator::kInvalid:
+        case LightEstimator::kColorCorrectionOnly:
+          break;
+        case LightEstimator::kUnchanged:
+          metrics.light_estimates_unchanged++;
+          break;
+        case LightEstimator::kSkipped:
+          metrics.light_sends_skipped++;
+          break;
+        case LightEstimator::kSend: {
+          const LightEstimate& estimate = light_estimator_.estimate();
+          cloudxr_client_->UpdateLightProps(estimate.direction,
+              estimate.intensity, estimate.ambient_spherical_harmonics);
+          metrics.light_sends++;
+          break;
         }
       }
 
-      ArLightEstimate_destroy(ar_light_estimate);
+      const bool new_estimate = result == LightEstimator::kSend ||
+                                result == LightEstimator::kSkipped;
+      if (new_estimate && cloudxr_client_->GetUseEnvLighting() &&
+          cubemap_streamer_.IsRunning()) {
+        const size_t bytes = cubemap_streamer_.Update(
+            ar_session_, light_estimator_.ar_light_estimate(),
+            light_estimator_.timestamp_ns());
+        if (bytes > 0) {
+          metrics.cubemap_updates++;
+          metrics.cubemap_bytes_sent += bytes;
+        }
+      }
+
+      if (result != LightEstimator::kInvalid &&
+          !cloudxr_client_->GetUseEnvLighting()) {
+        memcpy(color_correction, light_estimator_.color_correction(),
+               sizeof(color_correction));
+      }
     }
 
     if (have_frame) {
       // Composite CloudXR frame to the screen
       glViewport(0, 0, display_width_, display_height_);
-      cloudxr_client_->Render(color_correction);
+      {
+        ScopedPhaseTimer phase_timer(&metrics.frame_phases[kFramePhaseComposite]);
+        cloudxr_client_->Render(color_correction);
+      }
       cloudxr_client_->Release();
       cloudxr_client_->Stats();
     }
@@ -1135,8 +1630,9 @@ int HelloArApplication::OnDrawFrame() {
     if (tracking_state == AR_TRACKING_STATE_TRACKING) {
       glm::mat4 anchor_pose_mat(1.0f);
 
+      ScopedArObject<ArPose> anchor_pose(&ar_object_pools_.poses, ar_session_);
       util::GetTransformMatrixFromAnchor(*anchor_, ar_session_,
-                                         &anchor_pose_mat);
+                                         anchor_pose.get(), &anchor_pose_mat);
 
       base_frame_ = glm::inverse(anchor_pose_mat);
       base_frame_calibrated_ = true;
@@ -1146,55 +1642,37 @@ int HelloArApplication::OnDrawFrame() {
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-  // Update and render planes.
-  ArTrackableList* plane_list = nullptr;
-  ArTrackableList_create(ar_session_, &plane_list);
-  CHECK(plane_list != nullptr);
-
-  ArTrackableType plane_tracked_type = AR_TRACKABLE_PLANE;
-  ArSession_getAllTrackables(ar_session_, plane_tracked_type, plane_list);
+  // Render planes.
+  TRACE_SCOPE("Planes");
+  ScopedPhaseTimer planes_timer(&metrics.frame_phases[kFramePhasePlanes]);
+  if (!gl_resources_.IsReady(plane_resources_)) return(0);
 
-  int32_t plane_list_size = 0;
-  ArTrackableList_getSize(ar_session_, plane_list, &plane_list_size);
-  plane_count_ = plane_list_size;
-
-  for (int i = 0; i < plane_list_size; ++i) {
-    ArTrackable* ar_trackable = nullptr;
-    ArTrackableList_acquireItem(ar_session_, plane_list, i, &ar_trackable);
-    ArPlane* ar_plane = ArAsPlane(ar_trackable);
-    ArTrackingState out_tracking_state;
-    ArTrackable_getTrackingState(ar_session_, ar_trackable,
-                                 &out_tracking_state);
-
-    ArPlane* subsume_plane;
-    ArPlane_acquireSubsumedBy(ar_session_, ar_plane, &subsume_plane);
-    if (subsume_plane != nullptr) {
-      ArTrackable_release(ArAsTrackable(subsume_plane));
+  plane_renderer_.BeginFrame(projection_mat, view_mat, display_height_);
+  for (const PlaneRegistry::Plane& plane : plane_registry_.planes()) {
+    if (plane.tracking_state != AR_TRACKING_STATE_TRACKING) {
+      LOGE_RL(1000, "Tracked plane lost, skipping drawing.");
       continue;
     }
-
-    if (ArTrackingState::AR_TRACKING_STATE_TRACKING != out_tracking_state) {
-      LOGE("Tracked plane lost, skipping drawing.");
-      continue;
-    }
-
-    ArTrackingState plane_tracking_state;
-    ArTrackable_getTrackingState(ar_session_, ArAsTrackable(ar_plane),
-                                 &plane_tracking_state);
-    if (plane_tracking_state == AR_TRACKING_STATE_TRACKING) {
-      plane_renderer_.Draw(projection_mat, view_mat, *ar_session_, *ar_plane,
-                           kWhite);
-      ArTrackable_release(ar_trackable);
-    }
+    plane_renderer_.AddPlane(*ar_session_, *plane.plane, kWhite,
+                             plane.updated || !planes_drawn_last_frame);
   }
-
-  ArTrackableList_destroy(plane_list);
-  plane_list = nullptr;
+  plane_renderer_.Draw();
+  planes_drawn_ = true;
+  metrics.plane_mesh_rebuilds = plane_renderer_.stats().mesh_rebuilds;
+  metrics.plane_upload_bytes = plane_renderer_.stats().upload_bytes;
+  metrics.plane_vertices = plane_renderer_.stats().vertices;
+  metrics.plane_triangles = plane_renderer_.stats().triangles;
 
   return(0);
 }
 
 void HelloArApplication::OnTouched(float x, float y, bool longPress) {
+  // Long press in the top-left corner toggles the performance overlay
+  if (longPress && hud_renderer_.IsInToggleRegion(x, y)) {
+    hud_renderer_.ToggleVisible();
+    return;
+  }
+
   // if base frame is calibrated and user is not asking to reset, pass touches to server
   if (base_frame_calibrated_ && !longPress) {
     if (cloudxr_client_->IsRunning())
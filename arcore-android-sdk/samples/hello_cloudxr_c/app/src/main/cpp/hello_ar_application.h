@@ -48,10 +48,21 @@
 #include <string>
 #include <unordered_map>
 
+#include "ar_object_pool.h"
+#include "ar_recorder.h"
 #include "arcore_c_api.h"
 #include "background_renderer.h"
+#include "client_metrics.h"
+#include "cubemap_streamer.h"
+#include "frame_arena.h"
+#include "gl_resources.h"
+#include "gpu_memory.h"
 #include "glm.h"
+#include "hud_renderer.h"
+#include "light_estimator.h"
+#include "plane_registry.h"
 #include "plane_renderer.h"
+#include "program_cache.h"
 #include "util.h"
 
 namespace hello_ar {
@@ -67,6 +78,10 @@ class HelloArApplication {
   bool Init();
   void HandleLaunchOptions(std::string &cmdline);
   void SetArgs(const std::string &args);
+
+  // Directory for the shader program cache, e.g. the app's code cache.
+  void SetCacheDirectory(const std::string& directory);
+
   std::string GetServerIp();
   void NotifyUserError(ArStatus stat, const char* filename, const int linenum, bool terminate = false);
 
@@ -104,8 +119,31 @@ class HelloArApplication {
     return plane_count_ > 0 || using_image_anchors_ || base_frame_calibrated_;
   }
 
+  // Planes tracked by the plane registry, and whether the base frame is
+  // calibrated, for host benchmarks.
+  size_t GetPlaneCount() const { return plane_count_; }
+  bool IsCalibrated() const { return base_frame_calibrated_; }
+
+  // Performance counters of the render thread, for host benchmarks.
+  const ClientMetrics& GetMetrics() const;
+
+  // Streams the environmental HDR cubemap to |sink| while environment lighting
+  // is on.  CloudXR has no upstream channel for it, so the caller provides
+  // the transport; the app itself sends it over UDP with -cubemap-port.
+  // Returns false if |config| is invalid.
+  bool SetCubemapSink(const CubemapStreamer::Config& config,
+                      CubemapStreamer::Sink sink);
+
  private:
   void UpdateImageAnchors();
+  // Creates GL resources that are missing, e.g. after a new context, within
+  // a per-frame budget.  Called on the OpenGL thread.
+  void CreateGlResources();
+  // Draws the camera image, the streamed frame and the planes, everything
+  // but the performance overlay.  Returns OnDrawFrame()'s result.
+  int DrawScene();
+  // Shrinks the camera history if the GPU memory is over budget.
+  void FitGpuMemoryBudget();
 
   static bool exiting_;
 
@@ -131,10 +169,34 @@ class HelloArApplication {
 
   AAssetManager* const asset_manager_;
 
+  // Transient per-frame allocations and recycled ARCore objects, so a steady
+  // frame does not touch the heap.  Declared before the renderers using them.
+  FrameArena frame_arena_;
+  ArObjectPools ar_object_pools_;
+  PlaneRegistry plane_registry_;
+  LightEstimator light_estimator_;
+  CubemapStreamer cubemap_streamer_;
+  ProgramCache program_cache_;
+  GlResourceManager gl_resources_;
+  GpuMemoryTracker gpu_memory_;
+
   BackgroundRenderer background_renderer_;
   PlaneRenderer plane_renderer_;
-
-  int32_t plane_count_ = 0;
+  HudRenderer hud_renderer_;
+  // GlResourceManager groups of the renderers.
+  int background_resources_ = -1;
+  int plane_resources_ = -1;
+  int hud_resources_ = -1;
+  // Camera history of the background renderer, reduced to fit the GPU
+  // memory budget: number of images and the factor dividing their size.
+  int camera_history_length_ = BackgroundRenderer::kQueueLen;
+  int camera_history_scale_ = 1;
+  ArSessionRecorder ar_recorder_;
+
+  size_t plane_count_ = 0;
+  // Planes were drawn by the previous frame.  Otherwise planes not updated
+  // this frame may have changed since they were last drawn.
+  bool planes_drawn_ = false;
 
   // CloudXR client interface class
   class CloudXRClient;
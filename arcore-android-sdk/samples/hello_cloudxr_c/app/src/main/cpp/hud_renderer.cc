@@ -0,0 +1,447 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "hud_renderer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "util.h"
+
+namespace hello_ar {
+namespace {
+constexpr char kVertexShaderFilename[] = "shaders/hud.vert";
+constexpr char kFragmentShaderFilename[] = "shaders/hud.frag";
+constexpr char kGpuMemoryOwner[] = "hud";
+
+// The atlas is an 8x8 grid of 8x8 texel cells holding ASCII 32..95.  The '_'
+// cell is replaced by a solid block used for panels and graph bars.
+constexpr int kAtlasSize = 64;
+constexpr int kCellSize = 8;
+constexpr int kCellsPerRow = kAtlasSize / kCellSize;
+constexpr int kGlyphWidth = 5;
+constexpr int kGlyphHeight = 7;
+constexpr int kGlyphAdvance = kGlyphWidth + 1;
+constexpr int kLineHeight = kGlyphHeight + 3;
+constexpr char kFirstGlyph = ' ';
+constexpr char kLastGlyph = '_';
+constexpr int kSolidGlyph = kLastGlyph - kFirstGlyph;
+
+// 5x7 bitmaps, one byte per row with the leftmost pixel in bit 4.
+struct GlyphBitmap {
+  char c;
+  uint8_t rows[kGlyphHeight];
+};
+
+constexpr GlyphBitmap kGlyphs[] = {
+    {'0', {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}},
+    {'1', {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'2', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}},
+    {'3', {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}},
+    {'4', {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}},
+    {'5', {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}},
+    {'6', {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}},
+    {'7', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}},
+    {'8', {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}},
+    {'9', {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}},
+    {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}},
+    {':', {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}},
+    {'%', {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}},
+    {'/', {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}},
+    {'-', {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}},
+    {'A', {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+    {'B', {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}},
+    {'C', {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}},
+    {'D', {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}},
+    {'E', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}},
+    {'F', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}},
+    {'G', {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}},
+    {'H', {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+    {'I', {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'J', {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}},
+    {'K', {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}},
+    {'L', {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}},
+    {'M', {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}},
+    {'N', {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}},
+    {'O', {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+    {'P', {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}},
+    {'Q', {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}},
+    {'R', {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}},
+    {'S', {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}},
+    {'T', {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}},
+    {'U', {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+    {'V', {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}},
+    {'W', {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}},
+    {'X', {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}},
+    {'Y', {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}},
+    {'Z', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}},
+};
+
+// Panel layout, in atlas texels.  Scaled by pixel_scale_ on screen.
+constexpr int kMargin = 6;
+constexpr int kPadding = 4;
+constexpr int kPanelWidth = 180;
+constexpr int kGraphWidth = kPanelWidth - 2 * kPadding;
+constexpr int kFrameGraphHeight = 28;
+constexpr int kStatsGraphHeight = 16;
+
+constexpr uint32_t kPanelColor = 0x000000A0;
+constexpr uint32_t kGraphColor = 0x20202080;
+constexpr uint32_t kTextColor = 0xFFFFFFFF;
+constexpr uint32_t kGoodColor = 0x40E040FF;
+constexpr uint32_t kWarnColor = 0xE0E040FF;
+constexpr uint32_t kBadColor = 0xE04040FF;
+constexpr uint32_t kTargetColor = 0xFFFFFF80;
+constexpr uint32_t kBitrateColor = 0x40A0FFFF;
+constexpr uint32_t kRttColor = 0xFFA040FF;
+
+constexpr float kFrameTargetMs = 16.7f;
+constexpr float kFrameGraphMaxMs = 2.f * kFrameTargetMs;
+
+void GlyphUv(int glyph, float* u0, float* v0, float* u1, float* v1) {
+  const float texel = 1.f / kAtlasSize;
+  *u0 = (glyph % kCellsPerRow) * kCellSize * texel;
+  *v0 = (glyph / kCellsPerRow) * kCellSize * texel;
+  *u1 = *u0 + kGlyphWidth * texel;
+  *v1 = *v0 + kGlyphHeight * texel;
+}
+}  // namespace
+
+void HudRenderer::InitializeGlContent(AAssetManager* asset_manager,
+                                      ProgramCache* program_cache) {
+  shader_program_ = program_cache->CreateProgram(
+      kVertexShaderFilename, kFragmentShaderFilename, asset_manager);
+  if (!shader_program_) {
+    LOGE("Could not create program.");
+  }
+
+  uniform_texture_ = glGetUniformLocation(shader_program_, "texture");
+  attri_position_ = glGetAttribLocation(shader_program_, "position");
+  attri_uv_ = glGetAttribLocation(shader_program_, "uv");
+  attri_color_ = glGetAttribLocation(shader_program_, "color");
+  gpu_timer_.InitializeGlContent();
+
+  // Bake the glyph atlas.
+  std::vector<GLubyte> atlas(kAtlasSize * kAtlasSize, 0);
+  for (const GlyphBitmap& glyph : kGlyphs) {
+    const int index = glyph.c - kFirstGlyph;
+    const int x0 = (index % kCellsPerRow) * kCellSize;
+    const int y0 = (index / kCellsPerRow) * kCellSize;
+    for (int y = 0; y < kGlyphHeight; ++y) {
+      for (int x = 0; x < kGlyphWidth; ++x) {
+        if (glyph.rows[y] & (1 << (kGlyphWidth - 1 - x))) {
+          atlas[(y0 + y) * kAtlasSize + x0 + x] = 0xFF;
+        }
+      }
+    }
+  }
+  {
+    const int x0 = (kSolidGlyph % kCellsPerRow) * kCellSize;
+    const int y0 = (kSolidGlyph / kCellsPerRow) * kCellSize;
+    for (int y = 0; y < kCellSize; ++y) {
+      std::fill_n(&atlas[(y0 + y) * kAtlasSize + x0], kCellSize, 0xFF);
+    }
+  }
+
+  glGenTextures(1, &texture_id_);
+  glBindTexture(GL_TEXTURE_2D, texture_id_);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, kAtlasSize, kAtlasSize, 0,
+               GL_ALPHA, GL_UNSIGNED_BYTE, atlas.data());
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  gpu_memory_->Track(GpuObjectType::kTexture, texture_id_, kGpuMemoryOwner,
+                     GpuMemoryTracker::ImageBytes(kAtlasSize, kAtlasSize, 1,
+                                                  false));
+
+  // Every quad uses the same index pattern, so the index buffer is static.
+  std::vector<GLushort> indices(kMaxQuads * 6);
+  for (int i = 0; i < kMaxQuads; ++i) {
+    const GLushort base = static_cast<GLushort>(i * 4);
+    GLushort* quad = &indices[i * 6];
+    quad[0] = base;
+    quad[1] = base + 1;
+    quad[2] = base + 2;
+    quad[3] = base;
+    quad[4] = base + 2;
+    quad[5] = base + 3;
+  }
+
+  glGenBuffers(1, &index_buffer_);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort),
+               indices.data(), GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  gpu_memory_->Track(GpuObjectType::kBuffer, index_buffer_, kGpuMemoryOwner,
+                     indices.size() * sizeof(GLushort));
+
+  glGenBuffers(1, &vertex_buffer_);
+  glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices_), nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  gpu_memory_->Track(GpuObjectType::kBuffer, vertex_buffer_, kGpuMemoryOwner,
+                     sizeof(vertices_));
+
+  util::CheckGlError("hud_renderer::InitializeGlContent()");
+}
+
+void HudRenderer::SetDisplaySize(int width, int height) {
+  display_width_ = std::max(width, 1);
+  display_height_ = std::max(height, 1);
+  // Size the panel so it stays readable without covering the stream.
+  pixel_scale_ = std::max(1, std::min(width, height) / 540);
+}
+
+bool HudRenderer::IsInToggleRegion(float x, float y) const {
+  return x < display_width_ * 0.25f && y < display_height_ * 0.2f;
+}
+
+void HudRenderer::Sample(const ClientMetrics& metrics) {
+  const auto now = std::chrono::steady_clock::now();
+  if (last_frame_time_.time_since_epoch().count() != 0) {
+    frame_ms_[frame_head_] =
+        std::chrono::duration<float, std::milli>(now - last_frame_time_)
+            .count();
+    frame_head_ = (frame_head_ + 1) % kFrameHistory;
+  }
+  last_frame_time_ = now;
+
+  if (metrics.stats_samples != last_stats_sample_) {
+    last_stats_sample_ = metrics.stats_samples;
+    bitrate_kbps_[stats_head_] = metrics.bandwidth_utilization_kbps;
+    rtt_ms_[stats_head_] = metrics.round_trip_delay_ms;
+    stats_head_ = (stats_head_ + 1) % kStatsHistory;
+  }
+}
+
+void HudRenderer::AddQuad(float x0, float y0, float x1, float y1, float u0,
+                          float v0, float u1, float v1, uint32_t rgba) {
+  if (quad_count_ >= kMaxQuads) return;
+
+  // Pixel coordinates with a top-left origin to normalized device coordinates.
+  const float sx = 2.f / display_width_;
+  const float sy = 2.f / display_height_;
+  const float nx0 = x0 * sx - 1.f;
+  const float nx1 = x1 * sx - 1.f;
+  const float ny0 = 1.f - y0 * sy;
+  const float ny1 = 1.f - y1 * sy;
+  const GLubyte color[4] = {
+      static_cast<GLubyte>(rgba >> 24), static_cast<GLubyte>(rgba >> 16),
+      static_cast<GLubyte>(rgba >> 8), static_cast<GLubyte>(rgba)};
+
+  Vertex* v = &vertices_[quad_count_ * 4];
+  v[0] = {nx0, ny0, u0, v0, {color[0], color[1], color[2], color[3]}};
+  v[1] = {nx1, ny0, u1, v0, {color[0], color[1], color[2], color[3]}};
+  v[2] = {nx1, ny1, u1, v1, {color[0], color[1], color[2], color[3]}};
+  v[3] = {nx0, ny1, u0, v1, {color[0], color[1], color[2], color[3]}};
+  quad_count_++;
+}
+
+void HudRenderer::AddRect(float x0, float y0, float x1, float y1,
+                          uint32_t rgba) {
+  // Sample the middle of the solid cell so filtering never reaches an edge.
+  const float u = ((kSolidGlyph % kCellsPerRow) * kCellSize + kCellSize / 2) /
+                  static_cast<float>(kAtlasSize);
+  const float v = ((kSolidGlyph / kCellsPerRow) * kCellSize + kCellSize / 2) /
+                  static_cast<float>(kAtlasSize);
+  AddQuad(x0, y0, x1, y1, u, v, u, v, rgba);
+}
+
+float HudRenderer::AddText(float x, float y, const char* text, uint32_t rgba) {
+  const float scale = pixel_scale_;
+  for (const char* c = text; *c; ++c) {
+    char ch = *c;
+    if (ch >= 'a' && ch <= 'z') ch = ch - 'a' + 'A';
+    if (ch > kFirstGlyph && ch < kLastGlyph) {
+      float u0, v0, u1, v1;
+      GlyphUv(ch - kFirstGlyph, &u0, &v0, &u1, &v1);
+      AddQuad(x, y, x + kGlyphWidth * scale, y + kGlyphHeight * scale, u0, v0,
+              u1, v1, rgba);
+    }
+    x += kGlyphAdvance * scale;
+  }
+  return y + kLineHeight * scale;
+}
+
+void HudRenderer::AddGraph(float x, float y, float w, float h,
+                           const float* history, int size, int head,
+                           float scale, uint32_t rgba) {
+  AddRect(x, y, x + w, y + h, kGraphColor);
+  if (scale <= 0.f) return;
+
+  const float bar_width = w / size;
+  for (int i = 0; i < size; ++i) {
+    // Oldest sample on the left.
+    const float value = history[(head + i) % size];
+    if (value <= 0.f) continue;
+    const float bar_height = std::min(value * scale, 1.f) * h;
+    const float bx = x + i * bar_width;
+    AddRect(bx, y + h - bar_height, bx + bar_width, y + h, rgba);
+  }
+}
+
+void HudRenderer::Draw(const ClientMetrics& metrics) {
+  Sample(metrics);
+
+  if (!visible_ || !shader_program_) {
+    return;
+  }
+
+  quad_count_ = 0;
+  const float s = pixel_scale_;
+  const float x0 = kMargin * s;
+  const float y0 = kMargin * s;
+  const float x = x0 + kPadding * s;
+  const float graph_w = kGraphWidth * s;
+  char line[48];
+
+  // Panel background, sized once the content height is known.
+  const int panel_quad = quad_count_;
+  AddRect(0, 0, 0, 0, kPanelColor);
+
+  float y = y0 + kPadding * s;
+
+  float frame_sum_ms = 0.f;
+  int frame_samples = 0;
+  for (int i = 0; i < kFrameHistory; ++i) {
+    if (frame_ms_[i] > 0.f) {
+      frame_sum_ms += frame_ms_[i];
+      frame_samples++;
+    }
+  }
+  const float last_frame_ms = frame_ms_[(frame_head_ + kFrameHistory - 1) % kFrameHistory];
+  const float fps = frame_sum_ms > 0.f ? 1000.f * frame_samples / frame_sum_ms
+                                       : 0.f;
+  snprintf(line, sizeof(line), "FRAME %5.1f MS  %5.1f FPS", last_frame_ms, fps);
+  y = AddText(x, y, line, kTextColor);
+
+  // Frame-time graph, bars colored against the 60 Hz budget.
+  const float frame_h = kFrameGraphHeight * s;
+  AddRect(x, y, x + graph_w, y + frame_h, kGraphColor);
+  const float bar_width = graph_w / kFrameHistory;
+  for (int i = 0; i < kFrameHistory; ++i) {
+    const float ms = frame_ms_[(frame_head_ + i) % kFrameHistory];
+    if (ms <= 0.f) continue;
+    const uint32_t color = ms <= kFrameTargetMs       ? kGoodColor
+                           : ms <= kFrameGraphMaxMs   ? kWarnColor
+                                                      : kBadColor;
+    const float bar_h = std::min(ms / kFrameGraphMaxMs, 1.f) * frame_h;
+    const float bx = x + i * bar_width;
+    AddRect(bx, y + frame_h - bar_h, bx + bar_width, y + frame_h, color);
+  }
+  const float target_y = y + frame_h * (1.f - kFrameTargetMs / kFrameGraphMaxMs);
+  AddRect(x, target_y, x + graph_w, target_y + s, kTargetColor);
+  y += frame_h + kPadding * s;
+
+  snprintf(line, sizeof(line), "LATCH OK %llu WAIT %llu ERR %llu",
+           static_cast<unsigned long long>(metrics.latch_success),
+           static_cast<unsigned long long>(metrics.latch_not_ready),
+           static_cast<unsigned long long>(metrics.latch_error));
+  y = AddText(x, y, line, kTextColor);
+
+  float max_bitrate = 0.f;
+  float max_rtt = 0.f;
+  for (int i = 0; i < kStatsHistory; ++i) {
+    max_bitrate = std::max(max_bitrate, bitrate_kbps_[i]);
+    max_rtt = std::max(max_rtt, rtt_ms_[i]);
+  }
+
+  const float stats_h = kStatsGraphHeight * s;
+  snprintf(line, sizeof(line), "BITRATE %u KBPS",
+           metrics.bandwidth_utilization_kbps);
+  y = AddText(x, y, line, kTextColor);
+  AddGraph(x, y, graph_w, stats_h, bitrate_kbps_, kStatsHistory, stats_head_,
+           max_bitrate > 0.f ? 1.f / max_bitrate : 0.f, kBitrateColor);
+  y += stats_h + kPadding * s;
+
+  snprintf(line, sizeof(line), "RTT %u MS  LOSS %u",
+           metrics.round_trip_delay_ms, metrics.total_packets_lost);
+  y = AddText(x, y, line, kTextColor);
+  // Keep a 50 ms floor so a quiet link doesn't look like a spiky one.
+  AddGraph(x, y, graph_w, stats_h, rtt_ms_, kStatsHistory, stats_head_,
+           1.f / std::max(max_rtt, 50.f), kRttColor);
+  y += stats_h + kPadding * s;
+
+  if (gpu_timer_.IsSupported()) {
+    snprintf(line, sizeof(line), "HUD GPU %.3f MS", gpu_timer_.last_ms());
+    y = AddText(x, y, line, kTextColor);
+  }
+
+  // Now that the height is known, fill in the panel quad drawn beneath the rest.
+  const int used_quads = quad_count_;
+  quad_count_ = panel_quad;
+  AddRect(x0, y0, x0 + (kPanelWidth * s), y, kPanelColor);
+  quad_count_ = used_quads;
+
+  gpu_timer_.Begin();
+  glUseProgram(shader_program_);
+  glDisable(GL_DEPTH_TEST);
+  glDisable(GL_CULL_FACE);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+  glActiveTexture(GL_TEXTURE0);
+  glUniform1i(uniform_texture_, 0);
+  glBindTexture(GL_TEXTURE_2D, texture_id_);
+
+  glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, quad_count_ * 4 * sizeof(Vertex),
+                  vertices_);
+
+  glEnableVertexAttribArray(attri_position_);
+  glEnableVertexAttribArray(attri_uv_);
+  glEnableVertexAttribArray(attri_color_);
+  glVertexAttribPointer(attri_position_, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                        reinterpret_cast<const void*>(offsetof(Vertex, x)));
+  glVertexAttribPointer(attri_uv_, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                        reinterpret_cast<const void*>(offsetof(Vertex, u)));
+  glVertexAttribPointer(attri_color_, 4, GL_UNSIGNED_BYTE, GL_TRUE,
+                        sizeof(Vertex),
+                        reinterpret_cast<const void*>(offsetof(Vertex, color)));
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+  glDrawElements(GL_TRIANGLES, quad_count_ * 6, GL_UNSIGNED_SHORT, nullptr);
+
+  // The background passthrough draws from client-side arrays, so leave no
+  // GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER bound between renderers.
+  glDisableVertexAttribArray(attri_position_);
+  glDisableVertexAttribArray(attri_uv_);
+  glDisableVertexAttribArray(attri_color_);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glUseProgram(0);
+
+  glEnable(GL_CULL_FACE);
+  glEnable(GL_DEPTH_TEST);
+  gpu_timer_.End();
+  util::CheckGlError("hud_renderer::Draw()");
+}
+
+}  // namespace hello_ar
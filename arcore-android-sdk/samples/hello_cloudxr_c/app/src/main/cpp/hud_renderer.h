@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#ifndef C_ARCORE_HELLO_AR_HUD_RENDERER_H_
+#define C_ARCORE_HELLO_AR_HUD_RENDERER_H_
+
+#include <GLES2/gl2.h>
+#include <android/asset_manager.h>
+#include <chrono>
+#include <cstdint>
+
+#include "client_metrics.h"
+#include "gpu_memory.h"
+#include "gpu_timer.h"
+#include "program_cache.h"
+
+namespace hello_ar {
+
+// HudRenderer draws an on-screen performance overlay: frame-time graph, latch
+// outcome counters and bitrate/RTT history.  Text uses a glyph atlas baked at
+// init time and every element is a textured quad written into one dynamic
+// vertex buffer, so a frame costs a single glBufferSubData and a single draw
+// call, with no allocations on the render thread.
+class HudRenderer {
+ public:
+  // The atlas and buffers are accounted in |gpu_memory|.
+  explicit HudRenderer(GpuMemoryTracker* gpu_memory)
+      : gpu_memory_(gpu_memory) {}
+  ~HudRenderer() = default;
+
+  // Creates the atlas texture and buffers.  Must be called on the OpenGL
+  // thread.
+  void InitializeGlContent(AAssetManager* asset_manager,
+                           ProgramCache* program_cache);
+
+  void SetDisplaySize(int width, int height);
+
+  void SetVisible(bool visible) { visible_ = visible; }
+  bool IsVisible() const { return visible_; }
+  void ToggleVisible() { visible_ = !visible_; }
+
+  // Returns true if the screen position falls in the corner region that
+  // toggles the HUD on a long press.  Works while the HUD is hidden too.
+  bool IsInToggleRegion(float x, float y) const;
+
+  // Samples |metrics| into the history graphs and, if visible, draws the
+  // overlay over the current framebuffer.  Call once per frame, after
+  // everything else is drawn.
+  void Draw(const ClientMetrics& metrics);
+
+  // GPU time of the overlay's own draw, measured while it is visible.
+  const GpuTimer& gpu_timer() const { return gpu_timer_; }
+
+ private:
+  static constexpr int kFrameHistory = 120;
+  static constexpr int kStatsHistory = 60;
+  static constexpr int kMaxQuads = 512;
+
+  struct Vertex {
+    GLfloat x, y;
+    GLfloat u, v;
+    GLubyte color[4];
+  };
+
+  void Sample(const ClientMetrics& metrics);
+  void AddQuad(float x0, float y0, float x1, float y1, float u0, float v0,
+               float u1, float v1, uint32_t rgba);
+  void AddRect(float x0, float y0, float x1, float y1, uint32_t rgba);
+  float AddText(float x, float y, const char* text, uint32_t rgba);
+  void AddGraph(float x, float y, float w, float h, const float* history,
+                int size, int head, float scale, uint32_t rgba);
+
+  bool visible_ = false;
+  int display_width_ = 1;
+  int display_height_ = 1;
+  float pixel_scale_ = 2.f;
+
+  // History rings, |*_head_| is the next slot to write.
+  float frame_ms_[kFrameHistory] = {};
+  int frame_head_ = 0;
+  float bitrate_kbps_[kStatsHistory] = {};
+  float rtt_ms_[kStatsHistory] = {};
+  int stats_head_ = 0;
+  uint64_t last_stats_sample_ = 0;
+  std::chrono::steady_clock::time_point last_frame_time_;
+
+  Vertex vertices_[kMaxQuads * 4];
+  int quad_count_ = 0;
+
+  GLuint shader_program_ = 0;
+  GLuint texture_id_ = 0;
+  GLuint vertex_buffer_ = 0;
+  GLuint index_buffer_ = 0;
+  GLint attri_position_;
+  GLint attri_uv_;
+  GLint attri_color_;
+  GLint uniform_texture_;
+
+  GpuTimer gpu_timer_;
+  GpuMemoryTracker* const gpu_memory_;
+};
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_HUD_RENDERER_H_
@@ -115,6 +115,17 @@ JNI_METHOD(void, setArgs)
   }
 }
 
+JNI_METHOD(void, setCacheDirectory)
+(JNIEnv *env, jclass, jlong native_application, jstring jpath) {
+  if (jpath != nullptr) {
+    const char *path = env->GetStringUTFChars(jpath, nullptr);
+    if (path != nullptr) {
+      native(native_application)->SetCacheDirectory(path);
+      env->ReleaseStringUTFChars(jpath, path);
+    }
+  }
+}
+
 JNI_METHOD(jstring, getServerIp)
 (JNIEnv *env, jclass, jlong native_application) {
   const std::string ip = native(native_application)->GetServerIp();
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "light_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace hello_ar {
+namespace {
+constexpr float kDegreesToRadians = 3.14159265f / 180.f;
+// Keeps relative thresholds meaningful when the last sent value is ~0.
+constexpr float kMinMagnitude = 1e-3f;
+
+float Dot3(const float* a, const float* b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+}  // namespace
+
+LightEstimator::~LightEstimator() { Release(); }
+
+LightEstimator::Result LightEstimator::Update(const ArSession* session,
+                                              const ArFrame* frame,
+                                              bool environmental_hdr) {
+  if (ar_light_estimate_ == nullptr) {
+    ArLightEstimate_create(session, &ar_light_estimate_);
+  }
+  ArFrame_getLightEstimate(session, frame, ar_light_estimate_);
+
+  ArLightEstimateState state;
+  ArLightEstimate_getState(session, ar_light_estimate_, &state);
+  if (state != AR_LIGHT_ESTIMATE_STATE_VALID) {
+    valid_ = false;
+    return kInvalid;
+  }
+
+  int64_t timestamp_ns;
+  ArLightEstimate_getTimestamp(session, ar_light_estimate_, &timestamp_ns);
+  if (valid_ && timestamp_ns == timestamp_ns_) {
+    return kUnchanged;
+  }
+  valid_ = true;
+  timestamp_ns_ = timestamp_ns;
+
+  if (!environmental_hdr) {
+    ArLightEstimate_getColorCorrection(session, ar_light_estimate_,
+                                       color_correction_);
+    return kColorCorrectionOnly;
+  }
+
+  ArLightEstimate_getEnvironmentalHdrMainLightDirection(
+      session, ar_light_estimate_, estimate_.direction);
+  ArLightEstimate_getEnvironmentalHdrMainLightIntensity(
+      session, ar_light_estimate_, estimate_.intensity);
+  ArLightEstimate_getEnvironmentalHdrAmbientSphericalHarmonics(
+      session, ar_light_estimate_, estimate_.ambient_spherical_harmonics);
+
+  if (!ShouldSend(timestamp_ns)) {
+    return kSkipped;
+  }
+  has_sent_ = true;
+  sent_timestamp_ns_ = timestamp_ns;
+  sent_ = estimate_;
+  return kSend;
+}
+
+bool LightEstimator::ShouldSend(int64_t timestamp_ns) const {
+  // A timestamp going backwards means the session was reset.
+  if (!has_sent_ || timestamp_ns < sent_timestamp_ns_ ||
+      timestamp_ns - sent_timestamp_ns_ >= config_.max_interval_ns) {
+    return true;
+  }
+
+  // Directions are unit vectors, compare the angle between them.
+  const float cos_angle = Dot3(estimate_.direction, sent_.direction);
+  if (cos_angle <
+      std::cos(config_.direction_threshold_deg * kDegreesToRadians)) {
+    return true;
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    const float reference =
+        std::max(std::fabs(sent_.intensity[i]), kMinMagnitude);
+    if (std::fabs(estimate_.intensity[i] - sent_.intensity[i]) >
+        config_.intensity_threshold * reference) {
+      return true;
+    }
+  }
+
+  float delta_sq = 0.f;
+  float magnitude_sq = 0.f;
+  for (int i = 0; i < 27; ++i) {
+    const float delta = estimate_.ambient_spherical_harmonics[i] -
+                        sent_.ambient_spherical_harmonics[i];
+    delta_sq += delta * delta;
+    magnitude_sq += sent_.ambient_spherical_harmonics[i] *
+                    sent_.ambient_spherical_harmonics[i];
+  }
+  const float reference = std::max(std::sqrt(magnitude_sq), kMinMagnitude);
+  return std::sqrt(delta_sq) > config_.ambient_threshold * reference;
+}
+
+void LightEstimator::Reset() { has_sent_ = false; }
+
+void LightEstimator::Release() {
+  if (ar_light_estimate_ != nullptr) {
+    ArLightEstimate_destroy(ar_light_estimate_);
+    ar_light_estimate_ = nullptr;
+  }
+  valid_ = false;
+}
+
+}  // namespace hello_ar
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_LIGHT_ESTIMATOR_H_
+#define C_ARCORE_HELLO_AR_LIGHT_ESTIMATOR_H_
+
+#include <cstdint>
+
+#include "arcore_c_api.h"
+
+namespace hello_ar {
+
+// Environmental HDR lighting as sent to the server.
+struct LightEstimate {
+  float direction[3] = {0.f, 1.f, 0.f};
+  float intensity[3] = {};
+  float ambient_spherical_harmonics[27] = {};
+};
+
+// Reads the frame's light estimate into one reused ArLightEstimate and decides
+// whether it is worth sending upstream.  ARCore only produces a new estimate
+// at camera rate, so frames whose estimate timestamp has not moved are skipped
+// without querying anything.  A new estimate is sent when it differs from the
+// last sent one by more than a perceptual threshold, or when the last send is
+// older than |max_interval_ns|, so small drifts still reach the server.
+//
+// Not thread safe: owned and used by the render thread.
+class LightEstimator {
+ public:
+  struct Config {
+    // Main light direction change, in degrees.
+    float direction_threshold_deg = 5.f;
+    // Largest relative change of a main light intensity channel.
+    float intensity_threshold = 0.1f;
+    // Distance of the ambient SH coefficients relative to their magnitude.
+    float ambient_threshold = 0.1f;
+    // Longest time between sends while valid estimates keep arriving.
+    int64_t max_interval_ns = 1000000000;
+  };
+
+  enum Result {
+    // The estimate is not valid, nothing was read.
+    kInvalid,
+    // Same estimate as the previous frame.
+    kUnchanged,
+    // New estimate that does not need sending, as it is too close to the
+    // last sent one.
+    kSkipped,
+    // New estimate with environmental HDR off.  Only the color correction
+    // was read, nothing is ever sent.
+    kColorCorrectionOnly,
+    // New estimate that should be sent, see estimate().
+    kSend,
+  };
+
+  LightEstimator() = default;
+  ~LightEstimator();
+
+  LightEstimator(const LightEstimator&) = delete;
+  void operator=(const LightEstimator&) = delete;
+
+  void SetConfig(const Config& config) { config_ = config; }
+
+  // Reads the light estimate of |frame|.  With |environmental_hdr| the HDR
+  // main light and ambient SH are read and compared, otherwise only the color
+  // correction is.
+  Result Update(const ArSession* session, const ArFrame* frame,
+                bool environmental_hdr);
+
+  // Forgets the last sent estimate so the next valid one is sent, e.g. after
+  // reconnecting to the server.
+  void Reset();
+
+  // Destroys the ArLightEstimate.  Call before destroying the session.
+  void Release();
+
+  const LightEstimate& estimate() const { return estimate_; }
+
+  // The ArLightEstimate read by the last Update(), and its timestamp.
+  const ArLightEstimate* ar_light_estimate() const {
+    return ar_light_estimate_;
+  }
+  int64_t timestamp_ns() const { return timestamp_ns_; }
+
+  // Color correction of the last valid estimate, or the default if there is
+  // none.
+  const float* color_correction() const { return color_correction_; }
+
+ private:
+  bool ShouldSend(int64_t timestamp_ns) const;
+
+  Config config_;
+  ArLightEstimate* ar_light_estimate_ = nullptr;
+
+  int64_t timestamp_ns_ = -1;
+  bool valid_ = false;
+  LightEstimate estimate_;
+  float color_correction_[4] = {1.f, 1.f, 1.f, 0.466f};
+
+  bool has_sent_ = false;
+  int64_t sent_timestamp_ns_ = 0;
+  LightEstimate sent_;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_LIGHT_ESTIMATOR_H_
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "mesh_asset.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "util.h"
+
+namespace hello_ar {
+namespace {
+
+int16_t QuantizeSnorm16(float value) {
+  return static_cast<int16_t>(
+      std::lround(std::max(-1.f, std::min(1.f, value)) * 32767.f));
+}
+
+uint16_t QuantizeUnorm16(float value) {
+  return static_cast<uint16_t>(
+      std::lround(std::max(0.f, std::min(1.f, value)) * 65535.f));
+}
+
+}  // namespace
+
+bool MeshAsset::Open(AAssetManager* asset_manager, const char* file_name) {
+  if (!view_.OpenAsset(asset_manager, file_name)) return false;
+  if (!mesh::IsValidMeshFile(view_.data(), view_.size())) {
+    LOGE("%s is not a valid mesh file", file_name);
+    view_.Close();
+    return false;
+  }
+  memcpy(&header_, view_.data(), sizeof(header_));
+  return true;
+}
+
+void EncodeMesh(const ObjMesh& mesh, bool quantize, std::vector<uint8_t>* out) {
+  const size_t vertex_count = mesh.vertex_count();
+  uint32_t flags = 0;
+  if (!mesh.normals.empty()) {
+    flags |= mesh::kMeshNormals;
+    if (quantize) flags |= mesh::kMeshQuantizedNormals;
+  }
+  if (!mesh.uvs.empty()) {
+    flags |= mesh::kMeshUvs;
+    // Only uvs in [0, 1] survive quantization, tiling textures need floats.
+    const auto range = std::minmax_element(mesh.uvs.begin(), mesh.uvs.end());
+    if (quantize && *range.first >= 0.f && *range.second <= 1.f) {
+      flags |= mesh::kMeshQuantizedUvs;
+    }
+  }
+  if (mesh.index_type == GL_UNSIGNED_INT) flags |= mesh::kMeshIndex32;
+  const mesh::MeshVertexLayout layout = mesh::GetVertexLayout(flags);
+
+  mesh::MeshFileHeader header = {};
+  memcpy(header.magic, mesh::kFileMagic, sizeof(header.magic));
+  header.version = mesh::kFileVersion;
+  header.header_size = sizeof(header);
+  header.flags = flags;
+  header.vertex_count = static_cast<uint32_t>(vertex_count);
+  header.vertex_stride = layout.stride;
+  header.index_count = static_cast<uint32_t>(mesh.index_count());
+  header.vertex_offset = mesh::AlignOffset(sizeof(header));
+  header.vertex_size = uint64_t(vertex_count) * layout.stride;
+  header.index_offset =
+      mesh::AlignOffset(header.vertex_offset + header.vertex_size);
+  header.index_size = uint64_t(header.index_count) *
+                      ((flags & mesh::kMeshIndex32) ? 4 : 2);
+
+  out->assign(header.index_offset + header.index_size, 0);
+  memcpy(out->data(), &header, sizeof(header));
+  for (size_t i = 0; i < vertex_count; ++i) {
+    uint8_t* vertex = out->data() + header.vertex_offset + i * layout.stride;
+    memcpy(vertex, &mesh.positions[i * 3], 3 * sizeof(float));
+    if (flags & mesh::kMeshQuantizedNormals) {
+      const int16_t normal[4] = {QuantizeSnorm16(mesh.normals[i * 3]),
+                                 QuantizeSnorm16(mesh.normals[i * 3 + 1]),
+                                 QuantizeSnorm16(mesh.normals[i * 3 + 2]), 0};
+      memcpy(vertex + layout.normal_offset, normal, sizeof(normal));
+    } else if (flags & mesh::kMeshNormals) {
+      memcpy(vertex + layout.normal_offset, &mesh.normals[i * 3],
+             3 * sizeof(float));
+    }
+    if (flags & mesh::kMeshQuantizedUvs) {
+      const uint16_t uv[2] = {QuantizeUnorm16(mesh.uvs[i * 2]),
+                              QuantizeUnorm16(mesh.uvs[i * 2 + 1])};
+      memcpy(vertex + layout.uv_offset, uv, sizeof(uv));
+    } else if (flags & mesh::kMeshUvs) {
+      memcpy(vertex + layout.uv_offset, &mesh.uvs[i * 2], 2 * sizeof(float));
+    }
+  }
+  memcpy(out->data() + header.index_offset, mesh.index_data(),
+         header.index_size);
+}
+
+}  // namespace hello_ar
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_MESH_ASSET_H_
+#define C_ARCORE_HELLO_AR_MESH_ASSET_H_
+
+#include <GLES2/gl2.h>
+#include <android/asset_manager.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "asset_view.h"
+#include "mesh_format.h"
+#include "obj_loader.h"
+
+namespace hello_ar {
+
+// Binary mesh file (see mesh_format.h) mapped from the assets.  The vertex
+// and index data point into the mapping and are valid until the asset is
+// closed, so they can go to glBufferData() without an intermediate copy.
+class MeshAsset {
+ public:
+  // Opens and validates |file_name|, relative to the assets folder.
+  bool Open(AAssetManager* asset_manager, const char* file_name);
+  void Close() { view_.Close(); }
+
+  const mesh::MeshFileHeader& header() const { return header_; }
+  mesh::MeshVertexLayout vertex_layout() const {
+    return mesh::GetVertexLayout(header_.flags);
+  }
+  const uint8_t* vertex_data() const {
+    return view_.data() + header_.vertex_offset;
+  }
+  const uint8_t* index_data() const {
+    return view_.data() + header_.index_offset;
+  }
+  GLenum index_type() const {
+    return (header_.flags & mesh::kMeshIndex32) ? GL_UNSIGNED_INT
+                                                : GL_UNSIGNED_SHORT;
+  }
+
+ private:
+  AssetView view_;
+  mesh::MeshFileHeader header_ = {};
+};
+
+// Serializes |mesh| into the binary mesh format, quantizing normals and uvs
+// if |quantize| is set.
+void EncodeMesh(const ObjMesh& mesh, bool quantize, std::vector<uint8_t>* out);
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_MESH_ASSET_H_
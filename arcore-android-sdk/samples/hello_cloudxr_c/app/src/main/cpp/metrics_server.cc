@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "metrics_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "util.h"
+
+namespace hello_ar {
+namespace {
+// How often the serve loop wakes to check for Stop().
+constexpr int kPollTimeoutMs = 200;
+constexpr int kRequestTimeoutMs = 1000;
+
+void SendAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    const ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+    if (sent <= 0) {
+      if (sent < 0 && errno == EINTR) continue;
+      return;
+    }
+    data += sent;
+    size -= sent;
+  }
+}
+}  // namespace
+
+bool MetricsServer::Start(uint16_t port) {
+  if (IsRunning()) {
+    return true;
+  }
+
+  const int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    LOGE("Metrics server: socket failed: %s", strerror(errno));
+    return false;
+  }
+
+  const int reuse = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      listen(fd, 4) != 0) {
+    LOGE("Metrics server: unable to listen on port %u: %s", port,
+         strerror(errno));
+    close(fd);
+    return false;
+  }
+
+  socklen_t addr_size = sizeof(addr);
+  getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &addr_size);
+  port_ = ntohs(addr.sin_port);
+
+  listen_fd_ = fd;
+  running_ = true;
+  thread_ = std::thread(&MetricsServer::ServeLoop, this);
+  LOGI("Metrics server listening on 127.0.0.1:%u", port_);
+  return true;
+}
+
+void MetricsServer::Stop() {
+  if (!IsRunning()) {
+    return;
+  }
+
+  running_ = false;
+  thread_.join();
+  close(listen_fd_);
+  listen_fd_ = -1;
+  port_ = 0;
+}
+
+void MetricsServer::ServeLoop() {
+  pollfd listen_poll = {listen_fd_, POLLIN, 0};
+  while (running_) {
+    if (poll(&listen_poll, 1, kPollTimeoutMs) <= 0) {
+      continue;
+    }
+
+    const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      continue;
+    }
+    HandleConnection(fd);
+    close(fd);
+  }
+}
+
+void MetricsServer::HandleConnection(int fd) {
+  // Read the request head; only the request line matters.
+  char request[1024];
+  size_t received = 0;
+  pollfd conn_poll = {fd, POLLIN, 0};
+  while (received < sizeof(request) - 1 &&
+         poll(&conn_poll, 1, kRequestTimeoutMs) > 0) {
+    const ssize_t n = recv(fd, request + received,
+                           sizeof(request) - 1 - received, 0);
+    if (n <= 0) break;
+    received += n;
+    request[received] = '\0';
+    if (strstr(request, "\r\n\r\n") || strstr(request, "\n\n")) break;
+  }
+  request[received] = '\0';
+
+  const bool is_get = strncmp(request, "GET ", 4) == 0;
+  const char* path = request + 4;
+  const bool is_metrics = is_get && (strncmp(path, "/metrics", 8) == 0 ||
+                                     strncmp(path, "/ ", 2) == 0);
+
+  std::string body;
+  const char* status = "200 OK";
+  if (!is_get) {
+    status = "405 Method Not Allowed";
+  } else if (!is_metrics) {
+    status = "404 Not Found";
+  } else {
+    body = SerializePrometheus(snapshot_->Read());
+  }
+
+  char head[256];
+  const int head_size = snprintf(
+      head, sizeof(head),
+      "HTTP/1.0 %s\r\n"
+      "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+      "Content-Length: %zu\r\n"
+      "Connection: close\r\n\r\n",
+      status, body.size());
+  SendAll(fd, head, head_size);
+  SendAll(fd, body.data(), body.size());
+}
+
+}  // namespace hello_ar
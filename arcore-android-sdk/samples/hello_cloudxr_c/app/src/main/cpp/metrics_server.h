@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_METRICS_SERVER_H_
+#define C_ARCORE_HELLO_AR_METRICS_SERVER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "client_metrics.h"
+
+namespace hello_ar {
+
+// Minimal HTTP server bound to the loopback interface that serves the latest
+// published ClientMetrics in Prometheus text format at /metrics.  Requests are
+// handled one at a time on the server's own thread, so serialization never
+// runs on the render thread.  Reach it from a host with
+// `adb forward tcp:<port> tcp:<port>`.
+class MetricsServer {
+ public:
+  explicit MetricsServer(MetricsSnapshot* snapshot) : snapshot_(snapshot) {}
+  ~MetricsServer() { Stop(); }
+
+  // Port 0 listens on an ephemeral port, see port().
+  bool Start(uint16_t port);
+  void Stop();
+  bool IsRunning() const { return listen_fd_ >= 0; }
+  uint16_t port() const { return port_; }
+
+  MetricsServer(const MetricsServer&) = delete;
+  void operator=(const MetricsServer&) = delete;
+
+ private:
+  void ServeLoop();
+  void HandleConnection(int fd);
+
+  MetricsSnapshot* const snapshot_;
+  std::atomic<bool> running_{false};
+  int listen_fd_ = -1;
+  uint16_t port_ = 0;
+  std::thread thread_;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_METRICS_SERVER_H_
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_OBJ_LOADER_H_
+#define C_ARCORE_HELLO_AR_OBJ_LOADER_H_
+
+#include <GLES2/gl2.h>
+#include <android/asset_manager.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace hello_ar {
+
+// Indexed triangle mesh read from an OBJ file.  Each distinct combination of
+// position, texture and normal index in the faces becomes one vertex.
+struct ObjMesh {
+  // Vertex streams: 3 floats per vertex for positions and normals, 2 for uvs.
+  // normals and uvs are empty if no face references them, and zero for the
+  // vertices of faces that do not.
+  std::vector<GLfloat> positions;
+  std::vector<GLfloat> normals;
+  std::vector<GLfloat> uvs;
+
+  // Triangle indices, GL_UNSIGNED_SHORT in indices16 when every vertex fits,
+  // otherwise GL_UNSIGNED_INT in indices32, which on OpenGL ES 2.0 needs
+  // GL_OES_element_index_uint.
+  GLenum index_type = GL_UNSIGNED_SHORT;
+  std::vector<GLushort> indices16;
+  std::vector<GLuint> indices32;
+
+  size_t vertex_count() const { return positions.size() / 3; }
+  size_t index_count() const {
+    return index_type == GL_UNSIGNED_SHORT ? indices16.size()
+                                           : indices32.size();
+  }
+  const void* index_data() const {
+    return index_type == GL_UNSIGNED_SHORT
+               ? static_cast<const void*>(indices16.data())
+               : static_cast<const void*>(indices32.data());
+  }
+};
+
+// Parses OBJ text in one pass, without copying lines, so lines can be of any
+// length.  Reads v, vt, vn and f statements and ignores everything else.
+// Faces can have any number of vertices and are triangulated as fans;
+// negative indices count back from the latest element.  Logs and returns
+// false on malformed numbers or indices out of range.
+bool ParseObj(const char* text, size_t size, ObjMesh* out_mesh);
+
+// Parses the OBJ file |file_name|, relative to the assets folder.
+bool LoadObjMesh(AAssetManager* asset_manager, const char* file_name,
+                 ObjMesh* out_mesh);
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_OBJ_LOADER_H_
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "plane_registry.h"
+
+namespace hello_ar {
+
+void PlaneRegistry::Update(const ArSession* session, const ArFrame* frame) {
+  for (Plane& plane : planes_) plane.updated = false;
+
+  ScopedArObject<ArTrackableList> scoped_list(list_pool_, session);
+  ArTrackableList* list = scoped_list.get();
+  if (resync_) {
+    // Planes that are gone do not show up in a full scan either.
+    Clear();
+    ArSession_getAllTrackables(session, AR_TRACKABLE_PLANE, list);
+    resync_ = false;
+  } else {
+    ArFrame_getUpdatedTrackables(session, frame, AR_TRACKABLE_PLANE, list);
+  }
+
+  int32_t list_size = 0;
+  ArTrackableList_getSize(session, list, &list_size);
+  for (int32_t i = 0; i < list_size; ++i) {
+    ArTrackable* trackable = nullptr;
+    ArTrackableList_acquireItem(session, list, i, &trackable);
+    ArPlane* plane = ArAsPlane(trackable);
+
+    ArTrackingState tracking_state = AR_TRACKING_STATE_STOPPED;
+    ArTrackable_getTrackingState(session, trackable, &tracking_state);
+    ArPlane* subsumed_by = nullptr;
+    ArPlane_acquireSubsumedBy(session, plane, &subsumed_by);
+    if (subsumed_by != nullptr) {
+      ArTrackable_release(ArAsTrackable(subsumed_by));
+    }
+
+    auto it = index_.find(plane);
+    if (subsumed_by != nullptr ||
+        tracking_state == AR_TRACKING_STATE_STOPPED) {
+      if (it != index_.end()) Remove(plane);
+      ArTrackable_release(trackable);
+    } else if (it == index_.end()) {
+      // Keep the acquired reference while the plane is registered.
+      index_.emplace(plane, planes_.size());
+      planes_.push_back(Plane{plane, tracking_state, true});
+    } else {
+      Plane& registered = planes_[it->second];
+      registered.tracking_state = tracking_state;
+      registered.updated = true;
+      ArTrackable_release(trackable);
+    }
+  }
+}
+
+void PlaneRegistry::Clear() {
+  for (const Plane& plane : planes_) {
+    ArTrackable_release(ArAsTrackable(plane.plane));
+  }
+  planes_.clear();
+  index_.clear();
+}
+
+void PlaneRegistry::Remove(ArPlane* plane) {
+  auto it = index_.find(plane);
+  const size_t index = it->second;
+  index_.erase(it);
+  ArTrackable_release(ArAsTrackable(plane));
+  if (index != planes_.size() - 1) {
+    planes_[index] = planes_.back();
+    index_[planes_[index].plane] = index;
+  }
+  planes_.pop_back();
+}
+
+}  // namespace hello_ar
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_PLANE_REGISTRY_H_
+#define C_ARCORE_HELLO_AR_PLANE_REGISTRY_H_
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "ar_object_pool.h"
+#include "arcore_c_api.h"
+
+namespace hello_ar {
+
+// The session's planes that are still tracked or may resume tracking, kept
+// up to date from ArFrame_getUpdatedTrackables() so a frame only queries the
+// planes ARCore changed.  Subsumed and stopped planes are dropped.  Holds a
+// reference to each plane, so plane pointers stay valid and stable across
+// frames.
+//
+// Not thread safe: owned and used by the render thread.
+class PlaneRegistry {
+ public:
+  struct Plane {
+    ArPlane* plane;
+    ArTrackingState tracking_state;
+    // Reported by ARCore this frame, so its pose or polygon may have changed.
+    bool updated;
+  };
+
+  explicit PlaneRegistry(ArObjectPool<ArTrackableList>* list_pool)
+      : list_pool_(list_pool) {}
+  ~PlaneRegistry() { Clear(); }
+
+  PlaneRegistry(const PlaneRegistry&) = delete;
+  void operator=(const PlaneRegistry&) = delete;
+
+  // Applies the planes updated in |frame|.  The first update, and the first
+  // after Resync(), scans all of the session's planes instead.
+  void Update(const ArSession* session, const ArFrame* frame);
+
+  // Rescans all planes on the next update, e.g. after the session resumes.
+  void Resync() { resync_ = true; }
+
+  // Releases every plane.  Call before destroying the session.
+  void Clear();
+
+  const std::vector<Plane>& planes() const { return planes_; }
+  size_t size() const { return planes_.size(); }
+
+ private:
+  void Remove(ArPlane* plane);
+
+  ArObjectPool<ArTrackableList>* const list_pool_;
+  std::vector<Plane> planes_;
+  // Index of each plane in |planes_|.
+  std::unordered_map<const ArPlane*, size_t> index_;
+  bool resync_ = true;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_PLANE_REGISTRY_H_
@@ -15,28 +15,163 @@
  */
 
 #include "plane_renderer.h"
+#include <cmath>
+#include <cstddef>
+#include <limits>
 #include <string>
+#include "async_log.h"
+#include "texture_asset.h"
 #include "util.h"
 
 namespace hello_ar {
 namespace {
 constexpr char kVertexShaderFilename[] = "shaders/plane.vert";
 constexpr char kFragmentShaderFilename[] = "shaders/plane.frag";
+// ETC2 grid texture with its mip chain, the only source of the grid.
+// trigrid.png is just the input to texture_convert and is not in the APK.  If
+// the KTX cannot be loaded, the texture is left empty.
+constexpr char kGridTextureFilename[] = "models/trigrid.ktx";
+constexpr char kGpuMemoryOwner[] = "planes";
+
+// Initial size of the shared buffers, enough for a few dozen typical planes.
+constexpr uint32_t kInitialVertexCapacity = 4096;
+constexpr uint32_t kInitialIndexCapacity = 4 * kInitialVertexCapacity;
+// Cap of the shared vertex buffer.
+constexpr uint32_t kMaxVertexCapacity = 0x400000;
+// Ranges are rounded up to a power of two of at least this many elements, so
+// a growing polygon is usually rewritten in place.
+constexpr uint32_t kMinRangeSize = 32;
+// Frames after which the cached triangulation of a plane that is no longer
+// drawn is freed.
+constexpr uint32_t kEvictAfterFrames = 120;
+
+uint32_t RangeSize(size_t count) {
+  uint32_t size = kMinRangeSize;
+  while (size < count) size *= 2;
+  return size;
+}
+
+// FNV-1a of the polygon's coordinates.
+uint64_t HashPolygon(const float* data, int32_t length) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < length * sizeof(float); ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+const void* BufferOffset(size_t bytes) {
+  return reinterpret_cast<const void*>(bytes);
+}
+
+uint8_t ToUnorm8(float value) {
+  return static_cast<uint8_t>(
+      std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+// Simplification tolerance of level of detail 0, doubling with each level.
+constexpr float kLodBaseTolerance = 0.005f;
+constexpr int kMaxLodLevel = 6;
+// A level is kept until the ideal level leaves it by this fraction of a level,
+// so planes at a level boundary do not flip between levels.
+constexpr float kLodHysteresis = 0.25f;
+// Nearest distance used for the tolerance, for planes around the camera.
+constexpr float kMinLodDistance = 0.25f;
+// Polygons are simplified further until they have at most this many vertices,
+// at every level including full detail.
+constexpr int32_t kMaxLodPolygonVertices = 64;
+
+float SquaredDistanceToSegment(const glm::vec2& p, const glm::vec2& a,
+                               const glm::vec2& b) {
+  const glm::vec2 ab = b - a;
+  const float length2 = glm::dot(ab, ab);
+  const float t =
+      length2 > 0.0f ? glm::clamp(glm::dot(p - a, ab) / length2, 0.0f, 1.0f)
+                     : 0.0f;
+  const glm::vec2 d = p - (a + t * ab);
+  return glm::dot(d, d);
+}
+
+// Douglas-Peucker simplification of the closed polygon |in|, written to |out|
+// which has room for |size| vertices.  The polygon is split at vertex 0 and
+// the vertex farthest from it, and each half keeps at least its farthest
+// vertex, so the result has at least 4 vertices.  Returns the vertex count.
+int32_t SimplifyPolygon(const glm::vec2* in, int32_t size, float tolerance,
+                        FrameArena* arena, glm::vec2* out) {
+  if (size <= 4) {
+    std::copy(in, in + size, out);
+    return size;
+  }
+
+  bool* keep = arena->AllocateArray<bool>(size);
+  std::fill(keep, keep + size, false);
+  int32_t farthest = 0;
+  float farthest_distance2 = 0.0f;
+  for (int32_t i = 1; i < size; ++i) {
+    const glm::vec2 d = in[i] - in[0];
+    const float distance2 = glm::dot(d, d);
+    if (distance2 > farthest_distance2) {
+      farthest_distance2 = distance2;
+      farthest = i;
+    }
+  }
+  const float tolerance2 = tolerance * tolerance;
+  keep[0] = true;
+  keep[farthest] = true;
+
+  // Pending spans of vertex indices, where |size| stands for vertex 0.
+  struct Span {
+    int32_t first;
+    int32_t last;
+    bool forced;
+  };
+  Span* stack = arena->AllocateArray<Span>(size);
+  int32_t stack_size = 0;
+  stack[stack_size++] = Span{0, farthest, true};
+  stack[stack_size++] = Span{farthest, size, true};
+  while (stack_size > 0) {
+    const Span span = stack[--stack_size];
+    const glm::vec2& a = in[span.first % size];
+    const glm::vec2& b = in[span.last % size];
+    float max_distance = -1.0f;
+    int32_t max_index = -1;
+    for (int32_t i = span.first + 1; i < span.last; ++i) {
+      const float distance = SquaredDistanceToSegment(in[i], a, b);
+      if (distance > max_distance) {
+        max_distance = distance;
+        max_index = i;
+      }
+    }
+    if (max_index < 0 || (!span.forced && max_distance <= tolerance2)) {
+      continue;
+    }
+    keep[max_index] = true;
+    stack[stack_size++] = Span{span.first, max_index, false};
+    stack[stack_size++] = Span{max_index, span.last, false};
+  }
+
+  int32_t count = 0;
+  for (int32_t i = 0; i < size; ++i) {
+    if (keep[i]) out[count++] = in[i];
+  }
+  return count;
+}
 }  // namespace
 
-void PlaneRenderer::InitializeGlContent(AAssetManager* asset_manager) {
-  shader_program_ = util::CreateProgram(kVertexShaderFilename,
-                                        kFragmentShaderFilename, asset_manager);
+void PlaneRenderer::InitializeGlContent(AAssetManager* asset_manager,
+                                        ProgramCache* program_cache) {
+  shader_program_ = program_cache->CreateProgram(
+      kVertexShaderFilename, kFragmentShaderFilename, asset_manager);
   if (!shader_program_) {
     LOGE("Could not create program.");
   }
 
   uniform_mvp_mat_ = glGetUniformLocation(shader_program_, "mvp");
   uniform_texture_ = glGetUniformLocation(shader_program_, "texture");
-  uniform_model_mat_ = glGetUniformLocation(shader_program_, "model_mat");
-  uniform_normal_vec_ = glGetUniformLocation(shader_program_, "normal");
-  uniform_color_ = glGetUniformLocation(shader_program_, "color");
   attri_vertices_ = glGetAttribLocation(shader_program_, "vertex");
+  attri_uvs_ = glGetAttribLocation(shader_program_, "uv");
+  attri_colors_ = glGetAttribLocation(shader_program_, "color");
 
   glGenTextures(1, &texture_id_);
   glBindTexture(GL_TEXTURE_2D, texture_id_);
@@ -46,26 +181,171 @@ void PlaneRenderer::InitializeGlContent(AAssetManager* asset_manager) {
                   GL_LINEAR_MIPMAP_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-  if (!util::LoadPngFromAssetManager(GL_TEXTURE_2D, "models/trigrid.png")) {
-    LOGE("Could not load png texture for planes.");
+  size_t texture_bytes = 0;
+  if (LoadKtxTexture(asset_manager, kGridTextureFilename, &texture_bytes)) {
+    gpu_memory_->Track(GpuObjectType::kTexture, texture_id_, kGpuMemoryOwner,
+                       texture_bytes);
+  } else {
+    LOGE("Could not load the plane grid texture %s.", kGridTextureFilename);
   }
 
-  glGenerateMipmap(GL_TEXTURE_2D);
-
   glBindTexture(GL_TEXTURE_2D, 0);
 
+  // Names from a previous context are gone along with their contents.
+  meshes_.clear();
+  vertex_buffer_ = 0;
+  index_buffer_ = 0;
+  vertex_ranges_.Reset(0);
+  index_ranges_.Reset(0);
+  GrowBuffers(kInitialVertexCapacity, kInitialIndexCapacity);
+
   util::CheckGlError("plane_renderer::InitializeGlContent()");
 }
 
-void PlaneRenderer::Draw(const glm::mat4& projection_mat,
-                         const glm::mat4& view_mat, const ArSession& ar_session,
-                         const ArPlane& ar_plane, const glm::vec3& color) {
+void PlaneRenderer::BeginFrame(const glm::mat4& projection_mat,
+                               const glm::mat4& view_mat,
+                               int viewport_height) {
+  ++frame_;
+  view_projection_mat_ = projection_mat * view_mat;
+  camera_position_ = glm::vec3(glm::inverse(view_mat)[3]);
+  focal_length_pixels_ = projection_mat[1][1] * 0.5f * viewport_height;
+}
+
+int PlaneRenderer::SelectLodLevel(const glm::mat4& model_mat, float radius,
+                                  int current_level) const {
+  if (lod_tolerance_pixels_ <= 0.0f || focal_length_pixels_ <= 0.0f) {
+    return -1;
+  }
+  // Tolerance in meters at the nearest point of the plane's bounding circle.
+  const float distance =
+      std::max(glm::length(camera_position_ - glm::vec3(model_mat[3])) - radius,
+               kMinLodDistance);
+  const float tolerance =
+      lod_tolerance_pixels_ * distance / focal_length_pixels_;
+  const float level = std::log2(tolerance / kLodBaseTolerance);
+  const float lower = current_level < 0 ? -std::numeric_limits<float>::infinity()
+                                        : current_level - kLodHysteresis;
+  const float upper = current_level + 1 + kLodHysteresis;
+  if (level >= lower && level < upper) {
+    return current_level;
+  }
+  return std::min(std::max(static_cast<int>(std::floor(level)), -1),
+                  kMaxLodLevel);
+}
+
+void PlaneRenderer::AddPlane(const ArSession& ar_session,
+                             const ArPlane& ar_plane, const glm::vec3& color,
+                             bool plane_updated) {
+  if (!plane_updated) {
+    auto it = meshes_.find(&ar_plane);
+    if (it != meshes_.end() && it->second.polygon_length != 0 &&
+        it->second.color == color &&
+        SelectLodLevel(it->second.model_mat, it->second.radius,
+                       it->second.lod_level) == it->second.lod_level) {
+      PlaneMesh& mesh = it->second;
+      mesh.last_frame = frame_;
+      if (mesh.vertex_range.size == 0) UploadMesh(&mesh);
+      return;
+    }
+  }
+
+  int32_t polygon_length;
+  ArPlane_getPolygonSize(&ar_session, &ar_plane, &polygon_length);
+
+  if (polygon_length == 0) {
+    LOGE("PlaneRenderer::UpdatePlane, no valid plane polygon is found");
+    return;
+  }
+
+  ScopedArObject<ArPose> center_pose(pose_pool_, &ar_session);
+  ArPlane_getCenterPose(&ar_session, &ar_plane, center_pose.get());
+  glm::mat4 model_mat;
+  ArPose_getMatrix(&ar_session, center_pose.get(), glm::value_ptr(model_mat));
+
+  const int32_t vertices_size = polygon_length / 2;
+  ArenaVector<glm::vec2> raw_vertices(
+      vertices_size, glm::vec2(), ArenaAllocator<glm::vec2>(frame_arena_));
+  ArPlane_getPolygon(&ar_session, &ar_plane,
+                     glm::value_ptr(raw_vertices.front()));
+  const uint64_t polygon_hash =
+      HashPolygon(glm::value_ptr(raw_vertices.front()), polygon_length);
+
+  PlaneMesh& mesh = meshes_[&ar_plane];
+  mesh.last_frame = frame_;
+  bool polygon_changed = mesh.polygon_length != polygon_length ||
+                         mesh.polygon_hash != polygon_hash;
+  if (polygon_changed) {
+    float radius2 = 0.0f;
+    for (const glm::vec2& vertex : raw_vertices) {
+      radius2 = std::max(radius2, glm::dot(vertex, vertex));
+    }
+    mesh.radius = std::sqrt(radius2);
+  }
+  const int lod_level = SelectLodLevel(model_mat, mesh.radius, mesh.lod_level);
+  polygon_changed = polygon_changed || mesh.lod_level != lod_level;
+  if (polygon_changed) {
+    mesh.polygon_length = polygon_length;
+    mesh.polygon_hash = polygon_hash;
+    mesh.lod_level = lod_level;
+    if (lod_level < 0 && vertices_size <= kMaxLodPolygonVertices) {
+      Triangulate(raw_vertices.data(), vertices_size, &mesh);
+    } else {
+      glm::vec2* simplified = frame_arena_->AllocateArray<glm::vec2>(
+          vertices_size);
+      // Full detail polygons over the cap start from half the tolerance of
+      // level 0.
+      float tolerance = std::ldexp(kLodBaseTolerance, std::max(lod_level, -1));
+      int32_t simplified_size = SimplifyPolygon(
+          raw_vertices.data(), vertices_size, tolerance, frame_arena_,
+          simplified);
+      while (simplified_size > kMaxLodPolygonVertices) {
+        tolerance *= 2.0f;
+        simplified_size = SimplifyPolygon(raw_vertices.data(), vertices_size,
+                                          tolerance, frame_arena_, simplified);
+      }
+      Triangulate(simplified, simplified_size, &mesh);
+    }
+    stats_.mesh_rebuilds++;
+  }
+
+  if (polygon_changed || mesh.vertex_range.size == 0 ||
+      mesh.model_mat != model_mat || mesh.color != color) {
+    mesh.model_mat = model_mat;
+    mesh.normal = util::GetPlaneNormal(ar_session, *center_pose.get());
+    mesh.color = color;
+    UploadMesh(&mesh);
+  }
+}
+
+void PlaneRenderer::Draw() {
   if (!shader_program_) {
     LOGE("shader_program is null.");
     return;
   }
 
-  UpdateForPlane(ar_session, ar_plane);
+  // Planes not added this frame leave the batch.
+  stats_.vertices = 0;
+  stats_.triangles = 0;
+  for (auto it = meshes_.begin(); it != meshes_.end();) {
+    PlaneMesh& mesh = it->second;
+    if (mesh.last_frame != frame_ && mesh.vertex_range.size != 0) {
+      ReleaseRanges(&mesh);
+    }
+    if (mesh.vertex_range.size != 0) {
+      stats_.vertices += mesh.vertices.size();
+      stats_.triangles += mesh.triangles.size() / 3;
+    }
+    if (frame_ - mesh.last_frame > kEvictAfterFrames) {
+      it = meshes_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  const uint32_t index_count = index_ranges_.end();
+  if (index_count == 0) {
+    return;
+  }
 
   glUseProgram(shader_program_);
   glDepthMask(GL_FALSE);
@@ -74,29 +354,35 @@ void PlaneRenderer::Draw(const glm::mat4& projection_mat,
   glUniform1i(uniform_texture_, 0);
   glBindTexture(GL_TEXTURE_2D, texture_id_);
 
-  // Compose final mvp matrix for this plane renderer.
+  // The batch is in world space.
   glUniformMatrix4fv(uniform_mvp_mat_, 1, GL_FALSE,
-                     glm::value_ptr(projection_mat * view_mat * model_mat_));
-
-  glUniformMatrix4fv(uniform_model_mat_, 1, GL_FALSE,
-                     glm::value_ptr(model_mat_));
-  glUniform3f(uniform_normal_vec_, normal_vec_.x, normal_vec_.y, normal_vec_.z);
-  glUniform3f(uniform_color_, color.x, color.y, color.z);
+                     glm::value_ptr(view_projection_mat_));
 
+  glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
   glEnableVertexAttribArray(attri_vertices_);
-  glVertexAttribPointer(attri_vertices_, 3, GL_FLOAT, GL_FALSE, 0,
-                        vertices_.data());
-
-  glDrawElements(GL_TRIANGLES, triangles_.size(), GL_UNSIGNED_SHORT,
-                 triangles_.data());
-
+  glVertexAttribPointer(attri_vertices_, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                        BufferOffset(offsetof(Vertex, position)));
+  glEnableVertexAttribArray(attri_uvs_);
+  glVertexAttribPointer(attri_uvs_, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                        BufferOffset(offsetof(Vertex, uv)));
+  glEnableVertexAttribArray(attri_colors_);
+  glVertexAttribPointer(attri_colors_, 4, GL_UNSIGNED_BYTE, GL_TRUE,
+                        sizeof(Vertex), BufferOffset(offsetof(Vertex, color)));
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+  glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, nullptr);
+
+  glDisableVertexAttribArray(attri_uvs_);
+  glDisableVertexAttribArray(attri_colors_);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
   glUseProgram(0);
   glDepthMask(GL_TRUE);
   util::CheckGlError("plane_renderer::Draw()");
 }
 
-void PlaneRenderer::UpdateForPlane(const ArSession& ar_session,
-                                   const ArPlane& ar_plane) {
+void PlaneRenderer::Triangulate(const glm::vec2* raw_vertices,
+                                int32_t vertices_size, PlaneMesh* mesh) const {
   // The following code generates a triangle mesh filling a convex polygon,
   // including a feathered edge for blending.
   //
@@ -109,35 +395,21 @@ void PlaneRenderer::UpdateForPlane(const ArSession& ar_session,
   // |             |      |7-----------6|
   // ---------------     3---------------2
 
-  vertices_.clear();
-  triangles_.clear();
-
-  int32_t polygon_length;
-  ArPlane_getPolygonSize(&ar_session, &ar_plane, &polygon_length);
-
-  if (polygon_length == 0) {
-    LOGE("PlaneRenderer::UpdatePlane, no valid plane polygon is found");
-    return;
-  }
-
-  const int32_t vertices_size = polygon_length / 2;
-  std::vector<glm::vec2> raw_vertices(vertices_size);
-  ArPlane_getPolygon(&ar_session, &ar_plane,
-                     glm::value_ptr(raw_vertices.front()));
+  std::vector<glm::vec3>& vertices = mesh->vertices;
+  std::vector<GLushort>& triangles = mesh->triangles;
+  vertices.clear();
+  triangles.clear();
+  // The mesh keeps its capacity, so this only allocates for a larger polygon.
+  vertices.reserve(vertices_size * 2);
+  triangles.reserve(vertices_size * 9);
 
   // Fill vertex 0 to 3. Note that the vertex.xy are used for x and z
   // position. vertex.z is used for alpha. The outter polygon's alpha
   // is 0.
   for (int32_t i = 0; i < vertices_size; ++i) {
-    vertices_.push_back(glm::vec3(raw_vertices[i].x, raw_vertices[i].y, 0.0f));
+    vertices.push_back(glm::vec3(raw_vertices[i].x, raw_vertices[i].y, 0.0f));
   }
 
-  util::ScopedArPose scopedArPose(&ar_session);
-  ArPlane_getCenterPose(&ar_session, &ar_plane, scopedArPose.GetArPose());
-  ArPose_getMatrix(&ar_session, scopedArPose.GetArPose(),
-                   glm::value_ptr(model_mat_));
-  normal_vec_ = util::GetPlaneNormal(ar_session, *scopedArPose.GetArPose());
-
   // Feather distance 0.2 meters.
   const float kFeatherLength = 0.2f;
   // Feather scale over the distance between plane center and vertices.
@@ -151,31 +423,167 @@ void PlaneRenderer::UpdateForPlane(const ArSession& ar_session,
         1.0f - std::min((kFeatherLength / glm::length(v)), kFeatherScale);
     const glm::vec2 result_v = scale * v;
 
-    vertices_.push_back(glm::vec3(result_v.x, result_v.y, 1.0f));
+    vertices.push_back(glm::vec3(result_v.x, result_v.y, 1.0f));
   }
 
-  const int32_t vertices_length = vertices_.size();
+  const int32_t vertices_length = vertices.size();
   const int32_t half_vertices_length = vertices_length / 2;
 
   // Generate triangle (4, 5, 6) and (4, 6, 7).
   for (int i = half_vertices_length + 1; i < vertices_length - 1; ++i) {
-    triangles_.push_back(half_vertices_length);
-    triangles_.push_back(i);
-    triangles_.push_back(i + 1);
+    triangles.push_back(half_vertices_length);
+    triangles.push_back(i);
+    triangles.push_back(i + 1);
   }
 
   // Generate triangle (0, 1, 4), (4, 1, 5), (5, 1, 2), (5, 2, 6),
   // (6, 2, 3), (6, 3, 7), (7, 3, 0), (7, 0, 4)
   for (int i = 0; i < half_vertices_length; ++i) {
-    triangles_.push_back(i);
-    triangles_.push_back((i + 1) % half_vertices_length);
-    triangles_.push_back(i + half_vertices_length);
+    triangles.push_back(i);
+    triangles.push_back((i + 1) % half_vertices_length);
+    triangles.push_back(i + half_vertices_length);
+
+    triangles.push_back(i + half_vertices_length);
+    triangles.push_back((i + 1) % half_vertices_length);
+    triangles.push_back((i + half_vertices_length + 1) % half_vertices_length +
+                        half_vertices_length);
+  }
+}
+
+void PlaneRenderer::UploadMesh(PlaneMesh* mesh) {
+  const uint32_t vertex_size = RangeSize(mesh->vertices.size());
+  const uint32_t index_size = RangeSize(mesh->triangles.size());
+  if (mesh->vertex_range.size != vertex_size ||
+      mesh->index_range.size != index_size) {
+    ReleaseRanges(mesh);
+    if (!AllocateRanges(vertex_size, index_size, mesh) &&
+        (!GrowBuffers(vertex_size, index_size) ||
+         !AllocateRanges(vertex_size, index_size, mesh))) {
+      LOGE_RL(1000, "PlaneRenderer: too many plane vertices to draw.");
+      return;
+    }
+  }
+
+  // Texture coordinates project the world position onto two vectors
+  // orthogonal to the normal.  The arbitrary vector is not co-linear with
+  // either horizontal or vertical plane normals.
+  const glm::vec3 arbitrary(1.0f, 1.0f, 0.0f);
+  const glm::vec3 vec_u = glm::normalize(glm::cross(mesh->normal, arbitrary));
+  const glm::vec3 vec_v = glm::normalize(glm::cross(mesh->normal, vec_u));
+  const uint8_t red = ToUnorm8(mesh->color.x);
+  const uint8_t green = ToUnorm8(mesh->color.y);
+  const uint8_t blue = ToUnorm8(mesh->color.z);
+
+  vertex_scratch_.resize(mesh->vertices.size());
+  for (size_t i = 0; i < mesh->vertices.size(); ++i) {
+    const glm::vec3& local = mesh->vertices[i];
+    const glm::vec3 world =
+        glm::vec3(mesh->model_mat * glm::vec4(local.x, 0.0f, local.y, 1.0f));
+    Vertex& vertex = vertex_scratch_[i];
+    vertex.position = world;
+    vertex.uv = glm::vec2(glm::dot(world, vec_u), glm::dot(world, vec_v));
+    vertex.color[0] = red;
+    vertex.color[1] = green;
+    vertex.color[2] = blue;
+    // Local z is the feather alpha.
+    vertex.color[3] = ToUnorm8(local.z);
+  }
+
+  // Indices address the shared buffer; the rest of the range is degenerate.
+  const uint32_t base = mesh->vertex_range.offset;
+  index_scratch_.assign(mesh->index_range.size, 0);
+  for (size_t i = 0; i < mesh->triangles.size(); ++i) {
+    index_scratch_[i] = base + mesh->triangles[i];
+  }
 
-    triangles_.push_back(i + half_vertices_length);
-    triangles_.push_back((i + 1) % half_vertices_length);
-    triangles_.push_back((i + half_vertices_length + 1) % half_vertices_length +
-                         half_vertices_length);
+  const size_t vertex_bytes = vertex_scratch_.size() * sizeof(Vertex);
+  const size_t index_bytes = index_scratch_.size() * sizeof(GLuint);
+  glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+  glBufferSubData(GL_ARRAY_BUFFER, mesh->vertex_range.offset * sizeof(Vertex),
+                  vertex_bytes, vertex_scratch_.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+  glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+                  mesh->index_range.offset * sizeof(GLuint), index_bytes,
+                  index_scratch_.data());
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  stats_.upload_bytes += vertex_bytes + index_bytes;
+}
+
+bool PlaneRenderer::AllocateRanges(uint32_t vertex_size, uint32_t index_size,
+                                   PlaneMesh* mesh) {
+  if (!vertex_ranges_.Allocate(vertex_size, &mesh->vertex_range)) {
+    return false;
+  }
+  if (!index_ranges_.Allocate(index_size, &mesh->index_range)) {
+    vertex_ranges_.Free(mesh->vertex_range);
+    mesh->vertex_range = RangeAllocator::Range();
+    return false;
+  }
+  return true;
+}
+
+void PlaneRenderer::ReleaseRanges(PlaneMesh* mesh) {
+  if (mesh->index_range.size != 0 &&
+      mesh->index_range.offset + mesh->index_range.size <
+          index_ranges_.end()) {
+    // The range stays within the drawn part of the buffer.
+    index_scratch_.assign(mesh->index_range.size, 0);
+    const size_t index_bytes = index_scratch_.size() * sizeof(GLuint);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+                    mesh->index_range.offset * sizeof(GLuint), index_bytes,
+                    index_scratch_.data());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    stats_.upload_bytes += index_bytes;
+  }
+  vertex_ranges_.Free(mesh->vertex_range);
+  index_ranges_.Free(mesh->index_range);
+  mesh->vertex_range = RangeAllocator::Range();
+  mesh->index_range = RangeAllocator::Range();
+}
+
+bool PlaneRenderer::GrowBuffers(uint32_t extra_vertices,
+                                uint32_t extra_indices) {
+  const uint32_t needed_vertices = vertex_ranges_.allocated() + extra_vertices;
+  if (needed_vertices > kMaxVertexCapacity) {
+    return false;
+  }
+  const uint32_t vertex_capacity = std::min(
+      std::max(2 * vertex_ranges_.capacity(), needed_vertices),
+      kMaxVertexCapacity);
+  const uint32_t index_capacity = std::max(
+      2 * index_ranges_.capacity(), index_ranges_.allocated() + extra_indices);
+
+  if (!vertex_buffer_) glGenBuffers(1, &vertex_buffer_);
+  glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+  glBufferData(GL_ARRAY_BUFFER, vertex_capacity * sizeof(Vertex), nullptr,
+               GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  if (!index_buffer_) glGenBuffers(1, &index_buffer_);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_capacity * sizeof(GLuint),
+               nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  gpu_memory_->Track(GpuObjectType::kBuffer, vertex_buffer_, kGpuMemoryOwner,
+                     static_cast<uint64_t>(vertex_capacity) * sizeof(Vertex));
+  gpu_memory_->Track(GpuObjectType::kBuffer, index_buffer_, kGpuMemoryOwner,
+                     static_cast<uint64_t>(index_capacity) * sizeof(GLuint));
+  LOGI("PlaneRenderer: plane buffers hold %u vertices and %u indices.",
+       vertex_capacity, index_capacity);
+
+  // Placed meshes are packed from the start, so the drawn part of the index
+  // buffer holds no stale indices.
+  vertex_ranges_.Reset(vertex_capacity);
+  index_ranges_.Reset(index_capacity);
+  for (auto& entry : meshes_) {
+    PlaneMesh& mesh = entry.second;
+    if (mesh.vertex_range.size == 0) continue;
+    mesh.vertex_range = RangeAllocator::Range();
+    mesh.index_range = RangeAllocator::Range();
+    UploadMesh(&mesh);
   }
+  return true;
 }
 
 }  // namespace hello_ar
@@ -23,45 +23,154 @@
 #include <array>
 #include <cstdint>
 #include <cstdlib>
+#include <unordered_map>
 #include <vector>
 
+#include "ar_object_pool.h"
 #include "arcore_c_api.h"
+#include "frame_arena.h"
+#include "gpu_memory.h"
 #include "glm.h"
+#include "program_cache.h"
+#include "range_allocator.h"
 
 namespace hello_ar {
 
-// PlaneRenderer renders ARCore plane type.
+// PlaneRenderer renders ARCore plane type.  All planes of a frame are drawn
+// with a single draw call from a vertex and an index buffer shared by all
+// planes, in world space with per-vertex texture coordinates and color.
+//
+// Each plane owns a range of both buffers.  Its triangulation is cached and
+// rebuilt only when the plane's polygon or level of detail changes, and its
+// range is rewritten only when the triangulation, pose or color changes.
+// Index ranges of planes that are not drawn hold degenerate triangles.
+// Indices are 32-bit, which OpenGL ES 3.0 supports without extensions.
+//
+// The level of detail simplifies the polygon with a tolerance of a set number
+// of pixels at the plane's distance, in steps of powers of two.
 class PlaneRenderer {
  public:
-  PlaneRenderer() = default;
+  // Totals since construction.
+  struct Stats {
+    uint64_t mesh_rebuilds = 0;
+    uint64_t upload_bytes = 0;
+    // Size of the last frame's batch.
+    uint32_t vertices = 0;
+    uint32_t triangles = 0;
+  };
+
+  // |frame_arena| holds per-plane scratch data and |pose_pool| supplies the
+  // plane's center pose, so drawing does not allocate.  The texture and
+  // buffers are accounted in |gpu_memory|.
+  PlaneRenderer(FrameArena* frame_arena, ArObjectPool<ArPose>* pose_pool,
+                GpuMemoryTracker* gpu_memory)
+      : frame_arena_(frame_arena),
+        pose_pool_(pose_pool),
+        gpu_memory_(gpu_memory) {}
   ~PlaneRenderer() = default;
 
   // Sets up OpenGL state used by the plane renderer.  Must be called on the
   // OpenGL thread.
-  void InitializeGlContent(AAssetManager* asset_manager);
+  void InitializeGlContent(AAssetManager* asset_manager,
+                           ProgramCache* program_cache);
+
+  // Largest distance in pixels between a plane's outline and its simplified
+  // outline.  0 disables simplification.
+  void SetLodTolerance(float pixels) { lod_tolerance_pixels_ = pixels; }
+
+  // Starts collecting the planes of a frame seen through |view_mat| and
+  // |projection_mat| on a viewport |viewport_height| pixels high.
+  void BeginFrame(const glm::mat4& projection_mat, const glm::mat4& view_mat,
+                  int viewport_height);
+
+  // Adds the provided plane to this frame's batch.  If |plane_updated| is
+  // false, ARCore reported no change to the plane since it was last added, and
+  // its cached mesh is reused without querying the plane.
+  void AddPlane(const ArSession& ar_session, const ArPlane& ar_plane,
+                const glm::vec3& color, bool plane_updated = true);
+
+  // Draws the planes added since BeginFrame().
+  void Draw();
 
-  // Draws the provided plane.
-  void Draw(const glm::mat4& projection_mat, const glm::mat4& view_mat,
-            const ArSession& ar_session, const ArPlane& ar_plane,
-            const glm::vec3& color);
+  const Stats& stats() const { return stats_; }
 
  private:
-  void UpdateForPlane(const ArSession& ar_session, const ArPlane& ar_plane);
+  struct Vertex {
+    glm::vec3 position;
+    glm::vec2 uv;
+    // Plane color, and the feather alpha.
+    uint8_t color[4];
+  };
+
+  // Cached state of one plane.  The triangulation is in the plane's local
+  // space; the buffers hold it transformed by |model_mat|.
+  struct PlaneMesh {
+    uint64_t polygon_hash = 0;
+    int32_t polygon_length = 0;
+    // Simplification level of the triangulation, -1 for the full polygon.
+    int lod_level = -1;
+    // Distance of the farthest polygon vertex from the plane center.
+    float radius = 0.0f;
+    uint32_t last_frame = 0;
+    glm::mat4 model_mat = glm::mat4(1.0f);
+    glm::vec3 normal = glm::vec3(0.0f);
+    glm::vec3 color = glm::vec3(0.0f);
+    std::vector<glm::vec3> vertices;
+    std::vector<GLushort> triangles;
+    // Ranges in the shared buffers, empty while the plane is not drawn.
+    RangeAllocator::Range vertex_range;
+    RangeAllocator::Range index_range;
+  };
+
+  // Level of detail for a plane whose polygon reaches |radius| from its
+  // center, given the level it has now.
+  int SelectLodLevel(const glm::mat4& model_mat, float radius,
+                     int current_level) const;
+  void Triangulate(const glm::vec2* polygon, int32_t vertices_size,
+                   PlaneMesh* mesh) const;
+  // Places |mesh| in the shared buffers and uploads it.
+  void UploadMesh(PlaneMesh* mesh);
+  bool AllocateRanges(uint32_t vertex_size, uint32_t index_size,
+                      PlaneMesh* mesh);
+  // Returns the ranges of |mesh| and fills its indices with degenerate
+  // triangles.
+  void ReleaseRanges(PlaneMesh* mesh);
+  // Reallocates the shared buffers with room for at least the given number of
+  // additional elements and uploads every placed mesh again, packed at the
+  // start.  Returns false if the indices cannot address the vertices.
+  bool GrowBuffers(uint32_t extra_vertices, uint32_t extra_indices);
+
+  FrameArena* const frame_arena_;
+  ArObjectPool<ArPose>* const pose_pool_;
+  GpuMemoryTracker* const gpu_memory_;
+
+  // Keyed by plane handle.  A handle reused for another plane is caught by the
+  // polygon hash.
+  std::unordered_map<const ArPlane*, PlaneMesh> meshes_;
+  uint32_t frame_ = 0;
+  float lod_tolerance_pixels_ = 1.0f;
+  glm::mat4 view_projection_mat_ = glm::mat4(1.0f);
+  glm::vec3 camera_position_ = glm::vec3(0.0f);
+  // Focal length of the projection in pixels.
+  float focal_length_pixels_ = 1.0f;
 
-  std::vector<glm::vec3> vertices_;
-  std::vector<GLushort> triangles_;
-  glm::mat4 model_mat_ = glm::mat4(1.0f);
-  glm::vec3 normal_vec_ = glm::vec3(0.0f);
+  GLuint vertex_buffer_ = 0;
+  GLuint index_buffer_ = 0;
+  RangeAllocator vertex_ranges_;
+  RangeAllocator index_ranges_;
+  // Staging for uploads, kept to avoid reallocating it.
+  std::vector<Vertex> vertex_scratch_;
+  std::vector<GLuint> index_scratch_;
+  Stats stats_;
 
   GLuint texture_id_;
 
   GLuint shader_program_;
   GLint attri_vertices_;
+  GLint attri_uvs_;
+  GLint attri_colors_;
   GLint uniform_mvp_mat_;
   GLint uniform_texture_;
-  GLint uniform_model_mat_;
-  GLint uniform_normal_vec_;
-  GLint uniform_color_;
 };
 }  // namespace hello_ar
 
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "program_cache.h"
+
+#include <EGL/egl.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "asset_view.h"
+#include "util.h"
+
+namespace hello_ar {
+namespace {
+
+constexpr char kFileMagic[4] = {'G', 'P', 'B', 'C'};
+constexpr uint32_t kFileVersion = 1;
+
+struct ProgramCacheFileHeader {
+  char magic[4];
+  uint32_t version;
+  uint64_t key;
+  uint32_t binary_format;
+  uint32_t binary_size;
+};
+static_assert(sizeof(ProgramCacheFileHeader) == 24,
+              "ProgramCacheFileHeader layout changed");
+
+// FNV-1a, continued from |hash|.  A nul is hashed after the data, so
+// adjacent strings cannot run into each other.
+uint64_t Hash(const char* data, size_t size,
+              uint64_t hash = 14695981039346656037ull) {
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ull;
+  }
+  return hash * 1099511628211ull;
+}
+
+std::string GlString(GLenum name) {
+  const GLubyte* value = glGetString(name);
+  return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+float MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<float, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+}  // namespace
+
+void ProgramCache::SetDirectory(const std::string& directory) {
+  directory_ = directory;
+  if (!directory_.empty() && mkdir(directory_.c_str(), 0700) != 0 &&
+      errno != EEXIST) {
+    LOGE("Could not create program cache directory %s", directory_.c_str());
+    directory_.clear();
+  }
+}
+
+void ProgramCache::OnContextCreated() {
+  stats_ = Stats();
+  gl_renderer_ = GlString(GL_RENDERER);
+  gl_version_ = GlString(GL_VERSION);
+
+  GLint format_count = 0;
+  const std::string extensions = GlString(GL_EXTENSIONS);
+  if (extensions.find("GL_OES_get_program_binary") != std::string::npos) {
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &format_count);
+    get_program_binary_ = reinterpret_cast<PFNGLGETPROGRAMBINARYOESPROC>(
+        eglGetProcAddress("glGetProgramBinaryOES"));
+    program_binary_ = reinterpret_cast<PFNGLPROGRAMBINARYOESPROC>(
+        eglGetProcAddress("glProgramBinaryOES"));
+  }
+  supported_ = format_count > 0 && get_program_binary_ && program_binary_;
+  if (!supported_) {
+    LOGI("Program binaries not supported, shaders are compiled on start");
+  }
+}
+
+GLuint ProgramCache::CreateProgram(const char* vertex_shader_file_name,
+                                   const char* fragment_shader_file_name,
+                                   AAssetManager* asset_manager) {
+  const auto start = std::chrono::steady_clock::now();
+
+  AssetView vertex_shader;
+  AssetView fragment_shader;
+  if (!vertex_shader.OpenAsset(asset_manager, vertex_shader_file_name) ||
+      !fragment_shader.OpenAsset(asset_manager, fragment_shader_file_name)) {
+    return 0;
+  }
+
+  const bool use_cache = supported_ && !directory_.empty();
+  uint64_t key = 0;
+  std::string path;
+  if (use_cache) {
+    key = Hash(vertex_shader.chars(), vertex_shader.size());
+    key = Hash(fragment_shader.chars(), fragment_shader.size(), key);
+    key = Hash(gl_renderer_.data(), gl_renderer_.size(), key);
+    key = Hash(gl_version_.data(), gl_version_.size(), key);
+    path = CachePath(vertex_shader_file_name, fragment_shader_file_name);
+
+    if (const GLuint program = LoadBinary(path, key)) {
+      stats_.cache_hits++;
+      stats_.cache_hit_ms += MillisecondsSince(start);
+      return program;
+    }
+  }
+
+  const GLuint program = util::CreateProgramFromSource(
+      vertex_shader.chars(), vertex_shader.size(), fragment_shader.chars(),
+      fragment_shader.size());
+  if (program && use_cache) {
+    StoreBinary(path, key, program);
+  }
+  stats_.compiled++;
+  stats_.compile_ms += MillisecondsSince(start);
+  return program;
+}
+
+std::string ProgramCache::CachePath(
+    const char* vertex_shader_file_name,
+    const char* fragment_shader_file_name) const {
+  std::string name = std::string(vertex_shader_file_name) + "+" +
+                     fragment_shader_file_name + ".bin";
+  for (char& c : name) {
+    if (c == '/') c = '_';
+  }
+  return directory_ + "/" + name;
+}
+
+GLuint ProgramCache::LoadBinary(const std::string& path, uint64_t key) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) return 0;
+
+  ProgramCacheFileHeader header;
+  std::vector<uint8_t> binary;
+  struct stat file_stat;
+  bool ok = fstat(fileno(file), &file_stat) == 0 &&
+            fread(&header, sizeof(header), 1, file) == 1 &&
+            memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) == 0 &&
+            header.version == kFileVersion && header.key == key;
+  // The binary is the rest of the file.  A truncated or corrupt file must not
+  // make us allocate whatever size its header claims.
+  ok = ok && header.binary_size > 0 &&
+       static_cast<uint64_t>(file_stat.st_size) ==
+           sizeof(header) + static_cast<uint64_t>(header.binary_size);
+  if (ok) {
+    binary.resize(header.binary_size);
+    ok = fread(binary.data(), 1, binary.size(), file) == binary.size();
+  }
+  fclose(file);
+  if (!ok) {
+    LOGI("Program cache file %s is stale", path.c_str());
+    return 0;
+  }
+
+  GLuint program = glCreateProgram();
+  program_binary_(program, header.binary_format, binary.data(),
+                  header.binary_size);
+  GLint link_status = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &link_status);
+  if (link_status != GL_TRUE) {
+    // The driver can reject binaries for reasons the key does not cover.
+    LOGI("Driver rejected cached program %s", path.c_str());
+    glDeleteProgram(program);
+    remove(path.c_str());
+    return 0;
+  }
+  return program;
+}
+
+void ProgramCache::StoreBinary(const std::string& path, uint64_t key,
+                               GLuint program) {
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+  if (length <= 0) return;
+
+  std::vector<uint8_t> binary(length);
+  GLsizei written = 0;
+  GLenum format = 0;
+  get_program_binary_(program, length, &written, &format, binary.data());
+  if (written <= 0) return;
+
+  ProgramCacheFileHeader header;
+  memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+  header.version = kFileVersion;
+  header.key = key;
+  header.binary_format = format;
+  header.binary_size = static_cast<uint32_t>(written);
+
+  // Write to a temporary file and rename it, so a crash never leaves a
+  // truncated cache file behind.
+  const std::string temp_path = path + ".tmp";
+  FILE* file = fopen(temp_path.c_str(), "wb");
+  if (!file) {
+    LOGE("Could not write program cache file %s", temp_path.c_str());
+    return;
+  }
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(binary.data(), 1, written, file) ==
+                static_cast<size_t>(written);
+  ok = fclose(file) == 0 && ok;
+  if (!ok || rename(temp_path.c_str(), path.c_str()) != 0) {
+    LOGE("Could not write program cache file %s", path.c_str());
+    remove(temp_path.c_str());
+  }
+}
+
+}  // namespace hello_ar
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_PROGRAM_CACHE_H_
+#define C_ARCORE_HELLO_AR_PROGRAM_CACHE_H_
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <android/asset_manager.h>
+
+#include <cstdint>
+#include <string>
+
+namespace hello_ar {
+
+// Keeps linked shader programs as driver binaries (GL_OES_get_program_binary)
+// in app storage, so creating the GL surface does not compile GLSL on every
+// resume.  Each program has one file, tagged with a hash of both shader
+// sources, GL_RENDERER and GL_VERSION.  When any of them changes, or the
+// driver rejects the binary, the program is compiled from source and the file
+// is rewritten.
+//
+// Not thread safe: owned and used by the render thread.
+class ProgramCache {
+ public:
+  struct Stats {
+    int cache_hits = 0;
+    int compiled = 0;
+    float cache_hit_ms = 0.f;
+    float compile_ms = 0.f;
+  };
+
+  // Directory for the cache files, created if needed.  Empty (the default)
+  // disables the cache and every program is compiled.
+  void SetDirectory(const std::string& directory);
+
+  // Reads the GL strings and extension support of the current context and
+  // resets the stats.  Call on the OpenGL thread when the surface is created,
+  // before CreateProgram().
+  void OnContextCreated();
+
+  // Like util::CreateProgram(), through the cache.
+  GLuint CreateProgram(const char* vertex_shader_file_name,
+                       const char* fragment_shader_file_name,
+                       AAssetManager* asset_manager);
+
+  // Programs created since OnContextCreated().
+  const Stats& stats() const { return stats_; }
+
+ private:
+  std::string CachePath(const char* vertex_shader_file_name,
+                        const char* fragment_shader_file_name) const;
+  GLuint LoadBinary(const std::string& path, uint64_t key);
+  void StoreBinary(const std::string& path, uint64_t key, GLuint program);
+
+  std::string directory_;
+  std::string gl_renderer_;
+  std::string gl_version_;
+  bool supported_ = false;
+  PFNGLGETPROGRAMBINARYOESPROC get_program_binary_ = nullptr;
+  PFNGLPROGRAMBINARYOESPROC program_binary_ = nullptr;
+  Stats stats_;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_PROGRAM_CACHE_H_
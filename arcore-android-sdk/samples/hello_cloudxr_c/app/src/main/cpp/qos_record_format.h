@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_QOS_RECORD_FORMAT_H_
+#define C_ARCORE_HELLO_AR_QOS_RECORD_FORMAT_H_
+
+#include <cstdint>
+
+// On-disk layout of the connection QoS time series written by QosRecorder and
+// read back by the host-side tools/qos_decode utility.  This header must stay
+// free of Android and CloudXR dependencies so it can be built on the host.
+//
+// A file is a QosFileHeader followed by |capacity| fixed-size QosRecords.  The
+// file is preallocated and records are appended in place, so a record with a
+// zero timestamp marks the end of valid data even if |record_count| was not
+// updated (for example after a crash).
+namespace hello_ar {
+namespace qos {
+
+constexpr char kFileMagic[8] = {'C', 'X', 'R', 'Q', 'O', 'S', '\0', '\0'};
+constexpr uint32_t kFileVersion = 1;
+
+struct QosFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t record_size;
+  uint32_t capacity;
+  uint32_t interval_ms;
+  uint32_t record_count;
+  // Wall clock time the file was started, in milliseconds since the epoch.
+  uint64_t start_time_ms;
+  uint32_t reserved[8];
+};
+static_assert(sizeof(QosFileHeader) == 72, "QosFileHeader layout changed");
+
+// One sample of cxrConnectionStats.
+struct QosRecord {
+  // Wall clock time of the sample, in milliseconds since the epoch.
+  uint64_t timestamp_ms;
+  float frames_per_second;
+  float frame_delivery_time_ms;
+  float frame_queue_time_ms;
+  float frame_latch_time_ms;
+  uint32_t bandwidth_available_kbps;
+  uint32_t bandwidth_utilization_kbps;
+  uint32_t bandwidth_utilization_percent;
+  uint32_t round_trip_delay_ms;
+  uint32_t jitter_us;
+  uint32_t total_packets_received;
+  uint32_t total_packets_lost;
+  uint32_t total_packets_dropped;
+  uint32_t quality;
+  uint32_t quality_reasons;
+};
+static_assert(sizeof(QosRecord) == 64, "QosRecord layout changed");
+
+}  // namespace qos
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_QOS_RECORD_FORMAT_H_
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "qos_recorder.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "util.h"
+
+namespace hello_ar {
+namespace {
+constexpr char kFileBaseName[] = "cloudxr_qos";
+
+uint64_t WallClockMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+}  // namespace
+
+bool QosRecorder::Start(const Config& config, cxrReceiverHandle receiver) {
+  Stop();
+
+  config_ = config;
+  if (config_.interval_ms == 0) config_.interval_ms = 1;
+  if (config_.max_files == 0) config_.max_files = 1;
+  if (config_.max_file_kb == 0) config_.max_file_kb = 1;
+  receiver_ = receiver;
+  dropped_records_ = 0;
+
+  // A new session never overwrites the last one, rotate it out first.
+  RotateFiles();
+  if (!OpenFile()) {
+    return false;
+  }
+
+  LOGI("Recording connection QoS every %ums to %s", config_.interval_ms,
+       FilePath(0).c_str());
+  running_ = true;
+  thread_ = std::thread(&QosRecorder::SampleLoop, this);
+  return true;
+}
+
+void QosRecorder::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) return;
+    running_ = false;
+  }
+  wake_.notify_one();
+  thread_.join();
+
+  CloseFile();
+  receiver_ = nullptr;
+}
+
+void QosRecorder::SampleLoop() {
+  const auto interval = std::chrono::milliseconds(config_.interval_ms);
+  auto next_sample = std::chrono::steady_clock::now();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_) {
+    next_sample += interval;
+    if (wake_.wait_until(lock, next_sample, [this] { return !running_; })) {
+      break;
+    }
+
+    cxrConnectionStats stats = {};
+    if (cxrGetConnectionStats(receiver_, &stats) != cxrError_Success) {
+      continue;
+    }
+
+    Append(stats);
+  }
+}
+
+std::string QosRecorder::FilePath(uint32_t index) const {
+  std::string path = config_.directory + "/" + kFileBaseName;
+  if (index > 0) {
+    path += "." + std::to_string(index);
+  }
+  return path + ".bin";
+}
+
+void QosRecorder::RotateFiles() {
+  // Drop the oldest file, then shift the others up by one.
+  unlink(FilePath(config_.max_files - 1).c_str());
+  for (uint32_t index = config_.max_files - 1; index > 0; index--) {
+    rename(FilePath(index - 1).c_str(), FilePath(index).c_str());
+  }
+}
+
+bool QosRecorder::OpenFile() {
+  const uint32_t capacity = std::max<uint32_t>(
+      1, (config_.max_file_kb * 1024 - sizeof(qos::QosFileHeader)) /
+             sizeof(qos::QosRecord));
+  const size_t file_size =
+      sizeof(qos::QosFileHeader) + capacity * sizeof(qos::QosRecord);
+
+  const std::string path = FilePath(0);
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0) {
+    // Only the first failure is logged, Append() retries every sample.
+    if (dropped_records_ == 0) {
+      LOGE("Unable to open QoS record file %s: %s", path.c_str(),
+           strerror(errno));
+    }
+    return false;
+  }
+
+  if (ftruncate(fd_, file_size) != 0) {
+    if (dropped_records_ == 0) {
+      LOGE("Unable to size QoS record file %s: %s", path.c_str(),
+           strerror(errno));
+    }
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+
+  void* mapping =
+      mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (mapping == MAP_FAILED) {
+    if (dropped_records_ == 0) {
+      LOGE("Unable to map QoS record file %s: %s", path.c_str(),
+           strerror(errno));
+    }
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+
+  mapped_size_ = file_size;
+  header_ = static_cast<qos::QosFileHeader*>(mapping);
+  records_ = reinterpret_cast<qos::QosRecord*>(header_ + 1);
+
+  memcpy(header_->magic, qos::kFileMagic, sizeof(header_->magic));
+  header_->version = qos::kFileVersion;
+  header_->header_size = sizeof(qos::QosFileHeader);
+  header_->record_size = sizeof(qos::QosRecord);
+  header_->capacity = capacity;
+  header_->interval_ms = config_.interval_ms;
+  header_->record_count = 0;
+  header_->start_time_ms = WallClockMs();
+  return true;
+}
+
+void QosRecorder::CloseFile() {
+  if (header_) {
+    msync(header_, mapped_size_, MS_SYNC);
+    munmap(header_, mapped_size_);
+    header_ = nullptr;
+    records_ = nullptr;
+    mapped_size_ = 0;
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+void QosRecorder::Append(const cxrConnectionStats& stats) {
+  if (header_ && header_->record_count >= header_->capacity) {
+    CloseFile();
+    RotateFiles();
+  }
+  // A file that could not be opened after rotating, e.g. with the storage
+  // full, is retried on the next sample rather than ending the recording.
+  if (!header_ && !OpenFile()) {
+    dropped_records_++;
+    return;
+  }
+  if (dropped_records_ > 0) {
+    LOGI("QoS recording resumed, %u samples dropped", dropped_records_);
+    dropped_records_ = 0;
+  }
+
+  qos::QosRecord& record = records_[header_->record_count];
+  record.frames_per_second = stats.framesPerSecond;
+  record.frame_delivery_time_ms = stats.frameDeliveryTimeMs;
+  record.frame_queue_time_ms = stats.frameQueueTimeMs;
+  record.frame_latch_time_ms = stats.frameLatchTimeMs;
+  record.bandwidth_available_kbps = stats.bandwidthAvailableKbps;
+  record.bandwidth_utilization_kbps = stats.bandwidthUtilizationKbps;
+  record.bandwidth_utilization_percent = stats.bandwidthUtilizationPercent;
+  record.round_trip_delay_ms = stats.roundTripDelayMs;
+  record.jitter_us = stats.jitterUs;
+  record.total_packets_received = stats.totalPacketsReceived;
+  record.total_packets_lost = stats.totalPacketsLost;
+  record.total_packets_dropped = stats.totalPacketsDropped;
+  record.quality = static_cast<uint32_t>(stats.quality);
+  record.quality_reasons = stats.qualityReasons;
+  // The timestamp marks the record valid, so it is written last.
+  record.timestamp_ms = WallClockMs();
+  header_->record_count++;
+}
+
+}  // namespace hello_ar
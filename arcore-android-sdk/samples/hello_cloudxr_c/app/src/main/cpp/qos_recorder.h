@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_QOS_RECORDER_H_
+#define C_ARCORE_HELLO_AR_QOS_RECORDER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "CloudXRClient.h"
+#include "qos_record_format.h"
+
+namespace hello_ar {
+
+// QosRecorder samples cxrGetConnectionStats on a background thread at a fixed
+// interval and appends the samples to a memory-mapped binary file (see
+// qos_record_format.h).  Files are preallocated to a fixed size; once full the
+// current file is rotated to <name>.1.bin, and only the newest |max_files|
+// files are kept so on-device storage stays bounded.
+class QosRecorder {
+ public:
+  struct Config {
+    // Directory the cloudxr_qos*.bin files are written to.
+    std::string directory;
+    uint32_t interval_ms = 1000;
+    // Size cap of a single file, in kilobytes.
+    uint32_t max_file_kb = 1024;
+    // Number of files kept, including the one being written.
+    uint32_t max_files = 4;
+  };
+
+  QosRecorder() = default;
+  ~QosRecorder() { Stop(); }
+
+  // Starts sampling |receiver|.  The receiver must stay valid until Stop()
+  // returns.
+  bool Start(const Config& config, cxrReceiverHandle receiver);
+  void Stop();
+
+  QosRecorder(const QosRecorder&) = delete;
+  void operator=(const QosRecorder&) = delete;
+
+ private:
+  void SampleLoop();
+  bool OpenFile();
+  void CloseFile();
+  void RotateFiles();
+  void Append(const cxrConnectionStats& stats);
+  std::string FilePath(uint32_t index) const;
+
+  Config config_;
+  cxrReceiverHandle receiver_ = nullptr;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::thread thread_;
+  bool running_ = false;
+
+  // Samples dropped since the current file could not be opened.
+  uint32_t dropped_records_ = 0;
+
+  int fd_ = -1;
+  size_t mapped_size_ = 0;
+  qos::QosFileHeader* header_ = nullptr;
+  qos::QosRecord* records_ = nullptr;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_QOS_RECORDER_H_
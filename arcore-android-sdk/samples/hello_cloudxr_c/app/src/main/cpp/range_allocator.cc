@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "range_allocator.h"
+
+namespace hello_ar {
+
+void RangeAllocator::Reset(uint32_t capacity) {
+  capacity_ = capacity;
+  allocated_ = 0;
+  free_.clear();
+  if (capacity > 0) free_.push_back(Range{0, capacity});
+}
+
+bool RangeAllocator::Allocate(uint32_t size, Range* range) {
+  if (size == 0) {
+    *range = Range{0, 0};
+    return true;
+  }
+  for (size_t i = 0; i < free_.size(); ++i) {
+    Range& candidate = free_[i];
+    if (candidate.size < size) continue;
+    *range = Range{candidate.offset, size};
+    candidate.offset += size;
+    candidate.size -= size;
+    if (candidate.size == 0) free_.erase(free_.begin() + i);
+    allocated_ += size;
+    return true;
+  }
+  return false;
+}
+
+void RangeAllocator::Free(const Range& range) {
+  if (range.size == 0) return;
+  allocated_ -= range.size;
+
+  size_t i = 0;
+  while (i < free_.size() && free_[i].offset < range.offset) ++i;
+  const bool joins_previous =
+      i > 0 && free_[i - 1].offset + free_[i - 1].size == range.offset;
+  const bool joins_next =
+      i < free_.size() && range.offset + range.size == free_[i].offset;
+  if (joins_previous && joins_next) {
+    free_[i - 1].size += range.size + free_[i].size;
+    free_.erase(free_.begin() + i);
+  } else if (joins_previous) {
+    free_[i - 1].size += range.size;
+  } else if (joins_next) {
+    free_[i].offset = range.offset;
+    free_[i].size += range.size;
+  } else {
+    free_.insert(free_.begin() + i, range);
+  }
+}
+
+}  // namespace hello_ar
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_RANGE_ALLOCATOR_H_
+#define C_ARCORE_HELLO_AR_RANGE_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hello_ar {
+
+// First-fit allocator of ranges within a buffer of |capacity| elements, for
+// sub-allocating meshes from one shared GL buffer.  Freed ranges are merged
+// with their free neighbours.  Holds no memory of the buffer itself.
+//
+// Not thread safe: owned and used by the render thread.
+class RangeAllocator {
+ public:
+  struct Range {
+    uint32_t offset = 0;
+    uint32_t size = 0;
+  };
+
+  explicit RangeAllocator(uint32_t capacity = 0) { Reset(capacity); }
+
+  // Frees every range and sets the capacity.
+  void Reset(uint32_t capacity);
+
+  // Returns false if there is no free range of |size| elements.
+  bool Allocate(uint32_t size, Range* range);
+  void Free(const Range& range);
+
+  uint32_t capacity() const { return capacity_; }
+  uint32_t allocated() const { return allocated_; }
+  // End of the highest allocated range.
+  uint32_t end() const {
+    return !free_.empty() &&
+                   free_.back().offset + free_.back().size == capacity_
+               ? free_.back().offset
+               : capacity_;
+  }
+
+ private:
+  uint32_t capacity_ = 0;
+  uint32_t allocated_ = 0;
+  // Free ranges sorted by offset, none adjacent to another.
+  std::vector<Range> free_;
+};
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_RANGE_ALLOCATOR_H_
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "texture_asset.h"
+
+#include <GLES2/gl2.h>
+
+#include "asset_view.h"
+#include "texture_format.h"
+#include "util.h"
+
+namespace hello_ar {
+namespace {
+// OpenGL ES 3.0, absent from the GLES2 headers.
+constexpr GLenum kGlTextureMaxLevel = 0x813D;
+}  // namespace
+
+bool LoadKtxTexture(AAssetManager* asset_manager, const char* file_name,
+                    size_t* texture_bytes) {
+  AssetView view;
+  if (!view.OpenAsset(asset_manager, file_name)) return false;
+  ktx::KtxFileHeader header;
+  ktx::KtxLevel levels[ktx::kMaxLevels];
+  if (!ktx::ParseKtxFile(view.data(), view.size(), &header, levels)) {
+    LOGE("%s is not a valid KTX file", file_name);
+    return false;
+  }
+
+  // Clear stale errors so the check below only sees the uploads'.
+  while (glGetError() != GL_NO_ERROR) {
+  }
+  size_t bytes = 0;
+  for (uint32_t i = 0; i < header.number_of_mipmap_levels; ++i) {
+    const ktx::KtxLevel& level = levels[i];
+    if (header.gl_type == 0) {
+      glCompressedTexImage2D(GL_TEXTURE_2D, i, header.gl_internal_format,
+                             level.width, level.height, 0, level.size,
+                             view.data() + level.offset);
+    } else {
+      glTexImage2D(GL_TEXTURE_2D, i, header.gl_base_internal_format,
+                   level.width, level.height, 0, header.gl_format,
+                   header.gl_type, view.data() + level.offset);
+    }
+    bytes += level.size;
+  }
+  if (glGetError() != GL_NO_ERROR) {
+    LOGE("Could not upload %s, format 0x%x", file_name,
+         header.gl_internal_format);
+    return false;
+  }
+  // Files may stop short of the 1x1 level.
+  glTexParameteri(GL_TEXTURE_2D, kGlTextureMaxLevel,
+                  header.number_of_mipmap_levels - 1);
+
+  if (texture_bytes) *texture_bytes = bytes;
+  return true;
+}
+
+}  // namespace hello_ar
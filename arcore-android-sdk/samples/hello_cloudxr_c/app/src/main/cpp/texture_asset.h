@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_TEXTURE_ASSET_H_
+#define C_ARCORE_HELLO_AR_TEXTURE_ASSET_H_
+
+#include <android/asset_manager.h>
+
+#include <cstddef>
+
+namespace hello_ar {
+
+// Uploads the KTX file |file_name| (see texture_format.h), relative to the
+// assets folder, with all its mip levels to the texture bound to
+// GL_TEXTURE_2D.  The levels go to glCompressedTexImage2D() straight from the
+// mapped asset, without decoding or mipmap generation.  Returns false if the
+// file is missing or invalid, or the GL rejects its format, e.g. ASTC without
+// GL_KHR_texture_compression_astc_ldr.  |texture_bytes|, if set, receives
+// the size of all levels in GPU memory.
+bool LoadKtxTexture(AAssetManager* asset_manager, const char* file_name,
+                    size_t* texture_bytes);
+
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_TEXTURE_ASSET_H_
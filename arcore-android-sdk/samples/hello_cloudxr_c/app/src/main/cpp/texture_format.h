@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_TEXTURE_FORMAT_H_
+#define C_ARCORE_HELLO_AR_TEXTURE_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Layout of the KTX 1.1 texture files written by the texture_convert host
+// tool and mapped at runtime.  This header must stay free of Android and GL
+// dependencies.
+//
+// A file is a KtxFileHeader, key/value data that is skipped, then for each
+// mip level from the largest down a uint32 byte size followed by the level's
+// image, padded to 4 bytes.  Only single 2D textures are supported, not
+// arrays, cubemaps or 3D textures.  Values are little endian.
+namespace hello_ar {
+namespace ktx {
+
+constexpr uint8_t kFileIdentifier[12] = {0xAB, 'K',  'T',  'X',  ' ',  '1',
+                                         '1',  0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr uint32_t kEndianness = 0x04030201;
+constexpr uint32_t kMaxLevels = 16;
+
+// GL enums used in the header.
+constexpr uint32_t kGlUnsignedByte = 0x1401;
+constexpr uint32_t kGlRgb = 0x1907;
+constexpr uint32_t kGlRgba = 0x1908;
+constexpr uint32_t kGlRgba8 = 0x8058;
+constexpr uint32_t kGlCompressedRgb8Etc2 = 0x9274;
+constexpr uint32_t kGlCompressedRgba8Etc2Eac = 0x9278;
+
+struct KtxFileHeader {
+  uint8_t identifier[12];
+  uint32_t endianness;
+  // Zero for compressed formats.
+  uint32_t gl_type;
+  uint32_t gl_type_size;
+  uint32_t gl_format;
+  uint32_t gl_internal_format;
+  uint32_t gl_base_internal_format;
+  uint32_t pixel_width;
+  uint32_t pixel_height;
+  uint32_t pixel_depth;
+  uint32_t number_of_array_elements;
+  uint32_t number_of_faces;
+  uint32_t number_of_mipmap_levels;
+  uint32_t bytes_of_key_value_data;
+};
+static_assert(sizeof(KtxFileHeader) == 64, "KtxFileHeader layout changed");
+
+// One mip level's image within the file.
+struct KtxLevel {
+  uint32_t width;
+  uint32_t height;
+  uint32_t offset;
+  uint32_t size;
+};
+
+inline uint32_t PadLevelSize(uint32_t size) { return (size + 3) & ~3u; }
+
+// Checks the header of the |size| byte file at |data| and that all its mip
+// levels lie within the file.  Fills |header| and the first
+// |header->number_of_mipmap_levels| entries of |levels|.
+inline bool ParseKtxFile(const void* data, size_t size, KtxFileHeader* header,
+                         KtxLevel levels[kMaxLevels]) {
+  if (size < sizeof(KtxFileHeader)) return false;
+  memcpy(header, data, sizeof(*header));
+  if (memcmp(header->identifier, kFileIdentifier, sizeof(kFileIdentifier)) !=
+          0 ||
+      header->endianness != kEndianness || header->pixel_width == 0 ||
+      header->pixel_height == 0 || header->pixel_depth != 0 ||
+      header->number_of_array_elements != 0 || header->number_of_faces != 1 ||
+      header->number_of_mipmap_levels == 0 ||
+      header->number_of_mipmap_levels > kMaxLevels) {
+    return false;
+  }
+
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint64_t offset =
+      uint64_t(sizeof(KtxFileHeader)) + header->bytes_of_key_value_data;
+  for (uint32_t i = 0; i < header->number_of_mipmap_levels; ++i) {
+    if (offset + sizeof(uint32_t) > size) return false;
+    uint32_t level_size;
+    memcpy(&level_size, bytes + offset, sizeof(level_size));
+    offset += sizeof(uint32_t);
+    if (offset + level_size > size) return false;
+    levels[i].width = header->pixel_width >> i ? header->pixel_width >> i : 1;
+    levels[i].height =
+        header->pixel_height >> i ? header->pixel_height >> i : 1;
+    levels[i].offset = static_cast<uint32_t>(offset);
+    levels[i].size = level_size;
+    offset += PadLevelSize(level_size);
+  }
+  return true;
+}
+
+}  // namespace ktx
+}  // namespace hello_ar
+
+#endif  // C_ARCORE_HELLO_AR_TEXTURE_FORMAT_H_
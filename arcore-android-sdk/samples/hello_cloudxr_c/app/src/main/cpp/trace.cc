@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "trace.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#include "util.h"
+
+namespace hello_ar {
+namespace trace {
+
+std::atomic<bool> g_enabled{false};
+
+namespace {
+std::atomic<uint32_t> g_epoch{0};
+}  // namespace
+
+namespace {
+// Per-thread event capacity.  At 60fps with ~20 events per frame this holds
+// several seconds of events, far more than one flush interval.
+constexpr uint32_t kBufferCapacity = 8192;
+constexpr auto kFlushInterval = std::chrono::milliseconds(250);
+
+struct Event {
+  const char* name;
+  int64_t timestamp_ns;
+  int64_t value;
+  // Trace session the event was recorded in, events left over from a
+  // previous session are discarded rather than written to the new file.
+  uint32_t epoch;
+  EventType type;
+};
+
+// Single-producer/single-consumer ring.  The owning thread is the only
+// writer of |head|, the flush thread is the only writer of |tail|.  Buffers
+// form an intrusive list that is only ever pushed to, so a thread can
+// register its buffer without taking the flush thread's lock.
+struct ThreadBuffer {
+  explicit ThreadBuffer(uint32_t thread_id) : tid(thread_id) {}
+
+  const uint32_t tid;
+  ThreadBuffer* next = nullptr;
+  std::atomic<uint32_t> head{0};
+  std::atomic<uint32_t> tail{0};
+  std::atomic<uint32_t> dropped{0};
+  Event events[kBufferCapacity];
+};
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+class TraceWriter {
+ public:
+  bool Start(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_) {
+      return path == path_;
+    }
+
+    file_ = fopen(path.c_str(), "w");
+    if (!file_) {
+      LOGE("Unable to open client trace file %s", path.c_str());
+      return false;
+    }
+    path_ = path;
+    first_event_ = true;
+    // Anything recorded between the previous Stop() and now belongs to
+    // neither session.
+    epoch_ = g_epoch.fetch_add(1, std::memory_order_relaxed) + 1;
+    DrainAll();
+    fputs("[", file_);
+    WriteMetadata("process_name", 0, "CloudXR ARCore Client");
+
+    running_ = true;
+    flush_thread_ = std::thread(&TraceWriter::FlushLoop, this);
+    g_enabled.store(true, std::memory_order_release);
+    LOGI("Client trace enabled, writing to %s", path.c_str());
+    return true;
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!file_) return;
+      g_enabled.store(false, std::memory_order_release);
+      running_ = false;
+    }
+    wake_.notify_one();
+    flush_thread_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    DrainAll();
+    fputs("\n]\n", file_);
+    fclose(file_);
+    file_ = nullptr;
+    LOGI("Client trace written to %s", path_.c_str());
+  }
+
+  ThreadBuffer* GetThreadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+      // Buffers are kept for the life of the process, as the owning thread
+      // keeps a pointer to it in thread local storage.
+      buffer = new ThreadBuffer(static_cast<uint32_t>(syscall(SYS_gettid)));
+      ThreadBuffer* head = buffers_.load(std::memory_order_relaxed);
+      do {
+        buffer->next = head;
+      } while (!buffers_.compare_exchange_weak(head, buffer,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+    }
+    return buffer;
+  }
+
+ private:
+  void FlushLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+      wake_.wait_for(lock, kFlushInterval);
+      DrainAll();
+      fflush(file_);
+    }
+  }
+
+  // Must be called with |mutex_| held.
+  void DrainAll() {
+    for (ThreadBuffer* buffer = buffers_.load(std::memory_order_acquire);
+         buffer; buffer = buffer->next) {
+      const uint32_t head = buffer->head.load(std::memory_order_acquire);
+      uint32_t tail = buffer->tail.load(std::memory_order_relaxed);
+      for (; tail != head; tail++) {
+        const Event& event = buffer->events[tail % kBufferCapacity];
+        if (event.epoch == epoch_) WriteEvent(buffer->tid, event);
+      }
+      buffer->tail.store(tail, std::memory_order_release);
+
+      const uint32_t dropped =
+          buffer->dropped.exchange(0, std::memory_order_relaxed);
+      if (dropped) {
+        LOGE("Client trace dropped %u events on thread %u", dropped,
+             buffer->tid);
+      }
+    }
+  }
+
+  void WriteSeparator() {
+    fputs(first_event_ ? "\n" : ",\n", file_);
+    first_event_ = false;
+  }
+
+  void WriteMetadata(const char* type, uint32_t tid, const char* value) {
+    WriteSeparator();
+    fprintf(file_,
+            "{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,"
+            "\"args\":{\"name\":\"%s\"}}",
+            type, getpid(), tid, value);
+  }
+
+  void WriteEvent(uint32_t tid, const Event& event) {
+    static const char kPhase[] = {'B', 'E', 'i', 'C'};
+    WriteSeparator();
+    // Chrome trace timestamps are in (fractional) microseconds.
+    fprintf(file_,
+            "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lld.%03lld,\"pid\":%d,"
+            "\"tid\":%u",
+            event.name, kPhase[static_cast<int>(event.type)],
+            static_cast<long long>(event.timestamp_ns / 1000),
+            static_cast<long long>(event.timestamp_ns % 1000), getpid(), tid);
+    if (event.type == EventType::kCounter) {
+      fprintf(file_, ",\"args\":{\"value\":%lld}",
+              static_cast<long long>(event.value));
+    } else if (event.type == EventType::kInstant) {
+      fputs(",\"s\":\"t\"", file_);
+    }
+    fputs("}", file_);
+  }
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::thread flush_thread_;
+  bool running_ = false;
+  bool first_event_ = true;
+  uint32_t epoch_ = 0;
+  FILE* file_ = nullptr;
+  std::string path_;
+  std::atomic<ThreadBuffer*> buffers_{nullptr};
+};
+
+TraceWriter& GetWriter() {
+  static TraceWriter* writer = new TraceWriter();
+  return *writer;
+}
+}  // namespace
+
+bool Start(const std::string& path) { return GetWriter().Start(path); }
+
+void Stop() { GetWriter().Stop(); }
+
+void Record(EventType type, const char* name, int64_t value) {
+  ThreadBuffer* buffer = GetWriter().GetThreadBuffer();
+  const uint32_t head = buffer->head.load(std::memory_order_relaxed);
+  if (head - buffer->tail.load(std::memory_order_acquire) >= kBufferCapacity) {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  Event& event = buffer->events[head % kBufferCapacity];
+  event.name = name;
+  event.timestamp_ns = NowNs();
+  event.value = value;
+  event.epoch = g_epoch.load(std::memory_order_relaxed);
+  event.type = type;
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+}  // namespace trace
+}  // namespace hello_ar
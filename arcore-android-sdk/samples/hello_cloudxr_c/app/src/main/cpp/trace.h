@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef C_ARCORE_HELLO_AR_TRACE_H_
+#define C_ARCORE_HELLO_AR_TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace hello_ar {
+
+// Lightweight client-side event tracing, written out in the Chrome JSON trace
+// format so the client frame loop can be loaded in chrome://tracing or the
+// Perfetto UI next to the CloudXR library's own stream event traces.
+//
+// Events are recorded into a fixed-size lock-free buffer owned by the calling
+// thread, and a background thread drains all buffers to the trace file.  When
+// tracing is not started the macros below cost a single relaxed atomic load.
+// Defining HELLO_AR_DISABLE_TRACE compiles them out entirely.
+namespace trace {
+
+enum class EventType : uint8_t {
+  kBegin,
+  kEnd,
+  kInstant,
+  kCounter,
+};
+
+extern std::atomic<bool> g_enabled;
+
+inline bool IsEnabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+// Opens the trace file and starts the flush thread.  Safe to call again with
+// the same path, returns false if the file can not be opened.
+bool Start(const std::string& path);
+
+// Drains any pending events, terminates the trace file and stops the flush
+// thread.
+void Stop();
+
+// Records an event on the calling thread.  |name| must be a string literal or
+// otherwise outlive the trace session.
+void Record(EventType type, const char* name, int64_t value = 0);
+
+// Records a begin event on construction and the matching end event when the
+// scope exits.
+class ScopedEvent {
+ public:
+  explicit ScopedEvent(const char* name) : name_(IsEnabled() ? name : nullptr) {
+    if (name_) Record(EventType::kBegin, name_);
+  }
+  ~ScopedEvent() {
+    if (name_) Record(EventType::kEnd, name_);
+  }
+  ScopedEvent(const ScopedEvent&) = delete;
+  void operator=(const ScopedEvent&) = delete;
+
+ private:
+  const char* name_;
+};
+
+}  // namespace trace
+}  // namespace hello_ar
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifndef HELLO_AR_DISABLE_TRACE
+#define TRACE_SCOPE(name) \
+  hello_ar::trace::ScopedEvent TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_INSTANT(name)                                            \
+  do {                                                                 \
+    if (hello_ar::trace::IsEnabled())                                  \
+      hello_ar::trace::Record(hello_ar::trace::EventType::kInstant,    \
+                              name);                                   \
+  } while (0)
+#define TRACE_COUNTER(name, value)                                     \
+  do {                                                                 \
+    if (hello_ar::trace::IsEnabled())                                  \
+      hello_ar::trace::Record(hello_ar::trace::EventType::kCounter,    \
+                              name, static_cast<int64_t>(value));      \
+  } while (0)
+#else
+#define TRACE_SCOPE(name) \
+  do {                    \
+  } while (0)
+#define TRACE_INSTANT(name) \
+  do {                      \
+  } while (0)
+#define TRACE_COUNTER(name, value) \
+  do {                             \
+  } while (0)
+#endif  // HELLO_AR_DISABLE_TRACE
+
+#endif  // C_ARCORE_HELLO_AR_TRACE_H_
@@ -16,10 +16,11 @@
 #include "util.h"
 
 #include <unistd.h>
-#include <sstream>
+#include <algorithm>
+#include <cstring>
 #include <string>
 
-#include "jni_interface.h"
+#include "asset_view.h"
 
 namespace hello_ar {
 namespace util {
@@ -36,13 +37,15 @@ void CheckGlError(const char* operation) {
 }
 
 // Convenience function used in CreateProgram below.
-static GLuint LoadShader(GLenum shader_type, const char* shader_source) {
+static GLuint LoadShader(GLenum shader_type, const char* shader_source,
+                         size_t shader_length) {
   GLuint shader = glCreateShader(shader_type);
   if (!shader) {
     return shader;
   }
 
-  glShaderSource(shader, 1, &shader_source, nullptr);
+  const GLint length = static_cast<GLint>(shader_length);
+  glShaderSource(shader, 1, &shader_source, &length);
   glCompileShader(shader);
   GLint compiled = 0;
   glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
@@ -74,28 +77,33 @@ static GLuint LoadShader(GLenum shader_type, const char* shader_source) {
 GLuint CreateProgram(const char* vertex_shader_file_name,
                      const char* fragment_shader_file_name,
                      AAssetManager* asset_manager) {
-  std::string VertexShaderContent;
-  if (!LoadTextFileFromAssetManager(vertex_shader_file_name, asset_manager,
-                                    &VertexShaderContent)) {
-    LOGE("Failed to load file: %s", vertex_shader_file_name);
+  AssetView vertex_shader;
+  if (!vertex_shader.OpenAsset(asset_manager, vertex_shader_file_name)) {
     return 0;
   }
 
-  std::string FragmentShaderContent;
-  if (!LoadTextFileFromAssetManager(fragment_shader_file_name, asset_manager,
-                                    &FragmentShaderContent)) {
-    LOGE("Failed to load file: %s", fragment_shader_file_name);
+  AssetView fragment_shader;
+  if (!fragment_shader.OpenAsset(asset_manager, fragment_shader_file_name)) {
     return 0;
   }
 
-  GLuint vertexShader =
-      LoadShader(GL_VERTEX_SHADER, VertexShaderContent.c_str());
+  return CreateProgramFromSource(vertex_shader.chars(), vertex_shader.size(),
+                                 fragment_shader.chars(),
+                                 fragment_shader.size());
+}
+
+GLuint CreateProgramFromSource(const char* vertex_shader_source,
+                               size_t vertex_shader_length,
+                               const char* fragment_shader_source,
+                               size_t fragment_shader_length) {
+  GLuint vertexShader = LoadShader(GL_VERTEX_SHADER, vertex_shader_source,
+                                   vertex_shader_length);
   if (!vertexShader) {
     return 0;
   }
 
-  GLuint fragment_shader =
-      LoadShader(GL_FRAGMENT_SHADER, FragmentShaderContent.c_str());
+  GLuint fragment_shader = LoadShader(
+      GL_FRAGMENT_SHADER, fragment_shader_source, fragment_shader_length);
   if (!fragment_shader) {
     return 0;
   }
@@ -127,84 +135,6 @@ GLuint CreateProgram(const char* vertex_shader_file_name,
   return program;
 }
 
-bool LoadTextFileFromAssetManager(const char* file_name,
-                                  AAssetManager* asset_manager,
-                                  std::string* out_file_text_string) {
-  // If the file hasn't been uncompressed, load it to the internal storage.
-  // Note that AAsset_openFileDescriptor doesn't support compressed
-  // files (.obj).
-  AAsset* asset =
-      AAssetManager_open(asset_manager, file_name, AASSET_MODE_STREAMING);
-  if (asset == nullptr) {
-    LOGE("Error opening asset %s", file_name);
-    return false;
-  }
-
-  off_t file_size = AAsset_getLength(asset);
-  out_file_text_string->resize(file_size);
-  int ret = AAsset_read(asset, &out_file_text_string->front(), file_size);
-
-  if (ret <= 0) {
-    LOGE("Failed to open file: %s", file_name);
-    AAsset_close(asset);
-    return false;
-  }
-
-  AAsset_close(asset);
-  return true;
-}
-
-bool LoadPngFromAssetManager(int target, const std::string& path) {
-  JNIEnv* env = GetJniEnv();
-
-  // Put all the JNI values in a structure that is statically initalized on the
-  // first call to this method.  This makes it thread safe in the unlikely case
-  // of multiple threads calling this method.
-  static struct JNIData {
-    jclass helper_class;
-    jmethodID load_image_method;
-    jmethodID load_texture_method;
-  } jniIds = [env]() -> JNIData {
-    constexpr char kHelperClassName[] =
-        "com/nvidia/ar/hellocloudxr/JniInterface";
-    constexpr char kLoadImageMethodName[] = "loadImage";
-    constexpr char kLoadImageMethodSignature[] =
-        "(Ljava/lang/String;)Landroid/graphics/Bitmap;";
-    constexpr char kLoadTextureMethodName[] = "loadTexture";
-    constexpr char kLoadTextureMethodSignature[] =
-        "(ILandroid/graphics/Bitmap;)V";
-    jclass helper_class = FindClass(kHelperClassName);
-    if (helper_class) {
-      helper_class = static_cast<jclass>(env->NewGlobalRef(helper_class));
-      jmethodID load_image_method = env->GetStaticMethodID(
-          helper_class, kLoadImageMethodName, kLoadImageMethodSignature);
-      jmethodID load_texture_method = env->GetStaticMethodID(
-          helper_class, kLoadTextureMethodName, kLoadTextureMethodSignature);
-      return {helper_class, load_image_method, load_texture_method};
-    }
-    LOGE("hello_ar::util::Could not find Java helper class %s",
-         kHelperClassName);
-    return {};
-  }();
-
-  if (!jniIds.helper_class) {
-    return false;
-  }
-
-  jstring j_path = env->NewStringUTF(path.c_str());
-
-  jobject image_obj = env->CallStaticObjectMethod(
-      jniIds.helper_class, jniIds.load_image_method, j_path);
-
-  if (j_path) {
-    env->DeleteLocalRef(j_path);
-  }
-
-  env->CallStaticVoidMethod(jniIds.helper_class, jniIds.load_texture_method,
-                            target, image_obj);
-  return true;
-}
-
 bool LoadObjFile(const std::string& file_name, AAssetManager* asset_manager,
                  std::vector<GLfloat>* out_vertices,
                  std::vector<GLfloat>* out_normals,
@@ -217,17 +147,25 @@ bool LoadObjFile(const std::string& file_name, AAssetManager* asset_manager,
   std::vector<GLushort> normal_indices;
   std::vector<GLushort> uv_indices;
 
-  std::string file_buffer;
-  bool read_success = LoadTextFileFromAssetManager(file_name.c_str(),
-                                                   asset_manager, &file_buffer);
-  if (!read_success) {
+  AssetView file;
+  if (!file.OpenAsset(asset_manager, file_name.c_str())) {
     return false;
   }
-  std::stringstream file_string_stream(file_buffer);
 
-  while (!file_string_stream.eof()) {
+  const char* next_line = file.chars();
+  const char* const file_end = file.chars() + file.size();
+  while (next_line < file_end) {
+    // Lines are parsed in place, one at a time, from a local copy that the
+    // tokenizer below can modify.
+    const char* line_end = static_cast<const char*>(
+        memchr(next_line, '\n', file_end - next_line));
+    if (!line_end) line_end = file_end;
     char line_header[128];
-    file_string_stream.getline(line_header, 128);
+    const size_t line_length =
+        std::min<size_t>(line_end - next_line, sizeof(line_header) - 1);
+    memcpy(line_header, next_line, line_length);
+    line_header[line_length] = '\0';
+    next_line = line_end + 1;
 
     if (line_header[0] == 'v' && line_header[1] == 'n') {
       // Parse vertex normal.
@@ -412,9 +350,19 @@ void GetTransformMatrixFromAnchor(const ArAnchor& ar_anchor,
     return;
   }
   util::ScopedArPose pose(ar_session);
-  ArAnchor_getPose(ar_session, &ar_anchor, pose.GetArPose());
-  ArPose_getMatrix(ar_session, pose.GetArPose(),
-                   glm::value_ptr(*out_model_mat));
+  GetTransformMatrixFromAnchor(ar_anchor, ar_session, pose.GetArPose(),
+                               out_model_mat);
+}
+
+void GetTransformMatrixFromAnchor(const ArAnchor& ar_anchor,
+                                  ArSession* ar_session, ArPose* scratch_pose,
+                                  glm::mat4* out_model_mat) {
+  if (out_model_mat == nullptr) {
+    LOGE("util::GetTransformMatrixFromAnchor model_mat is null.");
+    return;
+  }
+  ArAnchor_getPose(ar_session, &ar_anchor, scratch_pose);
+  ArPose_getMatrix(ar_session, scratch_pose, glm::value_ptr(*out_model_mat));
 }
 
 glm::vec3 GetPlaneNormal(const ArSession& ar_session,
@@ -25,6 +25,7 @@
 #include <jni.h>
 #include <cstdint>
 #include <cstdlib>
+#include <string>
 #include <vector>
 
 #include "arcore_c_api.h"
@@ -85,24 +86,18 @@ GLuint CreateProgram(const char* vertex_shader_file_name,
                      const char* fragment_shader_file_name,
                      AAssetManager* asset_manager);
 
-// Load a text file from assets folder.
+// Create a shader program ID from GLSL source, which need not be nul
+// terminated, e.g. an AssetView.
 //
-// @param asset_manager, AAssetManager pointer.
-// @param file_name, path to the file, relative to the assets folder.
-// @param out_string, output string.
-// @return true if the file is loaded correctly, otherwise false.
-bool LoadTextFileFromAssetManager(const char* file_name,
-                                  AAssetManager* asset_manager,
-                                  std::string* out_file_text_string);
-
-// Load png file from assets folder and then assign it to the OpenGL target.
-// This method must be called from the renderer thread since it will result in
-// OpenGL calls to assign the image to the texture target.
-//
-// @param target, openGL texture target to load the image into.
-// @param path, path to the file, relative to the assets folder.
-// @return true if png is loaded correctly, otherwise false.
-bool LoadPngFromAssetManager(int target, const std::string& path);
+// @param vertex_shader_source, the vertex shader source.
+// @param vertex_shader_length, length of the vertex shader source.
+// @param fragment_shader_source, the fragment shader source.
+// @param fragment_shader_length, length of the fragment shader source.
+// @return a non-zero value if the shader is created successfully, otherwise 0.
+GLuint CreateProgramFromSource(const char* vertex_shader_source,
+                               size_t vertex_shader_length,
+                               const char* fragment_shader_source,
+                               size_t fragment_shader_length);
 
 // Load obj file from assets folder from the app.
 //
@@ -113,6 +108,10 @@ bool LoadPngFromAssetManager(int target, const std::string& path);
 // @param out_uv, output texture UV coordinates.
 // @param out_indices, output triangle indices.
 // @return true if obj is loaded correctly, otherwise false.
+//
+// Writes every triangle corner as its own vertex, with 16-bit indices.
+// LoadObjMesh() in obj_loader.h builds an indexed mesh instead; this one is
+// kept as the baseline of the obj_parse benchmark.
 bool LoadObjFile(const std::string& file_name, AAssetManager* asset_manager,
                  std::vector<GLfloat>* out_vertices,
                  std::vector<GLfloat>* out_normals,
@@ -128,6 +127,11 @@ void GetTransformMatrixFromAnchor(const ArAnchor& ar_anchor,
                                   ArSession* ar_session,
                                   glm::mat4* out_model_mat);
 
+// As above, reading the pose into |scratch_pose| instead of creating one.
+void GetTransformMatrixFromAnchor(const ArAnchor& ar_anchor,
+                                  ArSession* ar_session, ArPose* scratch_pose,
+                                  glm::mat4* out_model_mat);
+
 // Get the plane's normal from center pose.
 glm::vec3 GetPlaneNormal(const ArSession& ar_session, const ArPose& plane_pose);
 
@@ -155,8 +155,8 @@ public class HelloArActivity extends AppCompatActivity
     // check for any data passed to our activity that we want to handle
     cmdlineFromIntent = getIntent().getStringExtra("args");
 
-    JniInterface.assetManager = getAssets();
     nativeApplication = JniInterface.createNativeApplication(getAssets());
+    JniInterface.setCacheDirectory(nativeApplication, getCodeCacheDir().getAbsolutePath());
 
     planeStatusCheckingHandler = new Handler();
   }
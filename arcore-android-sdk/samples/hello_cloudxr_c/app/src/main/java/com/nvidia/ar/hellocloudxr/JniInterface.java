@@ -40,11 +40,6 @@ package com.nvidia.ar.hellocloudxr;
 import android.app.Activity;
 import android.content.Context;
 import android.content.res.AssetManager;
-import android.graphics.Bitmap;
-import android.graphics.BitmapFactory;
-import android.opengl.GLUtils;
-import android.util.Log;
-import java.io.IOException;
 
 /** JNI interface to native layer. */
 public class JniInterface {
@@ -53,9 +48,6 @@ public class JniInterface {
     System.loadLibrary("CloudXRClient");
   }
 
-  private static final String TAG = "JniInterface";
-  static AssetManager assetManager;
-
   public static native long createNativeApplication(AssetManager assetManager);
   public static native void destroyNativeApplication(long nativeApplication);
 
@@ -64,6 +56,7 @@ public class JniInterface {
   public static native void handleLaunchOptions(long nativeApplication, String cmdline);
 
   public static native void setArgs(long nativeApplication, String args);
+  public static native void setCacheDirectory(long nativeApplication, String path);
   public static native String getServerIp(long nativeApplication);
 
   public static native void onResume(long nativeApplication, Context context, Activity activity);
@@ -86,18 +79,4 @@ public class JniInterface {
 
   /** Get plane count in current session. Used to disable the "searching for surfaces" snackbar. */
   public static native boolean hasDetectedPlanes(long nativeApplication);
-
-  public static Bitmap loadImage(String imageName) {
-
-    try {
-      return BitmapFactory.decodeStream(assetManager.open(imageName));
-    } catch (IOException e) {
-      Log.e(TAG, "Cannot open image " + imageName);
-      return null;
-    }
-  }
-
-  public static void loadTexture(int target, Bitmap bitmap) {
-    GLUtils.texImage2D(target, 0, bitmap, 0);
-  }
 }
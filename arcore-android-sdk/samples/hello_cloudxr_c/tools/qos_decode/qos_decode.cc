@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+// Converts connection QoS record files written by the CloudXR ARCore client
+// (see the -qr launch option) into CSV.
+//
+// Usage: qos_decode [-o out.csv] cloudxr_qos.N.bin ... cloudxr_qos.bin
+//
+// Files are decoded in the order given, so pass rotated files oldest first
+// (highest index first) to get one continuous time series.
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "qos_record_format.h"
+
+using hello_ar::qos::QosFileHeader;
+using hello_ar::qos::QosRecord;
+
+namespace {
+
+const char* QualityName(uint32_t quality) {
+  static const char* kNames[] = {"unstable", "bad", "poor",
+                                 "fair",     "good", "excellent"};
+  return quality < sizeof(kNames) / sizeof(kNames[0]) ? kNames[quality]
+                                                      : "unknown";
+}
+
+// Mirrors cxrConnectionQualityReason; zero means quality is still being
+// estimated.
+std::string QualityReasons(uint32_t reasons) {
+  if (reasons == 0) return "estimating";
+  std::string out;
+  if (reasons & 0x1) out += "low_bandwidth|";
+  if (reasons & 0x2) out += "high_latency|";
+  if (reasons & 0x4) out += "high_packet_loss|";
+  if (out.empty()) return "other";
+  out.pop_back();
+  return out;
+}
+
+bool DecodeFile(const char* path, FILE* out) {
+  FILE* in = fopen(path, "rb");
+  if (!in) {
+    fprintf(stderr, "qos_decode: unable to open %s\n", path);
+    return false;
+  }
+
+  QosFileHeader header;
+  if (fread(&header, sizeof(header), 1, in) != 1 ||
+      memcmp(header.magic, hello_ar::qos::kFileMagic, sizeof(header.magic)) !=
+          0) {
+    fprintf(stderr, "qos_decode: %s is not a QoS record file\n", path);
+    fclose(in);
+    return false;
+  }
+  if (header.version != hello_ar::qos::kFileVersion ||
+      header.record_size != sizeof(QosRecord)) {
+    fprintf(stderr, "qos_decode: %s has unsupported version %u\n", path,
+            header.version);
+    fclose(in);
+    return false;
+  }
+
+  fseek(in, header.header_size, SEEK_SET);
+  std::vector<QosRecord> records(header.capacity);
+  const size_t count = fread(records.data(), sizeof(QosRecord),
+                             records.size(), in);
+  fclose(in);
+
+  for (size_t i = 0; i < count; i++) {
+    const QosRecord& r = records[i];
+    // Records are preallocated zeroed, the first empty one ends the data.
+    if (r.timestamp_ms == 0) break;
+
+    fprintf(out,
+            "%" PRIu64 ",%.2f,%.2f,%.2f,%.2f,%u,%u,%u,%u,%u,%u,%u,%u,%s,%s\n",
+            r.timestamp_ms, r.frames_per_second, r.frame_delivery_time_ms,
+            r.frame_queue_time_ms, r.frame_latch_time_ms,
+            r.bandwidth_available_kbps, r.bandwidth_utilization_kbps,
+            r.bandwidth_utilization_percent, r.round_trip_delay_ms,
+            r.jitter_us, r.total_packets_received, r.total_packets_lost,
+            r.total_packets_dropped, QualityName(r.quality),
+            QualityReasons(r.quality_reasons).c_str());
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  FILE* out = stdout;
+  std::vector<const char*> inputs;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      out = fopen(argv[++i], "w");
+      if (!out) {
+        fprintf(stderr, "qos_decode: unable to create %s\n", argv[i]);
+        return 1;
+      }
+    } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+      inputs.clear();
+      break;
+    } else {
+      inputs.push_back(argv[i]);
+    }
+  }
+
+  if (inputs.empty()) {
+    fprintf(stderr, "Usage: %s [-o out.csv] file.bin [file.bin ...]\n",
+            argv[0]);
+    return 1;
+  }
+
+  fputs("timestamp_ms,fps,frame_delivery_ms,frame_queue_ms,frame_latch_ms,"
+        "bandwidth_available_kbps,bandwidth_utilization_kbps,"
+        "bandwidth_utilization_percent,round_trip_ms,jitter_us,"
+        "packets_received,packets_lost,packets_dropped,quality,"
+        "quality_reasons\n",
+        out);
+
+  bool ok = true;
+  for (const char* input : inputs) {
+    ok = DecodeFile(input, out) && ok;
+  }
+
+  if (out != stdout) fclose(out);
+  return ok ? 0 : 1;
+}